@@ -2,7 +2,10 @@
 
 # Generates sprite sheets for each atlas
 
-# depends on .atl file(s), compress.tmp file, and mkatlas.pl script (which requires etc1tool and texturetool for compression)
+# depends on .atl file(s), compress.tmp file, and jni/atlas/mkatlas or the mkatlas.pl script (which require etc1tool and texturetool for compression)
+
+# jni/atlas/mkatl regroups an .atl file by what race_bench -c captured being drawn, so the quads drawn together
+# share atlases; mkatlas.pl ignores the sections it writes.
 
 set -u #referencing undefined variable causes error
 set -x #print out everything it does
@@ -27,12 +30,23 @@ etc1FileEnding='.pkm'
 pvrFileEnding='.pvr'
 atlasFileEnding='.atl'
 compressFileEnding=0
+# ETC1 has no alpha, mkatlas -a puts the alpha of translucent atlases in a second, gray, .pkm
+alphaOption=''
+
+# the C++ packer (cd jni && make -C atlas mkatlas) fits more in an atlas, turning images and trimming their
+# transparent borders; mkatlas.pl until it's built
+if [ -x jni/atlas/mkatlas ]; then
+	mkatlas='jni/atlas/mkatlas -R -t'
+else
+	mkatlas='perl ./mkatlas.pl'
+fi
 
 
-# if 'none' is specified as the compression param, no extension is specified and the default output from script mkatlas.pl is .png 
+# if 'none' is specified as the compression param, no extension is specified and the default output from mkatlas is .png 
 # otherwise...
 if [ ${compression} == 'etc1' ]; then
 	compressFileEnding=${etc1FileEnding}
+	alphaOption='-a'
 elif [ ${compression} == 'pvr' ]; then
 	compressFileEnding=${pvrFileEnding}
 fi
@@ -45,13 +59,20 @@ cat "${srcDir}/compress.tmp" | while read atlasLine; do
 	atlasName=$(echo ${atlasLine} | cut -s -d: -f1)
 	atlasCompress=$(echo ${atlasLine} | cut -s -d: -f2 | cut -s -d= -f2)
 	
-	# mkatlas params: -f configfile [-s size (128)] [-r imgrootdir (.)] [-p pvrspacing (0)] [-e output compressFileEnding (.png)] [-g group name (1)]
+	# mkatlas params: -f configfile [-s size (128)] [-r imgrootdir (.)] [-p pvrspacing (0)] [-e output compressFileEnding (.png)] [-g group name (1)] [-a]
+	# jni/atlas/mkatlas only: [-R (turn images)] [-t (trim transparent borders)] [-b bounds file] [-j threads]
 
 	if [[ ${atlasCompress} = 'yes' && ${compression} != 'none' ]]; then
-		perl ./mkatlas.pl -r "${srcDir}" -f "${srcDir}/${atlasName}${atlasFileEnding}" -s 1024 -p 4 -g "${atlasName}" -e "${compressFileEnding}" || { echo "FAILED!"; exit 1; }
+		${mkatlas} -r "${srcDir}" -f "${srcDir}/${atlasName}${atlasFileEnding}" -s 1024 -p 4 -g "${atlasName}" -e "${compressFileEnding}" ${alphaOption} || { echo "FAILED!"; exit 1; }
 		mv -f "${srcDir}/${atlasName}"*".atlas" "${srcDir}/${atlasName}"*"Atlas${compressFileEnding}" "${destDir}"
+		# only the translucent atlases have one
+		for alphaPlane in "${srcDir}/${atlasName}"*"Atlas_alpha${compressFileEnding}"; do
+			if [ -e "${alphaPlane}" ]; then
+				mv -f "${alphaPlane}" "${destDir}"
+			fi
+		done
 	elif [[ ${atlasCompress} = 'no' || ${compression} = 'none' ]]; then
-		perl ./mkatlas.pl -r "${srcDir}" -f "${srcDir}/${atlasName}${atlasFileEnding}" -s 1024 -p 2 -g "${atlasName}" || { echo "FAILED!"; exit 1; }
+		${mkatlas} -r "${srcDir}" -f "${srcDir}/${atlasName}${atlasFileEnding}" -s 1024 -p 2 -g "${atlasName}" || { echo "FAILED!"; exit 1; }
 		mv -f "${srcDir}/${atlasName}"*".atlas" "${srcDir}/${atlasName}"*"Atlas.png" "${destDir}"
 	else
 		echo "Error: compression flag error in compress.tmp on line ${atlasLine}"
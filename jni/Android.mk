@@ -26,9 +26,21 @@ LOCAL_SRC_FILES  := openal/OpenAL32/alAuxEffectSlot.c \
                     openal/Alc/ALu.c                  \
                     openal/Alc/android.c              \
                     openal/Alc/bs2b.c                 \
+                    openal/Alc/loopback.c             \
+                    openal/Alc/mixer.c                \
+                    openal/Alc/mixer_sse.c            \
                     openal/Alc/null.c                 \
 
 LOCAL_CFLAGS     := -DAL_BUILD_LIBRARY -DAL_ALEXT_PROTOTYPES
+
+# NEON isn't guaranteed on armeabi-v7a, so its kernels get built with NEON
+# enabled and are only picked after checking the CPU at run time
+ifeq ($(TARGET_ARCH_ABI),armeabi-v7a)
+LOCAL_SRC_FILES  += openal/Alc/mixer_neon.c.neon
+LOCAL_CFLAGS     += -DHAVE_NEON
+LOCAL_STATIC_LIBRARIES := cpufeatures
+endif
+
 LOCAL_LDLIBS     := -llog -Wl,-s
 
 include $(BUILD_SHARED_LIBRARY)
@@ -162,30 +174,44 @@ ENGINE_SRC_FILES = \
 	Collider.cpp \
 	Director.cpp \
 	Drawable.cpp \
+	Etc1Decoder.cpp \
 	GL.cpp \
 	GLMock.cpp \
+	InputJournal.cpp \
+	InputQueue.cpp \
+	JobSystem.cpp \
 	Label.cpp \
 	Menu.cpp \
 	MenuItem.cpp \
 	Mesh.cpp \
 	MoveAction.cpp \
+	RenderList.cpp \
 	Resource.cpp \
+	ResourceStream.cpp \
 	Resources.cpp \
 	RotateAction.cpp \
 	Scene.cpp \
 	Sound.cpp \
+	SoundAsset.cpp \
+	SoundBank.cpp \
 	SoundDevice.cpp \
 	Sprite.cpp \
+	StreamingSound.cpp \
 	Texture.cpp \
 	TexturedFont.cpp \
 	TexturedQuad.cpp \
 	TextureLibrary.cpp \
 	TextureLoader.cpp \
 	TouchButton.cpp \
+	PrimitiveBatch.cpp \
+	Profiler.cpp \
+	ProfilerOverlay.cpp \
 	ProgressBar.cpp \
 	DrawableRectangle.cpp \
 	DrawableLine.cpp \
-	FollowAction.cpp \
+	DrawCapture.cpp \
+	VertexBuffer.cpp \
+	VoicePool.cpp \
 
 GAME_SRC_FILES = \
 	Animal.cpp \
@@ -200,6 +226,7 @@ GAME_SRC_FILES = \
 	Globals.cpp \
 	LoadingScreenScene.cpp \
 	MainMenuScene.cpp \
+	NeighbourIndex.cpp \
 	Obstacle.cpp \
 	OpponentAI.cpp \
 	OpponentTruck.cpp \
@@ -233,3 +260,4 @@ LOCAL_LDLIBS := -lGLESv1_CM -llog -lz
 
 include $(BUILD_SHARED_LIBRARY)
 
+$(call import-module,android/cpufeatures)
@@ -8,6 +8,11 @@ else
 	APP_OPTIM := release
 endif
 
+# ndk-build PROFILE=1 turns on the zones of engine/Profiler.hpp, in release builds too.
+ifeq ($(PROFILE),1)
+	APP_CFLAGS += -DENGINE_PROFILE
+endif
+
 APP_STL := gnustl_static
 
 #From the NDK CPU Arch ABIs document:
@@ -0,0 +1,481 @@
+// Copyright 2011 Nuffer Brothers Software LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "AtlasBuilder.hpp"
+#include "engine/JobSystem.hpp"
+#include "miniblocxx/Array.hpp"
+#include "miniblocxx/Format.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+namespace atlas
+{
+
+BLOCXX_DEFINE_EXCEPTION(Atlas);
+
+const char* const SECTION_LINE = "// atlas";
+
+using namespace blocxx;
+using engine::JobSystem;
+
+namespace
+{
+
+// Change these if the tools are installed somewhere else.
+const char* const TEXTURETOOL = "/Developer/Platforms/iPhoneOS.platform/Developer/usr/bin/texturetool";
+const char* const ETC1TOOL = "etc1tool";
+
+const MaxRects::Heuristic HEURISTICS[] = { MaxRects::BestShortSideFit, MaxRects::BestLongSideFit, MaxRects::BestAreaFit };
+const size_t HEURISTIC_COUNT = sizeof(HEURISTICS) / sizeof(HEURISTICS[0]);
+const PackingOrder ORDERS[] = { LargestAreaFirst, LongestSideFirst };
+const size_t ORDER_COUNT = sizeof(ORDERS) / sizeof(ORDERS[0]);
+
+// Sorts indexes of sizes, largest first.
+struct Larger
+{
+	Larger(const std::vector<Rect>& sizes, PackingOrder order) : sizes(sizes), order(order) {}
+	long key(size_t i) const
+	{
+		const Rect& r = sizes[i];
+		return order == LargestAreaFirst ? long(r.width) * r.height : std::max(r.width, r.height);
+	}
+	bool operator()(size_t a, size_t b) const
+	{
+		return key(a) > key(b);
+	}
+	const std::vector<Rect>& sizes;
+	PackingOrder order;
+};
+
+class PackCandidates : public JobSystem::RangeBody
+{
+public:
+	PackCandidates(const std::vector<Rect>& sizes, int atlasSize, bool allowRotation)
+		: sizes(sizes), atlasSize(atlasSize), allowRotation(allowRotation), packings(HEURISTIC_COUNT * ORDER_COUNT)
+	{
+	}
+
+	virtual void run(size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; ++i)
+			packings[i] = pack(sizes, atlasSize, allowRotation, HEURISTICS[i % HEURISTIC_COUNT], ORDERS[i / HEURISTIC_COUNT]);
+	}
+
+	const std::vector<Rect>& sizes;
+	int atlasSize;
+	bool allowRotation;
+	std::vector<Packing> packings;
+};
+
+int scaled(int size, float factor)
+{
+	return int(floorf(size * factor + 0.5f));
+}
+
+}
+
+String ListEntry::name() const
+{
+	String name = filename;
+	size_t slash = name.lastIndexOf('/');
+	if (slash != String::npos)
+		name = name.substring(slash + 1);
+	size_t dot = name.lastIndexOf('.');
+	if (dot != String::npos)
+		name = name.substring(0, dot);
+	return name;
+}
+
+bool parseListLine(const String& line, ListEntry& entry)
+{
+	String trimmed(line);
+	trimmed.trim();
+	if (trimmed.empty() || trimmed.startsWith("//"))
+		return false;
+
+	StringArray fields = trimmed.tokenize(",");
+	entry = ListEntry();
+	entry.filename = fields[0].trim();
+	int ups = 0;
+	int downs = 0;
+	for (size_t i = 1; i < fields.size(); ++i)
+	{
+		String field = fields[i].trim();
+		if (field.startsWith('+'))
+		{
+			float& factor = ups++ == 0 ? entry.scaleWidthUp : entry.scaleHeightUp;
+			factor = field.substring(1).toFloat();
+		}
+		else if (field.startsWith('-'))
+		{
+			float& factor = downs++ == 0 ? entry.scaleWidthDown : entry.scaleHeightDown;
+			factor = field.substring(1).toFloat();
+		}
+	}
+	return true;
+}
+
+bool isSectionLine(const String& line)
+{
+	String trimmed(line);
+	trimmed.trim();
+	return trimmed == SECTION_LINE;
+}
+
+bool Packing::betterThan(const Packing& other) const
+{
+	if (atlasCount != other.atlasCount)
+		return atlasCount < other.atlasCount;
+	return lastOccupancy < other.lastOccupancy;
+}
+
+Packing pack(const std::vector<Rect>& sizes, int atlasSize, bool allowRotation, MaxRects::Heuristic heuristic,
+	PackingOrder order)
+{
+	std::vector<size_t> sorted(sizes.size());
+	for (size_t i = 0; i < sorted.size(); ++i)
+		sorted[i] = i;
+	std::stable_sort(sorted.begin(), sorted.end(), Larger(sizes, order));
+
+	Packing packing;
+	packing.atlas.resize(sizes.size());
+	packing.placed.resize(sizes.size());
+	packing.rotated.resize(sizes.size());
+	std::vector<MaxRects> atlases;
+	for (std::vector<size_t>::const_iterator it = sorted.begin(); it != sorted.end(); ++it)
+	{
+		const Rect& size = sizes[*it];
+		Rect placed;
+		bool rotated = false;
+		size_t atlas = 0;
+		while (atlas < atlases.size() && !atlases[atlas].insert(size.width, size.height, heuristic, placed, rotated))
+			++atlas;
+		if (atlas == atlases.size())
+		{
+			atlases.push_back(MaxRects(atlasSize, atlasSize, allowRotation));
+			if (!atlases.back().insert(size.width, size.height, heuristic, placed, rotated))
+				BLOCXX_THROW(AtlasException, Format("%1 x %2 doesn't fit in a %3 atlas", size.width, size.height, atlasSize).c_str());
+		}
+		packing.atlas[*it] = atlas;
+		packing.placed[*it] = placed;
+		packing.rotated[*it] = rotated;
+	}
+	packing.atlasCount = atlases.size();
+	packing.lastOccupancy = atlases.empty() ? 0 : atlases.back().occupancy();
+	return packing;
+}
+
+Packing packBest(const std::vector<Rect>& sizes, int atlasSize, bool allowRotation, JobSystem& jobs)
+{
+	PackCandidates candidates(sizes, atlasSize, allowRotation);
+	jobs.parallelFor(candidates.packings.size(), 1, candidates);
+	size_t best = 0;
+	for (size_t i = 1; i < candidates.packings.size(); ++i)
+	{
+		if (candidates.packings[i].betterThan(candidates.packings[best]))
+			best = i;
+	}
+	return candidates.packings[best];
+}
+
+class AtlasBuilder::PrepareSprites : public JobSystem::RangeBody
+{
+public:
+	explicit PrepareSprites(const AtlasBuilder& builder, std::vector<Sprite>& sprites) : builder(builder), sprites(sprites) {}
+
+	virtual void run(size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; ++i)
+		{
+			// Thrown on a worker nothing would catch it.
+			try
+			{
+				builder.prepare(sprites[i]);
+			}
+			catch (const Exception& e)
+			{
+				sprites[i].error = e.getMessage();
+			}
+		}
+	}
+
+	const AtlasBuilder& builder;
+	std::vector<Sprite>& sprites;
+};
+
+class AtlasBuilder::ComposeAtlases : public JobSystem::RangeBody
+{
+public:
+	explicit ComposeAtlases(const AtlasBuilder& builder) : builder(builder), translucent(builder.m_atlasCount, false), errors(builder.m_atlasCount) {}
+
+	virtual void run(size_t begin, size_t end)
+	{
+		const Options& options = builder.m_options;
+		const int margin = options.padding / 2;
+		for (size_t atlas = begin; atlas < end; ++atlas)
+		{
+			try
+			{
+				AtlasImage image(options.size, options.size);
+				for (std::vector<Sprite>::const_iterator it = builder.m_sprites.begin(); it != builder.m_sprites.end(); ++it)
+				{
+					if (it->atlas != atlas)
+						continue;
+					image.blit(it->rotated ? it->image.rotated() : it->image, it->placed.x + margin, it->placed.y + margin, margin);
+					if (!it->opaque)
+						translucent[atlas] = true;
+				}
+				String prefix = builder.prefix(atlas);
+				image.save(prefix + "Atlas.png");
+				if (options.alphaPlane && options.extension == ".pkm" && translucent[atlas])
+					image.saveAlpha(prefix + "Atlas_alpha.png");
+			}
+			catch (const Exception& e)
+			{
+				errors[atlas] = e.getMessage();
+			}
+		}
+	}
+
+	const AtlasBuilder& builder;
+	// Not vector<bool>, its elements share bytes.
+	std::vector<char> translucent;
+	std::vector<String> errors;
+};
+
+AtlasBuilder::AtlasBuilder(const Options& options)
+	: m_options(options)
+	, m_jobs(new JobSystem(options.workers))
+	, m_atlasCount(0)
+{
+	if (m_options.padding % 2 != 0)
+		BLOCXX_THROW(AtlasException, "the padding must be a multiple of 2");
+}
+
+AtlasBuilder::~AtlasBuilder()
+{
+	delete m_jobs;
+}
+
+void AtlasBuilder::load()
+{
+	readList();
+	std::cout << "total number of images: " << m_sprites.size() << std::endl;
+
+	PrepareSprites prepareSprites(*this, m_sprites);
+	m_jobs->parallelFor(m_sprites.size(), 1, prepareSprites);
+	for (std::vector<Sprite>::const_iterator it = m_sprites.begin(); it != m_sprites.end(); ++it)
+	{
+		if (!it->error.empty())
+			BLOCXX_THROW(AtlasException, it->error.c_str());
+	}
+}
+
+void AtlasBuilder::packSections()
+{
+	// Each section's atlases are numbered on from the last section's.
+	m_atlasCount = 0;
+	size_t sections = m_sprites.empty() ? 0 : m_sprites.back().section + 1;
+	for (size_t section = 0; section < sections; ++section)
+	{
+		std::vector<size_t> indexes;
+		std::vector<Rect> sizes;
+		for (size_t i = 0; i < m_sprites.size(); ++i)
+		{
+			if (m_sprites[i].section != section)
+				continue;
+			indexes.push_back(i);
+			sizes.push_back(packedSize(m_sprites[i]));
+		}
+		Packing packing = packBest(sizes, m_options.size, m_options.rotate, *m_jobs);
+		for (size_t i = 0; i < indexes.size(); ++i)
+		{
+			Sprite& sprite = m_sprites[indexes[i]];
+			sprite.atlas = m_atlasCount + packing.atlas[i];
+			sprite.placed = packing.placed[i];
+			sprite.rotated = packing.rotated[i];
+		}
+		m_atlasCount += packing.atlasCount;
+		if (sections > 1)
+			std::cout << "section " << section + 1 << ": ";
+		std::cout << "atlases: " << packing.atlasCount << ", the last " << int(packing.lastOccupancy * 100) << "% full" << std::endl;
+	}
+}
+
+void AtlasBuilder::build()
+{
+	load();
+	packSections();
+
+	ComposeAtlases composeAtlases(*this);
+	m_jobs->parallelFor(m_atlasCount, 1, composeAtlases);
+	for (size_t atlas = 0; atlas < m_atlasCount; ++atlas)
+	{
+		if (!composeAtlases.errors[atlas].empty())
+			BLOCXX_THROW(AtlasException, composeAtlases.errors[atlas].c_str());
+		writeAtlasFile(atlas, composeAtlases.translucent[atlas]);
+		compress(atlas, composeAtlases.translucent[atlas]);
+	}
+	if (!m_options.boundsFilename.empty())
+		writeBounds();
+}
+
+void AtlasBuilder::readList()
+{
+	std::ifstream in(m_options.listFilename.c_str());
+	if (!in)
+		BLOCXX_THROW(AtlasException, Format("Cannot open file: %1", m_options.listFilename).c_str());
+	std::string line;
+	size_t section = 0;
+	while (std::getline(in, line))
+	{
+		// A section with no images before it, the one the list starts with usually, is no section.
+		if (isSectionLine(line.c_str()))
+		{
+			if (!m_sprites.empty() && m_sprites.back().section == section)
+				++section;
+			continue;
+		}
+		Sprite sprite;
+		if (parseListLine(line.c_str(), sprite.entry))
+		{
+			sprite.line = line.c_str();
+			sprite.section = section;
+			m_sprites.push_back(sprite);
+		}
+	}
+}
+
+void AtlasBuilder::prepare(Sprite& sprite) const
+{
+	const ListEntry& entry = sprite.entry;
+	AtlasImage image = AtlasImage::load(m_options.root + "/" + entry.filename);
+	int width = scaled(image.width(), entry.scaleWidthUp);
+	int height = scaled(image.height(), entry.scaleHeightUp);
+	if (width != image.width() || height != image.height())
+		image = image.resized(width, height);
+
+	sprite.fullWidth = width;
+	sprite.fullHeight = height;
+	sprite.trim = Rect(0, 0, width, height);
+	sprite.opaque = image.opaque();
+	if (m_options.trim && !sprite.opaque)
+	{
+		Rect bounds = image.opaqueBounds();
+		// A completely transparent image is left as it is.
+		if (bounds.width > 0 && (bounds.width < width || bounds.height < height))
+		{
+			image = image.cropped(bounds);
+			sprite.trim = bounds;
+		}
+	}
+	sprite.image = image;
+
+	// pack() would throw too, without saying which image it was. The atlas is square, turning doesn't help.
+	if (image.width() + m_options.padding > m_options.size || image.height() + m_options.padding > m_options.size)
+		BLOCXX_THROW(AtlasException, Format("%1 doesn't fit in a %2 atlas", entry.filename, m_options.size).c_str());
+}
+
+Rect AtlasBuilder::packedSize(const Sprite& sprite) const
+{
+	return Rect(0, 0, sprite.image.width() + m_options.padding, sprite.image.height() + m_options.padding);
+}
+
+String AtlasBuilder::prefix(size_t atlas) const
+{
+	String prefix = m_options.listFilename;
+	if (prefix.endsWith(".atl"))
+		prefix = prefix.substring(0, prefix.length() - 4);
+	return prefix + String(UInt32(atlas + 1));
+}
+
+void AtlasBuilder::writeAtlasFile(size_t atlas, bool translucent) const
+{
+	String prefix = this->prefix(atlas);
+	// Named in the .atlas file from the image root, like the .atlas file itself is loaded.
+	String imageName = prefix;
+	if (imageName.startsWith(m_options.root + "/"))
+		imageName = imageName.substring(m_options.root.length() + 1);
+
+	std::ofstream out((prefix + ".atlas").c_str());
+	out << "image: " << imageName << "Atlas" << m_options.extension << "\n";
+	out << "size: " << m_options.size << " " << m_options.size << "\n";
+	out << "group: " << m_options.group << "\n";
+	const int margin = m_options.padding / 2;
+	for (std::vector<Sprite>::const_iterator it = m_sprites.begin(); it != m_sprites.end(); ++it)
+	{
+		if (it->atlas != atlas)
+			continue;
+		out << "quad: " << it->entry.name() << " " << it->placed.x + margin << " " << it->placed.y + margin << " "
+			<< it->image.width() << " " << it->image.height() << " "
+			<< it->entry.scaleWidthDown << " " << it->entry.scaleHeightDown;
+		if (it->opaque)
+			out << " opaque";
+		if (it->rotated)
+			out << " rotated";
+		if (it->image.width() != it->fullWidth || it->image.height() != it->fullHeight)
+			out << " trim " << it->trim.x << " " << it->trim.y << " " << it->fullWidth << " " << it->fullHeight;
+		out << "\n";
+	}
+	if (m_options.alphaPlane && m_options.extension == ".pkm" && translucent)
+		out << "alpha: " << imageName << "Atlas_alpha.pkm\n";
+	if (!out)
+		BLOCXX_THROW(AtlasException, Format("Cannot write %1.atlas", prefix).c_str());
+}
+
+void AtlasBuilder::compress(size_t atlas, bool translucent) const
+{
+	String prefix = this->prefix(atlas);
+	Array<String> calls;
+	if (m_options.extension == ".pvr")
+	{
+		calls.push_back(Format("%1 -o %2Atlas.pvr -f PVR -e PVRTC -p %2Atlas_pvrprev.png %2Atlas.png", TEXTURETOOL, prefix));
+	}
+	else if (m_options.extension == ".pkm")
+	{
+		calls.push_back(Format("%1 %2Atlas.png --encode -o %2Atlas.pkm", ETC1TOOL, prefix));
+		calls.push_back(Format("%1 %2Atlas.pkm --decode -o %2Atlas_etc1prev.png", ETC1TOOL, prefix));
+		if (m_options.alphaPlane && translucent)
+			calls.push_back(Format("%1 %2Atlas_alpha.png --encode -o %2Atlas_alpha.pkm", ETC1TOOL, prefix));
+	}
+	for (Array<String>::const_iterator it = calls.begin(); it != calls.end(); ++it)
+	{
+		std::cout << "Calling " << *it << std::endl;
+		if (system(it->c_str()) != 0)
+			BLOCXX_THROW(AtlasException, Format("%1 failed", *it).c_str());
+	}
+}
+
+void AtlasBuilder::writeBounds() const
+{
+	std::ofstream out(m_options.boundsFilename.c_str(), std::ios::app);
+	for (std::vector<Sprite>::const_iterator it = m_sprites.begin(); it != m_sprites.end(); ++it)
+	{
+		if (it->image.width() == it->fullWidth && it->image.height() == it->fullHeight)
+			continue;
+		// Left, top, right and bottom from the bottom left of the full image, and the factors
+		// the quad is scaled down by, which loadRealBounds() scales them by as well.
+		const Rect& trim = it->trim;
+		out << "image: " << it->entry.name() << " " << trim.x << " " << it->fullHeight - trim.y << " "
+			<< trim.x + trim.width << " " << it->fullHeight - trim.y - trim.height << " "
+			<< it->entry.scaleWidthDown << " " << it->entry.scaleHeightDown << "\n";
+	}
+	if (!out)
+		BLOCXX_THROW(AtlasException, Format("Cannot write %1", m_options.boundsFilename).c_str());
+}
+
+}
@@ -0,0 +1,183 @@
+// Copyright 2011 Nuffer Brothers Software LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef atlas_AtlasBuilder_HPP_INCLUDED
+#define atlas_AtlasBuilder_HPP_INCLUDED
+
+#include "AtlasImage.hpp"
+#include "MaxRects.hpp"
+#include "miniblocxx/BLOCXX_config.h"
+#include "miniblocxx/Exception.hpp"
+#include "miniblocxx/String.hpp"
+#include <vector>
+
+namespace engine
+{
+class JobSystem;
+}
+
+namespace atlas
+{
+
+BLOCXX_DECLARE_EXCEPTION(Atlas);
+
+// What mkatlas was asked to do, see its usage.
+struct Options
+{
+	Options()
+		: size(128), root("."), padding(0), extension(".png"), group("1"), alphaPlane(false)
+		, rotate(false), trim(false), workers(0)
+	{}
+	blocxx::String listFilename;
+	int size;
+	blocxx::String root;
+	// Pixels between images, half of it the image's edge repeated.
+	int padding;
+	blocxx::String extension;
+	blocxx::String group;
+	bool alphaPlane;
+	bool rotate;
+	bool trim;
+	// Where to add the bounds of trimmed images, in TextureLibrary::loadRealBounds() format. None if empty.
+	blocxx::String boundsFilename;
+	size_t workers;
+};
+
+/**
+ * One line of an .atl list:
+ *   <image>[,+<width scale up>][,+<height scale up>][,-<width scale down>][,-<height scale down>][,*<alternative name>]
+ * The image goes into the atlas scaled up, and the quad is drawn scaled down again. The alternative
+ * name was for a C header mkatlas.pl no longer writes, it is ignored.
+ *
+ * A SECTION_LINE starts a section: its images are packed into atlases of their own, none
+ * shared with another section's. mkatl writes them, mkatlas.pl takes them for comments.
+ */
+struct ListEntry
+{
+	ListEntry() : scaleWidthUp(1), scaleHeightUp(1), scaleWidthDown(1), scaleHeightDown(1) {}
+	// The quad's name, the image's filename without directory or extension.
+	blocxx::String name() const;
+
+	blocxx::String filename;
+	float scaleWidthUp;
+	float scaleHeightUp;
+	float scaleWidthDown;
+	float scaleHeightDown;
+};
+
+extern const char* const SECTION_LINE;
+
+// False for // comments, SECTION_LINE included, and blank lines.
+bool parseListLine(const blocxx::String& line, ListEntry& entry);
+bool isSectionLine(const blocxx::String& line);
+
+// Where each rectangle went, in which atlas and where in it.
+struct Packing
+{
+	Packing() : atlasCount(0), lastOccupancy(0) {}
+	// Fewer atlases, or as many with less in the last one.
+	bool betterThan(const Packing& other) const;
+
+	std::vector<size_t> atlas;
+	std::vector<Rect> placed;
+	std::vector<bool> rotated;
+	size_t atlasCount;
+	double lastOccupancy;
+};
+
+enum PackingOrder
+{
+	LargestAreaFirst,
+	LongestSideFirst
+};
+
+// Puts each rectangle (only their sizes matter) in the first atlas it fits in, starting a new
+// one when it fits in none. Throws if one doesn't fit in an empty atlas.
+Packing pack(const std::vector<Rect>& sizes, int atlasSize, bool allowRotation, MaxRects::Heuristic heuristic,
+	PackingOrder order);
+
+// Packs with every heuristic and order, each on a thread of jobs, and keeps the best.
+Packing packBest(const std::vector<Rect>& sizes, int atlasSize, bool allowRotation, engine::JobSystem& jobs);
+
+/**
+ * Makes the atlases of an .atl list, the same .atlas files, images and ETC1 or PVRTC
+ * compression mkatlas.pl did. Images are loaded and trimmed, and atlases composed and
+ * written, on all cores.
+ */
+class AtlasBuilder
+{
+public:
+	explicit AtlasBuilder(const Options& options);
+	~AtlasBuilder();
+
+	// Reads the list and prepares its images, on all cores.
+	void load();
+	// Packs the loaded images, each section into atlases of its own.
+	void packSections();
+	// Loads, packs and writes the atlases.
+	void build();
+
+	// An image ready for the atlas, and where it went.
+	struct Sprite
+	{
+		Sprite() : section(0), fullWidth(0), fullHeight(0), opaque(false), atlas(0), rotated(false) {}
+		// As it is in the list.
+		blocxx::String line;
+		ListEntry entry;
+		size_t section;
+		// Scaled up and trimmed.
+		AtlasImage image;
+		// The size once scaled up, before trimming.
+		int fullWidth;
+		int fullHeight;
+		// Where image was in that.
+		Rect trim;
+		// Of the whole image, a trimmed one never is.
+		bool opaque;
+		size_t atlas;
+		// In the atlas, the padding included.
+		Rect placed;
+		bool rotated;
+		// Set if loading it failed, it is thrown once all are done.
+		blocxx::String error;
+	};
+
+	const std::vector<Sprite>& sprites() const { return m_sprites; }
+	// What an image takes up in an atlas, the padding included.
+	Rect packedSize(const Sprite& sprite) const;
+
+private:
+	class PrepareSprites;
+	class ComposeAtlases;
+
+	void readList();
+	void prepare(Sprite& sprite) const;
+	// The list's filename without .atl, and the atlas' number.
+	blocxx::String prefix(size_t atlas) const;
+	void writeAtlasFile(size_t atlas, bool translucent) const;
+	void compress(size_t atlas, bool translucent) const;
+	void writeBounds() const;
+
+	Options m_options;
+	engine::JobSystem* m_jobs;
+	std::vector<Sprite> m_sprites;
+	size_t m_atlasCount;
+
+	AtlasBuilder(const AtlasBuilder&);
+	AtlasBuilder& operator=(const AtlasBuilder&);
+};
+
+}
+
+#endif
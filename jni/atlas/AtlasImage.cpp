@@ -0,0 +1,233 @@
+// Copyright 2011 Nuffer Brothers Software LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "AtlasImage.hpp"
+#include "miniblocxx/Format.hpp"
+#include <algorithm>
+#include <cstdio>
+
+extern "C"
+{
+#include "libpng/png.h"
+}
+
+namespace atlas
+{
+
+BLOCXX_DEFINE_EXCEPTION(AtlasImage);
+
+using namespace blocxx;
+
+namespace
+{
+
+// Closes the file and frees libpng's state however the function using them leaves.
+struct PngFile
+{
+	PngFile(const String& filename, const char* mode)
+		: file(fopen(filename.c_str(), mode)), png(0), info(0), writing(mode[0] == 'w')
+	{
+		if (!file)
+			BLOCXX_THROW(AtlasImageException, Format("Cannot open %1", filename).c_str());
+	}
+	~PngFile()
+	{
+		if (writing)
+			png_destroy_write_struct(&png, info ? &info : NULL);
+		else
+			png_destroy_read_struct(&png, info ? &info : NULL, NULL);
+		fclose(file);
+	}
+	FILE* file;
+	png_structp png;
+	png_infop info;
+	bool writing;
+};
+
+void writeRows(const String& filename, int width, int height, int colorType, const std::vector<png_bytep>& rows)
+{
+	PngFile out(filename, "wb");
+	out.png = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+	if (!out.png || !(out.info = png_create_info_struct(out.png)))
+		BLOCXX_THROW(AtlasImageException, "png_create_write_struct failed");
+	if (setjmp(png_jmpbuf(out.png)))
+		BLOCXX_THROW(AtlasImageException, Format("Cannot write %1", filename).c_str());
+	png_init_io(out.png, out.file);
+	// As mkatlas.pl did, the atlases are written once and read on every device.
+	png_set_compression_level(out.png, 9);
+	png_set_IHDR(out.png, out.info, width, height, 8, colorType, PNG_INTERLACE_NONE,
+		PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+	png_write_info(out.png, out.info);
+	png_write_image(out.png, const_cast<png_bytepp>(&rows[0]));
+	png_write_end(out.png, out.info);
+}
+
+}
+
+AtlasImage::AtlasImage(int width, int height)
+	: m_width(width)
+	, m_height(height)
+	, m_pixels(size_t(width) * height * 4, 0)
+{
+}
+
+AtlasImage AtlasImage::load(const String& filename)
+{
+	PngFile in(filename, "rb");
+	png_byte header[8];
+	if (fread(header, 1, sizeof(header), in.file) != sizeof(header) || png_sig_cmp(header, 0, sizeof(header)))
+		BLOCXX_THROW(AtlasImageException, Format("%1 is not a png", filename).c_str());
+	in.png = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+	if (!in.png || !(in.info = png_create_info_struct(in.png)))
+		BLOCXX_THROW(AtlasImageException, "png_create_read_struct failed");
+	if (setjmp(png_jmpbuf(in.png)))
+		BLOCXX_THROW(AtlasImageException, Format("Cannot read %1", filename).c_str());
+	png_init_io(in.png, in.file);
+	png_set_sig_bytes(in.png, sizeof(header));
+	png_read_info(in.png, in.info);
+
+	// Whatever the png has, RGBA with 8 bits each.
+	int colorType = png_get_color_type(in.png, in.info);
+	png_set_expand(in.png);
+	png_set_strip_16(in.png);
+	if (colorType == PNG_COLOR_TYPE_GRAY || colorType == PNG_COLOR_TYPE_GRAY_ALPHA)
+		png_set_gray_to_rgb(in.png);
+	png_set_filler(in.png, 0xFF, PNG_FILLER_AFTER);
+	png_read_update_info(in.png, in.info);
+
+	AtlasImage image(png_get_image_width(in.png, in.info), png_get_image_height(in.png, in.info));
+	std::vector<png_bytep> rows(image.m_height);
+	for (int y = 0; y < image.m_height; ++y)
+		rows[y] = image.pixel(0, y);
+	png_read_image(in.png, &rows[0]);
+	png_read_end(in.png, NULL);
+	return image;
+}
+
+void AtlasImage::save(const String& filename) const
+{
+	std::vector<png_bytep> rows(m_height);
+	for (int y = 0; y < m_height; ++y)
+		rows[y] = const_cast<png_bytep>(pixel(0, y));
+	writeRows(filename, m_width, m_height, PNG_COLOR_TYPE_RGB_ALPHA, rows);
+}
+
+void AtlasImage::saveAlpha(const String& filename) const
+{
+	std::vector<unsigned char> gray(size_t(m_width) * m_height * 3);
+	for (size_t i = 0; i < size_t(m_width) * m_height; ++i)
+		std::fill(&gray[i * 3], &gray[i * 3] + 3, m_pixels[i * 4 + 3]);
+	std::vector<png_bytep> rows(m_height);
+	for (int y = 0; y < m_height; ++y)
+		rows[y] = &gray[size_t(y) * m_width * 3];
+	writeRows(filename, m_width, m_height, PNG_COLOR_TYPE_RGB, rows);
+}
+
+AtlasImage AtlasImage::resized(int width, int height) const
+{
+	AtlasImage result(width, height);
+	for (int y = 0; y < height; ++y)
+	{
+		float sy = std::max(0.0f, (y + 0.5f) * m_height / height - 0.5f);
+		int y0 = std::min(int(sy), m_height - 1);
+		int y1 = std::min(y0 + 1, m_height - 1);
+		float fy = sy - y0;
+		for (int x = 0; x < width; ++x)
+		{
+			float sx = std::max(0.0f, (x + 0.5f) * m_width / width - 0.5f);
+			int x0 = std::min(int(sx), m_width - 1);
+			int x1 = std::min(x0 + 1, m_width - 1);
+			float fx = sx - x0;
+			for (int c = 0; c < 4; ++c)
+			{
+				float top = pixel(x0, y0)[c] * (1 - fx) + pixel(x1, y0)[c] * fx;
+				float bottom = pixel(x0, y1)[c] * (1 - fx) + pixel(x1, y1)[c] * fx;
+				result.pixel(x, y)[c] = (unsigned char)(top * (1 - fy) + bottom * fy + 0.5f);
+			}
+		}
+	}
+	return result;
+}
+
+Rect AtlasImage::opaqueBounds() const
+{
+	int left = m_width;
+	int right = -1;
+	int top = m_height;
+	int bottom = -1;
+	for (int y = 0; y < m_height; ++y)
+	{
+		for (int x = 0; x < m_width; ++x)
+		{
+			if (pixel(x, y)[3] != 0)
+			{
+				left = std::min(left, x);
+				right = std::max(right, x);
+				top = std::min(top, y);
+				bottom = std::max(bottom, y);
+			}
+		}
+	}
+	if (right < 0)
+		return Rect();
+	return Rect(left, top, right - left + 1, bottom - top + 1);
+}
+
+AtlasImage AtlasImage::cropped(const Rect& area) const
+{
+	AtlasImage result(area.width, area.height);
+	for (int y = 0; y < area.height; ++y)
+		std::copy(pixel(area.x, area.y + y), pixel(area.x, area.y + y) + area.width * 4, result.pixel(0, y));
+	return result;
+}
+
+AtlasImage AtlasImage::rotated() const
+{
+	AtlasImage result(m_height, m_width);
+	for (int y = 0; y < result.m_height; ++y)
+	{
+		for (int x = 0; x < result.m_width; ++x)
+		{
+			const unsigned char* from = pixel(y, m_height - 1 - x);
+			std::copy(from, from + 4, result.pixel(x, y));
+		}
+	}
+	return result;
+}
+
+bool AtlasImage::opaque() const
+{
+	for (size_t i = 3; i < m_pixels.size(); i += 4)
+	{
+		if (m_pixels[i] != 0xFF)
+			return false;
+	}
+	return true;
+}
+
+void AtlasImage::blit(const AtlasImage& image, int x, int y, int margin)
+{
+	for (int row = -margin; row < image.m_height + margin; ++row)
+	{
+		int fromY = std::min(std::max(row, 0), image.m_height - 1);
+		for (int column = -margin; column < image.m_width + margin; ++column)
+		{
+			int fromX = std::min(std::max(column, 0), image.m_width - 1);
+			const unsigned char* from = image.pixel(fromX, fromY);
+			std::copy(from, from + 4, pixel(x + column, y + row));
+		}
+	}
+}
+
+}
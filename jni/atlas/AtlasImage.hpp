@@ -0,0 +1,72 @@
+// Copyright 2011 Nuffer Brothers Software LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef atlas_AtlasImage_HPP_INCLUDED
+#define atlas_AtlasImage_HPP_INCLUDED
+
+#include "MaxRects.hpp"
+#include "miniblocxx/BLOCXX_config.h"
+#include "miniblocxx/Exception.hpp"
+#include "miniblocxx/String.hpp"
+#include <vector>
+
+namespace atlas
+{
+
+BLOCXX_DECLARE_EXCEPTION(AtlasImage);
+
+/**
+ * An RGBA image, 8 bits a channel, rows from the top.
+ */
+class AtlasImage
+{
+public:
+	AtlasImage() : m_width(0), m_height(0) {}
+	// Fully transparent black.
+	AtlasImage(int width, int height);
+
+	static AtlasImage load(const blocxx::String& filename);
+	void save(const blocxx::String& filename) const;
+	// The alpha as gray, white where opaque, for an ETC1 alpha plane.
+	void saveAlpha(const blocxx::String& filename) const;
+
+	int width() const { return m_width; }
+	int height() const { return m_height; }
+	unsigned char* pixel(int x, int y) { return &m_pixels[(y * m_width + x) * 4]; }
+	const unsigned char* pixel(int x, int y) const { return &m_pixels[(y * m_width + x) * 4]; }
+
+	// Bilinear, as GD's copyResized did for the scale up factors of an .atl line.
+	AtlasImage resized(int width, int height) const;
+	// The smallest part of the image with every pixel that isn't fully transparent.
+	// Empty if there is none.
+	Rect opaqueBounds() const;
+	AtlasImage cropped(const Rect& area) const;
+	// Turned a quarter clockwise, the top left corner goes to the top right.
+	AtlasImage rotated() const;
+	// No pixel shows anything through.
+	bool opaque() const;
+
+	// Copies image with its top left at x, y, then repeats its edge pixels margin more
+	// times all around, so filtering at the edges doesn't pick up the neighbors.
+	void blit(const AtlasImage& image, int x, int y, int margin);
+
+private:
+	int m_width;
+	int m_height;
+	std::vector<unsigned char> m_pixels;
+};
+
+}
+
+#endif
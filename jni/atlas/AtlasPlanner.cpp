@@ -0,0 +1,180 @@
+// Copyright 2011 Nuffer Brothers Software LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "AtlasPlanner.hpp"
+#include "miniblocxx/Array.hpp"
+#include <algorithm>
+#include <istream>
+#include <string>
+
+namespace atlas
+{
+
+using namespace blocxx;
+
+namespace
+{
+
+typedef std::map<String, size_t> Indexes;
+
+// Where each name is first in names.
+Indexes indexes(const std::vector<String>& names)
+{
+	Indexes result;
+	for (size_t i = 0; i < names.size(); ++i)
+		result.insert(std::make_pair(names[i], i));
+	return result;
+}
+
+// Sorts sections by area, largest first.
+struct LargerArea
+{
+	explicit LargerArea(const std::vector<long>& area) : area(area) {}
+	bool operator()(size_t a, size_t b) const
+	{
+		return area[a] > area[b];
+	}
+	const std::vector<long>& area;
+};
+
+}
+
+void CoUsage::read(std::istream& in)
+{
+	std::string line;
+	while (std::getline(in, line))
+	{
+		StringArray tokens = String(line.c_str()).tokenize(" \r");
+		addFrame(std::vector<String>(tokens.begin(), tokens.end()));
+	}
+}
+
+void CoUsage::addFrame(const std::vector<String>& names)
+{
+	++m_frames;
+	for (size_t i = 1; i < names.size(); ++i)
+	{
+		const String& a = names[i - 1];
+		const String& b = names[i];
+		if (a == b)
+			continue;
+		++m_pairs[a < b ? std::make_pair(a, b) : std::make_pair(b, a)];
+	}
+}
+
+std::vector<size_t> planSections(const std::vector<String>& names, const std::vector<Rect>& sizes,
+	const CoUsage& usage, long capacity)
+{
+	const size_t count = names.size();
+	// Sections are numbered by their first quad while merging, cluster[i] is quad i's.
+	std::vector<size_t> cluster(count);
+	std::vector<long> area(count);
+	std::vector<bool> alive(count, true);
+	std::vector<std::vector<double> > weight(count, std::vector<double>(count, 0));
+	for (size_t i = 0; i < count; ++i)
+	{
+		cluster[i] = i;
+		area[i] = long(sizes[i].width) * sizes[i].height;
+	}
+	Indexes index = indexes(names);
+	for (CoUsage::Pairs::const_iterator it = usage.pairs().begin(); it != usage.pairs().end(); ++it)
+	{
+		Indexes::const_iterator a = index.find(it->first.first);
+		Indexes::const_iterator b = index.find(it->first.second);
+		if (a == index.end() || b == index.end())
+			continue;
+		weight[a->second][b->second] += it->second;
+		weight[b->second][a->second] += it->second;
+	}
+
+	for (;;)
+	{
+		size_t bestA = count;
+		size_t bestB = count;
+		double best = 0;
+		for (size_t a = 0; a < count; ++a)
+		{
+			if (!alive[a])
+				continue;
+			for (size_t b = a + 1; b < count; ++b)
+			{
+				if (alive[b] && weight[a][b] > best && area[a] + area[b] <= capacity)
+				{
+					best = weight[a][b];
+					bestA = a;
+					bestB = b;
+				}
+			}
+		}
+		if (bestA == count)
+			break;
+
+		// b goes into a, and what was drawn next to b is now next to a.
+		alive[bestB] = false;
+		area[bestA] += area[bestB];
+		for (size_t k = 0; k < count; ++k)
+		{
+			weight[bestA][k] += weight[bestB][k];
+			weight[k][bestA] = weight[bestA][k];
+			if (cluster[k] == bestB)
+				cluster[k] = bestA;
+		}
+		weight[bestA][bestA] = 0;
+	}
+
+	// What is never drawn next to each other still shares atlases, each section going in
+	// the first that has room.
+	std::vector<size_t> clusters;
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (alive[i])
+			clusters.push_back(i);
+	}
+	std::stable_sort(clusters.begin(), clusters.end(), LargerArea(area));
+	std::vector<size_t> sectionOf(count);
+	std::vector<long> room;
+	for (std::vector<size_t>::const_iterator it = clusters.begin(); it != clusters.end(); ++it)
+	{
+		size_t section = 0;
+		while (section < room.size() && room[section] < area[*it])
+			++section;
+		if (section == room.size())
+			room.push_back(capacity);
+		room[section] -= area[*it];
+		sectionOf[*it] = section;
+	}
+
+	std::vector<size_t> result(count);
+	for (size_t i = 0; i < count; ++i)
+		result[i] = sectionOf[cluster[i]];
+	return result;
+}
+
+double switchesPerFrame(const std::vector<String>& names, const std::vector<size_t>& atlas, const CoUsage& usage)
+{
+	if (usage.frames() == 0)
+		return 0;
+	Indexes index = indexes(names);
+	double switches = 0;
+	for (CoUsage::Pairs::const_iterator it = usage.pairs().begin(); it != usage.pairs().end(); ++it)
+	{
+		Indexes::const_iterator a = index.find(it->first.first);
+		Indexes::const_iterator b = index.find(it->first.second);
+		if (a != index.end() && b != index.end() && atlas[a->second] != atlas[b->second])
+			switches += it->second;
+	}
+	return switches / usage.frames();
+}
+
+}
@@ -0,0 +1,71 @@
+// Copyright 2011 Nuffer Brothers Software LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef atlas_AtlasPlanner_HPP_INCLUDED
+#define atlas_AtlasPlanner_HPP_INCLUDED
+
+#include "MaxRects.hpp"
+#include "miniblocxx/BLOCXX_config.h"
+#include "miniblocxx/String.hpp"
+#include <iosfwd>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace atlas
+{
+
+/**
+ * How often each two quads were drawn one right after the other, counted over the frames
+ * of a capture engine::drawcapture wrote. Each of those draws costs a texture switch
+ * unless both quads are in the same atlas.
+ */
+class CoUsage
+{
+public:
+	CoUsage() : m_frames(0) {}
+
+	// Adds every frame of a capture, a line of quad names each.
+	void read(std::istream& in);
+	// Adds a frame, the quads in the order they were drawn.
+	void addFrame(const std::vector<blocxx::String>& names);
+
+	// Keyed by the two names, the smaller first.
+	typedef std::map<std::pair<blocxx::String, blocxx::String>, unsigned> Pairs;
+	const Pairs& pairs() const { return m_pairs; }
+	size_t frames() const { return m_frames; }
+
+private:
+	Pairs m_pairs;
+	size_t m_frames;
+};
+
+/**
+ * Splits quads into sections of at most capacity area each, a section to an atlas, so that
+ * the quads drawn one after the other most often share one. Starting with a section a quad,
+ * the two sections drawn one after the other most often are merged, while they fit together;
+ * then the sections are put together largest first, so no more atlases are made than
+ * needed. Returns each quad's section. sizes are what each quad takes up in the atlas.
+ */
+std::vector<size_t> planSections(const std::vector<blocxx::String>& names, const std::vector<Rect>& sizes,
+	const CoUsage& usage, long capacity);
+
+// The texture switches per frame between the named quads, each in atlas[i]. Switches
+// to or from quads not named aren't counted.
+double switchesPerFrame(const std::vector<blocxx::String>& names, const std::vector<size_t>& atlas,
+	const CoUsage& usage);
+
+}
+
+#endif
@@ -0,0 +1,147 @@
+// Copyright 2011 Nuffer Brothers Software LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "MaxRects.hpp"
+#include <algorithm>
+#include <climits>
+
+namespace atlas
+{
+
+MaxRects::MaxRects(int width, int height, bool allowRotation)
+	: m_width(width)
+	, m_height(height)
+	, m_allowRotation(allowRotation)
+	, m_usedArea(0)
+{
+	m_free.push_back(Rect(0, 0, width, height));
+}
+
+void MaxRects::score(const Rect& free, int width, int height, Heuristic heuristic, int& first, int& second) const
+{
+	int leftoverX = free.width - width;
+	int leftoverY = free.height - height;
+	int shortSide = std::min(leftoverX, leftoverY);
+	int longSide = std::max(leftoverX, leftoverY);
+	switch (heuristic)
+	{
+	case BestShortSideFit:
+		first = shortSide;
+		second = longSide;
+		break;
+	case BestLongSideFit:
+		first = longSide;
+		second = shortSide;
+		break;
+	case BestAreaFit:
+		first = free.width * free.height - width * height;
+		second = shortSide;
+		break;
+	}
+}
+
+bool MaxRects::insert(int width, int height, Heuristic heuristic, Rect& placed, bool& rotated)
+{
+	int bestFirst = INT_MAX;
+	int bestSecond = INT_MAX;
+	for (std::vector<Rect>::const_iterator it = m_free.begin(); it != m_free.end(); ++it)
+	{
+		int first;
+		int second;
+		if (width <= it->width && height <= it->height)
+		{
+			score(*it, width, height, heuristic, first, second);
+			if (first < bestFirst || (first == bestFirst && second < bestSecond))
+			{
+				bestFirst = first;
+				bestSecond = second;
+				placed = Rect(it->x, it->y, width, height);
+				rotated = false;
+			}
+		}
+		if (m_allowRotation && width != height && height <= it->width && width <= it->height)
+		{
+			score(*it, height, width, heuristic, first, second);
+			if (first < bestFirst || (first == bestFirst && second < bestSecond))
+			{
+				bestFirst = first;
+				bestSecond = second;
+				placed = Rect(it->x, it->y, height, width);
+				rotated = true;
+			}
+		}
+	}
+	if (bestFirst == INT_MAX)
+		return false;
+
+	place(placed);
+	return true;
+}
+
+void MaxRects::place(const Rect& used)
+{
+	// Every free rectangle used overlaps is replaced by the up to four parts of it
+	// around used, each as large as it can be.
+	std::vector<Rect> split;
+	for (std::vector<Rect>::const_iterator it = m_free.begin(); it != m_free.end(); ++it)
+	{
+		const Rect& free = *it;
+		if (used.x >= free.x + free.width || used.x + used.width <= free.x ||
+			used.y >= free.y + free.height || used.y + used.height <= free.y)
+		{
+			split.push_back(free);
+			continue;
+		}
+		if (used.y > free.y)
+			split.push_back(Rect(free.x, free.y, free.width, used.y - free.y));
+		if (used.y + used.height < free.y + free.height)
+			split.push_back(Rect(free.x, used.y + used.height, free.width, free.y + free.height - used.y - used.height));
+		if (used.x > free.x)
+			split.push_back(Rect(free.x, free.y, used.x - free.x, free.height));
+		if (used.x + used.width < free.x + free.width)
+			split.push_back(Rect(used.x + used.width, free.y, free.x + free.width - used.x - used.width, free.height));
+	}
+	m_free.swap(split);
+	prune();
+	m_usedArea += long(used.width) * used.height;
+}
+
+void MaxRects::prune()
+{
+	// A free rectangle inside another adds nothing.
+	for (size_t i = 0; i < m_free.size(); ++i)
+	{
+		for (size_t j = i + 1; j < m_free.size(); ++j)
+		{
+			if (m_free[j].contains(m_free[i]))
+			{
+				m_free.erase(m_free.begin() + i);
+				--i;
+				break;
+			}
+			if (m_free[i].contains(m_free[j]))
+			{
+				m_free.erase(m_free.begin() + j);
+				--j;
+			}
+		}
+	}
+}
+
+double MaxRects::occupancy() const
+{
+	return double(m_usedArea) / (double(m_width) * m_height);
+}
+
+}
@@ -0,0 +1,82 @@
+// Copyright 2011 Nuffer Brothers Software LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef atlas_MaxRects_HPP_INCLUDED
+#define atlas_MaxRects_HPP_INCLUDED
+
+#include <vector>
+
+namespace atlas
+{
+
+// x and y from the top left of the atlas, as in the image.
+struct Rect
+{
+	Rect() : x(0), y(0), width(0), height(0) {}
+	Rect(int x, int y, int width, int height) : x(x), y(y), width(width), height(height) {}
+	bool contains(const Rect& r) const
+	{
+		return r.x >= x && r.y >= y && r.x + r.width <= x + width && r.y + r.height <= y + height;
+	}
+	int x;
+	int y;
+	int width;
+	int height;
+};
+
+/**
+ * Places rectangles in one atlas with the MaxRects algorithm: it keeps every maximal
+ * free rectangle, overlapping each other, and puts the next rectangle in the one the
+ * heuristic likes best. That leaves much less unused than the old binary tree split.
+ */
+class MaxRects
+{
+public:
+	enum Heuristic
+	{
+		// Least left over along the shorter side of the free rectangle.
+		BestShortSideFit,
+		// Least left over along the longer side.
+		BestLongSideFit,
+		// The smallest free rectangle it fits in.
+		BestAreaFit
+	};
+
+	MaxRects(int width, int height, bool allowRotation);
+
+	// Finds a place for a width x height rectangle, turned a quarter (height x width in
+	// placed) when that fits better and rotation is allowed. False if it fits nowhere.
+	bool insert(int width, int height, Heuristic heuristic, Rect& placed, bool& rotated);
+
+	// The part of the atlas that has been placed, 0 to 1.
+	double occupancy() const;
+
+	const std::vector<Rect>& freeRects() const { return m_free; }
+
+private:
+	// Lower is better, the second breaks ties.
+	void score(const Rect& free, int width, int height, Heuristic heuristic, int& first, int& second) const;
+	void place(const Rect& used);
+	void prune();
+
+	int m_width;
+	int m_height;
+	bool m_allowRotation;
+	long m_usedArea;
+	std::vector<Rect> m_free;
+};
+
+}
+
+#endif
@@ -0,0 +1,164 @@
+// Copyright 2011 Nuffer Brothers Software LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Regroups the images of an .atl list into sections, each packed into atlases of its own
+// by mkatlas, so that the quads a frame draws one after the other share an atlas and
+// drawing them needs fewer texture switches. What frames draw comes from captures
+// race_bench -c wrote:
+//   race_bench -c yankeeshot.txt -t 0 ...
+//   mkatl -f foreground/foreground.atl -c yankeeshot.txt -s 1024 -p 2 -r .. -R -t -o foreground/foreground.atl
+// Pass the size, padding and options mkatlas is run with, the images take up what they
+// will there.
+
+#include "AtlasBuilder.hpp"
+#include "AtlasPlanner.hpp"
+#include "engine/JobSystem.hpp"
+#include "miniblocxx/Format.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <unistd.h>
+
+using namespace atlas;
+using blocxx::Format;
+using blocxx::String;
+
+namespace
+{
+
+void usage()
+{
+	std::cerr << "mkatl -f configfile -c capture [-c capture ...] -o output configfile [-s size (128)] [-r imgrootdir (.)]\n"
+		"  [-p spacing (0)] [-R (turn images to fit)] [-t (trim transparent borders)]\n"
+		"  [-u how full a section's atlas is planned, percent (90)] [-j worker threads (one less than the cores)]" << std::endl;
+	exit(1);
+}
+
+// Whether every section fits in one atlas.
+bool fits(const std::vector<Rect>& sizes, const std::vector<size_t>& sections, const Options& options,
+	engine::JobSystem& jobs)
+{
+	size_t count = sizes.empty() ? 0 : *std::max_element(sections.begin(), sections.end()) + 1;
+	for (size_t section = 0; section < count; ++section)
+	{
+		std::vector<Rect> inSection;
+		for (size_t i = 0; i < sizes.size(); ++i)
+		{
+			if (sections[i] == section)
+				inSection.push_back(sizes[i]);
+		}
+		if (packBest(inSection, options.size, options.rotate, jobs).atlasCount > 1)
+			return false;
+	}
+	return true;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+	Options options;
+	options.workers = engine::JobSystem::defaultWorkerCount();
+	std::vector<String> captures;
+	String output;
+	int fill = 90;
+	int c;
+	while ((c = getopt(argc, argv, "hf:c:o:s:r:p:Rtu:j:")) != -1)
+	{
+		switch (c)
+		{
+		case 'f': options.listFilename = optarg; break;
+		case 'c': captures.push_back(optarg); break;
+		case 'o': output = optarg; break;
+		case 's': options.size = atoi(optarg); break;
+		case 'r': options.root = optarg; break;
+		case 'p': options.padding = atoi(optarg); break;
+		case 'R': options.rotate = true; break;
+		case 't': options.trim = true; break;
+		case 'u': fill = atoi(optarg); break;
+		case 'j': options.workers = atoi(optarg); break;
+		default: usage();
+		}
+	}
+	if (options.listFilename.empty() || captures.empty() || output.empty() || options.size <= 0 || fill <= 0 || fill > 100)
+		usage();
+
+	try
+	{
+		CoUsage usage;
+		for (std::vector<String>::const_iterator it = captures.begin(); it != captures.end(); ++it)
+		{
+			std::ifstream in(it->c_str());
+			if (!in)
+				BLOCXX_THROW(AtlasException, Format("Cannot open file: %1", *it).c_str());
+			usage.read(in);
+		}
+		std::cout << "frames captured: " << usage.frames() << std::endl;
+
+		AtlasBuilder builder(options);
+		builder.load();
+		// The atlases the list makes as it is, to compare with.
+		builder.packSections();
+		const std::vector<AtlasBuilder::Sprite>& sprites = builder.sprites();
+		std::vector<String> names;
+		std::vector<Rect> sizes;
+		std::vector<size_t> atlases;
+		for (std::vector<AtlasBuilder::Sprite>::const_iterator it = sprites.begin(); it != sprites.end(); ++it)
+		{
+			names.push_back(it->entry.name());
+			sizes.push_back(builder.packedSize(*it));
+			atlases.push_back(it->atlas);
+		}
+
+		// Planned by area, a section may still not pack into one atlas. Plan them emptier until they do.
+		engine::JobSystem jobs(options.workers);
+		std::vector<size_t> sections;
+		for (; fill > 0; fill -= 5)
+		{
+			sections = planSections(names, sizes, usage, long(options.size) * options.size * fill / 100);
+			if (fits(sizes, sections, options, jobs))
+				break;
+			std::cout << "sections planned " << fill << "% full don't fit in an atlas each" << std::endl;
+		}
+		if (fill <= 0)
+			BLOCXX_THROW(AtlasException, "the sections don't fit in an atlas each");
+
+		size_t sectionCount = sections.empty() ? 0 : *std::max_element(sections.begin(), sections.end()) + 1;
+		size_t atlasCount = atlases.empty() ? 0 : *std::max_element(atlases.begin(), atlases.end()) + 1;
+		std::cout << "texture switches per frame: " << switchesPerFrame(names, atlases, usage) << " in "
+			<< atlasCount << " atlases, " << switchesPerFrame(names, sections, usage) << " in "
+			<< sectionCount << " sections" << std::endl;
+
+		std::ofstream out(output.c_str());
+		out << "// Sections planned by mkatl from what race_bench -c captured, each is packed into atlases of its own.\n";
+		for (size_t section = 0; section < sectionCount; ++section)
+		{
+			out << SECTION_LINE << "\n";
+			for (size_t i = 0; i < sprites.size(); ++i)
+			{
+				if (sections[i] == section)
+					out << sprites[i].line << "\n";
+			}
+		}
+		if (!out)
+			BLOCXX_THROW(AtlasException, Format("Cannot write %1", output).c_str());
+	}
+	catch (const blocxx::Exception& e)
+	{
+		std::cerr << "Error: " << e.getMessage() << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,74 @@
+// Copyright 2011 Nuffer Brothers Software LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Packs the images of an .atl list into atlases, see AtlasBuilder. Takes the options
+// mkatlas.pl did, and more:
+//   mkatlas -f foreground/foreground.atl -s 1024 -p 2 -r .. -R -t
+
+#include "AtlasBuilder.hpp"
+#include "engine/JobSystem.hpp"
+#include <cstdlib>
+#include <iostream>
+#include <unistd.h>
+
+namespace
+{
+
+void usage()
+{
+	std::cerr << "mkatlas -f configfile [-s size (128)] [-r imgrootdir (.)] [-p spacing (0)] [-e output extension (.png)]\n"
+		"  [-g group name (1)] [-a (alpha plane for .pkm)] [-R (turn images to fit)] [-t (trim transparent borders)]\n"
+		"  [-b bounds file to add trimmed bounds to] [-j worker threads (one less than the cores)]" << std::endl;
+	exit(1);
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+	atlas::Options options;
+	options.workers = engine::JobSystem::defaultWorkerCount();
+	int c;
+	while ((c = getopt(argc, argv, "hf:s:r:p:e:g:aRtb:j:")) != -1)
+	{
+		switch (c)
+		{
+		case 'f': options.listFilename = optarg; break;
+		case 's': options.size = atoi(optarg); break;
+		case 'r': options.root = optarg; break;
+		case 'p': options.padding = atoi(optarg); break;
+		case 'e': options.extension = optarg; break;
+		case 'g': options.group = optarg; break;
+		case 'a': options.alphaPlane = true; break;
+		case 'R': options.rotate = true; break;
+		case 't': options.trim = true; break;
+		case 'b': options.boundsFilename = optarg; break;
+		case 'j': options.workers = atoi(optarg); break;
+		default: usage();
+		}
+	}
+	if (options.listFilename.empty() || options.size <= 0)
+		usage();
+
+	try
+	{
+		atlas::AtlasBuilder(options).build();
+	}
+	catch (const blocxx::Exception& e)
+	{
+		std::cerr << "Error: " << e.getMessage() << std::endl;
+		return 1;
+	}
+	return 0;
+}
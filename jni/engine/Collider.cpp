@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "Collider.hpp"
+#include "Profiler.hpp"
 #include "graphlib/Fuzzy.hpp"
 #include "engine/Log.hpp"
 #include <algorithm>
@@ -63,6 +64,7 @@ namespace engine
 	// This implements a variant of the sorted
 	void doCollisionChecks(std::vector<CollidablePtr>& objects, const DateTime& thisFrameStartTime, const TimeDuration& deltaTime)
 	{
+		PROFILE_ZONE("doCollisionChecks");
 		std::vector<ColliderData> data;
 		data.reserve(objects.size() * 2);
 
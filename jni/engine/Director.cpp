@@ -14,10 +14,13 @@
 
 #include "EngineConfig.hpp"
 #include "Director.hpp"
+#include "DrawCapture.hpp"
 #include "Log.hpp"
+#include "Profiler.hpp"
 #include "GL.hpp"
 #include "Resources.hpp"
 #include "miniblocxx/DateTime.hpp"
+#include "miniblocxx/Exception.hpp"
 
 #include "libzip/zip.h"
 
@@ -26,6 +29,24 @@
 namespace engine
 {
 
+	Director::Director()
+		: _showing(0)
+		, _simulating(false)
+		, _stopping(false)
+		, _frameRequested(false)
+		, _frameRecorded(false)
+	{
+		pthread_mutex_init(&_simulationMutex, NULL);
+		pthread_cond_init(&_simulationCondition, NULL);
+	}
+
+	Director::~Director()
+	{
+		stopSimulation();
+		pthread_cond_destroy(&_simulationCondition);
+		pthread_mutex_destroy(&_simulationMutex);
+	}
+
 	Rectangle Director::screen() const
 	{
 		return Rectangle::makeCenteredOn(m_cameraPosition, m_scaleSize);
@@ -33,41 +54,175 @@ namespace engine
 
 	void Director::init(const char* apkPath)
 	{
+		PROFILE_THREAD("Main");
+		waitForSimulation();
+		// Called again each time the surface comes with a new context, in its default state.
+		// Only then are the buffer objects made in the last one gone.
+		gl::beginContext();
 		Resources::init(apkPath);
 	}
 
 	void Director::runScene(ScenePtr scene)
 	{
+		waitForSimulation();
 		_runningScene = scene;
 		_runningScene->handleActivated();
 	}
 
 	void Director::setSize(int width, int height, int scaleWidth, int scaleHeight)
 	{
+		waitForSimulation();
 		m_scaleSize = Size(scaleWidth, scaleHeight);
 
 		glViewport(0, 0, width, height);
 		LOGD("setSize(w:%d,h:%d, sw:%d,sh:%d)", width, height, scaleWidth, scaleHeight);
-		glMatrixMode(GL_PROJECTION);
-		glLoadIdentity();
-		gl::ortho(-scaleWidth/2.0f, scaleWidth/2.0f, -scaleHeight/2.0f, scaleHeight/2.0f, -1.0f, 1.0f);
-		glMatrixMode(GL_MODELVIEW);
-		glLoadIdentity();
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-		glEnable(GL_BLEND);
+		// draw() sets the projection.
+		gl::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		gl::enableBlend();
 	}
 
 	void Director::renderNextFrame()
 	{
-		updateNextFrame();
+		if (!_simulating)
+		{
+			updateNextFrame();
+			displayFrame();
+			PROFILE_FRAME();
+			return;
+		}
+
+		waitForSimulation();
+		pthread_mutex_lock(&_simulationMutex);
+		if (_frameRecorded)
+		{
+			_showing = 1 - _showing;
+			_frameRecorded = false;
+		}
+		_frameRequested = true;
+		pthread_cond_broadcast(&_simulationCondition);
+		pthread_mutex_unlock(&_simulationMutex);
+
+		// Right after starting there is nothing to show yet: a list without draws that
+		// doesn't clear has never held a frame. Shows the one just asked for.
+		if (_lists[_showing].drawCount() == 0 && !_lists[_showing].clearsColor())
+		{
+			waitForSimulation();
+			pthread_mutex_lock(&_simulationMutex);
+			_showing = 1 - _showing;
+			_frameRecorded = false;
+			pthread_mutex_unlock(&_simulationMutex);
+		}
 		displayFrame();
+		PROFILE_FRAME();
+	}
+
+	void Director::startSimulation()
+	{
+		if (_simulating)
+			return;
+		_stopping = false;
+		_frameRequested = false;
+		_frameRecorded = false;
+		_lists[0].clear();
+		_lists[1].clear();
+		if (pthread_create(&_simulation, NULL, simulationMain, this) != 0)
+		{
+			LOGE("Couldn't start the simulation thread, simulating on the GL thread");
+			return;
+		}
+		_simulating = true;
+	}
+
+	void Director::stopSimulation()
+	{
+		if (!_simulating)
+			return;
+		pthread_mutex_lock(&_simulationMutex);
+		_stopping = true;
+		pthread_cond_broadcast(&_simulationCondition);
+		pthread_mutex_unlock(&_simulationMutex);
+		pthread_join(_simulation, NULL);
+		_simulating = false;
+	}
+
+	bool Director::simulationIdle()
+	{
+		if (!_simulating)
+			return true;
+		pthread_mutex_lock(&_simulationMutex);
+		bool idle = !_frameRequested;
+		pthread_mutex_unlock(&_simulationMutex);
+		return idle;
+	}
+
+	void Director::waitForSimulation()
+	{
+		if (!_simulating || pthread_equal(pthread_self(), _simulation))
+			return;
+		PROFILE_ZONE("Director::waitForSimulation");
+		pthread_mutex_lock(&_simulationMutex);
+		while (_frameRequested)
+			pthread_cond_wait(&_simulationCondition, &_simulationMutex);
+		pthread_mutex_unlock(&_simulationMutex);
+	}
+
+	void* Director::simulationMain(void* director)
+	{
+		static_cast<Director*>(director)->simulate();
+		return NULL;
+	}
+
+	void Director::simulate()
+	{
+		PROFILE_THREAD("Simulation");
+		// Everything the scenes draw on this thread goes into the list being built.
+		RenderRecorder recorder;
+		gl::setThreadRecorder(&recorder);
+
+		pthread_mutex_lock(&_simulationMutex);
+		for (;;)
+		{
+			while (!_frameRequested && !_stopping)
+				pthread_cond_wait(&_simulationCondition, &_simulationMutex);
+			if (_stopping)
+				break;
+			RenderList& list = _lists[1 - _showing];
+			pthread_mutex_unlock(&_simulationMutex);
+
+			try
+			{
+				updateNextFrame();
+				recorder.begin(list);
+				draw();
+				recorder.end();
+			}
+			catch (const blocxx::Exception& e)
+			{
+				LOGE("Director::simulate() threw Exception: file: %s line: %d type: %s: \"%s\"", e.getFile(), e.getLine(), e.type(), e.getMessage());
+				abort();
+			}
+			catch (const std::exception& e)
+			{
+				LOGE("Director::simulate() threw std::exception: %s", e.what());
+				abort();
+			}
+
+			pthread_mutex_lock(&_simulationMutex);
+			_frameRequested = false;
+			_frameRecorded = true;
+			pthread_cond_broadcast(&_simulationCondition);
+		}
+		pthread_mutex_unlock(&_simulationMutex);
+		gl::setThreadRecorder(NULL);
 	}
 
 	void Director::updateNextFrame()
 	{
+		PROFILE_ZONE("Director::updateNextFrame");
 		DateTime thisFrameStartTime = DateTime::getCurrent();
 		TimeDuration deltaTime = (lastFrameStartTime == DateTime()) ? TimeDuration() : thisFrameStartTime - lastFrameStartTime;
 		lastFrameStartTime = thisFrameStartTime;
+		lastFrameDeltaTime = deltaTime;
 
 		//		LOGD("Director::renderNextFrame() deltaTime microseconds: %lld", (long long)deltaTime.microseconds());
 
@@ -82,55 +237,65 @@ namespace engine
 		{
 			//			LOGE("No running scene in Director::renderNextFrame.");
 		}
+		onFrameUpdated(deltaTime);
 	}
 
 	void Director::displayFrame()
 	{
-		draw();
+		if (_simulating)
+		{
+			_lists[_showing].submit();
+			gl::checkGLError("Director::displayFrame()");
+		}
+		else
+		{
+			draw();
+		}
 	}
 
 	void Director::draw()
 	{
 		using namespace gl;
-		clearColorBuffer();
-		clearDepthBuffer();
+		// Set every frame, so a frame recorded on the simulation thread carries its own.
+		matrixMode(GL_PROJECTION);
+		loadIdentity();
+		Rectangle screen = this->screen();
+		ortho(screen.left, screen.right, screen.bottom, screen.top, -1.0f, 1.0f);
+		matrixMode(GL_MODELVIEW);
 		loadIdentity();
+
+		// Nothing draws with depth. Where the scene's opaque children cover the screen, all of
+		// the color buffer is drawn over anyway.
+		Rectangle opaque(0, 0, 0, 0);
+		if (!_runningScene || !_runningScene->opaqueArea(screen, opaque))
+			clearColorBuffer();
 		VertexArrayScope vas;
 		ColorArrayScope cas;
 		TextureCoordArrayScope tcas;
 
 		if( _runningScene )
 		{
-			_runningScene->draw(screen());
+			_runningScene->draw(screen);
 		}
 		else
 		{
 			LOGE("No running scene in Director::draw()");
 		}
+		checkGLError("Director::draw()");
+		drawcapture::endFrame();
 	}
 
 	void Director::setCameraPosition(const Point& cameraPosition)
 	{
-		if (cameraPosition == m_cameraPosition) return;
-
+		waitForSimulation();
+		// draw() sets the projection from it.
 		m_cameraPosition = cameraPosition;
-
-		gl::matrixMode(GL_PROJECTION);
-		gl::loadIdentity();
-		Rectangle screen = this->screen();
-		//LOGD("setting ortho to (%f, %f: %f, %f)",
-		//	 screen.left, screen.right,
-		//	 screen.bottom, screen.top);
-		gl::ortho(screen.left, screen.right,
-			screen.bottom, screen.top,
-			-1.0f, 1.0f);
-
-		gl::matrixMode(GL_MODELVIEW);
 	}
 
 
 	void Director::handleTouchEvent(const TouchEvent& touchEvent)
 	{
+		waitForSimulation();
 		_runningScene->handleTouchEvent(touchEvent);
 	}
 
@@ -21,16 +21,27 @@
 #include "Point.hpp"
 #include "Size.hpp"
 #include "Rectangle.hpp"
+#include "RenderList.hpp"
 #include "miniblocxx/DateTime.hpp"
+#include "boost/signals2.hpp"
+#include <pthread.h>
 
 namespace engine
 {
 /**
  * You probably only want one instance of this class.
+ *
+ * After startSimulation() the scenes update and draw on a thread of their own, which
+ * records each frame into a RenderList for the GL thread to submit. While the GL thread
+ * draws one frame the simulation builds the next. Anything else touching the scenes
+ * from the GL thread has to wait for simulationIdle(), or call waitForSimulation().
  */
 class Director
 {
 public:
+	Director();
+	~Director();
+
 	void init(const char* apkPath);
 	void runScene(ScenePtr scene);
 	void setSize(int width, int height, int scaleWidth, int scaleHeight);
@@ -40,21 +51,58 @@ public:
 	void setCameraPosition(const Point& cameraPosition);
 
 
-	// Update and display the next frame.
+	// Update and display the next frame. With the simulation running: displays the frame
+	// it last built, and has it start on the next one.
 	void renderNextFrame();
 
 	void updateNextFrame();
+	// Draws the scene, or with the simulation running the last frame it built.
 	void displayFrame();
 
+	// The time the last updateNextFrame() advanced the scene by.
+	const TimeDuration& lastFrameTime() const			{ return lastFrameDeltaTime; }
+
+	// Called at the end of every updateNextFrame(), on the thread that ran it.
+	typedef boost::signals2::signal<void (const TimeDuration& /* deltaTime */)> frameUpdatedSignalT;
+	frameUpdatedSignalT& OnFrameUpdated()				{ return onFrameUpdated; }
+
+	// Call from the GL thread. Starting again does nothing.
+	void startSimulation();
+	void stopSimulation();
+	// Whether the simulation isn't building a frame, and never is without it.
+	bool simulationIdle();
+	// Waits until simulationIdle(). Doesn't wait on the simulation thread itself.
+	void waitForSimulation();
+
 private:
 	ScenePtr _runningScene;
 	DateTime lastFrameStartTime;
+	TimeDuration lastFrameDeltaTime;
 	Point m_cameraPosition;
 	Size m_scaleSize;
-	
+	frameUpdatedSignalT onFrameUpdated;
+
+	// The GL thread shows _lists[_showing], the simulation records into the other one.
+	RenderList _lists[2];
+	unsigned _showing;
+	pthread_t _simulation;
+	pthread_mutex_t _simulationMutex;
+	pthread_cond_t _simulationCondition;
+	bool _simulating;
+	bool _stopping;
+	// A frame the GL thread asked for and the simulation hasn't finished.
+	bool _frameRequested;
+	// Whether the list that isn't showing holds a frame it hasn't shown.
+	bool _frameRecorded;
+
 private:
+	Director(const Director&);
+	Director& operator=(const Director&);
+
 	void draw();
 	Rectangle screen() const;
+	static void* simulationMain(void* director);
+	void simulate();
 
 };
 
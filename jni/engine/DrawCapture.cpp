@@ -0,0 +1,70 @@
+// Copyright 2011 Nuffer Brothers Software LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "DrawCapture.hpp"
+#include <stdio.h>
+
+namespace engine
+{
+namespace drawcapture
+{
+	namespace
+	{
+		FILE* s_file = 0;
+		// The frame's last quad, empty at its start.
+		std::string s_last;
+	}
+
+	bool start(const std::string& path)
+	{
+		stop();
+		s_file = fopen(path.c_str(), "w");
+		return s_file != 0;
+	}
+
+	void stop()
+	{
+		if (!s_file)
+			return;
+		if (!s_last.empty())
+			endFrame();
+		fclose(s_file);
+		s_file = 0;
+	}
+
+	bool capturing()
+	{
+		return s_file != 0;
+	}
+
+	void quadDrawn(const std::string& name)
+	{
+		if (!s_file || name.empty() || name == s_last)
+			return;
+		if (!s_last.empty())
+			fputc(' ', s_file);
+		fputs(name.c_str(), s_file);
+		s_last = name;
+	}
+
+	void endFrame()
+	{
+		if (!s_file)
+			return;
+		// Frames without a quad are lines too, so line numbers stay frame numbers.
+		fputc('\n', s_file);
+		s_last.clear();
+	}
+}
+}
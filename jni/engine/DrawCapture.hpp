@@ -0,0 +1,47 @@
+// Copyright 2011 Nuffer Brothers Software LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef engine_DrawCapture_HPP_INCLUDED
+#define engine_DrawCapture_HPP_INCLUDED
+
+#include "EngineConfig.hpp"
+#include <string>
+
+namespace engine
+{
+/**
+ * Records which quads each frame draws, in the order it draws them, for mkatl to put the
+ * quads drawn together in the same atlas. A frame is a line of quad names separated by
+ * spaces; a quad drawn again right after itself is written once, as drawing it again
+ * costs no texture switch. Quads not from an atlas have no name and are left out.
+ *
+ * Everything but start() and stop() is called from the thread that draws, and those
+ * while it isn't drawing.
+ */
+namespace drawcapture
+{
+	// Starts writing to path, replacing it. Returns false if it couldn't be opened.
+	bool start(const std::string& path);
+	// Closes the file, ending a frame left half drawn.
+	void stop();
+	bool capturing();
+
+	// Called by TexturedQuad::draw().
+	void quadDrawn(const std::string& name);
+	// Called by Director::draw() once the frame is drawn.
+	void endFrame();
+}
+}
+
+#endif
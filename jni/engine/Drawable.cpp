@@ -14,14 +14,26 @@
 
 #include "EngineConfig.hpp"
 #include "Drawable.hpp"
+#include "PrimitiveBatch.hpp"
 #include "miniblocxx/Format.hpp"
+#include <algorithm> // for find
 
 namespace engine
 {
+	Drawable::~Drawable()
+	{
+		for (vector<DrawablePtr>::const_iterator it = m_attachedChildren.begin(); it != m_attachedChildren.end(); ++it)
+			(*it)->m_parent = 0;
+	}
+
 	void Drawable::update(const DateTime& thisFrameStartTime, const TimeDuration& deltaTime)
 	{
 		for (vector<ActionPtr>::const_iterator it = m_actions.begin(); it != m_actions.end(); ++it)
 			(*it)->apply(this, thisFrameStartTime, deltaTime);
+
+		// index based so a child may detach itself while being updated
+		for (size_t i = 0; i < m_attachedChildren.size(); ++i)
+			m_attachedChildren[i]->update(thisFrameStartTime, deltaTime);
 	}
 
 	std::string Drawable::name() const
@@ -39,18 +51,83 @@ namespace engine
 		Point oldPos(m_position);
 		m_position = position;
 		
+		invalidateWorldPosition();
+		
 		onPositionChanged(oldPos, position);
 	}
 
+	const Point& Drawable::worldPosition() const
+	{
+		if (m_parent == 0)
+			return m_position;
+
+		if (m_worldPositionDirty)
+		{
+			const Point& parentPosition = m_parent->worldPosition();
+			m_worldPosition = Point(parentPosition.x() + m_position.x(), parentPosition.y() + m_position.y());
+			m_worldPositionDirty = false;
+		}
+		return m_worldPosition;
+	}
+
+	void Drawable::invalidateWorldPosition()
+	{
+		// A dirty child's own children are already dirty, so the walk stops there.
+		for (vector<DrawablePtr>::const_iterator it = m_attachedChildren.begin(); it != m_attachedChildren.end(); ++it)
+		{
+			if (!(*it)->m_worldPositionDirty)
+			{
+				(*it)->m_worldPositionDirty = true;
+				(*it)->invalidateWorldPosition();
+			}
+		}
+	}
+
+	void Drawable::attachChild(const DrawablePtr& child)
+	{
+		if (child->m_parent == this)
+			return;
+		if (child->m_parent)
+			child->m_parent->detachChild(child);
+
+		m_attachedChildren.push_back(child);
+		child->m_parent = this;
+		child->m_worldPositionDirty = true;
+		child->invalidateWorldPosition();
+	}
+
+	void Drawable::detachChild(const DrawablePtr& child)
+	{
+		vector<DrawablePtr>::iterator it = std::find(m_attachedChildren.begin(), m_attachedChildren.end(), child);
+		if (it == m_attachedChildren.end())
+			return;
+
+		child->m_parent = 0;
+		child->invalidateWorldPosition();
+		m_attachedChildren.erase(it);
+	}
+
+	void Drawable::drawAttachedChildren(const Rectangle& screen)
+	{
+		for (vector<DrawablePtr>::const_iterator it = m_attachedChildren.begin(); it != m_attachedChildren.end(); ++it)
+		{
+			if (!(*it)->batched())
+				PrimitiveBatch::shared().flush();
+			(*it)->draw(screen);
+			(*it)->drawAttachedChildren(screen);
+		}
+	}
+
 	Point Drawable::getPositionRelativeToOrigin(const Rectangle& screen)
 	{
+		const Point& position = worldPosition();
 		switch (m_positionInterpretation) 
 		{
 			case E_ORIGIN:
-				return m_position;
+				return position;
 			case E_SCREEN:
-				return Point(screen.left + screen.width() / 2 + m_position.x(),
-							 screen.bottom + screen.height() / 2 + m_position.y());
+				return Point(screen.left + screen.width() / 2 + position.x(),
+							 screen.bottom + screen.height() / 2 + position.y());
 		}
 		return Point();
 	}
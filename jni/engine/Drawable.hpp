@@ -36,20 +36,44 @@ public:
 	Drawable()
 		: m_rotation(0.0)
 		, m_position(0.0, 0.0)
+		, m_worldPosition(0.0, 0.0)
+		, m_worldPositionDirty(false)
+		, m_parent(0)
 		, m_positionInterpretation(E_ORIGIN)
 	{}
+	virtual ~Drawable();
 
+	// Updates the actions and then all attached children.
 	virtual void update(const DateTime& thisFrameStartTime, const TimeDuration& deltaTime);
 	virtual void draw(const Rectangle& screen) = 0;
 	virtual std::string name() const;
 
+	// True when draw() covers all of area, in the coordinates it draws in, without any
+	// transparency. Scene draws those with blending off, and Director doesn't clear under them.
+	// Attached children are not part of it.
+	virtual bool opaqueArea(const Rectangle& screen, Rectangle& area) { return false; }
+
+	// True when draw() only adds to the PrimitiveBatch, so what was added before needn't be
+	// drawn first.
+	virtual bool batched() const { return false; }
+
 	float rotation() const { return m_rotation; }
 	virtual void setRotation(float rotation);
 
+	// position() is relative to the parent (if attached), worldPosition() is the parent's world position plus position().
 	const Point& position() const { return m_position; }
 	virtual void setPosition(const Point& position);
+	const Point& worldPosition() const;
 	Point getPositionRelativeToOrigin(const Rectangle& screen);
 
+	// Attached children follow this drawable. They are updated from update() and drawn
+	// right after their parent by drawAttachedChildren(). Only translation is inherited.
+	void attachChild(const DrawablePtr& child);
+	void detachChild(const DrawablePtr& child);
+	const std::vector<DrawablePtr>& attachedChildren() const { return m_attachedChildren; }
+	Drawable* parent() const { return m_parent; }
+	void drawAttachedChildren(const Rectangle& screen);
+
 	void addAction(const ActionPtr& action)
 	{
 		m_actions.push_back(action);
@@ -87,8 +111,14 @@ public:
 	}
 
 private:
+	void invalidateWorldPosition();
+
 	float m_rotation;
 	Point m_position;
+	mutable Point m_worldPosition;
+	mutable bool m_worldPositionDirty;
+	Drawable* m_parent;
+	std::vector<DrawablePtr> m_attachedChildren;
 	std::vector<ActionPtr> m_actions;
 	
 	positionChangedSignalT onPositionChanged;
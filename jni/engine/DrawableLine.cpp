@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #include "DrawableLine.hpp"
+#include "PrimitiveBatch.hpp"
+#include <algorithm>
 
 namespace engine
 {
@@ -26,33 +28,26 @@ namespace engine
 		setVertexes(lineVertexes);
 		setColor(1.0, 1.0, 1.0, 1.0);
 		
-		vertexNum = lineVertexes.size();
+		// setVertexes() keeps no more than 4.
+		vertexNum = std::min(lineVertexes.size(), size_t(4));
 	}
 	
 	// Draw a simple colored line
 	void DrawableLine::draw(const Rectangle& screen)
 	{
-		using namespace gl;
-
 		Point position = this->getPositionRelativeToOrigin(screen);
-
+		PrimitiveBatch& batch = PrimitiveBatch::shared();
+		for (int i = 1; i < vertexNum; ++i)
 		{
-			MatrixScope ms;
-			disableTexture2D();
-			//glEnable(GL_LINE_SMOOTH);
-			// Draw border.
-			gl::color(4, GL_FLOAT, 0, color);
-			vertex(2, GL_FLOAT, 0, vertexes);
-			translate(position.x(), position.y(), 0);
-			setGLLineWidth(width);
-			drawArrays(GL_LINE_STRIP, 0, vertexNum);
+			batch.line(Point(position.x() + vertexes[2 * i - 2], position.y() + vertexes[2 * i - 1]),
+				Point(position.x() + vertexes[2 * i], position.y() + vertexes[2 * i + 1]), width, color);
 		}
 	}
 
 	// Color component - from 0.0f to 1.0f.
 	void DrawableLine::setColor(float r, float g, float b, float a)
 	{
-		fillColorArray(color, 32, r, g, b, a);
+		fillColorArray(color, 4, r, g, b, a);
 	}
 	
 	void DrawableLine::setWidth(float lineWidth)
@@ -29,6 +29,7 @@ namespace engine
 		void setColor(float r, float g, float b, float a);
 		void setWidth(float width);
 		virtual void draw(const Rectangle& screen);
+		virtual bool batched() const { return true; }
 
 	private:
 		void fillColorArray(GLfloat* destColorArray, int destSize, float r, float g, float b, float a);
@@ -38,7 +39,7 @@ namespace engine
 		int vertexNum;
 		
 		GLfloat vertexes[8];
-		GLfloat color[32];
+		GLfloat color[4];
 
 	};
 
@@ -31,19 +31,16 @@ namespace engine
 		void setBorderColor(float r, float g, float b, float a);
 		void setBorderWidth(float width);
 		virtual void draw(const Rectangle& screen);
+		virtual bool batched() const { return true; }
 
 	private:
 		void fillColorArray(GLfloat* destColorArray, int destSize, float r, float g, float b, float a);
-		void setVertexes(GLfloat width, GLfloat height);
 
 		GLfloat barWidth;
 		GLfloat barHeight;
 
-		GLfloat vertexes[8];
-		GLfloat color[32];
-		
-		GLfloat borderVertexes[8];
-		GLfloat borderColor[32];
+		GLfloat color[4];
+		GLfloat borderColor[4];
 		GLfloat borderWidth;
 
 	};
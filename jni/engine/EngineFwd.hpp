@@ -33,6 +33,9 @@ namespace engine
 	class Resource;
 	typedef boost::intrusive_ptr<Resource> ResourcePtr;
 
+	class ResourceStream;
+	typedef boost::intrusive_ptr<ResourceStream> ResourceStreamPtr;
+
 	class Scene;
 	typedef boost::intrusive_ptr<Scene> ScenePtr;
 
@@ -76,6 +79,9 @@ namespace engine
 
 	class ProgressBar;
 	typedef boost::intrusive_ptr<ProgressBar> ProgressBarPtr;
+
+	class ProfilerOverlay;
+	typedef boost::intrusive_ptr<ProfilerOverlay> ProfilerOverlayPtr;
 	
 	class DrawableRectangle;
 	typedef boost::intrusive_ptr<DrawableRectangle> DrawableRectanglePtr;
@@ -85,6 +91,16 @@ namespace engine
 
     class Sound;
     typedef boost::intrusive_ptr<Sound> SoundPtr;
+
+	class SoundAsset;
+	typedef boost::intrusive_ptr<SoundAsset> SoundAssetPtr;
+
+	class SoundBank;
+
+	class StreamingSound;
+	typedef boost::intrusive_ptr<StreamingSound> StreamingSoundPtr;
+
+	class VoicePool;
 }
 
 #endif
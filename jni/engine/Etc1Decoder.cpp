@@ -0,0 +1,221 @@
+// Copyright 2011 Nuffer Brothers Software LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "Etc1Decoder.hpp"
+#include "Profiler.hpp"
+
+namespace engine
+{
+
+namespace Etc1Decoder
+{
+
+namespace
+{
+
+#if defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7))
+// GCC turns operations on these into SSE2 or NEON instructions where the target has
+// them, and into one int operation a lane where it doesn't.
+typedef int Lanes __attribute__((vector_size(16)));
+#else
+typedef int Lanes;
+#endif
+
+const unsigned LANE_COUNT = sizeof(Lanes) / sizeof(int);
+
+union LaneValues
+{
+	Lanes v;
+	int lane[LANE_COUNT];
+};
+
+inline Lanes splat(int value)
+{
+	LaneValues x;
+	for (unsigned i = 0; i < LANE_COUNT; ++i)
+		x.lane[i] = value;
+	return x.v;
+}
+
+// a where mask is 0, b where it is all ones.
+inline Lanes select(Lanes a, Lanes b, Lanes mask)
+{
+	return a ^ ((a ^ b) & mask);
+}
+
+inline Lanes clamp255(Lanes x, Lanes shift31, Lanes max)
+{
+	x &= ~(x >> shift31);
+	return (x | ((max - x) >> shift31)) & max;
+}
+
+// The small and large modifier of each table codeword.
+const int MODIFIERS[8][2] =
+{
+	{ 2, 8 }, { 5, 17 }, { 9, 29 }, { 13, 42 }, { 18, 60 }, { 24, 80 }, { 33, 106 }, { 47, 183 }
+};
+
+inline int extend4(int x)
+{
+	return (x << 4) | x;
+}
+
+inline int extend5(int x)
+{
+	return (x << 3) | (x >> 2);
+}
+
+// The 3 bit two's complement delta of differential mode.
+inline int delta3(int x)
+{
+	return (x ^ 4) - 4;
+}
+
+// Everything a block's pixels depend on, one block a lane. [0] and [1] are the two subblocks.
+struct Blocks
+{
+	LaneValues red[2];
+	LaneValues green[2];
+	LaneValues blue[2];
+	LaneValues small[2];
+	LaneValues large[2];
+	// All ones where the subblocks are on top of each other, 0 where side by side.
+	LaneValues flip;
+	// Bit x * 4 + y of each is that pixel's index bit.
+	LaneValues msbs;
+	LaneValues lsbs;
+
+	void set(unsigned lane, const unsigned char* block)
+	{
+		int base[2][3];
+		if (block[3] & 2)
+		{
+			for (int c = 0; c < 3; ++c)
+			{
+				int first = block[c] >> 3;
+				base[0][c] = extend5(first);
+				base[1][c] = extend5((first + delta3(block[c] & 7)) & 31);
+			}
+		}
+		else
+		{
+			for (int c = 0; c < 3; ++c)
+			{
+				base[0][c] = extend4(block[c] >> 4);
+				base[1][c] = extend4(block[c] & 15);
+			}
+		}
+		int tables[2] = { block[3] >> 5, (block[3] >> 2) & 7 };
+		for (int s = 0; s < 2; ++s)
+		{
+			red[s].lane[lane] = base[s][0];
+			green[s].lane[lane] = base[s][1];
+			blue[s].lane[lane] = base[s][2];
+			small[s].lane[lane] = MODIFIERS[tables[s]][0];
+			large[s].lane[lane] = MODIFIERS[tables[s]][1];
+		}
+		flip.lane[lane] = (block[3] & 1) ? -1 : 0;
+		msbs.lane[lane] = (block[4] << 8) | block[5];
+		lsbs.lane[lane] = (block[6] << 8) | block[7];
+	}
+};
+
+struct PackRGB565
+{
+	PackRGB565() : shift2(splat(2)), shift3(splat(3)), shift5(splat(5)), shift11(splat(11)) {}
+	Lanes operator()(Lanes r, Lanes g, Lanes b) const
+	{
+		return ((r >> shift3) << shift11) | ((g >> shift2) << shift5) | (b >> shift3);
+	}
+	Lanes shift2, shift3, shift5, shift11;
+};
+
+struct PackGreen
+{
+	Lanes operator()(Lanes r, Lanes g, Lanes b) const
+	{
+		return g;
+	}
+};
+
+template <typename Pixel, typename Pack>
+void decode(const unsigned char* blocks, unsigned width, unsigned height, Pixel* pixels, unsigned stride, const Pack& pack)
+{
+	const unsigned across = (width + 3) / 4;
+	const unsigned count = across * ((height + 3) / 4);
+	const Lanes one = splat(1);
+	const Lanes shift31 = splat(31);
+	const Lanes max = splat(255);
+
+	Blocks in;
+	for (unsigned first = 0; first < count; first += LANE_COUNT)
+	{
+		unsigned used = count - first < LANE_COUNT ? count - first : LANE_COUNT;
+		for (unsigned lane = 0; lane < used; ++lane)
+			in.set(lane, blocks + 8 * (first + lane));
+
+		for (unsigned x = 0; x < 4; ++x)
+		{
+			for (unsigned y = 0; y < 4; ++y)
+			{
+				// Which subblock the pixel is in, as a mask.
+				Lanes second = select(splat(x >= 2 ? -1 : 0), splat(y >= 2 ? -1 : 0), in.flip.v);
+				Lanes bit = splat(x * 4 + y);
+				Lanes large = -((in.lsbs.v >> bit) & one);
+				Lanes negative = -((in.msbs.v >> bit) & one);
+				Lanes modifier = select(select(in.small[0].v, in.small[1].v, second),
+					select(in.large[0].v, in.large[1].v, second), large);
+				modifier = (modifier ^ negative) - negative;
+
+				Lanes r = clamp255(select(in.red[0].v, in.red[1].v, second) + modifier, shift31, max);
+				Lanes g = clamp255(select(in.green[0].v, in.green[1].v, second) + modifier, shift31, max);
+				Lanes b = clamp255(select(in.blue[0].v, in.blue[1].v, second) + modifier, shift31, max);
+				LaneValues packed;
+				packed.v = pack(r, g, b);
+
+				for (unsigned lane = 0; lane < used; ++lane)
+				{
+					unsigned block = first + lane;
+					unsigned px = (block % across) * 4 + x;
+					unsigned py = (block / across) * 4 + y;
+					if (px < width && py < height)
+						pixels[py * stride + px] = Pixel(packed.lane[lane]);
+				}
+			}
+		}
+	}
+}
+
+}
+
+unsigned lanes()
+{
+	return LANE_COUNT;
+}
+
+void decodeImage(const unsigned char* blocks, unsigned width, unsigned height, GLushort* pixels, unsigned stride)
+{
+	PROFILE_ZONE("Etc1Decoder::decodeImage");
+	decode(blocks, width, height, pixels, stride, PackRGB565());
+}
+
+void decodeGreen(const unsigned char* blocks, unsigned width, unsigned height, GLubyte* pixels, unsigned stride)
+{
+	PROFILE_ZONE("Etc1Decoder::decodeGreen");
+	decode(blocks, width, height, pixels, stride, PackGreen());
+}
+
+}
+
+}
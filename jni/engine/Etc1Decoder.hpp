@@ -0,0 +1,47 @@
+// Copyright 2011 Nuffer Brothers Software LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef engine_Etc1Decoder_HPP_INCLUDED
+#define engine_Etc1Decoder_HPP_INCLUDED
+
+#include "EngineConfig.hpp"
+#include "GL.hpp"
+
+namespace engine
+{
+
+/**
+ * Decodes ETC1 for contexts that can't, see gl::State::etc1. Several 4x4 blocks are
+ * decoded at once, one to a lane of a vector register where the compiler has them
+ * (SSE2, NEON), so a whole atlas decodes quickly enough to do at load time.
+ */
+namespace Etc1Decoder
+{
+
+// How many blocks are decoded together.
+unsigned lanes();
+
+// blocks is the PKM data after its header: 8 bytes a block, left to right and then
+// top to bottom, ((width + 3) / 4) * ((height + 3) / 4) of them. Writes width x height
+// RGB565 pixels, stride pixels from the start of one row to the next.
+void decodeImage(const unsigned char* blocks, unsigned width, unsigned height, GLushort* pixels, unsigned stride);
+
+// The same, but only the green of each pixel, a byte each. Alpha planes are encoded gray.
+void decodeGreen(const unsigned char* blocks, unsigned width, unsigned height, GLubyte* pixels, unsigned stride);
+
+}
+
+}
+
+#endif
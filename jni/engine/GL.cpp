@@ -17,6 +17,7 @@
 #include "GL.hpp"
 #include "GLMock.hpp"
 #include "Log.hpp"
+#include <stdio.h>
 
 
 namespace engine
@@ -24,9 +25,92 @@ namespace engine
 
 namespace gl
 {
+State state;
+
+void invalidateState()
+{
+	State fresh;
+	fresh.buffers = state.buffers;
+	fresh.etc1 = state.etc1;
+	fresh.combiners = state.combiners;
+	fresh.context = state.context;
+	state = fresh;
+}
+
+namespace
+{
+	// Whether GL_VERSION is at least OpenGL ES 1.esMinor, or OpenGL 1.minor on the desktop.
+	bool versionAtLeast(int esMinor, int desktopMinor)
+	{
+		// "OpenGL ES-CM 1.1", or a desktop "2.1 ..."
+		std::string version = getVersion();
+		size_t digit = version.find_first_of("0123456789");
+		int major = 0;
+		int minor = 0;
+		if (digit == std::string::npos || sscanf(version.c_str() + digit, "%d.%d", &major, &minor) != 2)
+			return false;
+		bool es = version.find("OpenGL ES") != std::string::npos;
+		return major > 1 || minor >= (es ? esMinor : desktopMinor);
+	}
+}
+
+bool supportsBuffers()
+{
+	return versionAtLeast(1, 5);
+}
+
+bool supportsCombiners()
+{
+	return versionAtLeast(1, 3);
+}
+
+bool supportsEtc1()
+{
+#ifdef GL_ETC1_RGB8_OES
+	return getExtensions().find("GL_OES_compressed_ETC1_RGB8_texture") != std::string::npos;
+#else
+	return false;
+#endif
+}
+
+namespace
+{
+	// What bindAlphaTexture2D() draws with: the color the first unit made, with its
+	// alpha times the second unit's texture.
+	void setAlphaCombiner()
+	{
+		glActiveTexture(GL_TEXTURE1);
+		glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_COMBINE);
+		glTexEnvi(GL_TEXTURE_ENV, GL_COMBINE_RGB, GL_REPLACE);
+		glTexEnvi(GL_TEXTURE_ENV, GL_SRC0_RGB, GL_PREVIOUS);
+		glTexEnvi(GL_TEXTURE_ENV, GL_OPERAND0_RGB, GL_SRC_COLOR);
+		glTexEnvi(GL_TEXTURE_ENV, GL_COMBINE_ALPHA, GL_MODULATE);
+		glTexEnvi(GL_TEXTURE_ENV, GL_SRC0_ALPHA, GL_PREVIOUS);
+		glTexEnvi(GL_TEXTURE_ENV, GL_OPERAND0_ALPHA, GL_SRC_ALPHA);
+		glTexEnvi(GL_TEXTURE_ENV, GL_SRC1_ALPHA, GL_TEXTURE);
+		glTexEnvi(GL_TEXTURE_ENV, GL_OPERAND1_ALPHA, GL_SRC_ALPHA);
+		glActiveTexture(GL_TEXTURE0);
+		checkCall("setAlphaCombiner");
+	}
+}
+
+void beginContext()
+{
+	invalidateState();
+	state.buffers = supportsBuffers();
+	state.etc1 = supportsEtc1();
+	state.combiners = supportsCombiners();
+	if (state.combiners && !currentMock())
+		setAlphaCombiner();
+	++state.context;
+	LOGD("GL buffer objects %s", state.buffers ? "supported" : "not supported, using client arrays");
+	LOGD("ETC1 textures %s", state.etc1 ? "supported" : "not supported, decoding them to RGB565");
+	LOGD("Alpha planes %s", state.combiners ? "drawn with combiners" : "merged into RGBA4444");
+}
+
 const char* glStrError(GLint error)
 {
-	if(glMock) { return glMock->glStrError(error); }
+	if(GLMock* mock = currentMock()) { return mock->glStrError(error); }
 	
 	switch (error)
 	{
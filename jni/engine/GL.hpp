@@ -32,6 +32,7 @@
 #endif
 #include <stdlib.h>
 #include <string>
+#include <utility>
 
 namespace engine
 {
@@ -41,131 +42,373 @@ namespace gl
 
 const GLuint INVALID_TEXTURE = 0;
 
+// Where the calling thread's calls go instead of GL, if anywhere.
+inline GLMock* currentMock()
+{
+	if (threadRecorders)
+	{
+		if (GLMock* recorder = threadRecorder())
+			return recorder;
+	}
+	return glMock;
+}
+
+// Whether the calling thread records what it draws, see RenderRecorder. Vertex data has to
+// be in client memory then, and nothing can be made in GL.
+inline bool recording()
+{
+	return threadRecorders && threadRecorder();
+}
+
 const char* glStrError(GLint error);
 
+// Aborts if GL has flagged an error since the last check. glGetError() stalls the
+// pipeline, so it only checks in debug builds, and the Director only once a frame.
 inline void checkGLError(const char* op)
 {
-	// because calling into the graphics chip an extra two times can be slow, only do this if running in debug mode.
 #ifdef DEBUG
-	if(glMock) { glMock->checkGLError(op); return; }
-    GLint error = glGetError();
-    if (error)
-    {
-        LOGI("GL ERROR! after %s glError (%d: %s)\n", op, error, glStrError(error));
-    	abort();
-    }
+	if(GLMock* mock = currentMock()) { mock->checkGLError(op); return; }
+	GLint error = glGetError();
+	if (error)
+	{
+		// GL may have flagged more than one.
+		for (; error; error = glGetError())
+		{
+			LOGI("GL ERROR! after %s glError (%d: %s)\n", op, error, glStrError(error));
+		}
+		abort();
+	}
+#endif
+}
+
+// The wrappers' check. Define GL_CHECK_EACH_CALL in a debug build to find the call an
+// error comes from rather than just its frame.
+inline void checkCall(const char* op)
+{
+#if defined(DEBUG) && defined(GL_CHECK_EACH_CALL)
+	checkGLError(op);
 #endif
 }
 
+// The pointer of a client array, as glVertexPointer() and the like take it. With a
+// buffer, pointer is an offset into it.
+struct ArrayPointer
+{
+	ArrayPointer() : size(0), type(0), stride(0), pointer(NULL), buffer(0) {}
+	ArrayPointer(GLint size, GLenum type, GLsizei stride, const GLvoid* pointer, GLuint buffer = 0)
+		: size(size), type(type), stride(stride), pointer(pointer), buffer(buffer) {}
+
+	bool operator==(const ArrayPointer& x) const
+	{
+		return pointer == x.pointer && buffer == x.buffer && size == x.size && type == x.type && stride == x.stride;
+	}
+
+	GLint size;
+	GLenum type;
+	GLsizei stride;
+	const GLvoid* pointer;
+	GLuint buffer;
+};
+
+// A piece of GL state as it was last set, or unknown.
+template <typename T>
+class Cached
+{
+public:
+	Cached() : current(), known(false) {}
+
+	// Records value, and returns whether GL has to be told.
+	bool change(const T& value)
+	{
+		if (known && current == value)
+			return false;
+		current = value;
+		known = true;
+		return true;
+	}
+	void forget() { known = false; }
+	// Whether GL is known to have value.
+	bool is(const T& value) const { return known && current == value; }
+
+private:
+	T current;
+	bool known;
+};
+
+// What the wrappers last told GL, so they can leave out the calls that wouldn't change
+// anything. Only the GL thread draws, so nothing locks it. The mock sees every call.
+struct State
+{
+	State() : buffers(false), etc1(false), combiners(false), context(0) {}
+
+	Cached<GLuint> texture;
+	// On the second texture unit, see bindAlphaTexture2D().
+	Cached<GLuint> alphaTexture;
+	Cached<ArrayPointer> alphaTexCoordPointer;
+	Cached<bool> texture2D;
+	Cached<bool> blend;
+	Cached<std::pair<GLenum, GLenum> > blendFunc;
+	Cached<bool> vertexArray;
+	Cached<bool> colorArray;
+	Cached<bool> texCoordArray;
+	Cached<ArrayPointer> vertexPointer;
+	Cached<ArrayPointer> colorPointer;
+	Cached<ArrayPointer> texCoordPointer;
+	Cached<GLfloat> lineWidth;
+	Cached<GLuint> arrayBuffer;
+
+	// Whether the context has buffer objects. Without them nothing binds one, and
+	// vertex data stays in client memory.
+	bool buffers;
+	// Whether the context takes ETC1 textures. Without it they are decoded to RGB565.
+	bool etc1;
+	// Whether the context has a second texture unit and GL_COMBINE, for alpha planes.
+	bool combiners;
+	// Counts the contexts, a buffer object made in an earlier one is gone.
+	unsigned context;
+};
+
+extern State state;
+
+// Forgets the state the wrappers set, after GL calls that bypassed them.
+void invalidateState();
+
+// Whether GL_VERSION has buffer objects: core since OpenGL ES 1.1 and OpenGL 1.5.
+bool supportsBuffers();
+
+// Whether GL_VERSION has two texture units and GL_COMBINE: OpenGL ES 1.1 and OpenGL 1.3.
+bool supportsCombiners();
+
+// Whether GL_EXTENSIONS has GL_OES_compressed_ETC1_RGB8_texture, and the headers GL_ETC1_RGB8_OES.
+bool supportsEtc1();
+
+// With a new context current: forgets state, and finds out what the context has.
+void beginContext();
+
+inline void setCapability(Cached<bool>& cached, GLenum capability, bool enabled)
+{
+	if (!cached.change(enabled))
+		return;
+	if (enabled)
+		glEnable(capability);
+	else
+		glDisable(capability);
+	checkCall(enabled ? "glEnable" : "glDisable");
+}
+
+inline void setClientState(Cached<bool>& cached, GLenum array, bool enabled)
+{
+	if (!cached.change(enabled))
+		return;
+	if (enabled)
+		glEnableClientState(array);
+	else
+		glDisableClientState(array);
+	checkCall(enabled ? "glEnableClientState" : "glDisableClientState");
+}
+
 inline void setGLLineWidth(GLfloat width)
 {
-	if(glMock) { glMock->setGLLineWidth(width); return; }
+	if(GLMock* mock = currentMock()) { mock->setGLLineWidth(width); return; }
+	if (!state.lineWidth.change(width)) return;
 	glLineWidth(width);
 }
 
 inline void clearColorBuffer()
 {
-	if(glMock) { glMock->clearColorBuffer(); return; }
+	if(GLMock* mock = currentMock()) { mock->clearColorBuffer(); return; }
 	glClear(GL_COLOR_BUFFER_BIT);
-	checkGLError("glClear(GL_COLOR_BUFFER_BIT)");
+	checkCall("glClear(GL_COLOR_BUFFER_BIT)");
 }
 
 inline void clearDepthBuffer()
 {
-	if(glMock) { glMock->clearDepthBuffer(); return; }
+	if(GLMock* mock = currentMock()) { mock->clearDepthBuffer(); return; }
 	glClear(GL_DEPTH_BUFFER_BIT);
-	checkGLError("glClear(GL_DEPTH_BUFFER_BIT)");
+	checkCall("glClear(GL_DEPTH_BUFFER_BIT)");
 }
 
 inline void clearColorAndDepthBuffer()
 {
-	if(glMock) { glMock->clearColorAndDepthBuffer(); return; }
+	if(GLMock* mock = currentMock()) { mock->clearColorAndDepthBuffer(); return; }
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-	checkGLError("glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT)");
+	checkCall("glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT)");
 }
 
 inline void loadIdentity()
 {
-	if(glMock) { glMock->loadIdentity(); return; }
+	if(GLMock* mock = currentMock()) { mock->loadIdentity(); return; }
 	glLoadIdentity();
-	checkGLError("glLoadIdentity()");
+	checkCall("glLoadIdentity()");
 }
 
 inline void translate(GLfloat x, GLfloat y, GLfloat z)
 {
-	if(glMock) { glMock->translate(x,y,z); return; }
+	if(GLMock* mock = currentMock()) { mock->translate(x,y,z); return; }
 	glTranslatef(x, y, z);
-	checkGLError("glTranslatef");
+	checkCall("glTranslatef");
 }
 
 inline void rotate(GLfloat angle, GLfloat x, GLfloat y, GLfloat z)
 {
-	if(glMock) { glMock->rotate(angle,x,y,z); return; }
+	if(GLMock* mock = currentMock()) { mock->rotate(angle,x,y,z); return; }
 	glRotatef(angle, x, y, z);
-	checkGLError("glRotatef");
+	checkCall("glRotatef");
 }
 
 inline void scale(GLfloat x, GLfloat y, GLfloat z)
 {
-	if(glMock) { glMock->scale(x,y,z); return; }
+	if(GLMock* mock = currentMock()) { mock->scale(x,y,z); return; }
 	glScalef(x, y, z);
-	checkGLError("glScalef");
+	checkCall("glScalef");
 }
 
-inline void vertex(GLint size, GLenum type, GLsizei stride, const GLvoid* pointer)
+inline void bindArrayBuffer(GLuint buffer)
 {
-	if(glMock) { glMock->vertex(size,type,stride,pointer); return; }
+	if(GLMock* mock = currentMock()) { mock->bindArrayBuffer(buffer); return; }
+	if (!state.buffers || !state.arrayBuffer.change(buffer)) return;
+	glBindBuffer(GL_ARRAY_BUFFER, buffer);
+	checkCall("glBindBuffer(GL_ARRAY_BUFFER, buffer)");
+}
+
+// buffer is what pointer is an offset into, 0 for client memory.
+inline void vertex(GLint size, GLenum type, GLsizei stride, const GLvoid* pointer, GLuint buffer = 0)
+{
+	if(GLMock* mock = currentMock()) { mock->vertex(size,type,stride,pointer); return; }
+	if (!state.vertexPointer.change(ArrayPointer(size, type, stride, pointer, buffer))) return;
+	bindArrayBuffer(buffer);
 	glVertexPointer(size, type, stride, pointer);
-	checkGLError("glVertexPointer");
+	checkCall("glVertexPointer");
 }
 
-inline void color(GLint size, GLenum type, GLsizei stride, const GLvoid* pointer)
+inline void color(GLint size, GLenum type, GLsizei stride, const GLvoid* pointer, GLuint buffer = 0)
 {
-	if(glMock) { glMock->color(size,type,stride,pointer); return; }
+	if(GLMock* mock = currentMock()) { mock->color(size,type,stride,pointer); return; }
+	if (!state.colorPointer.change(ArrayPointer(size, type, stride, pointer, buffer))) return;
+	bindArrayBuffer(buffer);
 	glColorPointer(size, type, stride, pointer);
-	checkGLError("glColorPointer");
+	checkCall("glColorPointer");
 }
 
 inline void enableTexture2D()
 {
-	if(glMock) { glMock->enableTexture2D(); return; }
-	glEnable(GL_TEXTURE_2D);
-	checkGLError("glEnable(GL_TEXTURE_2D)");
+	if(GLMock* mock = currentMock()) { mock->enableTexture2D(); return; }
+	setCapability(state.texture2D, GL_TEXTURE_2D, true);
+}
+
+// Where texturing is on, what is drawn takes its alpha from texture, a GL_ALPHA texture
+// on the second texture unit, at the same coordinates as the first. So a color texture
+// without alpha, an ETC1 one, can draw translucent. INVALID_TEXTURE turns it off, and so
+// does disableTexture2D(). Needs state.combiners.
+inline void bindAlphaTexture2D(GLuint texture)
+{
+	if(GLMock* mock = currentMock()) { mock->bindAlphaTexture2D(texture); return; }
+	// A context with one texture unit has no GL_TEXTURE1 to turn on or off.
+	if (!state.combiners) return;
+	if (!state.alphaTexture.change(texture)) return;
+	glActiveTexture(GL_TEXTURE1);
+	glClientActiveTexture(GL_TEXTURE1);
+	if (texture != INVALID_TEXTURE)
+	{
+		// beginContext() set up its combiner.
+		glEnable(GL_TEXTURE_2D);
+		glBindTexture(GL_TEXTURE_2D, texture);
+		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+	}
+	else
+	{
+		glDisable(GL_TEXTURE_2D);
+		glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+	}
+	// texCoord() sets them again when there is a texture.
+	state.alphaTexCoordPointer.forget();
+	glActiveTexture(GL_TEXTURE0);
+	glClientActiveTexture(GL_TEXTURE0);
+	checkCall("bindAlphaTexture2D");
 }
 
+// Turns off the alpha texture too.
 inline void disableTexture2D()
 {
-	if(glMock) { glMock->disableTexture2D(); return; }
-	glDisable(GL_TEXTURE_2D);
-	checkGLError("glDisable(GL_TEXTURE_2D)");
+	if(GLMock* mock = currentMock()) { mock->disableTexture2D(); return; }
+	setCapability(state.texture2D, GL_TEXTURE_2D, false);
+	if (state.combiners && !state.alphaTexture.is(INVALID_TEXTURE))
+		bindAlphaTexture2D(INVALID_TEXTURE);
 }
 
-inline void texCoord(GLint size, GLenum type, GLsizei stride, const GLvoid* pointer)
+// Also the alpha texture's coordinates while there is one.
+inline void texCoord(GLint size, GLenum type, GLsizei stride, const GLvoid* pointer, GLuint buffer = 0)
 {
-	if(glMock) { glMock->texCoord(size,type,stride,pointer); return; }
-	glTexCoordPointer(size, type, stride, pointer);
-	checkGLError("glTexCoordPointer");
+	if(GLMock* mock = currentMock()) { mock->texCoord(size,type,stride,pointer); return; }
+	ArrayPointer coords(size, type, stride, pointer, buffer);
+	if (state.texCoordPointer.change(coords))
+	{
+		bindArrayBuffer(buffer);
+		glTexCoordPointer(size, type, stride, pointer);
+		checkCall("glTexCoordPointer");
+	}
+	if (state.combiners && !state.alphaTexture.is(INVALID_TEXTURE) && state.alphaTexCoordPointer.change(coords))
+	{
+		bindArrayBuffer(buffer);
+		glClientActiveTexture(GL_TEXTURE1);
+		glTexCoordPointer(size, type, stride, pointer);
+		glClientActiveTexture(GL_TEXTURE0);
+		checkCall("glTexCoordPointer");
+	}
 }
 
 inline void drawArrays(GLenum mode, GLint first, GLsizei count)
 {
-	if(glMock) { glMock->drawArrays(mode,first,count); return; }
+	if(GLMock* mock = currentMock()) { mock->drawArrays(mode,first,count); return; }
 	glDrawArrays(mode, first, count);
-	checkGLError("glDrawArrays");
+	checkCall("glDrawArrays");
 }
 
 inline GLuint genTexture()
 {
-	if(glMock) { return glMock->genTexture(); }
+	if(GLMock* mock = currentMock()) { return mock->genTexture(); }
 	GLuint texture;
 	glGenTextures(1, &texture);
-	checkGLError("glGenTextures");
+	checkCall("glGenTextures");
 	return texture;
 }
 
+inline GLuint genBuffer()
+{
+	if(GLMock* mock = currentMock()) { return mock->genBuffer(); }
+	GLuint buffer;
+	glGenBuffers(1, &buffer);
+	checkCall("glGenBuffers");
+	return buffer;
+}
+
+inline void deleteBuffers(GLsizei n, const GLuint* buffers)
+{
+	if(GLMock* mock = currentMock()) { mock->deleteBuffers(n,buffers); return; }
+	glDeleteBuffers(n, buffers);
+	checkCall("glDeleteBuffers");
+	// Deleting the bound buffer binds 0, the pointers into it are unchanged.
+	state.arrayBuffer.forget();
+}
+
+// To the bound array buffer.
+inline void bufferData(GLsizeiptr size, const GLvoid* data, GLenum usage)
+{
+	if(GLMock* mock = currentMock()) { mock->bufferData(size,data,usage); return; }
+	glBufferData(GL_ARRAY_BUFFER, size, data, usage);
+	checkCall("glBufferData(GL_ARRAY_BUFFER, size, data, usage)");
+}
+
+inline void bufferSubData(GLintptr offset, GLsizeiptr size, const GLvoid* data)
+{
+	if(GLMock* mock = currentMock()) { mock->bufferSubData(offset,size,data); return; }
+	glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
+	checkCall("glBufferSubData(GL_ARRAY_BUFFER, offset, size, data)");
+}
+
 inline std::string getString(GLenum name)
 {
-	if(glMock) { return glMock->getString(name); }
+	if(GLMock* mock = currentMock()) { return mock->getString(name); }
 	const GLubyte* junk = glGetString(name);
 	if( junk )
 	{
@@ -176,109 +419,158 @@ inline std::string getString(GLenum name)
 
 inline std::string getVendor()
 {
-	if(glMock) { return glMock->getVendor(); }
+	if(GLMock* mock = currentMock()) { return mock->getVendor(); }
 	std::string text = getString(GL_VENDOR);
-	checkGLError("glGetString(GL_VENDOR)");
+	checkCall("glGetString(GL_VENDOR)");
 	return text;
 }
 inline std::string getRenderer()
 {
-	if(glMock) { return glMock->getRenderer(); }
+	if(GLMock* mock = currentMock()) { return mock->getRenderer(); }
 	std::string text = getString(GL_RENDERER);
-	checkGLError("glGetString(GL_RENDERER)");
+	checkCall("glGetString(GL_RENDERER)");
 	return text;
 }
 inline std::string getVersion()
 {
-	if(glMock) { return glMock->getVersion(); }
+	if(GLMock* mock = currentMock()) { return mock->getVersion(); }
 	std::string text = getString(GL_VERSION);
-	checkGLError("glGetString(GL_VERSION)");
+	checkCall("glGetString(GL_VERSION)");
 	return text;
 }
 inline std::string getExtensions()
 {
-	if(glMock) { return glMock->getExtensions(); }
+	if(GLMock* mock = currentMock()) { return mock->getExtensions(); }
 	std::string text = getString(GL_EXTENSIONS);
-	checkGLError("glGetString(GL_EXTENSIONS)");
+	checkCall("glGetString(GL_EXTENSIONS)");
 	return text;
 }
 
 inline void bindTexture2D(GLuint texture)
 {
-	if(glMock) { glMock->bindTexture2D(texture); return; }
+	if(GLMock* mock = currentMock()) { mock->bindTexture2D(texture); return; }
+	if (!state.texture.change(texture)) return;
 	glBindTexture(GL_TEXTURE_2D, texture);
-	checkGLError("glBindTexture(GL_TEXTURE_2D, texture)");
+	checkCall("glBindTexture(GL_TEXTURE_2D, texture)");
 }
 
 inline void deleteTextures(GLsizei n, const GLuint *textures)
 {
-	if(glMock) { glMock->deleteTextures(n,textures); return; }
+	if(GLMock* mock = currentMock()) { mock->deleteTextures(n,textures); return; }
 	glDeleteTextures(n, textures);
-	checkGLError("glDeleteTextures");
+	checkCall("glDeleteTextures");
+	// Deleting the bound texture binds 0, but there is no telling whether it was.
+	state.texture.forget();
 }
 
 inline void texImage2D(GLsizei width, GLsizei height, GLvoid* imageData)
 {
-	if(glMock) { glMock->texImage2D(width,height,imageData); return; }
+	if(GLMock* mock = currentMock()) { mock->texImage2D(width,height,imageData); return; }
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, (GLvoid*) imageData);
-	checkGLError("glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, (GLvoid*) imageData)");
+	checkCall("glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, (GLvoid*) imageData)");
+}
+
+// Pixels packed some other way, such as GL_RGB and GL_UNSIGNED_SHORT_5_6_5.
+inline void texImage2D(GLenum format, GLenum type, GLsizei width, GLsizei height, const GLvoid* imageData)
+{
+	if(GLMock* mock = currentMock()) { mock->texImage2D(format,type,width,height,imageData); return; }
+	glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, type, imageData);
+	checkCall("glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, type, imageData)");
 }
 
 inline void texParameter(GLenum pname, GLint param)
 {
-	if(glMock) { glMock->texParameter(pname,param); return; }
+	if(GLMock* mock = currentMock()) { mock->texParameter(pname,param); return; }
 	glTexParameteri(GL_TEXTURE_2D, pname, param);
-	checkGLError("glTexParameteri(GL_TEXTURE_2D, pname, param)");
+	checkCall("glTexParameteri(GL_TEXTURE_2D, pname, param)");
 }
 
 inline void compressedTexImage2D(GLenum internalFormat, GLsizei width, GLsizei height, GLsizei imageSize, const GLvoid* data)
 {
-	if(glMock) { glMock->compressedTexImage2D(internalFormat,width,height,imageSize,data); return; }
+	if(GLMock* mock = currentMock()) { mock->compressedTexImage2D(internalFormat,width,height,imageSize,data); return; }
 	glCompressedTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, imageSize, data);
-	checkGLError("glCompressedTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, imageSize, data)");
+	checkCall("glCompressedTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, imageSize, data)");
 }
 	
 	inline void matrixMode(GLenum mode)
 	{
-		if(glMock) { glMock->matrixMode(mode); return; }
+		if(GLMock* mock = currentMock()) { mock->matrixMode(mode); return; }
 		glMatrixMode(mode);
-		checkGLError("glMatrixMode");
+		checkCall("glMatrixMode");
 	}
 	
 	inline void ortho(GLfloat left, GLfloat right, GLfloat bottom, GLfloat top, GLfloat zNear, GLfloat zFar)
 	{
-		if(glMock) { glMock->ortho(left,right,bottom,top,zNear,zFar); return; }
+		if(GLMock* mock = currentMock()) { mock->ortho(left,right,bottom,top,zNear,zFar); return; }
 #ifdef GL_VERSION_ES_CM_1_0
 		glOrthof(left, right, bottom, top, zNear, zFar);
 #else
 		glOrtho(left, right, bottom, top, zNear, zFar);
 #endif
-		checkGLError("glOrthof");
+		checkCall("glOrthof");
 	}
 	
 	inline void multMatrix(const GLfloat* m)
 	{
-		if(glMock) { glMock->multMatrix(m); return; }
+		if(GLMock* mock = currentMock()) { mock->multMatrix(m); return; }
 		glMultMatrixf(m);
-		checkGLError("glMultMatrixf");
+		checkCall("glMultMatrixf");
 	}
 
+inline void enableBlend()
+{
+	if(GLMock* mock = currentMock()) { mock->enableBlend(); return; }
+	setCapability(state.blend, GL_BLEND, true);
+}
+
+inline void disableBlend()
+{
+	if(GLMock* mock = currentMock()) { mock->disableBlend(); return; }
+	setCapability(state.blend, GL_BLEND, false);
+}
+
+inline void blendFunc(GLenum sfactor, GLenum dfactor)
+{
+	if(GLMock* mock = currentMock()) { mock->blendFunc(sfactor,dfactor); return; }
+	if (!state.blendFunc.change(std::make_pair(sfactor, dfactor))) return;
+	glBlendFunc(sfactor, dfactor);
+	checkCall("glBlendFunc");
+}
+
 class MatrixScope
 {
 public:
 	MatrixScope()
 	{
-		if(glMock) { glMock->MatrixScope(); return; }
+		if(GLMock* mock = currentMock()) { mock->MatrixScope(); return; }
 		glPushMatrix();
-		checkGLError("glPushMatrix()");
+		checkCall("glPushMatrix()");
 		glLoadIdentity();
-		checkGLError("glLoadIdentity()");
+		checkCall("glLoadIdentity()");
 	}
 	~MatrixScope()
 	{
-		if(glMock) { glMock->DestMatrixScope(); return; }
+		if(GLMock* mock = currentMock()) { mock->DestMatrixScope(); return; }
 		glPopMatrix();
-		checkGLError("glPopMatrix()");
+		checkCall("glPopMatrix()");
+	}
+};
+
+// Keeps the current matrix to build on, where MatrixScope starts over from the identity.
+class PushMatrixScope
+{
+public:
+	PushMatrixScope()
+	{
+		if(GLMock* mock = currentMock()) { mock->PushMatrixScope(); return; }
+		glPushMatrix();
+		checkCall("glPushMatrix()");
+	}
+	~PushMatrixScope()
+	{
+		if(GLMock* mock = currentMock()) { mock->DestPushMatrixScope(); return; }
+		glPopMatrix();
+		checkCall("glPopMatrix()");
 	}
 };
 
@@ -287,13 +579,13 @@ class ColorArrayScope
 public:
 	ColorArrayScope()
 	{
-		if(glMock) { glMock->ColorArrayScope(); return; }
-		glEnableClientState(GL_COLOR_ARRAY);
+		if(GLMock* mock = currentMock()) { mock->ColorArrayScope(); return; }
+		setClientState(state.colorArray, GL_COLOR_ARRAY, true);
 	}
 	~ColorArrayScope()
 	{
-		if(glMock) { glMock->DestColorArrayScope(); return; }
-		glDisableClientState(GL_COLOR_ARRAY);
+		if(GLMock* mock = currentMock()) { mock->DestColorArrayScope(); return; }
+		setClientState(state.colorArray, GL_COLOR_ARRAY, false);
 	}
 };
 
@@ -302,13 +594,13 @@ class CullFaceScope
 public:
 	CullFaceScope(GLenum mode)
 	{
-		if(glMock) { glMock->CullFaceScope(mode); return; }
+		if(GLMock* mock = currentMock()) { mock->CullFaceScope(mode); return; }
 		glEnable(GL_CULL_FACE);
 		glCullFace(mode);
 	}
 	~CullFaceScope()
 	{
-		if(glMock) { glMock->DestCullFaceScope(); return; }
+		if(GLMock* mock = currentMock()) { mock->DestCullFaceScope(); return; }
 		glDisable(GL_CULL_FACE);
 	}
 };
@@ -318,13 +610,13 @@ class VertexArrayScope
 public:
 	VertexArrayScope()
 	{
-		if(glMock) { glMock->VertexArrayScope(); return; }
-		glEnableClientState(GL_VERTEX_ARRAY);
+		if(GLMock* mock = currentMock()) { mock->VertexArrayScope(); return; }
+		setClientState(state.vertexArray, GL_VERTEX_ARRAY, true);
 	}
 	~VertexArrayScope()
 	{
-		if(glMock) { glMock->DestVertexArrayScope(); return; }
-		glDisableClientState(GL_VERTEX_ARRAY);
+		if(GLMock* mock = currentMock()) { mock->DestVertexArrayScope(); return; }
+		setClientState(state.vertexArray, GL_VERTEX_ARRAY, false);
 	}
 };
 
@@ -333,13 +625,13 @@ class TextureCoordArrayScope
 public:
 	TextureCoordArrayScope()
 	{
-		if(glMock) { glMock->TextureCoordArrayScope(); return; }
-		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+		if(GLMock* mock = currentMock()) { mock->TextureCoordArrayScope(); return; }
+		setClientState(state.texCoordArray, GL_TEXTURE_COORD_ARRAY, true);
 	}
 	~TextureCoordArrayScope()
 	{
-		if(glMock) { glMock->DestTextureCoordArrayScope(); return; }
-		glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+		if(GLMock* mock = currentMock()) { mock->DestTextureCoordArrayScope(); return; }
+		setClientState(state.texCoordArray, GL_TEXTURE_COORD_ARRAY, false);
 	}
 };
 
@@ -348,12 +640,12 @@ class Texture2DScope
 public:
 	Texture2DScope()
 	{
-		if(glMock) { glMock->Texture2DScope(); return; }
+		if(GLMock* mock = currentMock()) { mock->Texture2DScope(); return; }
 		enableTexture2D();
 	}
 	~Texture2DScope()
 	{
-		if(glMock) { glMock->DestTexture2DScope(); return; }
+		if(GLMock* mock = currentMock()) { mock->DestTexture2DScope(); return; }
 		disableTexture2D();
 	}
 };
@@ -1,7 +1,37 @@
 #include "GLMock.hpp"
+#include <pthread.h>
 
 namespace engine {
 	namespace gl {
 		GLMock* glMock;
+		volatile unsigned threadRecorders;
+
+		namespace
+		{
+			pthread_once_t keyOnce = PTHREAD_ONCE_INIT;
+			pthread_key_t recorderKey;
+
+			void createKey()
+			{
+				pthread_key_create(&recorderKey, NULL);
+			}
+		}
+
+		void setThreadRecorder(GLMock* recorder)
+		{
+			pthread_once(&keyOnce, createKey);
+			GLMock* old = static_cast<GLMock*>(pthread_getspecific(recorderKey));
+			pthread_setspecific(recorderKey, recorder);
+			if (recorder && !old)
+				__sync_add_and_fetch(&threadRecorders, 1);
+			else if (!recorder && old)
+				__sync_sub_and_fetch(&threadRecorders, 1);
+		}
+
+		GLMock* threadRecorder()
+		{
+			pthread_once(&keyOnce, createKey);
+			return static_cast<GLMock*>(pthread_getspecific(recorderKey));
+		}
 	}
-}
\ No newline at end of file
+}
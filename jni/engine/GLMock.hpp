@@ -52,15 +52,27 @@ namespace engine
 			virtual std::string getVersion() = 0;
 			virtual std::string getExtensions() = 0;
 			virtual void bindTexture2D(GLuint texture) = 0;
+			virtual void bindAlphaTexture2D(GLuint texture) = 0;
 			virtual void deleteTextures(GLsizei n, const GLuint *textures) = 0;
 			virtual void texImage2D(GLsizei width, GLsizei height, GLvoid* imageData) = 0;
+			virtual void texImage2D(GLenum format, GLenum type, GLsizei width, GLsizei height, const GLvoid* imageData) = 0;
 			virtual void texParameter(GLenum pname, GLint param) = 0;
 			virtual void compressedTexImage2D(GLenum internalFormat, GLsizei width, GLsizei height, GLsizei imageSize, const GLvoid* data) = 0;
 			virtual void matrixMode(GLenum mode) = 0;
 			virtual void ortho(GLfloat left, GLfloat right, GLfloat bottom, GLfloat top, GLfloat zNear, GLfloat zFar) = 0;
 			virtual void multMatrix(const GLfloat* m) = 0;
+			virtual void enableBlend() = 0;
+			virtual void disableBlend() = 0;
+			virtual void blendFunc(GLenum sfactor, GLenum dfactor) = 0;
+			virtual GLuint genBuffer() = 0;
+			virtual void deleteBuffers(GLsizei n, const GLuint* buffers) = 0;
+			virtual void bindArrayBuffer(GLuint buffer) = 0;
+			virtual void bufferData(GLsizeiptr size, const GLvoid* data, GLenum usage) = 0;
+			virtual void bufferSubData(GLintptr offset, GLsizeiptr size, const GLvoid* data) = 0;
 			virtual void MatrixScope() = 0;
 			virtual void DestMatrixScope() = 0;
+			virtual void PushMatrixScope() = 0;
+			virtual void DestPushMatrixScope() = 0;
 			virtual void ColorArrayScope() = 0;
 			virtual void DestColorArrayScope() = 0;
 			virtual void CullFaceScope(GLenum mode) = 0;
@@ -76,6 +88,13 @@ namespace engine
 		typedef boost::intrusive_ptr<GLMock> GLMockPtr;
 		
 		extern GLMock* glMock;
+
+		// A GLMock that records the calling thread's calls to draw them later, ahead of
+		// glMock, for that thread only. See RenderRecorder.
+		void setThreadRecorder(GLMock* recorder);
+		GLMock* threadRecorder();
+		// How many threads have one. Without any, finding the mock doesn't ask the thread.
+		extern volatile unsigned threadRecorders;
 	}
 }
 
@@ -0,0 +1,231 @@
+// Copyright 2011 Nuffer Brothers Software LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "InputJournal.hpp"
+#include "Log.hpp"
+#include "miniblocxx/BinarySerialization.hpp"
+#include "miniblocxx/Format.hpp"
+#include "miniblocxx/IOException.hpp"
+#include <streambuf>
+#include <string.h>
+
+namespace engine
+{
+
+namespace
+{
+	const UInt32 journalSignature = 0x524a4e4c; // "RJNL"
+	const UInt8 journalVersion = 1;
+}
+
+InputRecord::InputRecord()
+: type(E_FRAME)
+, touch(0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0)
+, key(0)
+, metaState(0)
+{
+	values[0] = values[1] = values[2] = 0;
+}
+
+InputJournalWriter::InputJournalWriter(std::streambuf& out, UInt32 seed, const Array<Int32>& parameters)
+: _out(out)
+{
+	BinarySerialization::write(_out, journalSignature);
+	BinarySerialization::write(_out, journalVersion);
+	BinarySerialization::write(_out, seed);
+	BinarySerialization::writeLen(_out, parameters.size());
+	for (size_t i = 0; i < parameters.size(); ++i)
+	{
+		BinarySerialization::write(_out, parameters[i]);
+	}
+}
+
+InputJournalWriter::~InputJournalWriter()
+{
+	_out.pubsync();
+}
+
+void InputJournalWriter::frame(const TimeDuration& frameTime)
+{
+	Int64 microseconds = frameTime.microseconds();
+	begin(InputRecord::E_FRAME);
+	BinarySerialization::writeLen(_out, microseconds < 0 ? 0 : static_cast<UInt32>(microseconds));
+}
+
+void InputJournalWriter::touch(const TouchEvent& touchEvent)
+{
+	begin(InputRecord::E_TOUCH);
+	BinarySerialization::write(_out, static_cast<UInt8>(touchEvent.action));
+	writeFloat(touchEvent.x);
+	writeFloat(touchEvent.y);
+	writeFloat(touchEvent.pressure);
+	writeFloat(touchEvent.size);
+	writeFloat(touchEvent.xPrecision);
+	writeFloat(touchEvent.yPrecision);
+	BinarySerialization::write(_out, static_cast<Int64>(touchEvent.downTime));
+	BinarySerialization::write(_out, static_cast<Int64>(touchEvent.eventTime));
+	BinarySerialization::write(_out, static_cast<Int32>(touchEvent.metaState));
+	BinarySerialization::write(_out, static_cast<Int32>(touchEvent.deviceId));
+	BinarySerialization::write(_out, static_cast<Int32>(touchEvent.edgeFlags));
+}
+
+void InputJournalWriter::trackball(float deltaX)
+{
+	begin(InputRecord::E_TRACKBALL);
+	writeFloat(deltaX);
+}
+
+void InputJournalWriter::orientation(float rollAngle, float pitchAngle, float headingAngle)
+{
+	begin(InputRecord::E_ORIENTATION);
+	writeFloat(rollAngle);
+	writeFloat(pitchAngle);
+	writeFloat(headingAngle);
+}
+
+void InputJournalWriter::keyDown(int key, int metaState)
+{
+	begin(InputRecord::E_KEY_DOWN);
+	BinarySerialization::write(_out, static_cast<Int32>(key));
+	BinarySerialization::write(_out, static_cast<Int32>(metaState));
+}
+
+void InputJournalWriter::keyUp(int key, int metaState)
+{
+	begin(InputRecord::E_KEY_UP);
+	BinarySerialization::write(_out, static_cast<Int32>(key));
+	BinarySerialization::write(_out, static_cast<Int32>(metaState));
+}
+
+void InputJournalWriter::flush()
+{
+	_out.pubsync();
+}
+
+void InputJournalWriter::begin(InputRecord::EType type)
+{
+	BinarySerialization::write(_out, static_cast<UInt8>(type));
+}
+
+void InputJournalWriter::writeFloat(float value)
+{
+	UInt32 bits;
+	memcpy(&bits, &value, sizeof(bits));
+	BinarySerialization::write(_out, bits);
+}
+
+InputJournalReader::InputJournalReader(std::streambuf& in)
+: _in(in)
+, _seed(0)
+{
+	UInt32 signature;
+	UInt8 version;
+	BinarySerialization::read(_in, signature);
+	BinarySerialization::read(_in, version);
+	if (signature != journalSignature || version != journalVersion)
+	{
+		BLOCXX_THROW(IOException, Format("Not an input journal, or version %1 of one", static_cast<int>(version)).c_str());
+	}
+	BinarySerialization::read(_in, _seed);
+	UInt32 count;
+	BinarySerialization::readLen(_in, count);
+	for (UInt32 i = 0; i < count; ++i)
+	{
+		Int32 parameter;
+		BinarySerialization::read(_in, parameter);
+		_parameters.push_back(parameter);
+	}
+}
+
+bool InputJournalReader::read(InputRecord& record)
+{
+	if (_in.sgetc() == std::char_traits<char>::eof())
+		return false;
+
+	UInt8 type;
+	BinarySerialization::read(_in, type);
+	try
+	{
+		switch (type)
+		{
+			case InputRecord::E_FRAME:
+			{
+				UInt32 microseconds;
+				BinarySerialization::readLen(_in, microseconds);
+				record.frameTime = TimeDuration(static_cast<Int64>(microseconds));
+				break;
+			}
+			case InputRecord::E_TOUCH:
+			{
+				UInt8 action;
+				Int64 downTime, eventTime;
+				Int32 metaState, deviceId, edgeFlags;
+				BinarySerialization::read(_in, action);
+				record.touch.action = action;
+				record.touch.x = readFloat();
+				record.touch.y = readFloat();
+				record.touch.pressure = readFloat();
+				record.touch.size = readFloat();
+				record.touch.xPrecision = readFloat();
+				record.touch.yPrecision = readFloat();
+				BinarySerialization::read(_in, downTime);
+				BinarySerialization::read(_in, eventTime);
+				BinarySerialization::read(_in, metaState);
+				BinarySerialization::read(_in, deviceId);
+				BinarySerialization::read(_in, edgeFlags);
+				record.touch.downTime = static_cast<long>(downTime);
+				record.touch.eventTime = static_cast<long>(eventTime);
+				record.touch.metaState = metaState;
+				record.touch.deviceId = deviceId;
+				record.touch.edgeFlags = edgeFlags;
+				break;
+			}
+			case InputRecord::E_TRACKBALL:
+				record.values[0] = readFloat();
+				break;
+			case InputRecord::E_ORIENTATION:
+				record.values[0] = readFloat();
+				record.values[1] = readFloat();
+				record.values[2] = readFloat();
+				break;
+			case InputRecord::E_KEY_DOWN:
+			case InputRecord::E_KEY_UP:
+				BinarySerialization::read(_in, record.key);
+				BinarySerialization::read(_in, record.metaState);
+				break;
+			default:
+				BLOCXX_THROW(IOException, Format("Unknown input journal record type %1", static_cast<int>(type)).c_str());
+		}
+	}
+	catch (const IOException&)
+	{
+		if (_in.sgetc() != std::char_traits<char>::eof())
+			throw;
+		LOGE("InputJournal: the last record is cut off");
+		return false;
+	}
+	record.type = static_cast<InputRecord::EType>(type);
+	return true;
+}
+
+float InputJournalReader::readFloat()
+{
+	UInt32 bits;
+	BinarySerialization::read(_in, bits);
+	float value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+}
@@ -0,0 +1,114 @@
+// Copyright 2011 Nuffer Brothers Software LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef engine_InputJournal_HPP_INCLUDED
+#define engine_InputJournal_HPP_INCLUDED
+
+#include "EngineConfig.hpp"
+#include "TouchEvent.hpp"
+#include "miniblocxx/Array.hpp"
+#include "miniblocxx/TimeDuration.hpp"
+#include "miniblocxx/Types.hpp"
+#include <iosfwd>
+
+namespace engine
+{
+/**
+ * An input journal is every input event of a run, interleaved with the frames in the
+ * order they happened, so a replay can hand each event to the same frame it reached
+ * originally and step each frame by the same time. Together with the random seed in
+ * its header that repeats the run exactly.
+ *
+ * The stream is BinarySerialization: a frame costs 2 or 3 bytes, an orientation sample
+ * 13, so a minute of racing is a few tens of KiB.
+ */
+struct InputRecord
+{
+	enum EType
+	{
+		// Everything since the previous frame record went into this frame.
+		E_FRAME = 0,
+		// touch is in Director coordinates, as Scene::handleTouchEvent() gets it.
+		E_TOUCH,
+		// values[0] is the trackball's deltaX.
+		E_TRACKBALL,
+		// values[] is roll, pitch and heading.
+		E_ORIENTATION,
+		// key and metaState as AndroidKeyboardInput::keyDown() and keyUp() get them.
+		E_KEY_DOWN,
+		E_KEY_UP
+	};
+
+	InputRecord();
+
+	EType type;
+	TimeDuration frameTime;
+	TouchEvent touch;
+	float values[3];
+	Int32 key;
+	Int32 metaState;
+};
+
+class InputJournalWriter
+{
+public:
+	// Writes the header: seed is what the random generators were seeded with, parameters
+	// whatever else the replay needs to set up the same way.
+	InputJournalWriter(std::streambuf& out, UInt32 seed, const Array<Int32>& parameters);
+	~InputJournalWriter();
+
+	// Not thread safe, the caller serializes the writes.
+	void frame(const TimeDuration& frameTime);
+	void touch(const TouchEvent& touchEvent);
+	void trackball(float deltaX);
+	void orientation(float rollAngle, float pitchAngle, float headingAngle);
+	void keyDown(int key, int metaState);
+	void keyUp(int key, int metaState);
+
+	void flush();
+
+private:
+	InputJournalWriter(const InputJournalWriter&);
+	InputJournalWriter& operator=(const InputJournalWriter&);
+
+	void begin(InputRecord::EType type);
+	void writeFloat(float value);
+
+	std::streambuf& _out;
+};
+
+class InputJournalReader
+{
+public:
+	// Reads the header, throws IOException if in isn't an input journal.
+	explicit InputJournalReader(std::streambuf& in);
+
+	UInt32 seed() const { return _seed; }
+	const Array<Int32>& parameters() const { return _parameters; }
+
+	// Returns false at the end of the journal. A journal cut off in the middle of a
+	// record, as a killed process leaves it, ends at the last whole one.
+	bool read(InputRecord& record);
+
+private:
+	float readFloat();
+
+	std::streambuf& _in;
+	UInt32 _seed;
+	Array<Int32> _parameters;
+};
+
+}
+
+#endif
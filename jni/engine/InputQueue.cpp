@@ -0,0 +1,65 @@
+// Copyright 2011 Nuffer Brothers Software LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "InputQueue.hpp"
+
+namespace engine
+{
+
+InputQueue::InputQueue()
+: _head(0)
+, _tail(0)
+, _dropped(0)
+{
+}
+
+bool InputQueue::push(const InputRecord& record)
+{
+	unsigned head = _head;
+	// The consumer must be done reading the slot before it is reused.
+	__sync_synchronize();
+	if (head - _tail >= capacity)
+	{
+		_dropped = _dropped + 1;
+		return false;
+	}
+	_records[head % capacity] = record;
+	// The record must be complete before the consumer can see it.
+	__sync_synchronize();
+	_head = head + 1;
+	return true;
+}
+
+unsigned InputQueue::size() const
+{
+	unsigned size = _head - _tail;
+	__sync_synchronize();
+	return size;
+}
+
+bool InputQueue::pop(InputRecord& record)
+{
+	unsigned tail = _tail;
+	if (_head == tail)
+		return false;
+	// Don't read the record before seeing the head that published it.
+	__sync_synchronize();
+	record = _records[tail % capacity];
+	// Done with the slot before the producer may see it free.
+	__sync_synchronize();
+	_tail = tail + 1;
+	return true;
+}
+
+}
@@ -0,0 +1,61 @@
+// Copyright 2011 Nuffer Brothers Software LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef engine_InputQueue_HPP_INCLUDED
+#define engine_InputQueue_HPP_INCLUDED
+
+#include "EngineConfig.hpp"
+#include "InputJournal.hpp"
+
+namespace engine
+{
+/**
+ * A wait-free ring of input events from the one thread input arrives on to the one
+ * thread that renders. Neither side ever blocks the other: push() drops the event if
+ * the renderer has fallen a whole ring behind, and the renderer takes only what was
+ * queued when it started on a frame.
+ */
+class InputQueue
+{
+public:
+	enum { capacity = 256 };
+
+	InputQueue();
+
+	// Producer side. Returns false, and drops record, when the queue is full.
+	bool push(const InputRecord& record);
+
+	// Consumer side. The number of records queued now, pop() takes them in order.
+	unsigned size() const;
+	bool pop(InputRecord& record);
+
+	// Records push() had to drop, ever.
+	unsigned dropped() const { return _dropped; }
+
+private:
+	InputQueue(const InputQueue&);
+	InputQueue& operator=(const InputQueue&);
+
+	InputRecord _records[capacity];
+	// Records ever pushed, only the producer writes it. Wraps, so only differences of
+	// it with _tail mean anything.
+	volatile unsigned _head;
+	// Records ever popped, only the consumer writes it.
+	volatile unsigned _tail;
+	volatile unsigned _dropped;
+};
+
+}
+
+#endif
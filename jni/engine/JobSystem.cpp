@@ -0,0 +1,218 @@
+// Copyright 2011 Nuffer Brothers Software LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "JobSystem.hpp"
+#include "Log.hpp"
+#include <algorithm>
+#include <unistd.h>
+
+namespace engine
+{
+
+namespace
+{
+	const size_t maxDefaultWorkers = 7;
+}
+
+JobSystem::JobSystem(size_t workerCount)
+	: m_generation(0)
+	, m_shutdown(false)
+	, m_pending(0)
+{
+	pthread_mutex_init(&m_wakeMutex, NULL);
+	pthread_cond_init(&m_wakeCondition, NULL);
+	pthread_mutex_init(&m_doneMutex, NULL);
+	pthread_cond_init(&m_doneCondition, NULL);
+
+	for (size_t i = 0; i < workerCount + 1; ++i)
+	{
+		WorkQueue* queue = new WorkQueue;
+		pthread_mutex_init(&queue->mutex, NULL);
+		m_queues.push_back(queue);
+	}
+
+	for (size_t i = 0; i < workerCount; ++i)
+	{
+		Worker* worker = new Worker;
+		worker->system = this;
+		worker->queue = i + 1;
+		if (pthread_create(&worker->thread, NULL, workerMain, worker) != 0)
+		{
+			LOGE("JobSystem: failed to start worker %zu, continuing with %zu", i, m_workers.size());
+			delete worker;
+			break;
+		}
+		m_workers.push_back(worker);
+	}
+	LOGI("JobSystem started with %zu workers", m_workers.size());
+}
+
+JobSystem::~JobSystem()
+{
+	pthread_mutex_lock(&m_wakeMutex);
+	m_shutdown = true;
+	pthread_cond_broadcast(&m_wakeCondition);
+	pthread_mutex_unlock(&m_wakeMutex);
+
+	for (size_t i = 0; i < m_workers.size(); ++i)
+	{
+		pthread_join(m_workers[i]->thread, NULL);
+		delete m_workers[i];
+	}
+	for (size_t i = 0; i < m_queues.size(); ++i)
+	{
+		pthread_mutex_destroy(&m_queues[i]->mutex);
+		delete m_queues[i];
+	}
+
+	pthread_cond_destroy(&m_doneCondition);
+	pthread_mutex_destroy(&m_doneMutex);
+	pthread_cond_destroy(&m_wakeCondition);
+	pthread_mutex_destroy(&m_wakeMutex);
+}
+
+size_t JobSystem::defaultWorkerCount()
+{
+	long cores = sysconf(_SC_NPROCESSORS_ONLN);
+	if (cores <= 1)
+		return 0;
+	return std::min(static_cast<size_t>(cores - 1), maxDefaultWorkers);
+}
+
+void JobSystem::parallelFor(size_t count, size_t grain, RangeBody& body)
+{
+	if (count == 0)
+		return;
+	if (grain == 0)
+		grain = 1;
+	if (m_workers.empty() || count <= grain)
+	{
+		body.run(0, count);
+		return;
+	}
+
+	size_t spanCount = (count + grain - 1) / grain;
+	pthread_mutex_lock(&m_doneMutex);
+	m_pending = spanCount;
+	pthread_mutex_unlock(&m_doneMutex);
+
+	// Deal the spans out round robin, the first one to the calling thread.
+	for (size_t i = 0; i < spanCount; ++i)
+	{
+		Span span;
+		span.body = &body;
+		span.begin = i * grain;
+		span.end = std::min(span.begin + grain, count);
+		WorkQueue* queue = m_queues[i % m_queues.size()];
+		pthread_mutex_lock(&queue->mutex);
+		queue->spans.push_back(span);
+		pthread_mutex_unlock(&queue->mutex);
+	}
+
+	pthread_mutex_lock(&m_wakeMutex);
+	++m_generation;
+	pthread_cond_broadcast(&m_wakeCondition);
+	pthread_mutex_unlock(&m_wakeMutex);
+
+	Span span;
+	while (takeSpan(0, span))
+	{
+		runSpan(span);
+	}
+
+	// Everything is taken, wait for the spans still running on the workers.
+	pthread_mutex_lock(&m_doneMutex);
+	while (m_pending > 0)
+	{
+		pthread_cond_wait(&m_doneCondition, &m_doneMutex);
+	}
+	pthread_mutex_unlock(&m_doneMutex);
+}
+
+void* JobSystem::workerMain(void* arg)
+{
+	Worker* worker = static_cast<Worker*>(arg);
+	worker->system->workerLoop(worker->queue);
+	return NULL;
+}
+
+void JobSystem::workerLoop(size_t queue)
+{
+	for (;;)
+	{
+		pthread_mutex_lock(&m_wakeMutex);
+		unsigned generation = m_generation;
+		bool shutdown = m_shutdown;
+		pthread_mutex_unlock(&m_wakeMutex);
+		if (shutdown)
+			return;
+
+		Span span;
+		while (takeSpan(queue, span))
+		{
+			runSpan(span);
+		}
+
+		// Spans queued after generation was read bump it, so they can't be missed here.
+		pthread_mutex_lock(&m_wakeMutex);
+		while (m_generation == generation && !m_shutdown)
+		{
+			pthread_cond_wait(&m_wakeCondition, &m_wakeMutex);
+		}
+		pthread_mutex_unlock(&m_wakeMutex);
+	}
+}
+
+bool JobSystem::takeSpan(size_t queue, Span& span)
+{
+	WorkQueue* own = m_queues[queue];
+	pthread_mutex_lock(&own->mutex);
+	if (!own->spans.empty())
+	{
+		span = own->spans.back();
+		own->spans.pop_back();
+		pthread_mutex_unlock(&own->mutex);
+		return true;
+	}
+	pthread_mutex_unlock(&own->mutex);
+
+	for (size_t i = 1; i < m_queues.size(); ++i)
+	{
+		WorkQueue* victim = m_queues[(queue + i) % m_queues.size()];
+		pthread_mutex_lock(&victim->mutex);
+		if (!victim->spans.empty())
+		{
+			span = victim->spans.front();
+			victim->spans.pop_front();
+			pthread_mutex_unlock(&victim->mutex);
+			return true;
+		}
+		pthread_mutex_unlock(&victim->mutex);
+	}
+	return false;
+}
+
+void JobSystem::runSpan(const Span& span)
+{
+	span.body->run(span.begin, span.end);
+
+	pthread_mutex_lock(&m_doneMutex);
+	if (--m_pending == 0)
+	{
+		pthread_cond_signal(&m_doneCondition);
+	}
+	pthread_mutex_unlock(&m_doneMutex);
+}
+
+}
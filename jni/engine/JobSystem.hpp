@@ -0,0 +1,103 @@
+// Copyright 2011 Nuffer Brothers Software LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef JOB_SYSTEM_HPP_INCLUDED
+#define JOB_SYSTEM_HPP_INCLUDED
+
+#include "EngineConfig.hpp"
+#include "boost/noncopyable.hpp"
+#include <pthread.h>
+#include <deque>
+#include <vector>
+
+namespace engine
+{
+/**
+ * A small pool of worker threads used to spread per-frame work over all cores.
+ *
+ * Every thread, including the one calling parallelFor() which always takes part, owns a
+ * deque of spans. A thread takes spans from the back of its own deque and, once that is
+ * empty, steals from the front of the others', so a few expensive spans don't leave the
+ * other cores idle.
+ *
+ * parallelFor() must only be called from one thread at a time and never from a RangeBody.
+ */
+class JobSystem : private boost::noncopyable
+{
+public:
+	/**
+	 * The work done by parallelFor(). run() is called concurrently with disjoint
+	 * [begin, end) spans, so it may only write state belonging to its own span.
+	 */
+	class RangeBody
+	{
+	public:
+		virtual ~RangeBody() {}
+		virtual void run(size_t begin, size_t end) = 0;
+	};
+
+	// With no workers everything runs on the thread calling parallelFor().
+	explicit JobSystem(size_t workerCount);
+	~JobSystem();
+
+	// One less than the number of online cores, since the calling thread works too.
+	static size_t defaultWorkerCount();
+
+	size_t workerCount() const { return m_workers.size(); }
+
+	// Runs body over [0, count) in spans of at most grain items. Returns once every span is done.
+	void parallelFor(size_t count, size_t grain, RangeBody& body);
+
+private:
+	struct Span
+	{
+		RangeBody* body;
+		size_t begin;
+		size_t end;
+	};
+
+	struct WorkQueue
+	{
+		pthread_mutex_t mutex;
+		std::deque<Span> spans;
+	};
+
+	struct Worker
+	{
+		JobSystem* system;
+		size_t queue;
+		pthread_t thread;
+	};
+
+	static void* workerMain(void* arg);
+	void workerLoop(size_t queue);
+	bool takeSpan(size_t queue, Span& span);
+	void runSpan(const Span& span);
+
+	std::vector<WorkQueue*> m_queues; // m_queues[0] belongs to the thread calling parallelFor()
+	std::vector<Worker*> m_workers;
+
+	pthread_mutex_t m_wakeMutex;
+	pthread_cond_t m_wakeCondition;
+	unsigned m_generation; // bumped every time spans are queued
+	bool m_shutdown;
+
+	pthread_mutex_t m_doneMutex;
+	pthread_cond_t m_doneCondition;
+	size_t m_pending; // spans of the current parallelFor() that haven't finished
+};
+
+}
+
+#endif
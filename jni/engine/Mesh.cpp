@@ -63,16 +63,16 @@ void Mesh::calculateRadius()
 
 void Mesh::draw()
 {
-	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-	glDisable(GL_TEXTURE_2D);
+	using namespace gl;
+	// The Director enables the arrays for the frame, the texture coordinates don't
+	// matter with texturing off.
+	disableTexture2D();
 	// load arrays into the engine
-	glVertexPointer(coordsPerVertex_, GL_FLOAT, 0, &vertexes_[0]);
-	glEnableClientState(GL_VERTEX_ARRAY);
-	glColorPointer(componentsPerColor_, GL_FLOAT, 0, &colors_[0]);
-	glEnableClientState(GL_COLOR_ARRAY);
+	vertex(coordsPerVertex_, GL_FLOAT, 0, &vertexes_[0]);
+	color(componentsPerColor_, GL_FLOAT, 0, &colors_[0]);
 
 	//render
-	glDrawArrays(renderStyle_, 0, vertexCount());
+	drawArrays(renderStyle_, 0, vertexCount());
 }
 
 }
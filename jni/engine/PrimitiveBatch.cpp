@@ -0,0 +1,98 @@
+// Copyright 2011 Nuffer Brothers Software LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "PrimitiveBatch.hpp"
+#include "Profiler.hpp"
+#include "VertexBuffer.hpp"
+#include <math.h>
+
+namespace engine
+{
+
+void PrimitiveBatch::rectangle(const Point& lowerLeft, GLfloat width, GLfloat height, const GLfloat* color)
+{
+	if (width <= 0 || height <= 0)
+		return;
+	GLfloat right = lowerLeft.x() + width;
+	GLfloat top = lowerLeft.y() + height;
+	quad(lowerLeft, Point(right, lowerLeft.y()), Point(right, top), Point(lowerLeft.x(), top), color);
+}
+
+void PrimitiveBatch::line(const Point& from, const Point& to, GLfloat width, const GLfloat* color)
+{
+	GLfloat dx = to.x() - from.x();
+	GLfloat dy = to.y() - from.y();
+	GLfloat length = sqrtf(dx * dx + dy * dy);
+	if (length == 0 || width <= 0)
+		return;
+	// Half the width across the line.
+	GLfloat nx = -dy / length * width / 2;
+	GLfloat ny = dx / length * width / 2;
+	quad(Point(from.x() + nx, from.y() + ny), Point(to.x() + nx, to.y() + ny),
+		Point(to.x() - nx, to.y() - ny), Point(from.x() - nx, from.y() - ny), color);
+}
+
+void PrimitiveBatch::outline(const Point& lowerLeft, GLfloat width, GLfloat height, GLfloat lineWidth, const GLfloat* color)
+{
+	Point lowerRight(lowerLeft.x() + width, lowerLeft.y());
+	Point upperRight(lowerLeft.x() + width, lowerLeft.y() + height);
+	Point upperLeft(lowerLeft.x(), lowerLeft.y() + height);
+	line(lowerLeft, upperLeft, lineWidth, color);
+	line(upperLeft, upperRight, lineWidth, color);
+	line(upperRight, lowerRight, lineWidth, color);
+	line(lowerRight, lowerLeft, lineWidth, color);
+}
+
+void PrimitiveBatch::quad(const Point& a, const Point& b, const Point& c, const Point& d, const GLfloat* color)
+{
+	add(a, color);
+	add(b, color);
+	add(c, color);
+	add(a, color);
+	add(c, color);
+	add(d, color);
+}
+
+void PrimitiveBatch::add(const Point& at, const GLfloat* color)
+{
+	_vertexes.push_back(at.x());
+	_vertexes.push_back(at.y());
+	_vertexes.insert(_vertexes.end(), color, color + 4);
+}
+
+void PrimitiveBatch::flush()
+{
+	if (_vertexes.empty())
+		return;
+	PROFILE_ZONE("PrimitiveBatch::flush");
+	using namespace gl;
+	const GLsizei stride = floatsPerVertex * sizeof(GLfloat);
+	MatrixScope ms;
+	disableTexture2D();
+	const GLvoid* pointer;
+	GLuint buffer = StreamingVertexBuffer::shared().upload(&_vertexes[0], _vertexes.size(), pointer);
+	vertex(2, GL_FLOAT, stride, pointer, buffer);
+	// An offset into buffer, if there is one.
+	color(4, GL_FLOAT, stride, reinterpret_cast<const GLvoid*>(reinterpret_cast<size_t>(pointer) + 2 * sizeof(GLfloat)), buffer);
+	drawArrays(GL_TRIANGLES, 0, vertexCount());
+	_vertexes.clear();
+}
+
+PrimitiveBatch& PrimitiveBatch::shared()
+{
+	static PrimitiveBatch* batch = new PrimitiveBatch;
+	return *batch;
+}
+
+}
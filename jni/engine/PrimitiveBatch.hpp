@@ -0,0 +1,71 @@
+// Copyright 2011 Nuffer Brothers Software LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef engine_PrimitiveBatch_HPP_INCLUDED
+#define engine_PrimitiveBatch_HPP_INCLUDED
+
+#include "EngineConfig.hpp"
+#include "GL.hpp"
+#include "Point.hpp"
+#include <vector>
+
+namespace engine
+{
+
+/**
+ * Untextured colored shapes from any number of drawables, drawn with one drawArrays().
+ * The vertexes are placed where they go in the scene as they are added, so no shape needs
+ * a matrix of its own. Lines become thin quads, so a change of width doesn't split the
+ * batch either, and their widths are in scene units rather than pixels.
+ *
+ * Whatever draws after a shape has to flush() the batch first. Scene::draw() and
+ * Drawable::drawAttachedChildren() do before every drawable that isn't batched().
+ * Only the thread drawing the scene uses it.
+ */
+class PrimitiveBatch
+{
+public:
+	PrimitiveBatch() {}
+
+	// color is r, g, b, a.
+	void rectangle(const Point& lowerLeft, GLfloat width, GLfloat height, const GLfloat* color);
+	void line(const Point& from, const Point& to, GLfloat width, const GLfloat* color);
+	// The lines around a rectangle, centered on its edges.
+	void outline(const Point& lowerLeft, GLfloat width, GLfloat height, GLfloat lineWidth, const GLfloat* color);
+
+	// Draws what was added since the last flush, if anything.
+	void flush();
+	bool empty() const { return _vertexes.empty(); }
+	size_t vertexCount() const { return _vertexes.size() / floatsPerVertex; }
+
+	// x, y, r, g, b, a.
+	static const size_t floatsPerVertex = 6;
+
+	// The one every scene draws with.
+	static PrimitiveBatch& shared();
+
+private:
+	PrimitiveBatch(const PrimitiveBatch&);
+	PrimitiveBatch& operator=(const PrimitiveBatch&);
+
+	// Two triangles, the corners in order around it.
+	void quad(const Point& a, const Point& b, const Point& c, const Point& d, const GLfloat* color);
+	void add(const Point& at, const GLfloat* color);
+
+	std::vector<GLfloat> _vertexes;
+};
+
+}
+
+#endif
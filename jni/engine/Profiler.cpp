@@ -0,0 +1,346 @@
+// Copyright 2011 Nuffer Brothers Software LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "Profiler.hpp"
+#include "Log.hpp"
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <algorithm>
+#ifdef __APPLE__
+#include <mach/mach_time.h>
+#endif
+
+namespace engine
+{
+namespace profiler
+{
+	struct Event
+	{
+		const char* name;
+		unsigned long long start;
+		unsigned long long end;
+	};
+
+	struct ThreadBuffer
+	{
+		Event events[eventsPerThread];
+		// Events ever recorded, only the owning thread writes it. Wraps, so only
+		// differences of it mean anything.
+		volatile unsigned head;
+		unsigned id;
+		const char* name;
+		// Guarded by the registry mutex.
+		unsigned base; // the first event reset() kept
+		unsigned summarized; // the first event endFrame() hasn't seen
+	};
+
+	namespace
+	{
+		pthread_once_t keyOnce = PTHREAD_ONCE_INIT;
+		pthread_key_t bufferKey;
+		pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+		std::vector<ThreadBuffer*> buffers;
+
+		struct Accumulator
+		{
+			const char* name;
+			double ms;
+			double worstMs;
+			unsigned calls;
+		};
+
+		// Zones of the frame endFrame() is summarizing, and of the window so far.
+		std::vector<Accumulator> frameZones;
+		std::vector<Accumulator> windowZones;
+		size_t windowFrames = 0;
+		double windowWorstFrameMs = 0;
+		// The last full window.
+		std::vector<ZoneStats> publishedZones;
+		double publishedWorstFrameMs = 0;
+		unsigned long long lastFrameEnd = 0;
+		std::vector<Event> scratch;
+
+		void createKey()
+		{
+			pthread_key_create(&bufferKey, NULL);
+		}
+
+		ThreadBuffer* threadBuffer()
+		{
+			pthread_once(&keyOnce, createKey);
+			ThreadBuffer* buffer = static_cast<ThreadBuffer*>(pthread_getspecific(bufferKey));
+			if (!buffer)
+			{
+				buffer = new ThreadBuffer;
+				memset(buffer, 0, sizeof(*buffer));
+				pthread_mutex_lock(&mutex);
+				buffers.push_back(buffer);
+				buffer->id = buffers.size();
+				pthread_mutex_unlock(&mutex);
+				pthread_setspecific(bufferKey, buffer);
+			}
+			return buffer;
+		}
+
+		void record(ThreadBuffer* buffer, const char* name, unsigned long long start, unsigned long long end)
+		{
+			unsigned head = buffer->head;
+			Event& event = buffer->events[head % eventsPerThread];
+			event.name = name;
+			event.start = start;
+			event.end = end;
+			// The event must be complete before a reader can see it.
+			__sync_synchronize();
+			buffer->head = head + 1;
+		}
+
+		// Appends the events of buffer from from up to its head to out, leaving out any the
+		// owning thread may have overwritten while they were copied. Returns the head.
+		unsigned copyEvents(const ThreadBuffer& buffer, unsigned from, std::vector<Event>& out)
+		{
+			unsigned head = buffer.head;
+			__sync_synchronize();
+			if (head - from > eventsPerThread)
+				from = head - eventsPerThread;
+			size_t first = out.size();
+			for (unsigned i = from; i != head; ++i)
+			{
+				out.push_back(buffer.events[i % eventsPerThread]);
+			}
+			__sync_synchronize();
+			// The owner may be writing the event after its head, over the oldest one.
+			unsigned reachable = buffer.head - from + 1;
+			if (reachable > eventsPerThread)
+			{
+				size_t lost = std::min<size_t>(reachable - eventsPerThread, head - from);
+				out.erase(out.begin() + first, out.begin() + first + lost);
+			}
+			return head;
+		}
+
+		Accumulator& accumulator(std::vector<Accumulator>& zones, const char* name)
+		{
+			for (size_t i = 0; i < zones.size(); ++i)
+			{
+				if (zones[i].name == name || strcmp(zones[i].name, name) == 0)
+					return zones[i];
+			}
+			Accumulator zone = { name, 0, 0, 0 };
+			zones.push_back(zone);
+			return zones.back();
+		}
+
+		bool worseThan(const ZoneStats& a, const ZoneStats& b)
+		{
+			return a.worstMs > b.worstMs;
+		}
+
+		std::vector<ZoneStats> windowStats()
+		{
+			std::vector<ZoneStats> stats;
+			for (size_t i = 0; i < windowZones.size(); ++i)
+			{
+				ZoneStats zone;
+				zone.name = windowZones[i].name;
+				zone.worstMs = windowZones[i].worstMs;
+				zone.averageMs = windowZones[i].ms / windowFrames;
+				zone.calls = static_cast<double>(windowZones[i].calls) / windowFrames;
+				stats.push_back(zone);
+			}
+			std::sort(stats.begin(), stats.end(), worseThan);
+			return stats;
+		}
+
+		// Trace event names are literals of the code, but keep the JSON valid regardless.
+		void writeJsonString(FILE* out, const char* s)
+		{
+			fputc('"', out);
+			for (; *s; ++s)
+			{
+				if (*s == '"' || *s == '\\')
+					fputc('\\', out);
+				if (static_cast<unsigned char>(*s) >= 0x20)
+					fputc(*s, out);
+			}
+			fputc('"', out);
+		}
+	}
+
+	Zone::Zone(const char* name)
+		: _buffer(threadBuffer())
+		, _name(name)
+		, _start(now())
+	{
+	}
+
+	Zone::~Zone()
+	{
+		record(_buffer, _name, _start, now());
+	}
+
+	unsigned long long now()
+	{
+#ifdef __APPLE__
+		static mach_timebase_info_data_t timebase;
+		if (timebase.denom == 0)
+			mach_timebase_info(&timebase);
+		return mach_absolute_time() * timebase.numer / timebase.denom;
+#else
+		timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return ts.tv_sec * 1000000000ull + ts.tv_nsec;
+#endif
+	}
+
+	void setThreadName(const char* name)
+	{
+		ThreadBuffer* buffer = threadBuffer();
+		pthread_mutex_lock(&mutex);
+		buffer->name = name;
+		pthread_mutex_unlock(&mutex);
+	}
+
+	void endFrame()
+	{
+		pthread_mutex_lock(&mutex);
+		unsigned long long frameEnd = now();
+
+		scratch.clear();
+		for (size_t i = 0; i < buffers.size(); ++i)
+		{
+			buffers[i]->summarized = copyEvents(*buffers[i], buffers[i]->summarized, scratch);
+		}
+		for (size_t i = 0; i < frameZones.size(); ++i)
+		{
+			frameZones[i].ms = 0;
+			frameZones[i].calls = 0;
+		}
+		for (size_t i = 0; i < scratch.size(); ++i)
+		{
+			Accumulator& zone = accumulator(frameZones, scratch[i].name);
+			zone.ms += (scratch[i].end - scratch[i].start) / 1e6;
+			++zone.calls;
+		}
+		for (size_t i = 0; i < frameZones.size(); ++i)
+		{
+			if (frameZones[i].calls == 0)
+				continue;
+			Accumulator& zone = accumulator(windowZones, frameZones[i].name);
+			zone.ms += frameZones[i].ms;
+			zone.worstMs = std::max(zone.worstMs, frameZones[i].ms);
+			zone.calls += frameZones[i].calls;
+		}
+
+		if (lastFrameEnd != 0)
+			windowWorstFrameMs = std::max(windowWorstFrameMs, (frameEnd - lastFrameEnd) / 1e6);
+		lastFrameEnd = frameEnd;
+		if (++windowFrames == statsWindowFrames)
+		{
+			publishedZones = windowStats();
+			publishedWorstFrameMs = windowWorstFrameMs;
+			windowZones.clear();
+			windowFrames = 0;
+			windowWorstFrameMs = 0;
+		}
+		pthread_mutex_unlock(&mutex);
+	}
+
+	std::vector<ZoneStats> worstZones(size_t count)
+	{
+		pthread_mutex_lock(&mutex);
+		std::vector<ZoneStats> stats = publishedZones;
+		pthread_mutex_unlock(&mutex);
+		if (stats.size() > count)
+			stats.resize(count);
+		return stats;
+	}
+
+	double worstFrameMs()
+	{
+		pthread_mutex_lock(&mutex);
+		double ms = publishedWorstFrameMs;
+		pthread_mutex_unlock(&mutex);
+		return ms;
+	}
+
+	bool dumpChromeTrace(const std::string& path)
+	{
+		FILE* out = fopen(path.c_str(), "w");
+		if (!out)
+		{
+			LOGE("Profiler: couldn't write %s", path.c_str());
+			return false;
+		}
+
+		pthread_mutex_lock(&mutex);
+		size_t eventCount = 0;
+		fprintf(out, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+		for (size_t i = 0; i < buffers.size(); ++i)
+		{
+			const ThreadBuffer& buffer = *buffers[i];
+			fprintf(out, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", i == 0 ? "" : ",\n", buffer.id);
+			if (buffer.name)
+				writeJsonString(out, buffer.name);
+			else
+				fprintf(out, "\"Thread %u\"", buffer.id);
+			fprintf(out, "}}");
+
+			std::vector<Event> events;
+			copyEvents(buffer, buffer.base, events);
+			for (size_t e = 0; e < events.size(); ++e)
+			{
+				fprintf(out, ",\n{\"name\":");
+				writeJsonString(out, events[e].name);
+				fprintf(out, ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+					buffer.id, events[e].start / 1e3, (events[e].end - events[e].start) / 1e3);
+			}
+			eventCount += events.size();
+		}
+		pthread_mutex_unlock(&mutex);
+		fprintf(out, "\n]}\n");
+
+		bool written = ferror(out) == 0;
+		if (fclose(out) != 0)
+			written = false;
+		if (written)
+		{
+			LOGI("Profiler: wrote %zu zones to %s", eventCount, path.c_str());
+		}
+		else
+		{
+			LOGE("Profiler: couldn't write %s", path.c_str());
+		}
+		return written;
+	}
+
+	void reset()
+	{
+		pthread_mutex_lock(&mutex);
+		for (size_t i = 0; i < buffers.size(); ++i)
+		{
+			buffers[i]->base = buffers[i]->summarized = buffers[i]->head;
+		}
+		frameZones.clear();
+		windowZones.clear();
+		windowFrames = 0;
+		windowWorstFrameMs = 0;
+		publishedZones.clear();
+		publishedWorstFrameMs = 0;
+		lastFrameEnd = 0;
+		pthread_mutex_unlock(&mutex);
+	}
+}
+}
@@ -0,0 +1,112 @@
+// Copyright 2011 Nuffer Brothers Software LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef engine_Profiler_HPP_INCLUDED
+#define engine_Profiler_HPP_INCLUDED
+
+#include "EngineConfig.hpp"
+#include <string>
+#include <vector>
+
+/**
+ * A zone times the rest of the scope it is declared in, on whatever thread runs it:
+ *
+ *     void Scene::draw(const Rectangle& screen)
+ *     {
+ *         PROFILE_ZONE("Scene::draw");
+ *         ...
+ *
+ * The name must be a string literal. The macros only do anything in builds with
+ * ENGINE_PROFILE defined (--enable-profiler, or ndk-build PROFILE=1), otherwise they
+ * compile to nothing.
+ */
+#ifdef ENGINE_PROFILE
+#define PROFILE_CAT2(a, b) a##b
+#define PROFILE_CAT(a, b) PROFILE_CAT2(a, b)
+#define PROFILE_ZONE(name) ::engine::profiler::Zone PROFILE_CAT(profileZone, __LINE__)(name)
+#define PROFILE_THREAD(name) ::engine::profiler::setThreadName(name)
+#define PROFILE_FRAME() ::engine::profiler::endFrame()
+#else
+#define PROFILE_ZONE(name) do {} while (false)
+#define PROFILE_THREAD(name) do {} while (false)
+#define PROFILE_FRAME() do {} while (false)
+#endif
+
+namespace engine
+{
+/**
+ * Every thread records its zones into a ring buffer of its own, which only that thread
+ * writes, so a zone costs two clock reads and no locks. endFrame() and
+ * dumpChromeTrace() read the buffers while the threads carry on writing, skipping
+ * whatever a thread may have overwritten meanwhile.
+ *
+ * A thread's buffer outlives the thread, so its zones still show in the trace.
+ */
+namespace profiler
+{
+	// Zones each thread keeps, older ones are overwritten.
+	const size_t eventsPerThread = 4096;
+	// Frames the zone statistics are gathered over.
+	const size_t statsWindowFrames = 60;
+
+	struct ThreadBuffer;
+
+	class Zone
+	{
+	public:
+		explicit Zone(const char* name);
+		~Zone();
+	private:
+		Zone(const Zone&);
+		Zone& operator=(const Zone&);
+
+		ThreadBuffer* _buffer;
+		const char* _name;
+		unsigned long long _start;
+	};
+
+	// Monotonic nanoseconds from an arbitrary start.
+	unsigned long long now();
+
+	// Names the calling thread in the trace, name must be a string literal.
+	void setThreadName(const char* name);
+
+	// Ends the frame, adding the zones every thread finished during it to the
+	// statistics. Call it from one thread only, once per frame.
+	void endFrame();
+
+	struct ZoneStats
+	{
+		std::string name;
+		double worstMs; // the most one frame spent in the zone
+		double averageMs; // per frame
+		double calls; // per frame
+	};
+
+	// The zones that took the longest in one frame of the last full statsWindowFrames
+	// frames, worst first. Zones of all threads are included.
+	std::vector<ZoneStats> worstZones(size_t count);
+	// The longest frame of the same frames.
+	double worstFrameMs();
+
+	// Writes every zone still in the buffers as Chrome trace-event JSON, for
+	// chrome://tracing. Returns false if path couldn't be written.
+	bool dumpChromeTrace(const std::string& path);
+
+	// Forgets every zone and the statistics.
+	void reset();
+}
+}
+
+#endif
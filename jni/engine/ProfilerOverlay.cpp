@@ -0,0 +1,104 @@
+// Copyright 2011 Nuffer Brothers Software LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ProfilerOverlay.hpp"
+#include "Profiler.hpp"
+#include "miniblocxx/Format.hpp"
+
+namespace engine
+{
+	namespace
+	{
+		const TimeDuration refreshPeriod = Time::microseconds(500000);
+	}
+
+	ProfilerOverlay::ProfilerOverlay(const TexturedFontPtr& font, size_t zoneCount, float scale)
+	{
+		for (size_t i = 0; i < zoneCount + 1; ++i)
+		{
+			LabelPtr line = new Label(font);
+			line->setScale(scale);
+			m_lines.push_back(line);
+		}
+		refresh();
+	}
+
+	void ProfilerOverlay::update(const DateTime& thisFrameStartTime, const TimeDuration& deltaTime)
+	{
+		Drawable::update(thisFrameStartTime, deltaTime);
+
+		m_sinceRefresh += deltaTime;
+		if (m_sinceRefresh > refreshPeriod)
+		{
+			refresh();
+			m_sinceRefresh = TimeDuration();
+		}
+	}
+
+	void ProfilerOverlay::draw(const Rectangle& screen)
+	{
+		for (size_t i = 0; i < m_lines.size(); ++i)
+		{
+			m_lines[i]->draw(screen);
+		}
+	}
+
+	std::string ProfilerOverlay::name() const
+	{
+		return "ProfilerOverlay";
+	}
+
+	void ProfilerOverlay::setPosition(const Point& p)
+	{
+		Drawable::setPosition(p);
+		layOut();
+	}
+
+	void ProfilerOverlay::setPositionInterpretation(Drawable::EPositionRelativeToOption positionInterpretation)
+	{
+		Drawable::setPositionInterpretation(positionInterpretation);
+		for (size_t i = 0; i < m_lines.size(); ++i)
+		{
+			m_lines[i]->setPositionInterpretation(positionInterpretation);
+		}
+	}
+
+	void ProfilerOverlay::refresh()
+	{
+		std::vector<profiler::ZoneStats> zones = profiler::worstZones(m_lines.size() - 1);
+		m_lines[0]->setText(Format("frame %1ms", String(profiler::worstFrameMs()).substring(0, 5)));
+		for (size_t i = 1; i < m_lines.size(); ++i)
+		{
+			if (i - 1 < zones.size())
+			{
+				const profiler::ZoneStats& zone = zones[i - 1];
+				m_lines[i]->setText(Format("%1 %2ms", zone.name, String(zone.worstMs).substring(0, 5)));
+			}
+			else
+			{
+				m_lines[i]->setText("");
+			}
+		}
+	}
+
+	void ProfilerOverlay::layOut()
+	{
+		float y = position().y();
+		for (size_t i = 0; i < m_lines.size(); ++i)
+		{
+			m_lines[i]->setPosition(Point(position().x(), y));
+			y -= m_lines[0]->size().height();
+		}
+	}
+}
@@ -0,0 +1,46 @@
+// Copyright 2011 Nuffer Brothers Software LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef engine_ProfilerOverlay_HPP_INCLUDED
+#define engine_ProfilerOverlay_HPP_INCLUDED
+
+#include "EngineConfig.hpp"
+#include "Drawable.hpp"
+#include "Label.hpp"
+
+namespace engine
+{
+	// Lists the worst frame time and the zones that took longest in one frame, one per line
+	// going down from position(), as the profiler's statistics come in.
+	class ProfilerOverlay : public Drawable
+	{
+	public:
+		ProfilerOverlay(const TexturedFontPtr& font, size_t zoneCount, float scale);
+
+		virtual void update(const DateTime& thisFrameStartTime, const TimeDuration& deltaTime);
+		virtual void draw(const Rectangle& screen);
+		virtual std::string name() const;
+		virtual void setPosition(const Point& p);
+		virtual void setPositionInterpretation(Drawable::EPositionRelativeToOption positionInterpretation);
+
+	private:
+		void refresh();
+		void layOut();
+
+		Array<LabelPtr> m_lines;
+		TimeDuration m_sinceRefresh;
+	};
+}
+
+#endif
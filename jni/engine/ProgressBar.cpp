@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "ProgressBar.hpp"
+#include "PrimitiveBatch.hpp"
 
 namespace engine
 {
@@ -24,13 +25,7 @@ namespace engine
 			, barHeight(height)
 			, borderWidth(4)
 	{
-		for (int i = 0; i<8; ++i)
-		{
-			vertexes[i] = 0.0;
-			borderVertexes[i] = 0.0;
-		}
 		scaleFactor = width / maxVal;
-		setVertexes(width, height);
 		setColor(1.0, 1.0, 1.0, 1.0);
 		setBorderColor(1.0, 1.0, 1.0, 1.0);
 	}
@@ -38,38 +33,16 @@ namespace engine
 	// Draw a simple colored rectangle without texture.
 	void ProgressBar::draw(const Rectangle& screen)
 	{
-		using namespace gl;
-
-		setVertexes((*connectedVariable) * scaleFactor, barHeight);
 		Point position = this->getPositionRelativeToOrigin(screen);
-
-
-		{
-			MatrixScope ms;
-			disableTexture2D();
-
-			// Draw border.
-			gl::color(4, GL_FLOAT, 0, borderColor);
-			vertex(2, GL_FLOAT, 0, borderVertexes);
-			translate(position.x(), position.y(), 0);
-			setGLLineWidth(borderWidth);
-			drawArrays(GL_LINE_LOOP, 0, 4);
-		}
-
-		{
-			MatrixScope ms;
-			disableTexture2D();
-
-			// Draw progress.
-			gl::color(4, GL_FLOAT, 0, color);
-			vertex(2, GL_FLOAT, 0, vertexes);
-			translate(position.x(), position.y(), 0);
-			drawArrays(GL_TRIANGLE_STRIP, 0, 4);
-		}
+		PrimitiveBatch& batch = PrimitiveBatch::shared();
+		batch.outline(Point(position.x() - borderWidth, position.y() - borderWidth),
+			barWidth + 2 * borderWidth, barHeight + 2 * borderWidth, borderWidth, borderColor);
+		batch.rectangle(position, progressWidth(), barHeight, color);
 	}
 
-	void ProgressBar::setVertexes(GLfloat width, GLfloat height)
+	GLfloat ProgressBar::progressWidth()
 	{
+		GLfloat width = (*connectedVariable) * scaleFactor;
 		// Check for overflow.
 		if (width > barWidth)
 		{
@@ -81,18 +54,7 @@ namespace engine
 			width = 0;
 			(*connectedVariable) = 0;
 		}
-
-		/*	0, 0,  lower left
-			0, h,  upper left
-			w, 0,  lower right
-			w, h   upper right 	*/
-		vertexes[3] = vertexes[7] = height;
-		vertexes[4] = vertexes[6] = width;
-
-
-		borderVertexes[0] = borderVertexes[1] = borderVertexes[2] = borderVertexes[7] = -borderWidth;
-		borderVertexes[3] = borderVertexes[5] = barHeight + borderWidth;
-		borderVertexes[4] = borderVertexes[6] = barWidth + borderWidth;
+		return width;
 	}
 
 	float ProgressBar::getCurrentValue() const
@@ -124,13 +86,13 @@ namespace engine
 	// Color component - from 0.0f to 1.0f.
 	void ProgressBar::setColor(float r, float g, float b, float a)
 	{
-		fillColorArray(color, 32, r, g, b, a);
+		fillColorArray(color, 4, r, g, b, a);
 	}
 
 	// Color component - from 0.0f to 1.0f.
 	void ProgressBar::setBorderColor(float r, float g, float b, float a)
 	{
-		fillColorArray(borderColor, 32, r, g, b, a);
+		fillColorArray(borderColor, 4, r, g, b, a);
 	}
 
 	void ProgressBar::setPosition(const Point& p)
@@ -32,6 +32,7 @@ namespace engine
 		void setColor(float r, float g, float b, float a);
 		void setBorderColor(float r, float g, float b, float a);
 		virtual void draw(const Rectangle& screen);
+		virtual bool batched() const { return true; }
 		virtual void setPosition(const Point& p);
 		virtual void setPositionInterpretation(Drawable::EPositionRelativeToOption positionInterpretation);
 
@@ -45,12 +46,12 @@ namespace engine
 		
 #if DEBUG // For testing purposes
 		GLvoid* getColor() { return color; }
-		GLvoid* getVertexes() { return vertexes; }
 #endif
 
 	private:
 		void fillColorArray(GLfloat* destColorArray, int destSize, float r, float g, float b, float a);
-		void setVertexes(GLfloat width, GLfloat height);
+		// The filled part, clamping the value to the bar.
+		GLfloat progressWidth();
 
 		float maxValue;
 		float currentValue;
@@ -59,11 +60,8 @@ namespace engine
 		GLfloat barHeight;
 		float scaleFactor;
 
-		GLfloat vertexes[8];
-		GLfloat color[32];
-
-		GLfloat borderVertexes[8];
-		GLfloat borderColor[32];
+		GLfloat color[4];
+		GLfloat borderColor[4];
 		GLfloat borderWidth;
 	};
 
@@ -0,0 +1,528 @@
+// Copyright 2011 Nuffer Brothers Software LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "RenderList.hpp"
+#include "Log.hpp"
+#include "Profiler.hpp"
+#include "VertexBuffer.hpp"
+#include <math.h>
+#include <string.h>
+
+namespace engine
+{
+
+namespace
+{
+	typedef RenderRecorder::Matrix Matrix;
+
+	Matrix identity()
+	{
+		Matrix result;
+		memset(result.m, 0, sizeof(result.m));
+		result.m[0] = result.m[5] = result.m[10] = result.m[15] = 1;
+		return result;
+	}
+
+	// a * b, column major.
+	Matrix product(const Matrix& a, const Matrix& b)
+	{
+		Matrix result;
+		for (int column = 0; column < 4; ++column)
+		{
+			for (int row = 0; row < 4; ++row)
+			{
+				GLfloat sum = 0;
+				for (int k = 0; k < 4; ++k)
+					sum += a.m[k * 4 + row] * b.m[column * 4 + k];
+				result.m[column * 4 + row] = sum;
+			}
+		}
+		return result;
+	}
+
+	// Element i of a client array, stride 0 meaning packed.
+	const GLfloat* element(const gl::ArrayPointer& array, GLint i)
+	{
+		GLsizei stride = array.stride ? array.stride : array.size * sizeof(GLfloat);
+		return reinterpret_cast<const GLfloat*>(static_cast<const char*>(array.pointer) + i * stride);
+	}
+
+	bool recordable(const gl::ArrayPointer& array)
+	{
+		return array.pointer && array.type == GL_FLOAT;
+	}
+
+	// offset floats on from base, which is an offset itself when the data is in a buffer.
+	const GLvoid* at(const GLvoid* base, size_t offset)
+	{
+		return reinterpret_cast<const GLvoid*>(reinterpret_cast<size_t>(base) + offset * sizeof(GLfloat));
+	}
+}
+
+RenderList::RenderList()
+: _clearColor(false)
+{
+	memcpy(_projection, identity().m, sizeof(_projection));
+}
+
+void RenderList::clear()
+{
+	_draws.clear();
+	_data.clear();
+	_clearColor = false;
+}
+
+void RenderList::submit()
+{
+	PROFILE_ZONE("RenderList::submit");
+	using namespace gl;
+	if (!_deletedTextures.empty())
+	{
+		deleteTextures(_deletedTextures.size(), &_deletedTextures[0]);
+		_deletedTextures.clear();
+	}
+	if (!_deletedBuffers.empty())
+	{
+		deleteBuffers(_deletedBuffers.size(), &_deletedBuffers[0]);
+		_deletedBuffers.clear();
+	}
+
+	matrixMode(GL_PROJECTION);
+	loadIdentity();
+	multMatrix(_projection);
+	matrixMode(GL_MODELVIEW);
+	loadIdentity();
+	if (_clearColor)
+		clearColorBuffer();
+	if (_draws.empty())
+		return;
+
+	VertexArrayScope vas;
+	ColorArrayScope cas;
+	TextureCoordArrayScope tcas;
+	const GLvoid* base;
+	GLuint buffer = StreamingVertexBuffer::shared().upload(&_data[0], _data.size(), base);
+	for (std::vector<Draw>::const_iterator draw = _draws.begin(); draw != _draws.end(); ++draw)
+	{
+		if (draw->texture == INVALID_TEXTURE)
+		{
+			disableTexture2D();
+		}
+		else
+		{
+			enableTexture2D();
+			bindTexture2D(draw->texture);
+			bindAlphaTexture2D(draw->alphaTexture);
+			texCoord(2, GL_FLOAT, 0, at(base, draw->texCoords), buffer);
+		}
+		if (draw->blend)
+			enableBlend();
+		else
+			disableBlend();
+		setGLLineWidth(draw->lineWidth);
+		vertex(2, GL_FLOAT, 0, at(base, draw->vertexes), buffer);
+		color(4, GL_FLOAT, 0, at(base, draw->colors), buffer);
+		drawArrays(draw->mode, 0, draw->count);
+	}
+	// Where the rest of the engine expects it.
+	enableBlend();
+}
+
+RenderRecorder::RenderRecorder()
+: _list(NULL)
+, _mode(0)
+, _texture2D(false)
+, _texture(gl::INVALID_TEXTURE)
+, _alphaTexture(gl::INVALID_TEXTURE)
+, _blend(true)
+, _lineWidth(1.0f)
+{
+	_stacks[0].push_back(identity());
+	_stacks[1].push_back(identity());
+}
+
+void RenderRecorder::begin(RenderList& list)
+{
+	list.clear();
+	_list = &list;
+	// Let go of between frames, the next list deletes them.
+	list._deletedTextures.insert(list._deletedTextures.end(), _deletedTextures.begin(), _deletedTextures.end());
+	_deletedTextures.clear();
+	list._deletedBuffers.insert(list._deletedBuffers.end(), _deletedBuffers.begin(), _deletedBuffers.end());
+	_deletedBuffers.clear();
+}
+
+void RenderRecorder::end()
+{
+	memcpy(_list->_projection, _stacks[1].back().m, sizeof(_list->_projection));
+	_list = NULL;
+}
+
+RenderRecorder::Matrix& RenderRecorder::current()
+{
+	return _stacks[_mode].back();
+}
+
+void RenderRecorder::multiply(const Matrix& by)
+{
+	current() = product(current(), by);
+}
+
+void RenderRecorder::unsupported(const char* call)
+{
+	LOGE("%s can't be recorded, only the GL thread can call it", call);
+}
+
+const char* RenderRecorder::glStrError(GLint error)
+{
+	return "";
+}
+
+void RenderRecorder::checkGLError(const char* op)
+{
+	// The GL thread checks when it submits.
+}
+
+void RenderRecorder::setGLLineWidth(GLfloat width)
+{
+	_lineWidth = width;
+}
+
+void RenderRecorder::clearColorBuffer()
+{
+	if (_list)
+		_list->_clearColor = true;
+}
+
+void RenderRecorder::clearDepthBuffer()
+{
+}
+
+void RenderRecorder::clearColorAndDepthBuffer()
+{
+	clearColorBuffer();
+}
+
+void RenderRecorder::loadIdentity()
+{
+	current() = identity();
+}
+
+void RenderRecorder::translate(GLfloat x, GLfloat y, GLfloat z)
+{
+	Matrix by = identity();
+	by.m[12] = x;
+	by.m[13] = y;
+	by.m[14] = z;
+	multiply(by);
+}
+
+void RenderRecorder::rotate(GLfloat angle, GLfloat x, GLfloat y, GLfloat z)
+{
+	GLfloat length = sqrtf(x * x + y * y + z * z);
+	if (length == 0)
+		return;
+	x /= length;
+	y /= length;
+	z /= length;
+	GLfloat radians = angle * M_PI / 180;
+	GLfloat c = cosf(radians);
+	GLfloat s = sinf(radians);
+	GLfloat t = 1 - c;
+	Matrix by = identity();
+	by.m[0] = x * x * t + c;
+	by.m[1] = y * x * t + z * s;
+	by.m[2] = x * z * t - y * s;
+	by.m[4] = x * y * t - z * s;
+	by.m[5] = y * y * t + c;
+	by.m[6] = y * z * t + x * s;
+	by.m[8] = x * z * t + y * s;
+	by.m[9] = y * z * t - x * s;
+	by.m[10] = z * z * t + c;
+	multiply(by);
+}
+
+void RenderRecorder::scale(GLfloat x, GLfloat y, GLfloat z)
+{
+	Matrix by = identity();
+	by.m[0] = x;
+	by.m[5] = y;
+	by.m[10] = z;
+	multiply(by);
+}
+
+void RenderRecorder::vertex(GLint size, GLenum type, GLsizei stride, const GLvoid* pointer)
+{
+	_vertexPointer = gl::ArrayPointer(size, type, stride, pointer);
+}
+
+void RenderRecorder::color(GLint size, GLenum type, GLsizei stride, const GLvoid* pointer)
+{
+	_colorPointer = gl::ArrayPointer(size, type, stride, pointer);
+}
+
+void RenderRecorder::enableTexture2D()
+{
+	_texture2D = true;
+}
+
+void RenderRecorder::disableTexture2D()
+{
+	_texture2D = false;
+	_alphaTexture = gl::INVALID_TEXTURE;
+}
+
+void RenderRecorder::texCoord(GLint size, GLenum type, GLsizei stride, const GLvoid* pointer)
+{
+	_texCoordPointer = gl::ArrayPointer(size, type, stride, pointer);
+}
+
+void RenderRecorder::drawArrays(GLenum mode, GLint first, GLsizei count)
+{
+	if (!_list || count <= 0)
+		return;
+	if (!recordable(_vertexPointer))
+	{
+		unsupported("drawArrays() without GL_FLOAT vertexes");
+		return;
+	}
+	bool textured = _texture2D && recordable(_texCoordPointer);
+
+	RenderList::Draw draw;
+	draw.mode = mode;
+	draw.count = count;
+	draw.texture = textured ? _texture : gl::INVALID_TEXTURE;
+	draw.alphaTexture = textured ? _alphaTexture : gl::INVALID_TEXTURE;
+	draw.blend = _blend;
+	draw.lineWidth = _lineWidth;
+	std::vector<GLfloat>& data = _list->_data;
+	draw.vertexes = data.size();
+	draw.colors = draw.vertexes + 2 * count;
+	draw.texCoords = draw.colors + 4 * count;
+	data.resize(draw.texCoords + (textured ? 2 * count : 0));
+
+	const GLfloat* m = _stacks[0].back().m;
+	GLfloat* out = &data[draw.vertexes];
+	for (GLint i = first; i < first + count; ++i)
+	{
+		const GLfloat* v = element(_vertexPointer, i);
+		GLfloat z = _vertexPointer.size > 2 ? v[2] : 0;
+		*out++ = m[0] * v[0] + m[4] * v[1] + m[8] * z + m[12];
+		*out++ = m[1] * v[0] + m[5] * v[1] + m[9] * z + m[13];
+	}
+	bool colored = recordable(_colorPointer);
+	for (GLint i = first; i < first + count; ++i)
+	{
+		const GLfloat* c = colored ? element(_colorPointer, i) : NULL;
+		for (GLint k = 0; k < 4; ++k)
+			*out++ = c && k < _colorPointer.size ? c[k] : 1.0f;
+	}
+	if (textured)
+	{
+		for (GLint i = first; i < first + count; ++i)
+		{
+			const GLfloat* uv = element(_texCoordPointer, i);
+			*out++ = uv[0];
+			*out++ = uv[1];
+		}
+	}
+	_list->_draws.push_back(draw);
+}
+
+GLuint RenderRecorder::genTexture()
+{
+	unsupported("genTexture()");
+	return gl::INVALID_TEXTURE;
+}
+
+std::string RenderRecorder::getString(GLenum name)
+{
+	unsupported("getString()");
+	return std::string();
+}
+
+std::string RenderRecorder::getVendor()
+{
+	return getString(GL_VENDOR);
+}
+
+std::string RenderRecorder::getRenderer()
+{
+	return getString(GL_RENDERER);
+}
+
+std::string RenderRecorder::getVersion()
+{
+	return getString(GL_VERSION);
+}
+
+std::string RenderRecorder::getExtensions()
+{
+	return getString(GL_EXTENSIONS);
+}
+
+void RenderRecorder::bindTexture2D(GLuint texture)
+{
+	_texture = texture;
+}
+
+void RenderRecorder::bindAlphaTexture2D(GLuint texture)
+{
+	_alphaTexture = texture;
+}
+
+void RenderRecorder::deleteTextures(GLsizei n, const GLuint *textures)
+{
+	// The list being shown may still draw with them.
+	std::vector<GLuint>& deleted = _list ? _list->_deletedTextures : _deletedTextures;
+	deleted.insert(deleted.end(), textures, textures + n);
+}
+
+void RenderRecorder::texImage2D(GLsizei width, GLsizei height, GLvoid* imageData)
+{
+	unsupported("texImage2D()");
+}
+
+void RenderRecorder::texImage2D(GLenum format, GLenum type, GLsizei width, GLsizei height, const GLvoid* imageData)
+{
+	unsupported("texImage2D()");
+}
+
+void RenderRecorder::texParameter(GLenum pname, GLint param)
+{
+	unsupported("texParameter()");
+}
+
+void RenderRecorder::compressedTexImage2D(GLenum internalFormat, GLsizei width, GLsizei height, GLsizei imageSize, const GLvoid* data)
+{
+	unsupported("compressedTexImage2D()");
+}
+
+void RenderRecorder::matrixMode(GLenum mode)
+{
+	_mode = mode == GL_PROJECTION ? 1 : 0;
+}
+
+void RenderRecorder::ortho(GLfloat left, GLfloat right, GLfloat bottom, GLfloat top, GLfloat zNear, GLfloat zFar)
+{
+	Matrix by = identity();
+	by.m[0] = 2 / (right - left);
+	by.m[5] = 2 / (top - bottom);
+	by.m[10] = -2 / (zFar - zNear);
+	by.m[12] = -(right + left) / (right - left);
+	by.m[13] = -(top + bottom) / (top - bottom);
+	by.m[14] = -(zFar + zNear) / (zFar - zNear);
+	multiply(by);
+}
+
+void RenderRecorder::multMatrix(const GLfloat* m)
+{
+	Matrix by;
+	memcpy(by.m, m, sizeof(by.m));
+	multiply(by);
+}
+
+void RenderRecorder::enableBlend()
+{
+	_blend = true;
+}
+
+void RenderRecorder::disableBlend()
+{
+	_blend = false;
+}
+
+void RenderRecorder::blendFunc(GLenum sfactor, GLenum dfactor)
+{
+	unsupported("blendFunc()");
+}
+
+GLuint RenderRecorder::genBuffer()
+{
+	unsupported("genBuffer()");
+	return 0;
+}
+
+void RenderRecorder::deleteBuffers(GLsizei n, const GLuint* buffers)
+{
+	std::vector<GLuint>& deleted = _list ? _list->_deletedBuffers : _deletedBuffers;
+	deleted.insert(deleted.end(), buffers, buffers + n);
+}
+
+void RenderRecorder::bindArrayBuffer(GLuint buffer)
+{
+	if (buffer != 0)
+		unsupported("bindArrayBuffer()");
+}
+
+void RenderRecorder::bufferData(GLsizeiptr size, const GLvoid* data, GLenum usage)
+{
+	unsupported("bufferData()");
+}
+
+void RenderRecorder::bufferSubData(GLintptr offset, GLsizeiptr size, const GLvoid* data)
+{
+	unsupported("bufferSubData()");
+}
+
+void RenderRecorder::MatrixScope()
+{
+	_stacks[_mode].push_back(identity());
+}
+
+void RenderRecorder::DestMatrixScope()
+{
+	if (_stacks[_mode].size() > 1)
+		_stacks[_mode].pop_back();
+}
+
+void RenderRecorder::PushMatrixScope()
+{
+	Matrix top = current();
+	_stacks[_mode].push_back(top);
+}
+
+void RenderRecorder::DestPushMatrixScope()
+{
+	DestMatrixScope();
+}
+
+// The submitting thread enables every array it needs.
+void RenderRecorder::ColorArrayScope() {}
+void RenderRecorder::DestColorArrayScope() {}
+void RenderRecorder::VertexArrayScope() {}
+void RenderRecorder::DestVertexArrayScope() {}
+void RenderRecorder::TextureCoordArrayScope() {}
+void RenderRecorder::DestTextureCoordArrayScope() {}
+
+void RenderRecorder::CullFaceScope(GLenum mode)
+{
+	unsupported("CullFaceScope");
+}
+
+void RenderRecorder::DestCullFaceScope()
+{
+}
+
+void RenderRecorder::Texture2DScope()
+{
+	enableTexture2D();
+}
+
+void RenderRecorder::DestTexture2DScope()
+{
+	disableTexture2D();
+}
+
+}
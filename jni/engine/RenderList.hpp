@@ -0,0 +1,176 @@
+// Copyright 2011 Nuffer Brothers Software LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef engine_RenderList_HPP_INCLUDED
+#define engine_RenderList_HPP_INCLUDED
+
+#include "EngineConfig.hpp"
+#include "GL.hpp"
+#include "GLMock.hpp"
+#include <vector>
+
+namespace engine
+{
+
+/**
+ * One frame's draws as a RenderRecorder took them down, so a thread other than the GL
+ * thread can build a frame that the GL thread draws later. Every draw has its vertexes
+ * already moved by the modelview matrix, its colors, and its texture coordinates if
+ * it has a texture, all in one array that submit() hands GL in a single upload.
+ */
+class RenderList
+{
+public:
+	RenderList();
+
+	void clear();
+	size_t drawCount() const { return _draws.size(); }
+	bool clearsColor() const { return _clearColor; }
+	// What the list holds for the vertexes, colors and texture coordinates of draws.
+	const std::vector<GLfloat>& data() const { return _data; }
+
+	// GL thread only. Draws the frame, and deletes what the recording thread let go of.
+	// It can be drawn again, the deletes only happen once.
+	void submit();
+
+	struct Draw
+	{
+		GLenum mode;
+		GLsizei count;
+		// gl::INVALID_TEXTURE when drawn without texturing.
+		GLuint texture;
+		// gl::INVALID_TEXTURE unless the alpha comes from one, see gl::bindAlphaTexture2D().
+		GLuint alphaTexture;
+		bool blend;
+		GLfloat lineWidth;
+		// Into data(), two floats a vertex, four a color, two a texture coordinate.
+		size_t vertexes;
+		size_t colors;
+		size_t texCoords;
+	};
+	const Draw& draw(size_t i) const { return _draws[i]; }
+
+private:
+	friend class RenderRecorder;
+
+	std::vector<Draw> _draws;
+	std::vector<GLfloat> _data;
+	GLfloat _projection[16];
+	bool _clearColor;
+	std::vector<GLuint> _deletedTextures;
+	std::vector<GLuint> _deletedBuffers;
+};
+
+/**
+ * The GLMock a thread records with, see gl::setThreadRecorder(). It keeps the matrixes
+ * and the state the draws depend on the way GL would, and drawArrays() copies what is
+ * drawn into the RenderList between begin() and end(). Nothing can be made in GL from
+ * a recording thread, genTexture() and the like fail. What it deletes, between frames
+ * too, the next list it records deletes when submitted.
+ *
+ * The engine draws flat: only GL_FLOAT arrays, two coordinates a vertex, are recorded.
+ */
+class RenderRecorder : public gl::GLMock
+{
+public:
+	RenderRecorder();
+
+	void begin(RenderList& list);
+	void end();
+
+	virtual const char* glStrError(GLint error);
+	virtual void checkGLError(const char* op);
+	virtual void setGLLineWidth(GLfloat width);
+	virtual void clearColorBuffer();
+	virtual void clearDepthBuffer();
+	virtual void clearColorAndDepthBuffer();
+	virtual void loadIdentity();
+	virtual void translate(GLfloat x, GLfloat y, GLfloat z);
+	virtual void rotate(GLfloat angle, GLfloat x, GLfloat y, GLfloat z);
+	virtual void scale(GLfloat x, GLfloat y, GLfloat z);
+	virtual void vertex(GLint size, GLenum type, GLsizei stride, const GLvoid* pointer);
+	virtual void color(GLint size, GLenum type, GLsizei stride, const GLvoid* pointer);
+	virtual void enableTexture2D();
+	virtual void disableTexture2D();
+	virtual void texCoord(GLint size, GLenum type, GLsizei stride, const GLvoid* pointer);
+	virtual void drawArrays(GLenum mode, GLint first, GLsizei count);
+	virtual GLuint genTexture();
+	virtual std::string getString(GLenum name);
+	virtual std::string getVendor();
+	virtual std::string getRenderer();
+	virtual std::string getVersion();
+	virtual std::string getExtensions();
+	virtual void bindTexture2D(GLuint texture);
+	virtual void bindAlphaTexture2D(GLuint texture);
+	virtual void deleteTextures(GLsizei n, const GLuint *textures);
+	virtual void texImage2D(GLsizei width, GLsizei height, GLvoid* imageData);
+	virtual void texImage2D(GLenum format, GLenum type, GLsizei width, GLsizei height, const GLvoid* imageData);
+	virtual void texParameter(GLenum pname, GLint param);
+	virtual void compressedTexImage2D(GLenum internalFormat, GLsizei width, GLsizei height, GLsizei imageSize, const GLvoid* data);
+	virtual void matrixMode(GLenum mode);
+	virtual void ortho(GLfloat left, GLfloat right, GLfloat bottom, GLfloat top, GLfloat zNear, GLfloat zFar);
+	virtual void multMatrix(const GLfloat* m);
+	virtual void enableBlend();
+	virtual void disableBlend();
+	virtual void blendFunc(GLenum sfactor, GLenum dfactor);
+	virtual GLuint genBuffer();
+	virtual void deleteBuffers(GLsizei n, const GLuint* buffers);
+	virtual void bindArrayBuffer(GLuint buffer);
+	virtual void bufferData(GLsizeiptr size, const GLvoid* data, GLenum usage);
+	virtual void bufferSubData(GLintptr offset, GLsizeiptr size, const GLvoid* data);
+	virtual void MatrixScope();
+	virtual void DestMatrixScope();
+	virtual void PushMatrixScope();
+	virtual void DestPushMatrixScope();
+	virtual void ColorArrayScope();
+	virtual void DestColorArrayScope();
+	virtual void CullFaceScope(GLenum mode);
+	virtual void DestCullFaceScope();
+	virtual void VertexArrayScope();
+	virtual void DestVertexArrayScope();
+	virtual void TextureCoordArrayScope();
+	virtual void DestTextureCoordArrayScope();
+	virtual void Texture2DScope();
+	virtual void DestTexture2DScope();
+
+	struct Matrix
+	{
+		GLfloat m[16];
+	};
+
+private:
+	Matrix& current();
+	void multiply(const Matrix& by);
+	void unsupported(const char* call);
+
+	RenderList* _list;
+	// Column major, as GL keeps them. [0] the modelview stack, [1] the projection's.
+	std::vector<Matrix> _stacks[2];
+	unsigned _mode;
+	bool _texture2D;
+	GLuint _texture;
+	GLuint _alphaTexture;
+	bool _blend;
+	GLfloat _lineWidth;
+	gl::ArrayPointer _vertexPointer;
+	gl::ArrayPointer _colorPointer;
+	gl::ArrayPointer _texCoordPointer;
+	// Deleted outside begin() and end(), for the next list to delete.
+	std::vector<GLuint> _deletedTextures;
+	std::vector<GLuint> _deletedBuffers;
+};
+
+}
+
+#endif
@@ -0,0 +1,124 @@
+// Copyright 2011 Nuffer Brothers Software LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ResourceStream.hpp"
+#if TARGET_OS_IPHONE != 1
+#include "libzip/zip.h"
+#endif
+#include "Log.hpp"
+
+namespace engine
+{
+
+ResourceStream::ResourceStream(const std::string& path, const std::string& filename)
+	: _path(path)
+	, _filename(filename)
+	, _size(0)
+#if TARGET_OS_IPHONE != 1
+	, _archive(NULL)
+#endif
+	, _file(NULL)
+{
+#if TARGET_OS_IPHONE != 1
+	// Not the archive Resources uses, libzip handles can't be shared between threads.
+	_archive = zip_open(_path.c_str(), 0, NULL);
+	if (!_archive)
+	{
+		LOGE("Error opening APK %s to stream %s", _path.c_str(), _filename.c_str());
+		return;
+	}
+#endif
+	open();
+}
+
+ResourceStream::~ResourceStream()
+{
+	close();
+#if TARGET_OS_IPHONE != 1
+	if (_archive)
+		zip_close(_archive);
+#endif
+}
+
+bool ResourceStream::isOpen() const
+{
+	return _file != NULL;
+}
+
+size_t ResourceStream::read(void* buffer, size_t size)
+{
+	if (!_file)
+		return 0;
+#if TARGET_OS_IPHONE != 1
+	int got = zip_fread(_file, buffer, size);
+	if (got < 0)
+	{
+		LOGE("Error reading %s from APK: %s", _filename.c_str(), zip_file_strerror(_file));
+		return 0;
+	}
+	return got;
+#else
+	return fread(buffer, 1, size, _file);
+#endif
+}
+
+bool ResourceStream::rewind()
+{
+	// Deflated entries can't seek, so open the entry again.
+	close();
+	open();
+	return isOpen();
+}
+
+void ResourceStream::open()
+{
+#if TARGET_OS_IPHONE != 1
+	if (!_archive)
+		return;
+	_file = zip_fopen(_archive, _filename.c_str(), 0);
+	if (!_file)
+	{
+		LOGE("Error opening %s from APK: %s", _filename.c_str(), zip_strerror(_archive));
+		return;
+	}
+	struct zip_stat fileStat;
+	zip_stat_init(&fileStat);
+	if (zip_stat(_archive, _filename.c_str(), 0, &fileStat) == 0)
+		_size = fileStat.size;
+#else
+	_file = fopen(_path.c_str(), "rb");
+	if (!_file)
+	{
+		LOGE("Error opening %s", _path.c_str());
+		return;
+	}
+	fseek(_file, 0, SEEK_END);
+	_size = ftell(_file);
+	fseek(_file, 0, SEEK_SET);
+#endif
+}
+
+void ResourceStream::close()
+{
+	if (!_file)
+		return;
+#if TARGET_OS_IPHONE != 1
+	zip_fclose(_file);
+#else
+	fclose(_file);
+#endif
+	_file = NULL;
+}
+
+}
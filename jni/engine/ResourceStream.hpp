@@ -0,0 +1,69 @@
+// Copyright 2011 Nuffer Brothers Software LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef engine_ResourceStream_hpp_INCLUDED_
+#define engine_ResourceStream_hpp_INCLUDED_
+
+#include "EngineConfig.hpp"
+#include "miniblocxx/IntrusiveCountableBase.hpp"
+#include <stdio.h>
+#include <string>
+
+#if TARGET_OS_IPHONE != 1
+struct zip;
+struct zip_file;
+#endif
+
+namespace engine
+{
+
+// Reads one file of the APK a piece at a time instead of all at once like Resource.
+// Each stream has a handle on the APK of its own, so it can be read on any thread,
+// but only one thread may use a stream at a time.
+class ResourceStream : public IntrusiveCountableBase
+{
+public:
+	// path is the APK (or on iOS, the file itself), filename the entry in it.
+	ResourceStream(const std::string& path, const std::string& filename);
+	~ResourceStream();
+
+	// False if the file couldn't be opened, reading it then always returns 0.
+	bool isOpen() const;
+	// The whole file's size in bytes, however much of it has been read.
+	size_t size() const { return _size; }
+	// Reads up to size bytes. Returns how many were read, 0 at the end of the file or on error.
+	size_t read(void* buffer, size_t size);
+	// Starts over from the beginning of the file.
+	bool rewind();
+
+	const std::string& name() const { return _filename; }
+
+private:
+	void open();
+	void close();
+
+	std::string _path;
+	std::string _filename;
+	size_t _size;
+#if TARGET_OS_IPHONE != 1
+	zip* _archive;
+	zip_file* _file;
+#else
+	FILE* _file;
+#endif
+};
+
+}
+
+#endif
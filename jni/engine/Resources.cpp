@@ -24,6 +24,7 @@
 #include "Log.hpp"
 #include <stdlib.h>
 #include "Resource.hpp"
+#include "ResourceStream.hpp"
 #include "miniblocxx/ScopeGuard.hpp"
 #include "miniblocxx/Format.hpp"
 #include <string>
@@ -43,6 +44,7 @@ namespace
 {
 #if TARGET_OS_IPHONE != 1
 zip* archive;
+std::string archivePath;
 #endif
 }
 
@@ -50,6 +52,7 @@ void init(const char* rootPath)
 {
 #if TARGET_OS_IPHONE != 1
 	LOGI("Loading APK %s", rootPath);
+	archivePath = rootPath;
 	archive = zip_open(rootPath, 0, NULL);
 	if (archive == NULL) {
 		LOGE("Error loading APK");
@@ -135,6 +138,23 @@ ResourcePtr loadResourceFromAssets(const char* filename)
 	return loadResource(filename);
 }
 
+ResourceStreamPtr openResourceStreamFromAssets(const char* filename)
+{
+	std::string name(filename);
+	if( name.find("assets/") != 0 )
+	{
+		name = "assets/" + name;
+	}
+#if TARGET_OS_IPHONE != 1
+	ResourceStreamPtr stream = new ResourceStream(archivePath, name);
+#else
+	ResourceStreamPtr stream = new ResourceStream(CCFileUtils::fullPathFromRelativePath(name.c_str()), name);
+#endif
+	if (!stream->isOpen())
+		return NULL;
+	return stream;
+}
+
 // Filename will be looked up in the apk (should start with assets/ or res/
 // returns 0 on error and the gl texture id on success.
 GLuint loadTextureFromPNG(const char* filename, int& width, int& height)
@@ -37,6 +37,8 @@ StringArray listResources();
 ResourcePtr loadResource(const char* filename);
 // loads from assets/ on Android
 ResourcePtr loadResourceFromAssets(const char* filename);
+// Like loadResourceFromAssets(), but for reading a large file a piece at a time on any thread.
+ResourceStreamPtr openResourceStreamFromAssets(const char* filename);
 
 
 // Filename will be looked up in the apk (should start with assets/ or res/
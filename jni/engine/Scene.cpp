@@ -16,6 +16,9 @@
 #include "Scene.hpp"
 #include "Collidable.hpp"
 #include "Collider.hpp"
+#include "GL.hpp"
+#include "PrimitiveBatch.hpp"
+#include "Profiler.hpp"
 #include "boost/foreach.hpp"
 #define foreach BOOST_FOREACH
 #include <algorithm> // for remove
@@ -37,6 +40,29 @@ namespace engine
 			DrawableEquals(const DrawablePtr& d) : drawable(d) {}
 			bool operator()(const Scene::ChildInfo& x) { return x.drawable == drawable; }
 		};
+
+		struct CompareBottom
+		{
+			bool operator()(const Rectangle& x, const Rectangle& y) { return x.bottom < y.bottom; }
+		};
+
+		// Whether areas leave none of screen uncovered. Only areas as wide as the screen count,
+		// stacked like the sections of a track, that's enough for backgrounds. Seams that don't
+		// meet exactly count as gaps, a clear too many is only slower.
+		bool covered(const Rectangle& screen, std::vector<Rectangle>& areas)
+		{
+			std::sort(areas.begin(), areas.end(), CompareBottom());
+			float coveredTo = screen.bottom;
+			foreach (const Rectangle& area, areas)
+			{
+				if (area.left > screen.left || area.right < screen.right)
+					continue;
+				if (area.bottom > coveredTo)
+					break;
+				coveredTo = std::max(coveredTo, area.top);
+			}
+			return coveredTo >= screen.top;
+		}
 	}
 	
 	Scene::~Scene()
@@ -80,6 +106,7 @@ namespace engine
 	
 	void Scene::update(const DateTime& thisFrameStartTime, const TimeDuration& deltaTime)
 	{
+		PROFILE_ZONE("Scene::update");
 		Drawable::update(thisFrameStartTime, deltaTime);
 		
 		// make a copy so that children objects can change the children in update()
@@ -93,10 +120,55 @@ namespace engine
 		doCollisionChecks(collidableChildren, thisFrameStartTime, deltaTime);
 	}
 	
+	size_t Scene::opaqueChildren(const Rectangle& screen)
+	{
+		opaqueAreas.clear();
+		Rectangle area(0, 0, 0, 0);
+		size_t count = 0;
+		while (count < children.size() && children[count].drawable->opaqueArea(screen, area))
+		{
+			opaqueAreas.push_back(area);
+			++count;
+		}
+		return count;
+	}
+
+	bool Scene::opaqueArea(const Rectangle& screen, Rectangle& area)
+	{
+		opaqueChildren(screen);
+		if (!covered(screen, opaqueAreas))
+			return false;
+		area = screen;
+		return true;
+	}
+
 	void Scene::draw(const Rectangle& screen)
 	{
-		foreach (ChildInfo& ci, children)
-			ci.drawable->draw(screen);
+		PROFILE_ZONE("Scene::draw");
+		// Nothing under an opaque child shows through, blending it would only cost fill rate.
+		// Only those before any other child can be drawn without blending, without a depth
+		// buffer, drawing order is what keeps what's in front in front.
+		size_t opaque = opaqueChildren(screen);
+		// Runs of batched children are drawn together, when something else comes along.
+		PrimitiveBatch& primitives = PrimitiveBatch::shared();
+		for (size_t i = 0; i < children.size(); ++i)
+		{
+			const DrawablePtr& drawable(children[i].drawable);
+			if (!drawable->batched())
+				primitives.flush();
+			if (i < opaque)
+				gl::disableBlend();
+			else
+				gl::enableBlend();
+			drawable->draw(screen);
+			if (!drawable->attachedChildren().empty())
+			{
+				gl::enableBlend();
+				drawable->drawAttachedChildren(screen);
+			}
+		}
+		primitives.flush();
+		gl::enableBlend();
 	}
 	
 	void Scene::handleTouchEvent(const TouchEvent& touchEvent)
@@ -44,6 +44,8 @@ public:
 	std::vector<CollidablePtr> getCollidableChildren() { return collidableChildren; }
 
 	// children are drawn lowest z-order first. children with the same z-order are drawn in order of addition.
+	// drawables attached to a child (Drawable::attachChild) are drawn right after it.
+	// the opaque children (Drawable::opaqueArea) that come before any other are drawn with blending off.
 	Scene& addChild(const DrawablePtr& child, int zOrder = 0);
 	Scene& removeChild(const DrawablePtr& child);
 	Scene& removeAllChildren();
@@ -52,11 +54,16 @@ public:
 	virtual void update(const DateTime& thisFrameStartTime, const TimeDuration& deltaTime);
 	virtual void handleCollisions(const DateTime& thisFrameStartTime, const TimeDuration& deltaTime);
 	virtual void draw(const Rectangle& screen);
+	// The whole screen, when the opaque children drawn first cover it.
+	virtual bool opaqueArea(const Rectangle& screen, Rectangle& area);
 	virtual void handleTouchEvent(const TouchEvent& touchEvent);
 	virtual void handleActivated();
 	
 private:
+	size_t opaqueChildren(const Rectangle& screen);
+
 	std::vector<ChildInfo> children;
+	std::vector<Rectangle> opaqueAreas;
 	std::vector<CollidablePtr> collidableChildren;
 };
 
@@ -13,112 +13,96 @@
 // limitations under the License.
 
 #include "Sound.hpp"
+#include "SoundAsset.hpp"
 #include "Log.hpp"
-#include "openal/include/AL/al.h"
-#include "openal/include/AL/alc.h"
-#include "openal/include/AL/alext.h"
-#include <string.h>
 
 namespace engine{
 
-	typedef struct{
-	 char  riff[4];//'RIFF'
-		 unsigned int riffSize;
-		 char  wave[4];//'WAVE'
-		 char  fmt[4];//'fmt '
-		 unsigned int fmtSize;
-		 unsigned short format;
-		 unsigned short channels;
-		 unsigned int samplesPerSec;
-		 unsigned int bytesPerSec;
-		 unsigned short blockAlign;
-		 unsigned short bitsPerSample;
-		 unsigned short byteExtraData;
-		 unsigned short extraData;
-		 char fact[4]; //'fact'
-		 unsigned int subChunk2Size;
-		 unsigned int numOfSamples;
-		 char  data[4];//'data'
-		 unsigned int dataSize;
-	  }BasicIMAWAVEHeader;
-
-
-Sound::Sound(const ResourcePtr& resource, ELoopingOption loopingOption, float gainAdjustmentFactor) 
-: _gainAdjustmentFactor(gainAdjustmentFactor)
+Sound::Sound(VoicePool& voices, const ResourcePtr& resource, ELoopingOption loopingOption, float gainAdjustmentFactor, int priority)
+: _voices(voices)
+, _asset(new SoundAsset(resource))
+, _loopingOption(loopingOption)
+, _priority(priority)
+, _gain(1.0)
+, _gainAdjustmentFactor(gainAdjustmentFactor)
 {
-	BasicIMAWAVEHeader header;
-	const char* data = (const char*)&*resource->begin();
-	memcpy(&header, data, sizeof(header));
-	LOGE("samplseParSec %d", header.samplesPerSec);
-	LOGE("blockSize %d", header.blockAlign);
-	LOGE("samplesPerBlock %d", header.extraData);
-	if (strcmp(header.riff, "RIFF"))
-	{
-		ALuint format = 0;
-		switch (header.bitsPerSample)
-		{
-			case 4:
-				format = AL_FORMAT_MONO_IMA4;
-				break;
-			default:
-				LOGE("Unknown wav format");
-				abort();
-				break;
-		}
-		if(format != 0)
-		{
-			alGenSources(1, &source);
-            alErrorCheck();
-			alGenBuffers(1, &buffer);
-            alErrorCheck();
-			alBufferData(buffer,format,data+sizeof(header),header.dataSize,header.samplesPerSec);
-            alErrorCheck();
-			alSourcei(source, AL_BUFFER, buffer);
-            alErrorCheck();
+}
 
-			if (loopingOption == E_LOOP)
-				alSourcei(source, AL_LOOPING, AL_TRUE);
-		}
-	}
-    else
-    {
-        LOGE("Couldn't play sound, header.riff is %s",header.riff);
-    }
+Sound::Sound(VoicePool& voices, const SoundAssetPtr& asset, ELoopingOption loopingOption, float gainAdjustmentFactor, int priority)
+: _voices(voices)
+, _asset(asset)
+, _loopingOption(loopingOption)
+, _priority(priority)
+, _gain(1.0)
+, _gainAdjustmentFactor(gainAdjustmentFactor)
+{
 }
 
 Sound::~Sound()
 {
-	alDeleteSources(1, &source);
-	alDeleteBuffers(1, &buffer);
+	stop();
 }
 
 void Sound::play()
 {
-    ALint state = 0;
-    alGetSourcei(source, AL_SOURCE_STATE, &state);
-    if (state != AL_PLAYING)
-        alSourcePlay(source);
-    alErrorCheck();
+	play(_priority);
+}
+
+void Sound::play(int priority)
+{
+	startVoice(priority, NULL);
+}
+
+void Sound::playAt(const Point& position)
+{
+	startVoice(_priority, &position);
 }
-	
+
 void Sound::stop()
 {
-	alSourceStop(source);
-	alErrorCheck();
+	for (size_t i = 0; i < _playing.size(); ++i)
+	{
+		_voices.stop(_playing[i]);
+	}
+	_playing.clear();
 }
 
 void Sound::setGain(float gain)
 {
-	alSourcef(source, AL_GAIN, gain*_gainAdjustmentFactor);
-    alErrorCheck();
+	_gain = gain;
+	for (size_t i = 0; i < _playing.size(); ++i)
+	{
+		_voices.setGain(_playing[i], effectiveGain());
+	}
 }
-    
-void Sound::alErrorCheck()
+
+bool Sound::startVoice(int priority, const Point* position)
 {
-    ALenum problem;
-    if((problem = alGetError()) != AL_NO_ERROR)
-        LOGE("openAL detected an error: %d",problem);
-}
+	// Forget plays that have finished or lost their voice.
+	for (size_t i = 0; i < _playing.size(); )
+	{
+		if (_voices.isPlaying(_playing[i]))
+		{
+			++i;
+		}
+		else
+		{
+			_playing[i] = _playing.back();
+			_playing.pop_back();
+		}
+	}
+
+	bool loop = _loopingOption == E_LOOP;
+	if (loop && !_playing.empty())
+		return true;
 
+	VoicePool::VoiceHandle handle;
+	bool started = position ?
+		_voices.playAt(_asset, priority, effectiveGain(), loop, *position, handle) :
+		_voices.play(_asset, priority, effectiveGain(), loop, handle);
+	if (started)
+		_playing.push_back(handle);
+	return started;
 }
 
+}
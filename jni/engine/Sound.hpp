@@ -18,15 +18,15 @@
 #include "EngineConfig.hpp"
 #include "EngineFwd.hpp"
 #include "Resource.hpp"
-#ifdef __APPLE__
-#include <OpenAL/al.h>
-#else
-#include "openal/include/AL/al.h"
-#endif
+#include "VoicePool.hpp"
+#include "Point.hpp"
+#include <vector>
 
 
 namespace engine
 {
+    // A sound effect or music track as the game uses it. Every play() gets a voice of its
+    // own from the VoicePool, so the same Sound can be heard several times at once.
     class Sound : public IntrusiveCountableBase
     {
     public:
@@ -36,20 +36,41 @@ namespace engine
             E_PLAY_ONCE
         };
 
-        Sound(const ResourcePtr& data, ELoopingOption loopingOption, float gainAdjustmentFactor = 1.0);
+        // Higher priorities take voices from lower ones when all voices are busy.
+        enum EPriority
+        {
+            E_PRIORITY_LOW = 0,
+            E_PRIORITY_NORMAL = 10,
+            E_PRIORITY_HIGH = 20,
+            E_PRIORITY_MUSIC = 30
+        };
+
+        Sound(VoicePool& voices, const ResourcePtr& data, ELoopingOption loopingOption, float gainAdjustmentFactor = 1.0,
+              int priority = E_PRIORITY_NORMAL);
+        // For an asset already loaded, by a SoundBank for instance.
+        Sound(VoicePool& voices, const SoundAssetPtr& asset, ELoopingOption loopingOption, float gainAdjustmentFactor = 1.0,
+              int priority = E_PRIORITY_NORMAL);
         ~Sound();
+        // A looping sound that is already playing isn't started again.
     	void play();
+    	void play(int priority);
+        // Like play(), but dropped if position is out of earshot of the pool's listener.
+        void playAt(const Point& position);
 		void stop();
         void setGain(float gain);
 
     private:
+        bool startVoice(int priority, const Point* position);
+        float effectiveGain() const { return _gain * _gainAdjustmentFactor; }
 
-    	ALuint source;
-    	ALuint buffer;
+        VoicePool& _voices;
+        SoundAssetPtr _asset;
+        ELoopingOption _loopingOption;
+        int _priority;
+        std::vector<VoicePool::VoiceHandle> _playing; // plays that may still be on a voice
     	
+        float _gain;
     	float _gainAdjustmentFactor;
-        
-        void alErrorCheck();
     };
 }
 #endif
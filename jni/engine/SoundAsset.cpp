@@ -0,0 +1,67 @@
+// Copyright 2011 Nuffer Brothers Software LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "SoundAsset.hpp"
+#include "Log.hpp"
+#include "openal/include/AL/al.h"
+#include "openal/include/AL/alc.h"
+#include "openal/include/AL/alext.h"
+#include <string.h>
+
+namespace engine{
+
+SoundAsset::SoundAsset(const ResourcePtr& resource)
+: _buffer(0)
+{
+	BasicIMAWAVEHeader header;
+	const char* data = (const char*)&*resource->begin();
+	memcpy(&header, data, sizeof(header));
+	LOGE("samplseParSec %d", header.samplesPerSec);
+	LOGE("blockSize %d", header.blockAlign);
+	LOGE("samplesPerBlock %d", header.extraData);
+	if (strcmp(header.riff, "RIFF"))
+	{
+		ALuint format = 0;
+		switch (header.bitsPerSample)
+		{
+			case 4:
+				format = AL_FORMAT_MONO_IMA4;
+				break;
+			default:
+				LOGE("Unknown wav format");
+				abort();
+				break;
+		}
+		if(format != 0)
+		{
+			alGenBuffers(1, &_buffer);
+			alBufferData(_buffer,format,data+sizeof(header),header.dataSize,header.samplesPerSec);
+			ALenum problem;
+			if((problem = alGetError()) != AL_NO_ERROR)
+				LOGE("openAL detected an error: %d",problem);
+		}
+	}
+    else
+    {
+        LOGE("Couldn't load sound, header.riff is %s",header.riff);
+    }
+}
+
+SoundAsset::~SoundAsset()
+{
+	if (_buffer != 0)
+		alDeleteBuffers(1, &_buffer);
+}
+
+}
@@ -0,0 +1,68 @@
+// Copyright 2011 Nuffer Brothers Software LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef engine_SoundAsset_HPP_INCLUDED
+#define engine_SoundAsset_HPP_INCLUDED
+
+#include "EngineConfig.hpp"
+#include "EngineFwd.hpp"
+#include "Resource.hpp"
+#ifdef __APPLE__
+#include <OpenAL/al.h>
+#else
+#include "openal/include/AL/al.h"
+#endif
+
+
+namespace engine
+{
+	// The header of the IMA ADPCM wave files the game ships, the sample data follows it.
+	typedef struct{
+	 char  riff[4];//'RIFF'
+		 unsigned int riffSize;
+		 char  wave[4];//'WAVE'
+		 char  fmt[4];//'fmt '
+		 unsigned int fmtSize;
+		 unsigned short format;
+		 unsigned short channels;
+		 unsigned int samplesPerSec;
+		 unsigned int bytesPerSec;
+		 unsigned short blockAlign;
+		 unsigned short bitsPerSample;
+		 unsigned short byteExtraData;
+		 unsigned short extraData;
+		 char fact[4]; //'fact'
+		 unsigned int subChunk2Size;
+		 unsigned int numOfSamples;
+		 char  data[4];//'data'
+		 unsigned int dataSize;
+	  }BasicIMAWAVEHeader;
+
+    // The decoded sample data of one sound file in an OpenAL buffer. Never changes once
+    // loaded, so any number of voices may play it at the same time.
+    class SoundAsset : public IntrusiveCountableBase
+    {
+    public:
+        explicit SoundAsset(const ResourcePtr& data);
+        ~SoundAsset();
+
+        ALuint buffer() const { return _buffer; }
+        // False if the data couldn't be loaded, playing it does nothing.
+        bool isValid() const { return _buffer != 0; }
+
+    private:
+        ALuint _buffer;
+    };
+}
+#endif
@@ -0,0 +1,214 @@
+// Copyright 2011 Nuffer Brothers Software LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "SoundBank.hpp"
+#include "Log.hpp"
+#include "Profiler.hpp"
+#include "Resource.hpp"
+#include "Resources.hpp"
+#include "ResourceStream.hpp"
+#include "SoundAsset.hpp"
+#include <algorithm>
+#include <time.h>
+
+namespace engine{
+
+namespace
+{
+	unsigned long long nowNs()
+	{
+		timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return ts.tv_sec * 1000000000ull + ts.tv_nsec;
+	}
+
+	// Resources::loadResourceFromAssets() shares one zip handle with the loading thread,
+	// a stream has one of its own.
+	ResourcePtr readWhole(const std::string& filename)
+	{
+		ResourceStreamPtr stream = Resources::openResourceStreamFromAssets(filename.c_str());
+		if (!stream || stream->size() == 0)
+			return NULL;
+		Array<UInt8> data(stream->size());
+		size_t got = 0;
+		while (got < data.size())
+		{
+			size_t n = stream->read(&data[got], data.size() - got);
+			if (n == 0)
+				return NULL;
+			got += n;
+		}
+		return new Resource(data, stream->name());
+	}
+}
+
+SoundBank::SoundBank()
+: _started(false)
+, _nextFile(0)
+, _collected(0)
+{
+	pthread_mutex_init(&_mutex, NULL);
+	pthread_cond_init(&_completed, NULL);
+}
+
+SoundBank::~SoundBank()
+{
+	// Leave the workers nothing more to take.
+	pthread_mutex_lock(&_mutex);
+	_nextFile = _filenames.size();
+	pthread_mutex_unlock(&_mutex);
+	joinWorkers();
+	pthread_cond_destroy(&_completed);
+	pthread_mutex_destroy(&_mutex);
+}
+
+void SoundBank::add(const std::string& filename)
+{
+	LOGASSERT(!_started, "SoundBank: %s added after start()", filename.c_str());
+	_filenames.push_back(filename);
+	_assets.push_back(NULL);
+}
+
+void SoundBank::start(size_t workerCount)
+{
+	if (_started)
+		return;
+	_started = true;
+
+	workerCount = std::min(workerCount, _filenames.size());
+	for (size_t i = 0; i < workerCount; ++i)
+	{
+		pthread_t worker;
+		if (pthread_create(&worker, NULL, workerMain, this) != 0)
+		{
+			// finish() loads whatever the workers don't.
+			LOGE("SoundBank: failed to start worker %u, continuing with %u", (unsigned)i, (unsigned)_workers.size());
+			break;
+		}
+		_workers.push_back(worker);
+	}
+}
+
+void SoundBank::finish(const ProgressFunction& progress)
+{
+	start();
+
+	while (true)
+	{
+		size_t index;
+		if (takeFile(index))
+			load(index);
+
+		pthread_mutex_lock(&_mutex);
+		// Only wait when there is nothing left to take, otherwise help the workers.
+		while (_completions.empty() && _collected < _filenames.size() && _nextFile == _filenames.size())
+		{
+			pthread_cond_wait(&_completed, &_mutex);
+		}
+		std::deque<Completion> ready;
+		ready.swap(_completions);
+		_collected += ready.size();
+		size_t collected = _collected;
+		pthread_mutex_unlock(&_mutex);
+
+		for (size_t i = 0; i < ready.size(); ++i)
+		{
+			const Completion& completion = ready[i];
+			_assets[completion.index] = completion.asset;
+			if (progress != NULL)
+			{
+				LoadReport report;
+				report.filename = _filenames[completion.index];
+				report.loaded = completion.asset.get() != NULL;
+				report.fraction = (float)(collected - ready.size() + i + 1) / (float)_filenames.size();
+				report.readMs = completion.readNs / 1e6;
+				report.convertMs = completion.convertNs / 1e6;
+				progress(report);
+			}
+		}
+		if (collected == _filenames.size())
+			break;
+	}
+	joinWorkers();
+}
+
+SoundAssetPtr SoundBank::asset(const std::string& filename) const
+{
+	for (size_t i = 0; i < _filenames.size(); ++i)
+	{
+		if (_filenames[i] == filename)
+			return _assets[i];
+	}
+	LOGE("SoundBank: %s isn't in the bank", filename.c_str());
+	return NULL;
+}
+
+void* SoundBank::workerMain(void* self)
+{
+	static_cast<SoundBank*>(self)->work();
+	return NULL;
+}
+
+void SoundBank::work()
+{
+	PROFILE_THREAD("SoundBank");
+	size_t index;
+	while (takeFile(index))
+	{
+		load(index);
+	}
+}
+
+bool SoundBank::takeFile(size_t& index)
+{
+	pthread_mutex_lock(&_mutex);
+	bool taken = _nextFile < _filenames.size();
+	if (taken)
+		index = _nextFile++;
+	pthread_mutex_unlock(&_mutex);
+	return taken;
+}
+
+void SoundBank::load(size_t index)
+{
+	PROFILE_ZONE("SoundBank::load");
+	Completion completion;
+	completion.index = index;
+
+	unsigned long long start = nowNs();
+	ResourcePtr resource = readWhole(_filenames[index]);
+	unsigned long long read = nowNs();
+	if (resource)
+		completion.asset = new SoundAsset(resource);
+	else
+		LOGE("SoundBank: couldn't read %s", _filenames[index].c_str());
+	completion.readNs = read - start;
+	completion.convertNs = nowNs() - read;
+
+	pthread_mutex_lock(&_mutex);
+	_completions.push_back(completion);
+	pthread_cond_signal(&_completed);
+	pthread_mutex_unlock(&_mutex);
+}
+
+void SoundBank::joinWorkers()
+{
+	for (size_t i = 0; i < _workers.size(); ++i)
+	{
+		pthread_join(_workers[i], NULL);
+	}
+	_workers.clear();
+}
+
+}
@@ -0,0 +1,99 @@
+// Copyright 2011 Nuffer Brothers Software LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef engine_SoundBank_HPP_INCLUDED
+#define engine_SoundBank_HPP_INCLUDED
+
+#include "EngineConfig.hpp"
+#include "EngineFwd.hpp"
+#include "boost/noncopyable.hpp"
+#include <pthread.h>
+#include <deque>
+#include <string>
+#include <vector>
+#include <tr1/functional>
+
+
+namespace engine
+{
+    /**
+     * Loads a list of sound files on worker threads of its own, so reading them from the
+     * APK and handing them to OpenAL overlaps whatever the loading thread does meanwhile,
+     * which is mostly decoding textures.
+     *
+     * add() every file, then start(). finish() waits for the files, reporting each one to
+     * its progress function as the workers complete it, after which asset() has them all.
+     * Only the thread that calls start() may use the bank.
+     */
+    class SoundBank : private boost::noncopyable
+    {
+    public:
+        // What finish() reports about every file once it is ready.
+        struct LoadReport
+        {
+            std::string filename;
+            bool loaded;
+            float fraction; // of the bank's files done, this one included
+            double readMs; // inflating the file from the APK
+            double convertMs; // handing it to OpenAL
+        };
+        typedef std::tr1::function<void (const LoadReport&)> ProgressFunction;
+
+        static const size_t defaultWorkerCount = 2;
+
+        SoundBank();
+        // Waits for the workers, dropping whatever they loaded that finish() didn't collect.
+        ~SoundBank();
+
+        // Only before start().
+        void add(const std::string& filename);
+        // Does nothing if the bank has been started already.
+        void start(size_t workerCount = defaultWorkerCount);
+        bool started() const { return _started; }
+        // Waits for every file, loading the ones no worker has taken yet on this thread.
+        void finish(const ProgressFunction& progress = NULL);
+
+        // NULL if filename wasn't added, isn't finished or couldn't be loaded.
+        SoundAssetPtr asset(const std::string& filename) const;
+        size_t size() const { return _filenames.size(); }
+
+    private:
+        struct Completion
+        {
+            size_t index;
+            SoundAssetPtr asset;
+            unsigned long long readNs;
+            unsigned long long convertNs;
+        };
+
+        static void* workerMain(void* self);
+        void work();
+        // Takes the next file no thread has taken yet. False once there are none.
+        bool takeFile(size_t& index);
+        void load(size_t index);
+        void joinWorkers();
+
+        std::vector<std::string> _filenames;
+        std::vector<SoundAssetPtr> _assets;
+        std::vector<pthread_t> _workers;
+        bool _started;
+
+        pthread_mutex_t _mutex;
+        pthread_cond_t _completed;
+        size_t _nextFile;
+        std::deque<Completion> _completions;
+        size_t _collected; // completions finish() has taken off the queue
+    };
+}
+#endif
@@ -17,6 +17,7 @@
 #include "libzip/zip.h"
 #include "Resources.hpp"
 #include "Resource.hpp"
+#include "VoicePool.hpp"
 
 namespace engine
 {
@@ -27,11 +28,12 @@ namespace engine
         device = alcOpenDevice(NULL);
         context = alcCreateContext(device, context_attribs);
         alcMakeContextCurrent(context);
+        voicePool = new VoicePool(VoicePool::defaultVoiceCount);
     }
 
     SoundDevice::~SoundDevice()
     {
-        // Don't do this because there currently is no mechanism to ensure that the Sound instances
+        // Don't do this (or delete voicePool) because there currently is no mechanism to ensure that the Sound instances
         // are first destroyed. Also there is currently no need to cleanup, only one SoundDevice is
         // used for the duration of the process, and when the process exits, the OS does the cleanup.
         //alcMakeContextCurrent(NULL);
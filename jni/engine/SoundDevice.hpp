@@ -40,9 +40,13 @@ public:
     SoundDevice();
     ~SoundDevice();
 
+    // The voices every Sound plays on.
+    VoicePool& voices() { return *voicePool; }
+
 private:
 	ALCdevice* device;
 	ALCcontext* context;
+	VoicePool* voicePool; // created once the context is current
 };
 }
 #endif
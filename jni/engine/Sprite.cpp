@@ -91,6 +91,15 @@ string Sprite::name() const
 	return spriteName;
 }
 
+bool Sprite::opaqueArea(const Rectangle& screen, Rectangle& area)
+{
+	// Only still quads, an animation's frames can differ. A rotated quad doesn't cover a rectangle.
+	if (!texturedQuad_ || !texturedQuad_->opaque() || rotation() != 0.0)
+		return false;
+	area = Rectangle::makeCenteredOn(getPositionRelativeToOrigin(screen), size());
+	return true;
+}
+
 void Sprite::updateBoundingRect()
 {
 	Point center;
@@ -105,7 +114,7 @@ void Sprite::updateBoundingRect()
 		center = animation_->getCurrentRealBoundCenter();
 		sz = animation_->currentRealSize();
 	}
-	Rectangle imageRectangle = Rectangle::makeCenteredOn(position(), size());
+	Rectangle imageRectangle = Rectangle::makeCenteredOn(worldPosition(), size());
 	Rectangle boundRectangle = Rectangle::makeCenteredOn(center, sz);
 	boundRectangle.left += imageRectangle.left;
 	boundRectangle.right += imageRectangle.left;
@@ -37,6 +37,7 @@ public:
 	virtual void update(const DateTime& thisFrameStartTime, const TimeDuration& deltaTime);
 	virtual void draw(const Rectangle& screen);
 	virtual std::string name() const;
+	virtual bool opaqueArea(const Rectangle& screen, Rectangle& area);
 
 	virtual bool doesCollideWith(const Collidable& other) const;
 	virtual void handleCollision(Collidable& other, const DateTime& thisFrameStartTime, const TimeDuration& deltaTime);
@@ -0,0 +1,209 @@
+// Copyright 2011 Nuffer Brothers Software LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "StreamingSound.hpp"
+#include "Log.hpp"
+#include "openal/include/AL/al.h"
+#include "openal/include/AL/alc.h"
+#include "openal/include/AL/alext.h"
+#include <algorithm>
+#include <string.h>
+#include <time.h>
+
+namespace engine{
+
+namespace
+{
+	// Well under the time one buffer plays for, 4 blocks are 184ms at 22050Hz.
+	const long refillIntervalNs = 50 * 1000 * 1000;
+}
+
+StreamingSound::StreamingSound(const ResourceStreamPtr& stream, float gainAdjustmentFactor)
+: _stream(stream)
+, _dataLeft(0)
+, _source(0)
+, _streaming(false)
+, _stopRequested(false)
+, _gain(1.0)
+, _gainAdjustmentFactor(gainAdjustmentFactor)
+{
+	memset(&_header, 0, sizeof(_header));
+	memset(_buffers, 0, sizeof(_buffers));
+	pthread_mutex_init(&_mutex, NULL);
+	pthread_cond_init(&_wake, NULL);
+
+	alGenSources(1, &_source);
+	alGenBuffers(bufferCount, _buffers);
+	ALenum problem;
+	if((problem = alGetError()) != AL_NO_ERROR)
+		LOGE("openAL detected an error: %d",problem);
+}
+
+StreamingSound::~StreamingSound()
+{
+	stop();
+	alDeleteSources(1, &_source);
+	alDeleteBuffers(bufferCount, _buffers);
+	pthread_cond_destroy(&_wake);
+	pthread_mutex_destroy(&_mutex);
+}
+
+void StreamingSound::play()
+{
+	if (_streaming || !_stream)
+		return;
+	if (!_stream->rewind() || !readHeader())
+		return;
+
+	size_t queued = 0;
+	while (queued < bufferCount && fill(_buffers[queued]))
+	{
+		++queued;
+	}
+	if (queued == 0)
+		return;
+	alSourceQueueBuffers(_source, queued, _buffers);
+	alSourcei(_source, AL_LOOPING, AL_FALSE);
+	alSourcef(_source, AL_GAIN, effectiveGain());
+	alSourcePlay(_source);
+
+	_stopRequested = false;
+	if (pthread_create(&_thread, NULL, streamMain, this) != 0)
+	{
+		// It still plays what was queued.
+		LOGE("StreamingSound: failed to start the streaming thread for %s", _stream->name().c_str());
+		return;
+	}
+	_streaming = true;
+}
+
+void StreamingSound::stop()
+{
+	if (_streaming)
+	{
+		pthread_mutex_lock(&_mutex);
+		_stopRequested = true;
+		pthread_cond_signal(&_wake);
+		pthread_mutex_unlock(&_mutex);
+		pthread_join(_thread, NULL);
+		_streaming = false;
+	}
+	// Stopping marks every queued buffer processed, detaching them all unqueues them.
+	alSourceStop(_source);
+	alSourcei(_source, AL_BUFFER, 0);
+}
+
+void StreamingSound::setGain(float gain)
+{
+	_gain = gain;
+	alSourcef(_source, AL_GAIN, effectiveGain());
+}
+
+void* StreamingSound::streamMain(void* self)
+{
+	static_cast<StreamingSound*>(self)->stream();
+	return NULL;
+}
+
+void StreamingSound::stream()
+{
+	pthread_mutex_lock(&_mutex);
+	while (!_stopRequested)
+	{
+		pthread_mutex_unlock(&_mutex);
+
+		ALint processed = 0;
+		alGetSourcei(_source, AL_BUFFERS_PROCESSED, &processed);
+		for (; processed > 0; --processed)
+		{
+			ALuint buffer;
+			alSourceUnqueueBuffers(_source, 1, &buffer);
+			if (!fill(buffer))
+			{
+				// Leave the source to play out what is still queued.
+				return;
+			}
+			alSourceQueueBuffers(_source, 1, &buffer);
+		}
+
+		// If the refills fell behind, the source ran dry and stopped.
+		ALint state = AL_PLAYING;
+		alGetSourcei(_source, AL_SOURCE_STATE, &state);
+		if (state != AL_PLAYING)
+		{
+			LOGI("StreamingSound: %s underran, restarting it", _stream->name().c_str());
+			alSourcePlay(_source);
+		}
+
+		timespec wakeAt;
+		clock_gettime(CLOCK_REALTIME, &wakeAt);
+		wakeAt.tv_nsec += refillIntervalNs;
+		if (wakeAt.tv_nsec >= 1000000000)
+		{
+			wakeAt.tv_sec += 1;
+			wakeAt.tv_nsec -= 1000000000;
+		}
+		pthread_mutex_lock(&_mutex);
+		if (!_stopRequested)
+			pthread_cond_timedwait(&_wake, &_mutex, &wakeAt);
+	}
+	pthread_mutex_unlock(&_mutex);
+}
+
+bool StreamingSound::readHeader()
+{
+	if (_stream->read(&_header, sizeof(_header)) != sizeof(_header))
+	{
+		LOGE("StreamingSound: %s is too short for a wave header", _stream->name().c_str());
+		return false;
+	}
+	// Same format as SoundAsset expects.
+	if (memcmp(_header.riff, "RIFF", 4) != 0 || _header.bitsPerSample != 4 || _header.channels != 1 ||
+		_header.blockAlign == 0 || _header.dataSize < _header.blockAlign)
+	{
+		LOGE("StreamingSound: %s isn't a mono IMA ADPCM wave file", _stream->name().c_str());
+		return false;
+	}
+	// Only whole blocks, so every buffer holds whole blocks even across the loop.
+	_dataLeft = _header.dataSize - _header.dataSize % _header.blockAlign;
+	_data.resize(blocksPerBuffer * _header.blockAlign);
+	return true;
+}
+
+bool StreamingSound::fill(ALuint buffer)
+{
+	size_t size = 0;
+	while (size < _data.size())
+	{
+		if (_dataLeft == 0)
+		{
+			// The end of the track, carry on from its start.
+			if (!_stream->rewind() || !readHeader())
+				return false;
+		}
+		size_t got = _stream->read(&_data[size], std::min(_data.size() - size, _dataLeft));
+		if (got == 0)
+		{
+			LOGE("StreamingSound: %s ended before its data did", _stream->name().c_str());
+			return false;
+		}
+		size += got;
+		_dataLeft -= got;
+	}
+	// No alGetError() here, it would take errors meant for the game's thread.
+	alBufferData(buffer, AL_FORMAT_MONO_IMA4, &_data[0], size, _header.samplesPerSec);
+	return true;
+}
+
+}
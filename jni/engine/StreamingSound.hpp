@@ -0,0 +1,82 @@
+// Copyright 2011 Nuffer Brothers Software LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef engine_StreamingSound_HPP_INCLUDED
+#define engine_StreamingSound_HPP_INCLUDED
+
+#include "EngineConfig.hpp"
+#include "EngineFwd.hpp"
+#include "ResourceStream.hpp"
+#include "SoundAsset.hpp"
+#ifdef __APPLE__
+#include <OpenAL/al.h>
+#else
+#include "openal/include/AL/al.h"
+#endif
+#include <pthread.h>
+#include <vector>
+
+
+namespace engine
+{
+    /**
+     * A looping music track played from its file a few IMA4 blocks at a time, so only
+     * bufferCount small buffers are ever resident however long the track is.
+     *
+     * A thread of its own refills the buffers as the source finishes them and starts the
+     * file over when it runs out, so the loop has no gap. The track has a source of its
+     * own too, music never competes with the effects for a VoicePool voice.
+     */
+    class StreamingSound : public IntrusiveCountableBase
+    {
+    public:
+        static const size_t bufferCount = 4;
+        static const size_t blocksPerBuffer = 4;
+
+        StreamingSound(const ResourceStreamPtr& stream, float gainAdjustmentFactor = 1.0);
+        ~StreamingSound();
+
+        // Starts the track from the beginning, unless it is already playing.
+        void play();
+        void stop();
+        void setGain(float gain);
+        bool isPlaying() const { return _streaming; }
+
+    private:
+        static void* streamMain(void* self);
+        void stream();
+        bool readHeader();
+        // Fills buffer with the next blocks of the track. False if the file can't be read.
+        bool fill(ALuint buffer);
+        float effectiveGain() const { return _gain * _gainAdjustmentFactor; }
+
+        ResourceStreamPtr _stream;
+        BasicIMAWAVEHeader _header;
+        size_t _dataLeft; // bytes of sample data not read yet in this pass over the file
+        std::vector<char> _data;
+
+        ALuint _source;
+        ALuint _buffers[bufferCount];
+
+        pthread_t _thread;
+        pthread_mutex_t _mutex;
+        pthread_cond_t _wake;
+        bool _streaming;
+        bool _stopRequested;
+
+        float _gain;
+        float _gainAdjustmentFactor;
+    };
+}
+#endif
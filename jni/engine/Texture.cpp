@@ -69,6 +69,18 @@ void Texture::loadFromPkmData(ResourcePtr pkmData)
 	LOGD("loaded texture from preloaded pkm data");
 }
 
+void Texture::loadFromPkmData(ResourcePtr pkmData, ResourcePtr alphaData)
+{
+	int h, w;
+	glTextureId = TextureLoader::loadTextureFromPKM(pkmData, alphaData, w, h, alphaTextureId);
+	if (glTextureId == gl::INVALID_TEXTURE)
+	{
+		LOGE("failed to load texture from pkm data and its alpha plane");
+		abort();
+	}
+	LOGD("loaded texture from pkm data and its alpha plane");
+}
+
 void Texture::draw(const Rectangle& screen)
 {
 	if (!loaded())
@@ -81,6 +93,7 @@ void Texture::draw(const Rectangle& screen)
 	using namespace gl;
 	enableTexture2D();
 	bindTexture2D(glTextureId);
+	bindAlphaTexture2D(alphaTextureId);
 }
 
 void Texture::unload()
@@ -90,6 +103,11 @@ void Texture::unload()
 		LOGD("unload(%p) called for texture id %d", this, glTextureId);
 		gl::deleteTextures(1, &glTextureId);
 		glTextureId = gl::INVALID_TEXTURE;
+		if (alphaTextureId != gl::INVALID_TEXTURE)
+		{
+			gl::deleteTextures(1, &alphaTextureId);
+			alphaTextureId = gl::INVALID_TEXTURE;
+		}
 	}
 }
 
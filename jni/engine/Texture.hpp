@@ -33,13 +33,15 @@ BLOCXX_DECLARE_EXCEPTION(Texture);
 class Texture : public Drawable
 {
 public:
-	Texture() : glTextureId(gl::INVALID_TEXTURE) {}
-	Texture(GLuint glTextureId) : glTextureId(glTextureId) {}
+	Texture() : glTextureId(gl::INVALID_TEXTURE), alphaTextureId(gl::INVALID_TEXTURE) {}
+	Texture(GLuint glTextureId) : glTextureId(glTextureId), alphaTextureId(gl::INVALID_TEXTURE) {}
 	~Texture();
 
 	void loadFromResource(const char* name);
 	void loadFromPngData(png_byte* imageData, int width, int height);
 	void loadFromPkmData(ResourcePtr pkmData);
+	// With the alpha from a gray alphaData, see TextureLoader::loadTextureFromPKM().
+	void loadFromPkmData(ResourcePtr pkmData, ResourcePtr alphaData);
 
 	template <typename StrT>
 	void loadFromResource(const StrT& name)
@@ -47,13 +49,15 @@ public:
 		return loadFromResource(name.c_str());
 	}
 
-	bool loaded() { return glTextureId != gl::INVALID_TEXTURE; }
+	bool loaded() const { return glTextureId != gl::INVALID_TEXTURE; }
 
 	void unload();
 
 	virtual void draw(const Rectangle& screen);
 private:
 	GLuint glTextureId;
+	// Where the alpha comes from, when not from glTextureId.
+	GLuint alphaTextureId;
 
 
 };
@@ -17,10 +17,12 @@
 #include "Resources.hpp"
 #include "Resource.hpp"
 #include "Log.hpp"
+#include "Profiler.hpp"
 #include "TextureLoader.hpp"
 #include "miniblocxx/String.hpp"
 #include "boost/range/algorithm_ext/push_back.hpp"
 #include "boost/next_prior.hpp"
+#include <algorithm>
 
 
 using namespace boost;
@@ -33,8 +35,62 @@ namespace engine
 {
 BLOCXX_DEFINE_EXCEPTION(TextureLibrary);
 
+	TextureLibrary::TextureLibrary()
+		: atlasSetScaleX(1.0f)
+		, atlasSetScaleY(1.0f)
+	{
+	}
+
 	TextureLibrary::~TextureLibrary() {}
 
+	void TextureLibrary::addAtlasSet(const String& directory, const Size& screenSize)
+	{
+		atlasSets.push_back(AtlasSet(directory, screenSize));
+	}
+
+	void TextureLibrary::selectAtlasSet(const Size& screenSize, const Size& worldSize)
+	{
+		if (!atlases.empty())
+		{
+			// The quads made so far would be of another set than the ones made from now on.
+			LOGD("Atlases already loaded, keeping their set");
+			return;
+		}
+		const AtlasSet* best = NULL;
+		for (vector<AtlasSet>::const_iterator it = atlasSets.begin(); it != atlasSets.end(); ++it)
+		{
+			const Size& size = it->screenSize;
+			// One for a screen as large as the world's would only draw like the atlases in no set do.
+			if (size.width() < screenSize.width() || size.height() < screenSize.height()
+				|| size.width() >= worldSize.width() || size.height() >= worldSize.height())
+				continue;
+			if (best && size.width() * size.height() >= best->screenSize.width() * best->screenSize.height())
+				continue;
+			if (listAtlases(it->directory + "/").empty())
+			{
+				LOGI("No atlases for a %dx%d screen in %s", (int)size.width(), (int)size.height(), it->directory.c_str());
+				continue;
+			}
+			best = &*it;
+		}
+
+		atlasSetDirectory = best ? best->directory + "/" : String();
+		atlasSetDirectories.clear();
+		StringArray setAtlases = best ? listAtlases(atlasSetDirectory) : StringArray();
+		for (size_t i = 0; i < setAtlases.size(); ++i)
+		{
+			String directory = setAtlases[i].substring(atlasSetDirectory.length(), setAtlases[i].lastIndexOf('/') + 1 - atlasSetDirectory.length());
+			if (std::find(atlasSetDirectories.begin(), atlasSetDirectories.end(), directory) == atlasSetDirectories.end())
+			{
+				atlasSetDirectories.push_back(directory);
+			}
+		}
+		atlasSetScaleX = best ? worldSize.width() / best->screenSize.width() : 1.0f;
+		atlasSetScaleY = best ? worldSize.height() / best->screenSize.height() : 1.0f;
+		LOGI("Atlases for a %dx%d screen: %s", (int)screenSize.width(), (int)screenSize.height(),
+			best ? best->directory.c_str() : "the default");
+	}
+
 	StringArray TextureLibrary::listAtlases(String prefixFilter) const
 {
 	StringArray files = Resources::listResources();
@@ -73,23 +129,60 @@ BLOCXX_DEFINE_EXCEPTION(TextureLibrary);
 	StringArray atlases = listAtlases();
 	for( size_t i = 0; i < atlases.size(); ++i )
 	{
+		// The selected set's atlases go by the names the ones they stand in for have.
+		String name = atlases[i];
+		if (!atlasSetDirectory.empty() && name.startsWith(atlasSetDirectory))
+		{
+			name = name.substring(atlasSetDirectory.length());
+		}
+		else if (inAtlasSet(name) || !atlasSetPrefix(name).empty())
+		{
+			continue;
+		}
 		if (progressCallback != NULL)
 		{
 			progressCallback(1.0f);
 		}
-		loadAtlasData(atlases[i]);
+		loadAtlasData(name);
+	}
+}
+
+	bool TextureLibrary::inAtlasSet(const String& filename) const
+{
+	for (vector<AtlasSet>::const_iterator it = atlasSets.begin(); it != atlasSets.end(); ++it)
+	{
+		if (filename.startsWith(it->directory + "/"))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+	String TextureLibrary::atlasSetPrefix(const String& atlasFilename) const
+{
+	size_t slash = atlasFilename.lastIndexOf('/');
+	String directory = slash == String::npos ? String() : atlasFilename.substring(0, slash + 1);
+	if (std::find(atlasSetDirectories.begin(), atlasSetDirectories.end(), directory) == atlasSetDirectories.end())
+	{
+		return String();
 	}
+	return atlasSetDirectory;
 }
 
 	void TextureLibrary::loadAtlasData(const String& name)
 {
+	PROFILE_ZONE("TextureLibrary::loadAtlasData");
 	// load the atlas description
 	String atlasFilename = name;
 	if( !name.endsWith(".atlas") )
 	{
 		atlasFilename += ".atlas";
 	}
-	ResourcePtr atlasResource = Resources::loadResourceFromAssets(atlasFilename.c_str());
+	const String prefix = atlasSetPrefix(atlasFilename);
+	const float scaleX = prefix.empty() ? 1.0f : atlasSetScaleX;
+	const float scaleY = prefix.empty() ? 1.0f : atlasSetScaleY;
+	ResourcePtr atlasResource = Resources::loadResourceFromAssets((prefix + atlasFilename).c_str());
 	String atlasStr = String(
 		reinterpret_cast<const char*>(&*atlasResource->begin()),
 		distance(atlasResource->begin(), atlasResource->end()));
@@ -102,9 +195,14 @@ BLOCXX_DEFINE_EXCEPTION(TextureLibrary);
 		const String& line(*it);
 		if (line.startsWith("image:"))
 		{
-			atlas.imageFilename = line.tokenize(": \t").at(1);
+			atlas.imageFilename = prefix + line.tokenize(": \t").at(1);
 			LOGD("parsed image filename %s", atlas.imageFilename.c_str());
 		}
+		else if (line.startsWith("alpha:"))
+		{
+			atlas.alphaFilename = prefix + line.tokenize(": \t").at(1);
+			LOGD("parsed alpha filename %s", atlas.alphaFilename.c_str());
+		}
 		else if (line.startsWith("group:"))
 		{
 			atlas.group = line.tokenize(": \t").at(1);
@@ -113,16 +211,37 @@ BLOCXX_DEFINE_EXCEPTION(TextureLibrary);
 		else if (line.startsWith("quad:"))
 		{
 			StringArray toks = line.tokenize(": \t");
-			atlas.quads.push_back(Quad(
+			Quad quad(
 					toks.at(1),
 					toks.at(2).toUInt16(),
 					toks.at(3).toUInt16(),
 					toks.at(4).toUInt16(),
 					toks.at(5).toUInt16(),
-					toks.at(6).toFloat(),
-					toks.at(7).toFloat(),
+					toks.at(6).toFloat() * scaleX,
+					toks.at(7).toFloat() * scaleY,
+					false,
 					atlas.size,
-					atlas.texture));
+					atlas.texture);
+			for (size_t i = 8; i < toks.size(); ++i)
+			{
+				if (toks[i] == "opaque")
+				{
+					quad.opaque = true;
+				}
+				else if (toks[i] == "rotated")
+				{
+					quad.rotated = true;
+				}
+				else if (toks[i] == "trim")
+				{
+					quad.trimLeft = toks.at(i + 1).toUInt16();
+					quad.trimTop = toks.at(i + 2).toUInt16();
+					quad.fullWidth = toks.at(i + 3).toUInt16();
+					quad.fullHeight = toks.at(i + 4).toUInt16();
+					i += 4;
+				}
+			}
+			atlas.quads.push_back(quad);
 			LOGD("parsed quad line: %s", line.c_str());
 		}
 		else if (line.startsWith("size:"))
@@ -161,6 +280,7 @@ BLOCXX_DEFINE_EXCEPTION(TextureLibrary);
 
 	void TextureLibrary::loadAtlasTexture(const std::string& name)
 {
+	PROFILE_ZONE("TextureLibrary::loadAtlasTexture");
 	LOGD("loadAtlasTexture loading atlas %s", name.c_str());
 	atlasMap_t::const_iterator loc = atlases.find(name);
 	if( loc == atlases.end() )
@@ -185,6 +305,12 @@ BLOCXX_DEFINE_EXCEPTION(TextureLibrary);
 				isTextureLoaded = true;
 			}
 		}
+		else if (!atlas.alphaFilename.empty())
+		{
+			LOGI("Loading texture and its alpha plane.");
+			atlas.texture->loadFromPkmData(takePKM(atlas.imageFilename), takePKM(atlas.alphaFilename));
+			isTextureLoaded = true;
+		}
 		else
 		{
 			texPKMLibrary_t::iterator im = texPKMLibrary.find(atlas.imageFilename);
@@ -210,6 +336,16 @@ BLOCXX_DEFINE_EXCEPTION(TextureLibrary);
 	}
 }
 
+	ResourcePtr TextureLibrary::takePKM(const String& filename)
+	{
+		texPKMLibrary_t::iterator im = texPKMLibrary.find(filename);
+		if (im == texPKMLibrary.end())
+			return Resources::loadResourceFromAssets(filename.c_str());
+		ResourcePtr data = im->second;
+		texPKMLibrary.erase(im);
+		return data;
+	}
+
 	void TextureLibrary::unloadAtlasTexture(const std::string& name)
 {
 	LOGD("unloadAtlasTexture unloading atlas %s", name.c_str());
@@ -254,30 +390,48 @@ BLOCXX_DEFINE_EXCEPTION(TextureLibrary);
 
 		const Quad& quad((*it).second);
 
+		// The part of the atlas the image is in.
+		UInt16 atlasWidth = quad.rotated ? quad.height : quad.width;
+		UInt16 atlasHeight = quad.rotated ? quad.width : quad.height;
+
+		TexturedQuadPtr result;
 		realBoundLibrary_t::const_iterator rb = realBoundLibrary.find(name);
 		if (rb != realBoundLibrary.end())
 		{
 			LOGD("Loading real bounding rectangle: %s", (rb->first).c_str());
-			return new TexturedQuad(float(quad.left) / quad.atlasSize.width(),
+			result = new TexturedQuad(float(quad.left) / quad.atlasSize.width(),
 									float(quad.bottom) / quad.atlasSize.height(),
-									float(quad.left + quad.width) / quad.atlasSize.width(),
-									float(quad.bottom + quad.height) / quad.atlasSize.height(),
+									float(quad.left + atlasWidth) / quad.atlasSize.width(),
+									float(quad.bottom + atlasHeight) / quad.atlasSize.height(),
 									quad.atlasTexture,
-									quad.width * quad.widthScaleFactor,
-									quad.height * quad.heightScaleFactor,
+									quad.fullWidth * quad.widthScaleFactor,
+									quad.fullHeight * quad.heightScaleFactor,
 									rb->second);
 
 		}
 		else
 		{
-			return new TexturedQuad(float(quad.left) / quad.atlasSize.width(),
+			result = new TexturedQuad(float(quad.left) / quad.atlasSize.width(),
 									float(quad.bottom) / quad.atlasSize.height(),
-									float(quad.left + quad.width) / quad.atlasSize.width(),
-									float(quad.bottom + quad.height) / quad.atlasSize.height(),
+									float(quad.left + atlasWidth) / quad.atlasSize.width(),
+									float(quad.bottom + atlasHeight) / quad.atlasSize.height(),
 									quad.atlasTexture,
-									quad.width * quad.widthScaleFactor,
-									quad.height * quad.heightScaleFactor);
+									quad.fullWidth * quad.widthScaleFactor,
+									quad.fullHeight * quad.heightScaleFactor);
+		}
+		if (quad.rotated)
+			result->setRotatedInAtlas();
+		if (quad.width != quad.fullWidth || quad.height != quad.fullHeight)
+		{
+			// Top and left in the image from the top are y and x in the quad's -0.5 to 0.5.
+			float left = float(quad.trimLeft) / quad.fullWidth - 0.5f;
+			float top = 0.5f - float(quad.trimTop) / quad.fullHeight;
+			result->setTrimmedArea(Rectangle(left, left + float(quad.width) / quad.fullWidth,
+											top, top - float(quad.height) / quad.fullHeight));
 		}
+		result->setOpaque(quad.opaque);
+		result->setName(name);
+		return result;
 	}
 
 	void TextureLibrary::loadRealBounds(const String& fileName)
@@ -323,6 +477,7 @@ BLOCXX_DEFINE_EXCEPTION(TextureLibrary);
 				const Atlas& atlas = loc->second;
 				if (!atlas.texture->loaded())
 				{
+					PROFILE_ZONE("TextureLibrary::preloadTexImage");
 					int w, h;
 					if (atlas.imageFilename.endsWith(".png"))
 					{
@@ -335,6 +490,8 @@ BLOCXX_DEFINE_EXCEPTION(TextureLibrary);
 					{
 						LOGD("Preloading pkm image %s", atlas.imageFilename.c_str());
 						texPKMLibrary.insert(make_pair(atlas.imageFilename, Resources::loadResourceFromAssets(atlas.imageFilename.c_str())));
+						if (!atlas.alphaFilename.empty())
+							texPKMLibrary.insert(make_pair(atlas.alphaFilename, Resources::loadResourceFromAssets(atlas.alphaFilename.c_str())));
 					}
 
 					progressCallback(0);
@@ -65,21 +65,43 @@ BLOCXX_DECLARE_EXCEPTION(TextureLibrary);
  * Format of an .atlas file
  * Each line has a prefix and a colon identifying the type.
  * The quad line is a space delimited sequence:
- *   quad:<name> <left> <bottom> <width> <height> <x scale factor> <y scale factor>
+ *   quad:<name> <left> <bottom> <width> <height> <x scale factor> <y scale factor> [opaque] [rotated]
+ *     [trim <left> <top> <full width> <full height>]
+ * mkatlas writes opaque when no pixel of the image has any transparency, those quads are drawn with blending off.
+ * With -R it may turn an image a quarter clockwise to fit it in, rotated, so it takes <height> x <width> of
+ * the atlas. With -t it leaves out the fully transparent border of an image: trim says where the <width> x
+ * <height> that's left was in the full image, which is what the quad draws as.
  * The group line is:
  *   group:<group name>
  * The image line is:
  *   image:<image filename>
+ * An ETC1 (.pkm) image can't have alpha, for translucent quads mkatlas -a writes it to a
+ * gray ETC1 image of the same size as well, and the line:
+ *   alpha:<alpha image filename>
  * The size line is:
  *   size:<atlas image width> <atlas image height>
+ *
+ * Smaller screens can have atlases of their own, made from images resized for them, so they
+ * decode, upload and sample no more than they show. Each such set is in a directory of the
+ * assets, laid out like the assets themselves, the images its .atlas files name from that
+ * directory. It stands in for the assets' atlases in each directory it has any in.
  */
 
 
 class TextureLibrary : boost::noncopyable, public virtual IntrusiveCountableBase
 {
 public:
+	TextureLibrary();
 	~TextureLibrary();
 
+	// The atlases under directory were made for a screenSize screen.
+	void addAtlasSet(const String& directory, const Size& screenSize);
+	// Picks the set made for the smallest screen that is still at least screenSize, or the atlases
+	// in no set, made for worldSize, if none is or it isn't in the assets. The quads of a set are
+	// scaled up by as much as its images were scaled down, so they are as large in the world.
+	// Does nothing once an atlas is loaded.
+	void selectAtlasSet(const Size& screenSize, const Size& worldSize);
+
 	void loadAllAtlases(const std::tr1::function<void (float)>& progressCallback = NULL);
 
 	StringArray listAtlases(String prefixFilter = String()) const;
@@ -113,16 +135,25 @@ public:
 
 
 private:
+	// Whether an .atlas file of the assets is one of a set's.
+	bool inAtlasSet(const String& filename) const;
+	// What to prefix an atlas' filename with to load the selected set's instead, empty if the
+	// set has no atlases in its directory.
+	String atlasSetPrefix(const String& atlasFilename) const;
+	// The preloaded PKM data, which is then let go of, or else the file's.
+	ResourcePtr takePKM(const String& filename);
 
 
 	struct Quad
 	{
 		Quad(const String& name, UInt16 left, UInt16 bottom, UInt16 width, UInt16 height, float widthScaleFactor,
-			 float heightScaleFactor, const Size& atlasSize, const TexturePtr& atlasTexture)
+			 float heightScaleFactor, bool opaque, const Size& atlasSize, const TexturePtr& atlasTexture)
 		: name(name), left(left), bottom(bottom), width(width), height(height), widthScaleFactor(widthScaleFactor),
-		heightScaleFactor(heightScaleFactor), atlasSize(atlasSize), atlasTexture(atlasTexture)
+		heightScaleFactor(heightScaleFactor), opaque(opaque), rotated(false), trimLeft(0), trimTop(0),
+		fullWidth(width), fullHeight(height), atlasSize(atlasSize), atlasTexture(atlasTexture)
 		{}
-		// quad:<name> <left> <bottom> <width> <height> <x scale factor> <y scale factor>
+		// quad:<name> <left> <bottom> <width> <height> <x scale factor> <y scale factor> [opaque] [rotated]
+		//   [trim <left> <top> <full width> <full height>]
 		String name;
 		UInt16 left;
 		UInt16 bottom;
@@ -130,6 +161,14 @@ private:
 		UInt16 height;
 		float widthScaleFactor;
 		float heightScaleFactor;
+		bool opaque;
+		// The atlas has the image turned a quarter clockwise, height wide and width high.
+		bool rotated;
+		// Only width x height of the full image is in the atlas, from trimLeft, trimTop.
+		UInt16 trimLeft;
+		UInt16 trimTop;
+		UInt16 fullWidth;
+		UInt16 fullHeight;
 		Size atlasSize;
 		TexturePtr atlasTexture;
 	};
@@ -167,6 +206,8 @@ private:
 		Atlas() : texture(new Texture) {}
 
 		String imageFilename;
+		// Empty unless the image is a PKM with its alpha in another.
+		String alphaFilename;
 		String group;
 		Size size;
 		vector<Quad> quads;
@@ -175,6 +216,22 @@ private:
 	// key is atlas name. value is data loaded from the atlas file
 	typedef tr1::unordered_map<string, Atlas> atlasMap_t;
 	atlasMap_t atlases;
+
+	struct AtlasSet
+	{
+		AtlasSet(const String& directory, const Size& screenSize) : directory(directory), screenSize(screenSize) {}
+		String directory;
+		Size screenSize;
+	};
+	vector<AtlasSet> atlasSets;
+	// The selected set's directory with a trailing slash, empty for the atlases in no set.
+	String atlasSetDirectory;
+	// The directories, from the set's and with a trailing slash, it has atlases in. Where it
+	// has none, like when it leaves out the fonts, the assets' own atlases are loaded.
+	vector<String> atlasSetDirectories;
+	// What the selected set's quads are scaled by.
+	float atlasSetScaleX;
+	float atlasSetScaleY;
 };
 
 template <typename KeysT>
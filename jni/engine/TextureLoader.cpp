@@ -15,6 +15,7 @@
 #include "EngineConfig.hpp"
 #include "EngineFwd.hpp"
 #include "TextureLoader.hpp"
+#include "Etc1Decoder.hpp"
 #include "GL.hpp"
 extern "C"
 {
@@ -315,20 +316,24 @@ etc1_uint32 etc1_get_encoded_data_size(etc1_uint32 width, etc1_uint32 height)
 	return (((width + 3) & ~3) * ((height + 3) & ~3)) >> 1;
 }
 
-GLuint loadTextureFromPKM(const ResourcePtr& pkmData, int &width, int &height)
+namespace
+{
+
+const unsigned ETC_PKM_HEADER_SIZE = 16;
+
+// The blocks after the header, NULL if pkmData isn't a PKM.
+etc1_byte* readPKM(const ResourcePtr& pkmData, int &width, int &height)
 {
-#ifdef GL_ETC1_RGB8_OES
-	const unsigned ETC_PKM_HEADER_SIZE = 16;
 	if (pkmData->data().size() <= ETC_PKM_HEADER_SIZE)
 	{
 		LOGE("pkmData is not the right size. expected > %u, is: %zu", ETC_PKM_HEADER_SIZE, pkmData->data().size());
-		return TEXTURE_LOAD_ERROR;
+		return NULL;
 	}
 
 	etc1_byte* header = &pkmData->data()[0];
 
 	if (!etc1_pkm_is_valid(header))
-		return TEXTURE_LOAD_ERROR;
+		return NULL;
 
 	width = etc1_pkm_get_width(header);
 	height = etc1_pkm_get_height(header);
@@ -338,21 +343,107 @@ GLuint loadTextureFromPKM(const ResourcePtr& pkmData, int &width, int &height)
 	if (pkmData->data().size() != ETC_PKM_HEADER_SIZE + encodedDataSize)
 	{
 		LOGE("pkmData is not the right size. expected: %zu, is: %zu", ETC_PKM_HEADER_SIZE + encodedDataSize, pkmData->data().size());
-		return TEXTURE_LOAD_ERROR;
+		return NULL;
+	}
+	return header + ETC_PKM_HEADER_SIZE;
+}
+
+// In pixels, so rows start on 4 byte boundaries as GL_UNPACK_ALIGNMENT expects.
+unsigned alignedStride(unsigned width, unsigned pixelSize)
+{
+	return ((width * pixelSize + 3) & ~3) / pixelSize;
+}
+
+// To the bound texture.
+void uploadETC1(etc1_byte* blocks, int width, int height)
+{
+#ifdef GL_ETC1_RGB8_OES
+	if (gl::state.etc1)
+	{
+		compressedTexImage2D(GL_ETC1_RGB8_OES, width, height, etc1_get_encoded_data_size(width, height), static_cast<GLvoid*> (blocks));
+		return;
 	}
+#endif
+	// Decoded here instead.
+	unsigned stride = alignedStride(width, sizeof(GLushort));
+	std::vector<GLushort> pixels(stride * height);
+	Etc1Decoder::decodeImage(blocks, width, height, &pixels[0], stride);
+	texImage2D(GL_RGB, GL_UNSIGNED_SHORT_5_6_5, width, height, &pixels[0]);
+}
+
+void setFilters()
+{
+	texParameter(GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	texParameter(GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+}
+
+}
+
+GLuint loadTextureFromPKM(const ResourcePtr& pkmData, int &width, int &height)
+{
+	etc1_byte* blocks = readPKM(pkmData, width, height);
+	if (!blocks)
+		return TEXTURE_LOAD_ERROR;
 
 	//Now generate the OpenGL texture object
 	GLuint texture = genTexture();
 	bindTexture2D(texture);
-	compressedTexImage2D(GL_ETC1_RGB8_OES, width, height, encodedDataSize, static_cast<GLvoid*> (&pkmData->data()[ETC_PKM_HEADER_SIZE]));
-	texParameter(GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	texParameter(GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	uploadETC1(blocks, width, height);
+	setFilters();
 
 	return texture;
-#else
-	LOGE("PKM texture format not supported by this platform");
-	return TEXTURE_LOAD_ERROR;
-#endif
+}
+
+GLuint loadTextureFromPKM(const ResourcePtr& pkmData, const ResourcePtr& alphaData, int &width, int &height, GLuint& alphaTexture)
+{
+	alphaTexture = INVALID_TEXTURE;
+	etc1_byte* blocks = readPKM(pkmData, width, height);
+	int alphaWidth = 0;
+	int alphaHeight = 0;
+	etc1_byte* alphaBlocks = readPKM(alphaData, alphaWidth, alphaHeight);
+	if (!blocks || !alphaBlocks)
+		return TEXTURE_LOAD_ERROR;
+	if (alphaWidth != width || alphaHeight != height)
+	{
+		LOGE("alpha plane is %dx%d, its image %dx%d", alphaWidth, alphaHeight, width, height);
+		return TEXTURE_LOAD_ERROR;
+	}
+
+	// GL_COMBINE only takes alpha from alpha, so the gray plane can't stay ETC1.
+	unsigned alphaStride = alignedStride(width, sizeof(GLubyte));
+	std::vector<GLubyte> alpha(alphaStride * height);
+	Etc1Decoder::decodeGreen(alphaBlocks, width, height, &alpha[0], alphaStride);
+
+	GLuint texture = genTexture();
+	bindTexture2D(texture);
+	if (gl::state.combiners)
+	{
+		uploadETC1(blocks, width, height);
+		setFilters();
+		alphaTexture = genTexture();
+		bindTexture2D(alphaTexture);
+		texImage2D(GL_ALPHA, GL_UNSIGNED_BYTE, width, height, &alpha[0]);
+		setFilters();
+		return texture;
+	}
+
+	// Without a second texture unit the two become one RGBA4444 texture.
+	unsigned stride = alignedStride(width, sizeof(GLushort));
+	std::vector<GLushort> pixels(stride * height);
+	Etc1Decoder::decodeImage(blocks, width, height, &pixels[0], stride);
+	for (int y = 0; y < height; ++y)
+	{
+		GLushort* row = &pixels[y * stride];
+		const GLubyte* alphaRow = &alpha[y * alphaStride];
+		for (int x = 0; x < width; ++x)
+		{
+			GLushort rgb = row[x];
+			row[x] = GLushort((rgb & 0xF000) | ((rgb << 1) & 0x0F00) | ((rgb << 3) & 0x00F0) | (alphaRow[x] >> 4));
+		}
+	}
+	texImage2D(GL_RGBA, GL_UNSIGNED_SHORT_4_4_4_4, width, height, &pixels[0]);
+	setFilters();
+	return texture;
 }
 
 }
@@ -39,6 +39,11 @@ TexturePtr loadTexture(const ResourcePtr& data);
 // returns 0 on error and the gl texture id on success.
 GLuint loadTextureFromPNG(const ResourcePtr& pngData, int &width, int &height);
 GLuint loadTextureFromPKM(const ResourcePtr& pkmData, int &width, int &height);
+// An ETC1 image with its alpha in a second, gray, ETC1 image of the same size. Where the
+// context has combiners alphaTexture is set to draw it with, see gl::bindAlphaTexture2D().
+// Where it doesn't, the two are merged into one RGBA4444 texture and alphaTexture is
+// gl::INVALID_TEXTURE.
+GLuint loadTextureFromPKM(const ResourcePtr& pkmData, const ResourcePtr& alphaData, int &width, int &height, GLuint& alphaTexture);
 
 png_byte* loadImageFromPNG(const ResourcePtr& pngData, int &width, int &height);
 GLuint loadTextureFromPNGData(png_byte* image_data, int &width, int &height);
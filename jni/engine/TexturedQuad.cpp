@@ -14,11 +14,46 @@
 
 #include "EngineConfig.hpp"
 #include "TexturedQuad.hpp"
+#include "DrawCapture.hpp"
 #include "GL.hpp"
+#include "VertexBuffer.hpp"
+#include <algorithm>
 
 namespace engine
 {
 
+namespace
+{
+	// The unit quad's 4 vertexes and then their colors, slot 0. Every quad has the same.
+	StaticVertexBuffer& quadGeometry(const GLfloat* vertexes, const GLfloat* colors)
+	{
+		static StaticVertexBuffer* geometry = 0;
+		if (!geometry)
+		{
+			GLfloat data[24];
+			std::copy(vertexes, vertexes + 8, data);
+			std::copy(colors, colors + 16, data + 8);
+			geometry = new StaticVertexBuffer(24);
+			geometry->allocate(data);
+		}
+		return *geometry;
+	}
+
+	// Every quad's uv coordinates, a slot each.
+	StaticVertexBuffer& quadUvs()
+	{
+		static StaticVertexBuffer* uvs = new StaticVertexBuffer(8);
+		return *uvs;
+	}
+
+	// Swaps the uv coordinates of two of the quad's vertexes.
+	void swapUvs(GLfloat* uvs, int a, int b)
+	{
+		swap(uvs[a * 2], uvs[b * 2]);
+		swap(uvs[a * 2 + 1], uvs[b * 2 + 1]);
+	}
+}
+
 const GLfloat TexturedQuad::s_texturedQuadVertexes[8] = {-0.5,-0.5, 0.5,-0.5, -0.5,0.5, 0.5,0.5};
 const GLfloat TexturedQuad::s_texturedQuadColorValues[16] = {1.0,1.0,1.0,1.0, 1.0,1.0,1.0,1.0, 1.0,1.0,1.0,1.0, 1.0,1.0,1.0,1.0};
 
@@ -29,26 +64,66 @@ void TexturedQuad::draw(const Rectangle& screen)
 	{
 		return;
 	}
+	if (drawcapture::capturing())
+		drawcapture::quadDrawn(name_);
 
-	vertex(coordsPerVertex_, GL_FLOAT, 0, &vertexes_[0]);
-	color(componentsPerColor_, GL_FLOAT, 0, &colors_[0]);
+	StaticVertexBuffer& geometry = quadGeometry(&vertexes_[0], &colors_[0]);
+	GLuint geometryBuffer = geometry.prepare();
+	vertex(coordsPerVertex_, GL_FLOAT, 0, geometry.pointer(0), geometryBuffer);
+	color(componentsPerColor_, GL_FLOAT, 0, geometry.pointer(0, 8), geometryBuffer);
 
 	texture_->draw(screen);
 
-	texCoord(2, GL_FLOAT, 0, uvCoordinates_);
+	StaticVertexBuffer& uvs = quadUvs();
+	if (uvSlot_ == StaticVertexBuffer::noSlot)
+	{
+		uvSlot_ = uvs.allocate(uvCoordinates_);
+	}
+	else if (uvSlotStale_)
+	{
+		uvs.set(uvSlot_, uvCoordinates_);
+	}
+	uvSlotStale_ = false;
+	GLuint uvBuffer = uvs.prepare();
+	texCoord(2, GL_FLOAT, 0, uvs.pointer(uvSlot_), uvBuffer);
 
 	//render
-	drawArrays(renderStyle_, 0, vertexCount());
-
+	if (trimmed_)
+	{
+		PushMatrixScope ms;
+		// Mirrored along with the image.
+		GLfloat x = (trimmedArea_.left + trimmedArea_.right) / 2;
+		GLfloat y = (trimmedArea_.top + trimmedArea_.bottom) / 2;
+		translate(_flippedHorizontal ? -x : x, _flippedVertical ? -y : y, 0);
+		gl::scale(trimmedArea_.width(), trimmedArea_.height(), 1.0f);
+		drawArrays(renderStyle_, 0, vertexCount());
+	}
+	else
+	{
+		drawArrays(renderStyle_, 0, vertexCount());
+	}
 }
 
+	void TexturedQuad::setRotatedInAtlas()
+	{
+		// The image's bottom left is at the rectangle's top left, its top right at the bottom right.
+		GLfloat uMin = uvCoordinates_[0];
+		GLfloat vMax = uvCoordinates_[1];
+		GLfloat uMax = uvCoordinates_[2];
+		GLfloat vMin = uvCoordinates_[5];
+		GLfloat rotated[8] = { uMin, vMin, uMin, vMax, uMax, vMin, uMax, vMax };
+		std::copy(rotated, rotated + 8, uvCoordinates_);
+		uvSlotStale_ = true;
+	}
+
 	void TexturedQuad::setFlippedHorizontal(bool x) 
 	{ 
 		if (_flippedHorizontal == x) return;
 		
-		// swap uMin and uMax
-		swap(uvCoordinates_[0], uvCoordinates_[2]);
-		swap(uvCoordinates_[4], uvCoordinates_[6]);
+		// swap left and right, which is uMin and uMax unless the image is rotated in the atlas
+		swapUvs(uvCoordinates_, 0, 1);
+		swapUvs(uvCoordinates_, 2, 3);
+		uvSlotStale_ = true;
 		
 		_flippedHorizontal = x; 
 	}
@@ -57,13 +132,20 @@ void TexturedQuad::draw(const Rectangle& screen)
 	{
 		if (_flippedVertical == x) return;
 		
-		// swap vMin and vMax
-		swap(uvCoordinates_[1], uvCoordinates_[5]);
-		swap(uvCoordinates_[3], uvCoordinates_[7]);
+		// swap top and bottom
+		swapUvs(uvCoordinates_, 0, 2);
+		swapUvs(uvCoordinates_, 1, 3);
+		uvSlotStale_ = true;
 		
 		_flippedVertical = x;
 	}
 
+	TexturedQuad::~TexturedQuad()
+	{
+		if (uvSlot_ != StaticVertexBuffer::noSlot)
+			quadUvs().release(uvSlot_);
+	}
+
 	Size TexturedQuad::getRealSize() const
 	{
 		return Size(realBound.right - realBound.left, realBound.top - realBound.bottom);
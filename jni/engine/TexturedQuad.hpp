@@ -21,6 +21,7 @@
 #include "Mesh.hpp"
 #include "Size.hpp"
 #include "Point.hpp"
+#include <string>
 
 namespace engine
 {
@@ -39,8 +40,11 @@ public:
 		, _scaleX(1.0)
 		, _scaleY(1.0)
 		, realBound(0, width, height, 0)
-
-		
+		, uvSlot_(~UInt32(0))
+		, uvSlotStale_(false)
+		, opaque_(false)
+		, trimmed_(false)
+		, trimmedArea_(-0.5, 0.5, 0.5, -0.5)
 	{
 		uvCoordinates_[0] = uMin;
 		uvCoordinates_[1] = vMax;
@@ -66,7 +70,11 @@ public:
 		, _scaleX(1.0)
 		, _scaleY(1.0)
 		, realBound(realBoundingRect)
-
+		, uvSlot_(~UInt32(0))
+		, uvSlotStale_(false)
+		, opaque_(false)
+		, trimmed_(false)
+		, trimmedArea_(-0.5, 0.5, 0.5, -0.5)
 	{
 		uvCoordinates_[0] = uMin;
 		uvCoordinates_[1] = vMax;
@@ -80,6 +88,8 @@ public:
 		uvCoordinates_[7] = vMin;
 	}
 
+	virtual ~TexturedQuad();
+
 	virtual void draw(const Rectangle& screen);
 
 	// Return size of full image.
@@ -102,6 +112,24 @@ public:
 	float getScaleX(){ return _scaleX; }
 	float getScaleY(){ return _scaleY; }
 
+	// Every pixel of the image has full alpha, as the atlas says. Nothing shows through where an
+	// opaque quad is drawn, so it can go with blending off. False until the texture is loaded, as
+	// nothing is drawn then.
+	bool opaque() const { return opaque_ && texture_ && texture_->loaded(); }
+	void setOpaque(bool x) { opaque_ = x; }
+
+	// The atlas has the image turned a quarter clockwise, to pack better. Call before any flip.
+	void setRotatedInAtlas();
+
+	// The atlas only has the part of the image in area, the rest was transparent and trimmed
+	// off. area is in the quad's own units, -0.5 to 0.5 with y up, so the part is drawn where
+	// it was in the full image.
+	void setTrimmedArea(const Rectangle& area) { trimmed_ = true; trimmedArea_ = area; }
+
+	// The atlas' name for the image, what drawcapture records. Empty for quads not from an atlas.
+	const std::string& name() const { return name_; }
+	void setName(const std::string& x) { name_ = x; }
+
 private:
 	TexturePtr texture_;
 	GLfloat uvCoordinates_[8];
@@ -111,9 +139,19 @@ private:
 	bool _flippedVertical;
 	float _scaleX;
 	float _scaleY;
+	Rectangle realBound;
+	// Where uvCoordinates_ are in the buffer all quads share, from the first draw on.
+	UInt32 uvSlot_;
+	bool uvSlotStale_;
+	bool opaque_;
+	bool trimmed_;
+	Rectangle trimmedArea_;
+	std::string name_;
 	static const GLfloat s_texturedQuadVertexes[8];
 	static const GLfloat s_texturedQuadColorValues[16];
-	Rectangle realBound;
+
+	TexturedQuad(const TexturedQuad&);
+	TexturedQuad& operator=(const TexturedQuad&);
 };
 
 }
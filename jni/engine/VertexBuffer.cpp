@@ -0,0 +1,161 @@
+// Copyright 2011 Nuffer Brothers Software LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "VertexBuffer.hpp"
+#include "miniblocxx/MutexLock.hpp"
+#include <algorithm>
+#include <string.h>
+
+namespace engine
+{
+
+namespace
+{
+	// A thread that records what it draws copies the vertex data, it can't use buffer objects.
+	bool useBuffers()
+	{
+		return !gl::recording() && gl::state.buffers;
+	}
+}
+
+StaticVertexBuffer::StaticVertexBuffer(size_t slotFloats)
+: _slotFloats(slotFloats)
+, _dirtyBegin(0)
+, _dirtyEnd(0)
+, _buffer(0)
+, _bufferFloats(0)
+, _context(0)
+{
+}
+
+UInt32 StaticVertexBuffer::allocate(const GLfloat* data)
+{
+	{
+		MutexLock lock(_releasedGuard);
+		_free.insert(_free.end(), _released.begin(), _released.end());
+		_released.clear();
+	}
+	UInt32 slot;
+	if (_free.empty())
+	{
+		slot = _data.size() / _slotFloats;
+		_data.resize(_data.size() + _slotFloats);
+	}
+	else
+	{
+		slot = _free.back();
+		_free.pop_back();
+	}
+	set(slot, data);
+	return slot;
+}
+
+void StaticVertexBuffer::set(UInt32 slot, const GLfloat* data)
+{
+	size_t begin = slot * _slotFloats;
+	memcpy(&_data[begin], data, _slotFloats * sizeof(GLfloat));
+	if (_dirtyBegin == _dirtyEnd)
+	{
+		_dirtyBegin = begin;
+		_dirtyEnd = begin + _slotFloats;
+	}
+	else
+	{
+		_dirtyBegin = std::min(_dirtyBegin, begin);
+		_dirtyEnd = std::max(_dirtyEnd, begin + _slotFloats);
+	}
+}
+
+void StaticVertexBuffer::release(UInt32 slot)
+{
+	MutexLock lock(_releasedGuard);
+	_released.push_back(slot);
+}
+
+GLuint StaticVertexBuffer::prepare()
+{
+	using namespace gl;
+	if (!useBuffers())
+		return 0;
+
+	if (_buffer == 0 || _context != state.context)
+	{
+		_buffer = genBuffer();
+		_bufferFloats = 0;
+		_context = state.context;
+	}
+	bindArrayBuffer(_buffer);
+	if (_data.size() > _bufferFloats)
+	{
+		// Room for what may come, so allocating doesn't mean uploading everything again.
+		_bufferFloats = _data.capacity();
+		bufferData(_bufferFloats * sizeof(GLfloat), NULL, GL_STATIC_DRAW);
+		bufferSubData(0, _data.size() * sizeof(GLfloat), &_data[0]);
+	}
+	else if (_dirtyBegin != _dirtyEnd)
+	{
+		bufferSubData(_dirtyBegin * sizeof(GLfloat), (_dirtyEnd - _dirtyBegin) * sizeof(GLfloat), &_data[_dirtyBegin]);
+	}
+	_dirtyBegin = _dirtyEnd = 0;
+	return _buffer;
+}
+
+const GLvoid* StaticVertexBuffer::pointer(UInt32 slot, size_t offset) const
+{
+	size_t at = slot * _slotFloats + offset;
+	if (useBuffers())
+		return reinterpret_cast<const GLvoid*>(at * sizeof(GLfloat));
+	return &_data[at];
+}
+
+StreamingVertexBuffer::StreamingVertexBuffer()
+: _next(0)
+, _context(0)
+{
+	_buffers[0] = _buffers[1] = 0;
+}
+
+GLuint StreamingVertexBuffer::upload(const GLfloat* data, size_t count, const GLvoid*& pointer)
+{
+	using namespace gl;
+	if (!useBuffers())
+	{
+		pointer = data;
+		return 0;
+	}
+
+	if (_buffers[0] == 0 || _context != state.context)
+	{
+		_buffers[0] = genBuffer();
+		_buffers[1] = genBuffer();
+		_context = state.context;
+	}
+	unsigned turn = _next;
+	_next = 1 - _next;
+	bindArrayBuffer(_buffers[turn]);
+	// ES 1.1 has no GL_STREAM_DRAW. Not glBufferSubData(), new storage lets the driver
+	// leave the old to pending draws.
+	bufferData(count * sizeof(GLfloat), data, GL_DYNAMIC_DRAW);
+	pointer = NULL;
+	return _buffers[turn];
+}
+
+StreamingVertexBuffer& StreamingVertexBuffer::shared()
+{
+	// Never destroyed, the context outlives the statics' destructors anyway.
+	static StreamingVertexBuffer* buffer = new StreamingVertexBuffer;
+	return *buffer;
+}
+
+}
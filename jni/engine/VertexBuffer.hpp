@@ -0,0 +1,102 @@
+// Copyright 2011 Nuffer Brothers Software LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef engine_VertexBuffer_HPP_INCLUDED
+#define engine_VertexBuffer_HPP_INCLUDED
+
+#include "EngineConfig.hpp"
+#include "GL.hpp"
+#include "miniblocxx/Mutex.hpp"
+#include "miniblocxx/Types.hpp"
+#include <vector>
+
+namespace engine
+{
+
+/**
+ * Vertex data that rarely changes, in equal slots of one buffer object that GL keeps,
+ * so drawing doesn't copy it to the GPU again. Where the context has no buffer objects
+ * the slots stay in client memory, and drawing works the same.
+ *
+ * Only the GL thread allocates, sets and draws, release() can come from any thread.
+ */
+class StaticVertexBuffer
+{
+public:
+	explicit StaticVertexBuffer(size_t slotFloats);
+	// Leaves the buffer object to the context, it may be gone already.
+	~StaticVertexBuffer() {}
+
+	// Takes a slot for slotFloats floats at data.
+	UInt32 allocate(const GLfloat* data);
+	void set(UInt32 slot, const GLfloat* data);
+	void release(UInt32 slot);
+
+	// Gets what changed to GL. Returns the buffer to hand gl::vertex() and the like with
+	// pointer(), 0 when the data is in client memory.
+	GLuint prepare();
+	// Where offset floats into slot is, after prepare().
+	const GLvoid* pointer(UInt32 slot, size_t offset = 0) const;
+
+	static const UInt32 noSlot = ~UInt32(0);
+
+private:
+	StaticVertexBuffer(const StaticVertexBuffer&);
+	StaticVertexBuffer& operator=(const StaticVertexBuffer&);
+
+	size_t _slotFloats;
+	std::vector<GLfloat> _data;
+	Mutex _releasedGuard;
+	std::vector<UInt32> _released;
+	std::vector<UInt32> _free;
+	// What of _data GL doesn't have yet, in floats.
+	size_t _dirtyBegin;
+	size_t _dirtyEnd;
+	GLuint _buffer;
+	size_t _bufferFloats;
+	unsigned _context;
+};
+
+/**
+ * Vertex data that is new every time it's drawn. Two buffer objects take turns, and each
+ * upload gives the driver new storage, so it never waits for the GPU to finish drawing
+ * the old contents. Without buffer objects the data is drawn from where it is. GL thread
+ * only.
+ */
+class StreamingVertexBuffer
+{
+public:
+	StreamingVertexBuffer();
+	~StreamingVertexBuffer() {}
+
+	// Gets count floats at data to GL. Returns the buffer to hand gl::vertex() and the
+	// like, and pointer to go with it. data has to last until the draw if it returns 0.
+	// A draw can use the last two uploads, a third takes the first one's buffer.
+	GLuint upload(const GLfloat* data, size_t count, const GLvoid*& pointer);
+
+	// The one all simple geometry shares.
+	static StreamingVertexBuffer& shared();
+
+private:
+	StreamingVertexBuffer(const StreamingVertexBuffer&);
+	StreamingVertexBuffer& operator=(const StreamingVertexBuffer&);
+
+	GLuint _buffers[2];
+	unsigned _next;
+	unsigned _context;
+};
+
+}
+
+#endif
@@ -0,0 +1,148 @@
+// Copyright 2011 Nuffer Brothers Software LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "VoicePool.hpp"
+#include "SoundAsset.hpp"
+#include "Log.hpp"
+
+namespace engine
+{
+
+VoicePool::VoicePool(size_t voiceCount)
+	: _nextSerial(1)
+	, _audibleDistance(defaultAudibleDistance)
+{
+	for (size_t i = 0; i < voiceCount; ++i)
+	{
+		Voice voice;
+		voice.source = 0;
+		voice.priority = 0;
+		voice.serial = 0;
+		alGenSources(1, &voice.source);
+		if (alGetError() != AL_NO_ERROR)
+		{
+			LOGE("VoicePool: only got %zu of %zu sources", _voices.size(), voiceCount);
+			break;
+		}
+		_voices.push_back(voice);
+	}
+}
+
+VoicePool::~VoicePool()
+{
+	for (size_t i = 0; i < _voices.size(); ++i)
+	{
+		alSourceStop(_voices[i].source);
+		alDeleteSources(1, &_voices[i].source);
+	}
+}
+
+bool VoicePool::play(const SoundAssetPtr& asset, int priority, float gain, bool loop, VoiceHandle& handle)
+{
+	if (!asset || !asset->isValid())
+		return false;
+
+	Voice* voice = findVoice(priority);
+	if (!voice)
+		return false;
+
+	alSourceStop(voice->source);
+	alSourcei(voice->source, AL_BUFFER, asset->buffer());
+	alSourcei(voice->source, AL_LOOPING, loop ? AL_TRUE : AL_FALSE);
+	alSourcef(voice->source, AL_GAIN, gain);
+	alSourcePlay(voice->source);
+	ALenum problem;
+	if((problem = alGetError()) != AL_NO_ERROR)
+		LOGE("openAL detected an error: %d",problem);
+
+	voice->asset = asset;
+	voice->priority = priority;
+	voice->serial = _nextSerial++;
+	handle.voice = voice - &_voices[0];
+	handle.serial = voice->serial;
+	return true;
+}
+
+bool VoicePool::playAt(const SoundAssetPtr& asset, int priority, float gain, bool loop, const Point& position, VoiceHandle& handle)
+{
+	float dx = position.x() - _listenerPosition.x();
+	float dy = position.y() - _listenerPosition.y();
+	if (dx * dx + dy * dy > _audibleDistance * _audibleDistance)
+		return false;
+	return play(asset, priority, gain, loop, handle);
+}
+
+bool VoicePool::isPlaying(const VoiceHandle& handle) const
+{
+	return owns(handle) && isPlaying(_voices[handle.voice]);
+}
+
+void VoicePool::stop(const VoiceHandle& handle)
+{
+	if (owns(handle))
+		alSourceStop(_voices[handle.voice].source);
+}
+
+void VoicePool::setGain(const VoiceHandle& handle, float gain)
+{
+	if (owns(handle))
+		alSourcef(_voices[handle.voice].source, AL_GAIN, gain);
+}
+
+size_t VoicePool::playingVoiceCount() const
+{
+	size_t count = 0;
+	for (size_t i = 0; i < _voices.size(); ++i)
+	{
+		if (isPlaying(_voices[i]))
+			++count;
+	}
+	return count;
+}
+
+bool VoicePool::isPlaying(const Voice& voice) const
+{
+	if (voice.serial == 0)
+		return false;
+	ALint state = 0;
+	alGetSourcei(voice.source, AL_SOURCE_STATE, &state);
+	return state == AL_PLAYING;
+}
+
+bool VoicePool::owns(const VoiceHandle& handle) const
+{
+	return handle.serial != 0 && handle.voice < _voices.size() && _voices[handle.voice].serial == handle.serial;
+}
+
+VoicePool::Voice* VoicePool::findVoice(int priority)
+{
+	Voice* victim = NULL;
+	for (size_t i = 0; i < _voices.size(); ++i)
+	{
+		Voice& voice = _voices[i];
+		if (!isPlaying(voice))
+			return &voice;
+		if (!victim || voice.priority < victim->priority ||
+			(voice.priority == victim->priority && voice.serial < victim->serial))
+		{
+			victim = &voice;
+		}
+	}
+
+	if (victim && victim->priority <= priority)
+		return victim;
+	return NULL;
+}
+
+}
@@ -0,0 +1,92 @@
+// Copyright 2011 Nuffer Brothers Software LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef engine_VoicePool_HPP_INCLUDED
+#define engine_VoicePool_HPP_INCLUDED
+
+#include "EngineConfig.hpp"
+#include "EngineFwd.hpp"
+#include "Point.hpp"
+#include "boost/noncopyable.hpp"
+#ifdef __APPLE__
+#include <OpenAL/al.h>
+#else
+#include "openal/include/AL/al.h"
+#endif
+#include <vector>
+
+
+namespace engine
+{
+    /**
+     * A fixed number of OpenAL sources shared by all sounds, so the source count doesn't
+     * grow with the number of assets and one asset can play on several voices at once.
+     *
+     * When every voice is busy, a new play takes the voice with the lowest priority,
+     * the oldest one of those, unless that priority is higher than its own. Positional
+     * plays further than audibleDistance() from the listener are dropped.
+     */
+    class VoicePool : private boost::noncopyable
+    {
+    public:
+        // Identifies one play of an asset. Once its voice is reused the handle just stops matching.
+        struct VoiceHandle
+        {
+            VoiceHandle(): voice(0), serial(0) {}
+            size_t voice;
+            unsigned serial;
+        };
+
+        static const size_t defaultVoiceCount = 16;
+        static const float defaultAudibleDistance = 600.0f;
+
+        explicit VoicePool(size_t voiceCount);
+        ~VoicePool();
+
+        void setListenerPosition(const Point& position) { _listenerPosition = position; }
+        const Point& listenerPosition() const { return _listenerPosition; }
+        void setAudibleDistance(float distance) { _audibleDistance = distance; }
+        float audibleDistance() const { return _audibleDistance; }
+
+        // Starts asset on a voice. Returns false if it was dropped, leaving handle untouched.
+        bool play(const SoundAssetPtr& asset, int priority, float gain, bool loop, VoiceHandle& handle);
+        bool playAt(const SoundAssetPtr& asset, int priority, float gain, bool loop, const Point& position, VoiceHandle& handle);
+
+        bool isPlaying(const VoiceHandle& handle) const;
+        void stop(const VoiceHandle& handle);
+        void setGain(const VoiceHandle& handle, float gain);
+
+        size_t voiceCount() const { return _voices.size(); }
+        size_t playingVoiceCount() const;
+
+    private:
+        struct Voice
+        {
+            ALuint source;
+            SoundAssetPtr asset;
+            int priority;
+            unsigned serial; // 0 while unused, otherwise larger for later plays
+        };
+
+        bool isPlaying(const Voice& voice) const;
+        bool owns(const VoiceHandle& handle) const;
+        Voice* findVoice(int priority);
+
+        std::vector<Voice> _voices;
+        unsigned _nextSerial;
+        Point _listenerPosition;
+        float _audibleDistance;
+    };
+}
+#endif
@@ -38,7 +38,7 @@ namespace rr
     void Animal::playHitSound() const
     {
         if (_hitSound)
-            _hitSound->play();
+            _hitSound->playAt(position());
     }
 	
 	void Animal::stopSounds() const
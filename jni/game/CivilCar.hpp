@@ -26,6 +26,7 @@ namespace rr
 		{}
 
 		virtual float getTurnAngle();
+		virtual bool isCivilCar() const { return true; }
 
 	};
 
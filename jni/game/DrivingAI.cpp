@@ -4,17 +4,26 @@
 #include "Truck.hpp"
 #include "engine/Log.hpp"
 #include "boost/random.hpp"
+#include "boost/foreach.hpp"
+
+#define foreach BOOST_FOREACH
 
 namespace rr
 {
 
 	static boost::mt19937 rng(::time(NULL));
 
+	void DrivingAI::seedRandom(unsigned seed)
+	{
+		rng.seed(seed);
+	}
+
 	DrivingAI::DrivingAI(TruckControllerPtr controller, RoadBoundPtr road):
 		  truckController(controller)
 		, roadBound(road)
 		, currentIndexInRoadBound(0)
 		, posOnRoad(P_Random)
+		, braking(false)
 	{
 		const Rectangle& truckRect = controller->getTruck()->getBoundingRect();
 		truckWidth = (truckRect.right - truckRect.left) * 1.6f;
@@ -27,11 +36,77 @@ namespace rr
 		 LOGI("Turning accuracy set to %f", turningAccuracy);
 	}
 
-	void DrivingAI::update(const TimeDuration& deltaTime, vector<TruckControllerPtr>& trucksControllers)
+	void DrivingAI::decide(const TimeDuration& deltaTime, const NeighbourIndex& neighbours)
 	{
+		clearDecision();
 		const Rectangle& truckRect = truckController->getTruck()->getBoundingRect();
 		stayOnRoad(deltaTime, truckRect);
-		processOtherTrucks(truckRect, trucksControllers, deltaTime);
+		processOtherTrucks(truckRect, neighbours, deltaTime);
+	}
+
+	void DrivingAI::applyDecision()
+	{
+		const TruckPtr& truck = truckController->getTruck();
+		switch (decision.turn)
+		{
+			case Decision::T_Left: truck->setInputLeft(true); break;
+			case Decision::T_Right: truck->setInputRight(true); break;
+			case Decision::T_Straight: truck->setInputLeft(false); break;
+			case Decision::T_Unchanged: break;
+		}
+
+		switch (decision.brake)
+		{
+			case Decision::B_Down: truckController->brakeActionDown(); break;
+			case Decision::B_Up: truckController->brakeActionUp(); break;
+			case Decision::B_Unchanged: break;
+		}
+
+		if (decision.nitro)
+		{
+			truckController->nitroActionDown();
+		}
+
+		if (decision.shoot)
+		{
+			truckController->getShotGun().shoot();
+			truck->activateAttachedAnimation(Truck::ShotgunBlast);
+		}
+
+		foreach(const Hit& hit, decision.hits)
+		{
+			const TruckPtr& target = hit.target->getTruck();
+			if (hit.damage > 0)
+			{
+				target->decrementHealth(hit.damage);
+			}
+			target->setAttachedAnimationPosition(Truck::Sparks, Point(0, -(target->size().height()) / 2));
+			target->activateAttachedAnimation(Truck::Sparks);
+		}
+	}
+
+	void DrivingAI::clearDecision()
+	{
+		decision.turn = Decision::T_Unchanged;
+		decision.brake = Decision::B_Unchanged;
+		decision.nitro = false;
+		decision.shoot = false;
+		decision.hits.clear();
+		braking = truckController->isBraking();
+	}
+
+	bool DrivingAI::isReadyToShoot()
+	{
+		// The gun isn't fired until applyDecision(), so one already decided on counts too.
+		return !decision.shoot && truckController->getShotGun().isReadyToShoot();
+	}
+
+	void DrivingAI::hitTruck(const TruckControllerPtr& target, int damage)
+	{
+		Hit hit;
+		hit.target = target.get();
+		hit.damage = damage;
+		decision.hits.push_back(hit);
 	}
 
 	void DrivingAI::stayOnRoad(const TimeDuration& deltaTime, const Rectangle& truckRect)
@@ -95,18 +170,18 @@ namespace rr
 		if (truckRect.left <= leftBorder)
 		{
 			turningTime = TimeDuration();
-			truckController->getTruck()->setInputRight(true); // Driving right back to road.
+			turnTruck(Decision::T_Right); // Driving right back to road.
 		}
 		else if (truckRect.right >= rightBorder)
 		{
 			turningTime = TimeDuration();
-			truckController->getTruck()->setInputLeft(true); // Driving left back to road.
+			turnTruck(Decision::T_Left); // Driving left back to road.
 		}
 		else
 		{
 			if (turningTime.realSeconds() > turningAccuracy)
 			{
-				truckController->getTruck()->setInputLeft(false);  //Reset all turning actions.
+				turnTruck(Decision::T_Straight);  //Reset all turning actions.
 				accelerateTruck();
 			}
 		}
@@ -115,11 +190,19 @@ namespace rr
 
 	void DrivingAI::slowdownTruck()
 	{
-		if (!truckController->isBraking()) truckController->brakeActionDown();
+		if (!braking)
+		{
+			decision.brake = Decision::B_Down;
+			braking = true;
+		}
 	}
 	void DrivingAI::accelerateTruck()
 	{
-		if (truckController->isBraking()) truckController->brakeActionUp();
+		if (braking)
+		{
+			decision.brake = Decision::B_Up;
+			braking = false;
+		}
 	}
 
 } // namespace rr
@@ -9,6 +9,7 @@
 #include "miniblocxx/IntrusiveCountableBase.hpp"
 #include "TruckController.hpp"
 #include "RoadBound.hpp"
+#include "NeighbourIndex.hpp"
 
 namespace rr
 {
@@ -16,6 +17,8 @@ namespace rr
 	{
 	public:
 		DrivingAI(TruckControllerPtr controller, RoadBoundPtr road);
+		// See seedRandomGenerators().
+		static void seedRandom(unsigned seed);
 		enum PositionOnRoad
 		{
 			P_Left = 0,
@@ -23,18 +26,64 @@ namespace rr
 			P_Random
 		};
 
+		// A shotgun hit on another vehicle. damage may be 0, the target still shows sparks.
+		struct Hit
+		{
+			TruckController* target;
+			int damage;
+		};
+
+		// Everything the AI wants to change in the world this frame.
+		struct Decision
+		{
+			enum Turn
+			{
+				T_Unchanged = 0,
+				T_Left,
+				T_Right,
+				T_Straight
+			};
+			enum Brake
+			{
+				B_Unchanged = 0,
+				B_Down,
+				B_Up
+			};
+
+			Decision(): turn(T_Unchanged), brake(B_Unchanged), nitro(false), shoot(false) {}
+
+			Turn turn;
+			Brake brake;
+			bool nitro;
+			bool shoot;
+			vector<Hit> hits;
+		};
+
 		virtual ~DrivingAI(){}
-		virtual void update(const TimeDuration& deltaTime, vector<TruckControllerPtr>& trucksControllers);
+		// Works out this frame's decision. Only reads the AI's own truck and the snapshot in
+		// neighbours, and only writes to the AI itself, so all AIs may decide in parallel.
+		virtual void decide(const TimeDuration& deltaTime, const NeighbourIndex& neighbours);
+		// Carries out the last decision. Call on the main thread, for all AIs in a fixed order.
+		void applyDecision();
+		const Decision& getDecision() const { return decision; }
 		virtual void setPositionOnRoad(PositionOnRoad position) { posOnRoad = position; }
 		TruckControllerPtr& getTruckController() { return truckController; }
 
 	protected:
-		virtual void processOtherTrucks(const Rectangle& truckRect, vector<TruckControllerPtr>& trucksControllers, 
+		virtual void processOtherTrucks(const Rectangle& truckRect, const NeighbourIndex& neighbours, 
 										const TimeDuration& deltaTime) {}
 		virtual void slowdownTruck();
 		virtual void accelerateTruck();
 		virtual void stayOnRoad(const TimeDuration& deltaTime, const Rectangle& truckRect);
 
+		// Helpers for decide() that record into decision instead of changing the truck.
+		void clearDecision();
+		void turnTruck(Decision::Turn turn) { decision.turn = turn; }
+		void nitroTruck() { decision.nitro = true; }
+		bool isReadyToShoot();
+		void shootGun() { decision.shoot = true; }
+		void hitTruck(const TruckControllerPtr& target, int damage);
+
 	protected:
 		TruckControllerPtr truckController;
 
@@ -48,6 +97,8 @@ namespace rr
 		float truckWidth;
 		float turningAccuracy;
 		TimeDuration turningTime;
+		bool braking; // the brake state decision will leave the truck in
+		Decision decision;
 
 	};
 } // namespace rr
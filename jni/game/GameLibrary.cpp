@@ -9,10 +9,13 @@
 #include "miniblocxx/Array.hpp"
 #include "engine/TexturedFont.hpp"
 #include "engine/Log.hpp"
+#include "engine/Profiler.hpp"
 #include "CivilCar.hpp"
 #include "boost/foreach.hpp"
 #define foreach BOOST_FOREACH
 #include "engine/Sound.hpp"
+#include "engine/StreamingSound.hpp"
+#include "boost/bind.hpp"
 
 namespace rr
 {
@@ -51,11 +54,31 @@ namespace rr
 		{
 			return Format("%1TruckDrivesNorth%<2:04>", truckColorStr(color), frame);
 		}
-	}
 
-    GameLibrary::GameLibrary(const TextureLibraryPtr& textureLibrary)
+		// Every sound effect load() makes, the rage sounds aside.
+		const char* soundFiles[] = {
+			"sounds/fat_guy_splash.wav",
+			"sounds/puddle_splash.wav",
+			"sounds/outhouse_smash.wav",
+			"sounds/hit_bush.wav",
+			"sounds/hit_tree.wav",
+			"sounds/tractor_crash.wav",
+			"sounds/roadkill_hit.wav",
+			"sounds/Shotgun.wav",
+			"sounds/GunPing.wav",
+			"sounds/cops_coming.wav",
+			"sounds/racers_crash.wav",
+			"sounds/truck_startup.wav",
+			"sounds/truck_rev_fade.wav"
+		};
+		const int rageSoundCount = 6;
+	}
+
+    GameLibrary::GameLibrary(const TextureLibraryPtr& textureLibrary, VoicePool& voices)
         : _textureLibrary(textureLibrary)
+        , _voices(voices)
         , progressCallback(NULL)
+        , soundProgressCallback(NULL)
     {}
 
     GameLibrary::~GameLibrary()
@@ -94,6 +117,37 @@ namespace rr
 		progressCallback = progressCbck;
 	}
 
+	void GameLibrary::setSoundProgressFunction(const std::tr1::function<void (float)>& soundProgressCbck)
+	{
+		soundProgressCallback = soundProgressCbck;
+	}
+
+	size_t GameLibrary::soundCount()
+	{
+		return sizeof_array(soundFiles) + rageSoundCount;
+	}
+
+	void GameLibrary::startLoadingSounds()
+	{
+		if (_soundBank.started())
+			return;
+		for (size_t i = 0; i < sizeof_array(soundFiles); ++i)
+		{
+			_soundBank.add(soundFiles[i]);
+		}
+		for (int i = 1; i <= rageSoundCount; i++)
+		{
+			_soundBank.add(Format("sounds/rage%1.wav", i).c_str());
+		}
+		_soundBank.start();
+	}
+
+	void GameLibrary::soundLoaded(const SoundBank::LoadReport& report)
+	{
+		LOGD("Loaded %s: read %.1fms, converted %.1fms", report.filename.c_str(), report.readMs, report.convertMs);
+		if (soundProgressCallback != NULL) soundProgressCallback(report.fraction);
+	}
+
 	CivilCarPtr GameLibrary::civilCar(TruckColor color) const
 	{
 		string name = Format("%1CarDrivesNorth0001", truckColorStr(color));
@@ -496,6 +550,7 @@ namespace rr
 
 	void GameLibrary::load()
 	{
+		PROFILE_ZONE("GameLibrary::load");
 		LOGD("GameLibrary::load");
 		// Loading real bounding rectangles.
 		_textureLibrary->loadRealBounds("realrect.bound");
@@ -530,13 +585,17 @@ namespace rr
 		_textureLibrary->animationFrames("Tree", _obstaclesFrames[(size_t)Tree]);
 		_textureLibrary->animationFrames("Tractor", _obstaclesFrames[(size_t)Tractor]);
         
+        // Usually started before the textures, so most of the sounds are ready by now.
+        startLoadingSounds();
+        _soundBank.finish(boost::bind(&GameLibrary::soundLoaded, this, _1));
+
         _obstaclesSounds.resize(obstacleCount);
-        _obstaclesSounds[(size_t)FatGuy] = new Sound(Resources::loadResourceFromAssets("sounds/fat_guy_splash.wav"), Sound::E_PLAY_ONCE);
-        _obstaclesSounds[(size_t)Puddle] = new Sound(Resources::loadResourceFromAssets("sounds/puddle_splash.wav"), Sound::E_PLAY_ONCE);
-        _obstaclesSounds[(size_t)Outhouse] = new Sound(Resources::loadResourceFromAssets("sounds/outhouse_smash.wav"), Sound::E_PLAY_ONCE);
-        _obstaclesSounds[(size_t)Shrub] = new Sound(Resources::loadResourceFromAssets("sounds/hit_bush.wav"), Sound::E_PLAY_ONCE);
-        _obstaclesSounds[(size_t)Tree] = new Sound(Resources::loadResourceFromAssets("sounds/hit_tree.wav"), Sound::E_PLAY_ONCE);
-        _obstaclesSounds[(size_t)Tractor] = new Sound(Resources::loadResourceFromAssets("sounds/tractor_crash.wav"), Sound::E_PLAY_ONCE);
+        _obstaclesSounds[(size_t)FatGuy] = new Sound(_voices, _soundBank.asset("sounds/fat_guy_splash.wav"), Sound::E_PLAY_ONCE, 1.0, Sound::E_PRIORITY_LOW);
+        _obstaclesSounds[(size_t)Puddle] = new Sound(_voices, _soundBank.asset("sounds/puddle_splash.wav"), Sound::E_PLAY_ONCE, 1.0, Sound::E_PRIORITY_LOW);
+        _obstaclesSounds[(size_t)Outhouse] = new Sound(_voices, _soundBank.asset("sounds/outhouse_smash.wav"), Sound::E_PLAY_ONCE, 1.0, Sound::E_PRIORITY_LOW);
+        _obstaclesSounds[(size_t)Shrub] = new Sound(_voices, _soundBank.asset("sounds/hit_bush.wav"), Sound::E_PLAY_ONCE, 1.0, Sound::E_PRIORITY_LOW);
+        _obstaclesSounds[(size_t)Tree] = new Sound(_voices, _soundBank.asset("sounds/hit_tree.wav"), Sound::E_PLAY_ONCE, 1.0, Sound::E_PRIORITY_LOW);
+        _obstaclesSounds[(size_t)Tractor] = new Sound(_voices, _soundBank.asset("sounds/tractor_crash.wav"), Sound::E_PLAY_ONCE, 1.0, Sound::E_PRIORITY_LOW);
 
 		_animalFrameNames.resize(5);
 		_animalFrameNames[(size_t)Armadillo] = _textureLibrary->listQuads("ArmadilloAlive");
@@ -544,27 +603,27 @@ namespace rr
 		_animalFrameNames[(size_t)Possum] = _textureLibrary->listQuads("PossumAlive");
 		_animalFrameNames[(size_t)Raccoon] = _textureLibrary->listQuads("RaccoonAlive");
 		_animalFrameNames[(size_t)Squirrel] = _textureLibrary->listQuads("SquirrelAlive");
-        _animalSound = new Sound(Resources::loadResourceFromAssets("sounds/roadkill_hit.wav"), Sound::E_PLAY_ONCE);
+        _animalSound = new Sound(_voices, _soundBank.asset("sounds/roadkill_hit.wav"), Sound::E_PLAY_ONCE, 1.0, Sound::E_PRIORITY_LOW);
 
-        _backgroundMusic = new Sound(Resources::loadResourceFromAssets("sounds/Edits_Intro4.wav"), Sound::E_LOOP);
-        _shotgunSound = new Sound(Resources::loadResourceFromAssets("sounds/Shotgun.wav"), Sound::E_PLAY_ONCE);
-        _gunPingSound = new Sound(Resources::loadResourceFromAssets("sounds/GunPing.wav"), Sound::E_PLAY_ONCE);
-        _copsComingSound = new Sound(Resources::loadResourceFromAssets("sounds/cops_coming.wav"), Sound::E_PLAY_ONCE);
-        _racersCrashSound = new Sound(Resources::loadResourceFromAssets("sounds/racers_crash.wav"), Sound::E_PLAY_ONCE);
+        _backgroundMusic = new StreamingSound(Resources::openResourceStreamFromAssets("sounds/Edits_Intro4.wav"));
+        _shotgunSound = new Sound(_voices, _soundBank.asset("sounds/Shotgun.wav"), Sound::E_PLAY_ONCE);
+        _gunPingSound = new Sound(_voices, _soundBank.asset("sounds/GunPing.wav"), Sound::E_PLAY_ONCE);
+        _copsComingSound = new Sound(_voices, _soundBank.asset("sounds/cops_coming.wav"), Sound::E_PLAY_ONCE);
+        _racersCrashSound = new Sound(_voices, _soundBank.asset("sounds/racers_crash.wav"), Sound::E_PLAY_ONCE, 1.0, Sound::E_PRIORITY_LOW);
 
-        for (int i = 1; i <= 6; i++)
+        for (int i = 1; i <= rageSoundCount; i++)
         {
-            _rageSounds.push_back(new Sound(Resources::loadResourceFromAssets(Format("sounds/rage%1.wav", i).c_str()), Sound::E_PLAY_ONCE));
+            _rageSounds.push_back(new Sound(_voices, _soundBank.asset(Format("sounds/rage%1.wav", i).c_str()), Sound::E_PLAY_ONCE, 1.0, Sound::E_PRIORITY_HIGH));
         }
 
-        _truckStartupSound = new Sound(Resources::loadResourceFromAssets("sounds/truck_startup.wav"), Sound::E_PLAY_ONCE);
-        _truckRevFadeSound = new Sound(Resources::loadResourceFromAssets("sounds/truck_rev_fade.wav"), Sound::E_PLAY_ONCE);
+        _truckStartupSound = new Sound(_voices, _soundBank.asset("sounds/truck_startup.wav"), Sound::E_PLAY_ONCE);
+        _truckRevFadeSound = new Sound(_voices, _soundBank.asset("sounds/truck_rev_fade.wav"), Sound::E_PLAY_ONCE);
         
 		LOGD("GameLibrary::load finished");
 
 	}
 
-    SoundPtr GameLibrary::backgroundMusic() const
+    StreamingSoundPtr GameLibrary::backgroundMusic() const
     {
         return _backgroundMusic;
     }
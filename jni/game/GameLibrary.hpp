@@ -10,6 +10,7 @@
 #include "miniblocxx/String.hpp"
 #include "miniblocxx/Array.hpp"
 #include "engine/TouchButton.hpp"
+#include "engine/SoundBank.hpp"
 #include <tr1/functional>
 
 
@@ -18,10 +19,13 @@ namespace rr
 	class GameLibrary
 	{
 	public:
-		GameLibrary(const TextureLibraryPtr& textureLibrary);
+		GameLibrary(const TextureLibraryPtr& textureLibrary, VoicePool& voices);
 		
         ~GameLibrary();
 
+		// Reads the sound effects on worker threads until load() needs them, call it
+		// before loading the textures so the two overlap.
+		void startLoadingSounds();
 		// should be called to load cache of TexturedQuadPtrs/Animations.
 		void load();
 		void loadMenuButtons();
@@ -30,8 +34,13 @@ namespace rr
 		
 		void setSoundGain(float gain);
 		void setMusicGain(float gain);
+		VoicePool& voices() { return _voices; }
 		
 		void setProgressFunction(const std::tr1::function<void (float)>& progressCallback);
+		// Called once for each sound load() collects, with the bank's fraction done so far.
+		void setSoundProgressFunction(const std::tr1::function<void (float)>& soundProgressCallback);
+		// How many sounds startLoadingSounds() queues.
+		static size_t soundCount();
 
 		// sprites
 		PlayerTruckPtr playerTruck(float& rollAngle) const;
@@ -179,7 +188,7 @@ namespace rr
 		void unloadRaceAtlases() const;
 
         // music
-        SoundPtr backgroundMusic() const;
+        StreamingSoundPtr backgroundMusic() const;
         
         // sounds
         SoundPtr shotgunSound() const;
@@ -189,7 +198,11 @@ namespace rr
         SoundPtr copsComingSound() const;
 
 	private:
+		void soundLoaded(const SoundBank::LoadReport& report);
+
 		const TextureLibraryPtr _textureLibrary;
+		VoicePool& _voices;
+		SoundBank _soundBank;
 		
 		std::vector<std::vector<TexturedQuadPtr> > _obstaclesFrames;
         std::vector<SoundPtr> _obstaclesSounds;
@@ -206,7 +219,8 @@ namespace rr
 		
 		std::vector<StringArray> _animalFrameNames;
 		std::tr1::function<void (float)> progressCallback;
-		SoundPtr _backgroundMusic;
+		std::tr1::function<void (float)> soundProgressCallback;
+		StreamingSoundPtr _backgroundMusic;
         SoundPtr _shotgunSound;
         SoundPtr _gunPingSound;
         SoundPtr _animalSound;
@@ -2,6 +2,12 @@
 
 #include "RRConfig.hpp"
 #include "Globals.hpp"
+#include "DrivingAI.hpp"
+#include "OpponentAI.hpp"
+#include "PlayerTruck.hpp"
+#include "RaceScene.hpp"
+#include "RoadBound.hpp"
+#include <stdlib.h>
 
 namespace rr
 {
@@ -20,4 +26,15 @@ RedneckRacerGame& game()
 	return *theGame;
 }
 
+void seedRandomGenerators(unsigned seed)
+{
+	DrivingAI::seedRandom(seed);
+	OpponentAI::seedRandom(seed);
+	PlayerTruck::seedRandom(seed);
+	RaceScene::seedRandom(seed);
+	RoadBound::seedRandom(seed);
+	// RaceTracks shuffles the random track with rand().
+	srand(seed);
+}
+
 }
@@ -10,6 +10,11 @@ namespace rr
 {
 	RedneckRacerGame& game();
 
+	// The game seeds its random number generators from the clock. This reseeds all of
+	// them, so that races built afterwards and driven with the same input play out the
+	// same way every time, as race_bench needs.
+	void seedRandomGenerators(unsigned seed);
+
 	const int DefaultScaleWidth = 480;
 	const int DefaultScaleHeight = 800;
 	const int DefaultScreenLeft = -DefaultScaleWidth/2;
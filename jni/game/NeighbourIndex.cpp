@@ -0,0 +1,82 @@
+// Copyright 2011 Nuffer Brothers Software LLC. All Rights Reserved.
+
+#include "NeighbourIndex.hpp"
+#include "TruckController.hpp"
+#include "Truck.hpp"
+#include <algorithm>
+
+namespace rr
+{
+	namespace
+	{
+		struct CompareCenterY
+		{
+			bool operator()(const NeighbourIndex::Entry& x, const NeighbourIndex::Entry& y) const { return x.center.y() < y.center.y(); }
+			bool operator()(const NeighbourIndex::Entry& x, float y) const { return x.center.y() < y; }
+			bool operator()(float x, const NeighbourIndex::Entry& y) const { return x < y.center.y(); }
+		};
+
+		struct CompareOrder
+		{
+			bool operator()(const NeighbourIndex::Entry* x, const NeighbourIndex::Entry* y) const { return x->order < y->order; }
+		};
+	}
+
+	NeighbourIndex::NeighbourIndex()
+		: leader(NULL)
+	{
+	}
+
+	void NeighbourIndex::rebuild(const std::vector<TruckControllerPtr>& controllers)
+	{
+		// Same rule the police used on the full list: start with the first controller and
+		// take any racer that is further up the track.
+		size_t leaderOrder = 0;
+		entries.resize(controllers.size());
+		for (size_t i = 0; i < controllers.size(); ++i)
+		{
+			const TruckPtr& truck = controllers[i]->getTruck();
+			Entry& entry(entries[i]);
+			entry.controller = controllers[i];
+			entry.rect = truck->getBoundingRect();
+			entry.center = Point((entry.rect.left + entry.rect.right) / 2, (entry.rect.top + entry.rect.bottom) / 2);
+			entry.position = truck->position();
+			entry.order = i;
+			entry.civilCar = truck->isCivilCar();
+			entry.racer = truck->isRacer();
+
+			if (entry.racer && truck->position().y() > controllers[leaderOrder]->getTruck()->position().y())
+				leaderOrder = i;
+		}
+		std::sort(entries.begin(), entries.end(), CompareCenterY());
+
+		leader = NULL;
+		for (size_t i = 0; i < entries.size(); ++i)
+		{
+			if (entries[i].order == leaderOrder)
+				leader = &entries[i];
+		}
+	}
+
+	void NeighbourIndex::query(const TruckControllerPtr& controller, float range, std::vector<const Entry*>& neighbours) const
+	{
+		neighbours.clear();
+		const Rectangle& rect = controller->getTruck()->getBoundingRect();
+		Point center((rect.left + rect.right) / 2, (rect.top + rect.bottom) / 2);
+		const float rangeSquared = range * range;
+
+		std::vector<Entry>::const_iterator first = std::lower_bound(entries.begin(), entries.end(), center.y() - range, CompareCenterY());
+		std::vector<Entry>::const_iterator last = std::upper_bound(first, entries.end(), center.y() + range, CompareCenterY());
+		for (std::vector<Entry>::const_iterator it = first; it != last; ++it)
+		{
+			if (it->controller == controller)
+				continue;
+			float dx = it->center.x() - center.x();
+			float dy = it->center.y() - center.y();
+			if (dx * dx + dy * dy <= rangeSquared)
+				neighbours.push_back(&*it);
+		}
+		std::sort(neighbours.begin(), neighbours.end(), CompareOrder());
+	}
+
+} // namespace rr
@@ -0,0 +1,53 @@
+// Copyright 2011 Nuffer Brothers Software LLC. All Rights Reserved.
+
+#ifndef __NEIGHBOURINDEX_HPP__
+#define __NEIGHBOURINDEX_HPP__
+
+#include "RRConfig.hpp"
+#include "RRFwd.hpp"
+#include "engine/Rectangle.hpp"
+#include "engine/Point.hpp"
+#include <vector>
+
+namespace rr
+{
+	// Per-frame snapshot of all vehicles sorted by y, so that the AI can find the
+	// vehicles near it without scanning every TruckController.
+	// Rebuild it once per frame before the AI runs.
+	class NeighbourIndex
+	{
+	public:
+		struct Entry
+		{
+			Entry() : rect(0, 0, 0, 0), order(0), civilCar(false), racer(false) {}
+			TruckControllerPtr controller;
+			Rectangle rect;
+			Point center;
+			Point position; // the vehicle's position(), which isn't necessarily the center of rect
+			size_t order; // index in the controllers passed to rebuild()
+			bool civilCar;
+			bool racer;
+		};
+
+		NeighbourIndex();
+
+		void rebuild(const std::vector<TruckControllerPtr>& controllers);
+
+		// Fills neighbours with the other vehicles whose center is within range of the center
+		// of controller's vehicle, in the order they were passed to rebuild().
+		void query(const TruckControllerPtr& controller, float range, std::vector<const Entry*>& neighbours) const;
+
+		// The racer furthest up the track, or the first controller if it is ahead of all racers.
+		// NULL if the index is empty.
+		const Entry* leadingRacer() const { return leader; }
+
+		size_t size() const { return entries.size(); }
+
+	private:
+		std::vector<Entry> entries; // sorted by center y
+		const Entry* leader;
+	};
+
+} // namespace rr
+
+#endif // __NEIGHBOURINDEX_HPP__
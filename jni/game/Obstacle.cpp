@@ -12,7 +12,7 @@ namespace rr
     void Obstacle::playHitSound() const
     {
         if (_hitSound)
-            _hitSound->play();
+            _hitSound->playAt(position());
     }
 	
 	void Obstacle::stopSounds() const
@@ -5,7 +5,7 @@
 #include "TruckController.hpp"
 #include "Truck.hpp"
 #include "engine/Log.hpp"
-#include "CivilCar.hpp"
+#include "NeighbourIndex.hpp"
 #include "ShotGun.hpp"
 #include "boost/random.hpp"
 
@@ -14,19 +14,38 @@
 
 namespace rr
 {
-	static boost::rand48 rng(::time(NULL));
+	static boost::rand48 seedRng(::time(NULL));
 	static boost::uniform_real<> chance(0.0,5.0);
+
+	void OpponentAI::seedRandom(unsigned seed)
+	{
+		seedRng.seed(seed);
+	}
+
+	OpponentAI::OpponentAI(TruckControllerPtr controller, RoadBoundPtr road):
+		  DrivingAI(controller, road)
+		, shoot(false)
+		, interacted(false)
+		, rng(seedRng())
+	{
+	}
 	
-	void OpponentAI::processOtherTrucks(const Rectangle& truckRect, vector<TruckControllerPtr>& trucksControllers, 
+	void OpponentAI::processOtherTrucks(const Rectangle& truckRect, const NeighbourIndex& neighbours, 
 										const TimeDuration& deltaTime)
 	{		
 		setInteracted(false);
 		shoot = false;
-		foreach(TruckControllerPtr tc, trucksControllers)
+
+		// Nothing outside of shotgun range can be interacted with. The second term is a generous
+		// bound on the center distance of a truck that is within hitRange to the side.
+		float range = std::max(getTruckController()->getShotGun().getShotRange(),
+							   hitRange + truckRect.width() + truckRect.height());
+		neighbours.query(getTruckController(), range, nearbyTrucks);
+		foreach(const NeighbourIndex::Entry* neighbour, nearbyTrucks)
 		{
-			if (NULL == dynamic_cast<CivilCar*>(&(*tc->getTruck()))) // Don't attack civil cars.
+			if (!neighbour->civilCar) // Don't attack civil cars.
 			{
-				interactWithOtherTruck(truckRect, tc->getTruck()->getBoundingRect(), deltaTime);
+				interactWithOtherTruck(truckRect, neighbour->rect, deltaTime);
 			}
 
 			if (isInteracted())
@@ -35,14 +54,12 @@ namespace rr
 				{
 					// calculate damage
 					Point p1 = getTruckController()->getTruck()->position();
-					Point p2 = tc->getTruck()->position();
+					Point p2 = neighbour->position;
 					int damage = getTruckController()->getShotGun().calculateDamage(p1,p2);
 					// handle the hit
 					if (damage > 0) {
 						// TODO: if we want, play an opponent hit sound
-						tc->getTruck()->decrementHealth(damage);
-						tc->getTruck()->setAttachedAnimationPosition(Truck::Sparks, Point(0, -(tc->getTruck()->size().height()) / 2));
-						tc->getTruck()->activateAttachedAnimation(Truck::Sparks);
+						hitTruck(neighbour->controller, damage);
 					} else {
 						// TODO: if we want, play an opponent miss sound
 					}
@@ -53,7 +70,7 @@ namespace rr
 
 		if (!isInteracted()) // Road is free.
 		{
-			getTruckController()->nitroActionDown();
+			nitroTruck();
 		}
 	}
 
@@ -67,12 +84,11 @@ namespace rr
         {
             if (getTruckController()->getShotGun().isObjectInRange(truckRect, opRect))
             {
-                if (getTruckController()->getShotGun().isReadyToShoot() && chance(rng) < deltaTime.realSeconds())
+                if (isReadyToShoot() && chance(rng) < deltaTime.realSeconds())
                 {
                     setInteracted(true);
                     shoot = true;
-                    getTruckController()->getShotGun().shoot();
-                    getTruckController()->getTruck()->activateAttachedAnimation(Truck::ShotgunBlast);
+                    shootGun();
 					// TODO: If we want, this is where an opponent shotgun sound would go
                 }
             }
@@ -83,7 +99,7 @@ namespace rr
 		{
 			if (truckRect.left - opRect.right < hitRange)
 			{
-				getTruckController()->getTruck()->setInputLeft(true);
+				turnTruck(Decision::T_Left);
 				setInteracted(true);
 				//LOGI("Hit left");
 			}
@@ -92,19 +108,18 @@ namespace rr
 		{
 			if (opRect.left - truckRect.right < hitRange)
 			{
-				getTruckController()->getTruck()->setInputRight(true);
+				turnTruck(Decision::T_Right);
 				setInteracted(true);
 				//LOGI("Hit right");
 			}
 		}
 		else if (getTruckController()->getShotGun().isObjectInRange(truckRect, opRect))
 		{
-			if (getTruckController()->getShotGun().isReadyToShoot() && chance(rng) < deltaTime.realSeconds())
+			if (isReadyToShoot() && chance(rng) < deltaTime.realSeconds())
 			{
 				setInteracted(true);
 				shoot = true;
-				getTruckController()->getShotGun().shoot();
-				getTruckController()->getTruck()->activateAttachedAnimation(Truck::ShotgunBlast);
+				shootGun();
 				// TODO: If we want to, this is where an opponent shotgun sound would go.
 			}
 		}
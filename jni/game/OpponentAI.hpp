@@ -5,6 +5,7 @@
 
 #include "DrivingAI.hpp"
 #include "miniblocxx/TimeDuration.hpp"
+#include "boost/random/linear_congruential.hpp"
 
 
 namespace rr
@@ -12,14 +13,12 @@ namespace rr
 	class OpponentAI: public DrivingAI
 	{
 	public:
-		OpponentAI(TruckControllerPtr controller, RoadBoundPtr road):
-			  DrivingAI(controller, road)
-            , shoot(false)
-			, interacted(false)
-		{}
+		OpponentAI(TruckControllerPtr controller, RoadBoundPtr road);
+		// Seeds the generator the AIs created afterwards seed theirs from.
+		static void seedRandom(unsigned seed);
 
 	protected:
-		virtual void processOtherTrucks(const Rectangle& truckRect, vector<TruckControllerPtr>& trucksControllers, 
+		virtual void processOtherTrucks(const Rectangle& truckRect, const NeighbourIndex& neighbours, 
 										const TimeDuration& deltaTime);
 		virtual void interactWithOtherTruck(const Rectangle& truckRect, const Rectangle& opponentTruckRect,
 											const TimeDuration& deltaTime);
@@ -54,6 +53,8 @@ namespace rr
 		bool shoot;
 	private:
 		bool interacted;
+		boost::rand48 rng; // per AI so that decide() can run on any thread
+		vector<const NeighbourIndex::Entry*> nearbyTrucks; // scratch space for processOtherTrucks()
 
 	};
 }
@@ -12,6 +12,11 @@ namespace rr
 		const float TURN_THRESHOLD = 7.0;
         boost::rand48 randEng(::time(NULL));
 	}
+
+	void PlayerTruck::seedRandom(unsigned seed)
+	{
+		randEng.seed(seed);
+	}
 	
 	bool PlayerTruck::inputLeft() const
 	{
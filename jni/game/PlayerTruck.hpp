@@ -34,6 +34,9 @@ namespace rr
             truckParams = rr::Truck::TruckParameters(0, 0, defaultTruckDefense*2, defaultTruckArmor*2, 0);
 		}
 		
+		// See seedRandomGenerators().
+		static void seedRandom(unsigned seed);
+
 		virtual bool inputLeft() const;
 		virtual bool inputRight() const;
 		virtual float getTurnAngle();
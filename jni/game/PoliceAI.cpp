@@ -14,28 +14,22 @@
 
 namespace rr
 {
-	void PoliceAI::update(const TimeDuration& deltaTime, vector<TruckControllerPtr>& trucksControllers)
+	void PoliceAI::decide(const TimeDuration& deltaTime, const NeighbourIndex& neighbours)
 	{
+		clearDecision();
 		const Rectangle& truckRect = truckController->getTruck()->getBoundingRect();
 		stayOnRoad(deltaTime, truckRect);
-		processOtherTrucks(truckRect, trucksControllers, deltaTime);
-		attackFirstPlaceTruck(trucksControllers);
+		processOtherTrucks(truckRect, neighbours, deltaTime);
+		attackFirstPlaceTruck(neighbours);
 	}
 
-	void PoliceAI::attackFirstPlaceTruck(vector<TruckControllerPtr>& trucksControllers)
+	void PoliceAI::attackFirstPlaceTruck(const NeighbourIndex& neighbours)
 	{
-		TruckControllerPtr firstPlace = trucksControllers[0];
+		const NeighbourIndex::Entry* firstPlace = neighbours.leadingRacer();
+		if (!firstPlace)
+			return;
 
-		foreach(TruckControllerPtr tc, trucksControllers)
-		{
-			if(tc->getTruck()->isRacer())
-			{
-				if(tc->getTruck()->position().y() > firstPlace->getTruck()->position().y())
-					firstPlace = tc;
-			}
-		}
-
-		Point firstPos = firstPlace->getTruck()->position();
+		Point firstPos = firstPlace->position;
 		Point policePos = truckController->getTruck()->position();
 		if (firstPos.y() - policePos.y() > 200)
 		{
@@ -45,16 +39,13 @@ namespace rr
 		{
 			slowdownTruck();
 		}
-		else if (truckController->getShotGun().isObjectInRange(truckController->getTruck()->getBoundingRect(), firstPlace->getTruck()->getBoundingRect()))
+		else if (truckController->getShotGun().isObjectInRange(truckController->getTruck()->getBoundingRect(), firstPlace->rect))
 		{
-			if (truckController->getShotGun().isReadyToShoot())
+			if (isReadyToShoot())
 			{
 				//LOGD("KABLOOIEEEEEEEE!!!~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~");
-				truckController->getTruck()->activateAttachedAnimation(Truck::ShotgunBlast);
-				truckController->getShotGun().shoot();
-				truckController->getTruck()->activateAttachedAnimation(Truck::ShotgunBlast);
-				firstPlace->getTruck()->setAttachedAnimationPosition(Truck::Sparks, Point(0, -(firstPlace->getTruck()->size().height()) / 2));
-				firstPlace->getTruck()->activateAttachedAnimation(Truck::Sparks);
+				shootGun();
+				hitTruck(firstPlace->controller, 0); // sparks only, the police do no damage
 			}
 		}
 	}
@@ -13,9 +13,9 @@ namespace rr
 		PoliceAI(TruckControllerPtr controller, RoadBoundPtr road):
 					  OpponentAI(controller, road)
 		{shoot = true;}
-		void update(const TimeDuration& deltaTime, vector<TruckControllerPtr>& trucksControllers);
+		void decide(const TimeDuration& deltaTime, const NeighbourIndex& neighbours);
 	private:
-        void attackFirstPlaceTruck(vector<TruckControllerPtr>& trucksControllers);
+        void attackFirstPlaceTruck(const NeighbourIndex& neighbours);
 	};
 }
 
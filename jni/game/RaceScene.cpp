@@ -26,6 +26,7 @@
 #include "engine/TexturedFont.hpp"
 #include "engine/Label.hpp"
 #include "FPSAction.hpp"
+#include "engine/ProfilerOverlay.hpp"
 #include "engine/Rectangle.hpp"
 #include "boost/foreach.hpp"
 #define foreach BOOST_FOREACH
@@ -44,6 +45,8 @@
 #include "graphlib/GenericVector2.hpp"
 #include "RaceTracks.hpp"
 #include "BestTimes.hpp"
+#include "engine/JobSystem.hpp"
+#include "engine/VoicePool.hpp"
 
 
 namespace rr
@@ -59,6 +62,34 @@ namespace rr
 			//LOGD("We're making progress! Currently at %02.2f%%", f*100);
 		}
 
+		// AIs are cheap to run, so give each job a few of them.
+		const size_t aiJobGrain = 4;
+
+		// Runs DrivingAI::decide() for a span of the AIs against this frame's neighbour index.
+		class DecideAIJob : public JobSystem::RangeBody
+		{
+		public:
+			DecideAIJob(const vector<DrivingAIPtr>& ais, const NeighbourIndex& neighbours, const TimeDuration& deltaTime)
+				: ais(ais)
+				, neighbours(neighbours)
+				, deltaTime(deltaTime)
+			{
+			}
+
+			virtual void run(size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; ++i)
+				{
+					ais[i]->decide(deltaTime, neighbours);
+				}
+			}
+
+		private:
+			const vector<DrivingAIPtr>& ais;
+			const NeighbourIndex& neighbours;
+			const TimeDuration& deltaTime;
+		};
+
 		const float turnDelay = 0.25;
 		const float turnAngle = 25.0;
 		const int TruckCenterVerticalOffset = 133;
@@ -131,6 +162,11 @@ namespace rr
 		currentRaceTrack = raceTrack;
 	}
 
+	void RaceScene::seedRandom(unsigned seed)
+	{
+		randEng.seed(seed);
+	}
+
 	void RaceScene::restartRace()
 	{
 		// Stop sounds
@@ -224,7 +260,6 @@ namespace rr
 
 		// Prepare road bound
 		roadBound = new RoadBound(DefaultScreenRight, DefaultScreenTop);
-		roadBound->setName("RoadBound");
 
 		vector<char> track_sequence = raceTracks.getRaceTrack(currentRaceTrack);
 		for (size_t i = 0; i < track_sequence.size(); ++i)
@@ -261,8 +296,6 @@ namespace rr
 		addCollidableChild(left);
 		addCollidableChild(right);
 
-		addCollidableChild(roadBound);
-
 		assert(!roadBound->isPointOnRoad(40,yPosition-DefaultScreenTop+1));
 		assert(roadBound->isPointOnRoad(40,yPosition-DefaultScreenTop));
 		assert(roadBound->isPointOnRoad(40,yPosition-DefaultScreenTop-1));
@@ -322,6 +355,13 @@ namespace rr
 		label->setPosition(Point(0, -380));
 		addChild(label, hudZOrder);
 		#endif
+
+		#ifdef ENGINE_PROFILE
+		ProfilerOverlayPtr profilerOverlay = new ProfilerOverlay(gameLibrary.theMilkmanConspiracyFont(), 5, 0.5);
+		profilerOverlay->setPositionInterpretation(Drawable::E_SCREEN);
+		profilerOverlay->setPosition(Point(0, 300));
+		addChild(profilerOverlay, hudZOrder);
+		#endif
 		
 		addAnimals(GameLibrary::Armadillo);
 		addAnimals(GameLibrary::Snake);
@@ -749,9 +789,13 @@ namespace rr
 				{
 					startNearbyAnimalsMoving();
 					// Update AI
+					neighbours.rebuild(trucksControllers);
+					DecideAIJob decideAI(opponentsAi, neighbours, deltaTime);
+					game().jobs().parallelFor(opponentsAi.size(), aiJobGrain, decideAI);
+					// Apply in a fixed order so the outcome doesn't depend on which thread decided first.
 					foreach(DrivingAIPtr ai, opponentsAi)
 					{
-						ai->update(deltaTime, trucksControllers);
+						ai->applyDecision();
 					}
 					foreach(TruckControllerPtr t, trucksControllers)
 					{
@@ -779,9 +823,48 @@ namespace rr
 		//LOGI("Active rect x: %f y: %f", cameraTruck->getBoundingRect().left, cameraTruck->getBoundingRect().top);
 
 		game().director().setCameraPosition(translateScreenPointToRacePoint(Point(0, 0)));
+		// Hits far from the player are not worth a voice.
+		gameLibrary.voices().setListenerPosition(playerTruck->position());
 		removeOffScreenStuff();
 	}
 	
+	void RaceScene::handleCollisions(const DateTime& thisFrameStartTime, const TimeDuration& deltaTime)
+	{
+		Scene::handleCollisions(thisFrameStartTime, deltaTime);
+		updateTrucksOnRoad();
+	}
+
+	void RaceScene::updateTrucksOnRoad()
+	{
+		// Damage and rage from offroad driving are processed in class TruckController.
+		// trucksControllers includes the player's truck controller.
+		roadQueryTrucks.clear();
+		foreach(TruckControllerPtr t, trucksControllers)
+		{
+			roadQueryTrucks.push_back(t->getTruck());
+		}
+
+		size_t count = roadQueryTrucks.size();
+		if (count == 0)
+			return;
+		roadQueryYs.resize(count);
+		roadQueryLefts.resize(count);
+		roadQueryRights.resize(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			roadQueryYs[i] = roadQueryTrucks[i]->getBoundingRect().top;
+		}
+
+		roadBound->getBoundCoordinates(&roadQueryYs[0], count, &roadQueryLefts[0], &roadQueryRights[0]);
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			const Rectangle& rect(roadQueryTrucks[i]->getBoundingRect());
+			float mid = (rect.left + rect.right) / 2.0;
+			roadQueryTrucks[i]->setOnRoad(mid >= roadQueryLefts[i] && mid <= roadQueryRights[i]);
+		}
+	}
+
 	Point RaceScene::translateScreenPointToRacePoint(const Point& screenPoint) const
 	{
 		return Point(screenPoint.x(), screenPoint.y() + playerTruck->position().y() + TruckCenterVerticalOffset);
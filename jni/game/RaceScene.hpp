@@ -12,6 +12,7 @@
 #include <vector>
 #include "TruckController.hpp"
 #include "RoadBound.hpp"
+#include "NeighbourIndex.hpp"
 #include "RacePosAction.hpp"
 #include "RaceTracks.hpp"
 
@@ -30,10 +31,13 @@ namespace rr
 		virtual ~RaceScene();
 		
 		virtual void update(const DateTime& thisFrameStartTime, const TimeDuration& deltaTime);
+		virtual void handleCollisions(const DateTime& thisFrameStartTime, const TimeDuration& deltaTime);
 		
 		virtual void handleTouchEvent(const TouchEvent& touchEvent);
 
 		void setRaceTrack(RaceTracks::Races raceTrack);
+		// See seedRandomGenerators().
+		static void seedRandom(unsigned seed);
 		void restartRace();
 
 		static const int backgroundZOrder = -1;
@@ -81,6 +85,7 @@ namespace rr
 		void addTrucksControllers();
 		void startNearbyAnimalsMoving();
 		void removeOffScreenStuff();
+		void updateTrucksOnRoad();
 		
 	private:
 
@@ -122,6 +127,7 @@ namespace rr
 		vector<TruckControllerPtr> trucksControllers; // For opponents, police and civil cars.
 		vector<TouchHandlerPtr> truckTouchHandlers;
 		vector<DrivingAIPtr> opponentsAi;
+		NeighbourIndex neighbours; // rebuilt every frame before the AI runs
 
 		ProgressBarPtr playerTruckDefense;
 		ProgressBarPtr playerTruckArmor;
@@ -134,6 +140,11 @@ namespace rr
 		TimeDuration infoLabelShowingTime;
 
 		RoadBoundPtr roadBound;
+		// Scratch space for updateTrucksOnRoad(), kept to avoid allocating every frame.
+		vector<TruckPtr> roadQueryTrucks;
+		vector<float> roadQueryYs;
+		vector<float> roadQueryLefts;
+		vector<float> roadQueryRights;
 
 		RacePosActionPtr racePosAction;
 
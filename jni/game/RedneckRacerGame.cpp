@@ -13,12 +13,15 @@
 #include "engine/TextureLoader.hpp"
 #include "engine/TouchEvent.hpp"
 #include "engine/Log.hpp"
+#include "engine/Profiler.hpp"
 #include "Globals.hpp"
 #include "LoadingScreenScene.hpp"
 #include "engine/TexturedFont.hpp"
 #include "engine/ProgressBar.hpp"
 #include "engine/Sound.hpp"
+#include "engine/StreamingSound.hpp"
 #include "BestTimes.hpp"
+#include <time.h>
 
 namespace rr
 {
@@ -34,6 +37,12 @@ void imageLoadingProgress(float f)
 	LOGE("Resources for Loading Count = %i", resourcesForLoadingCount);*/
 }
 
+// One step for every sound, the texture groups' fractions start over and would move the bar back.
+void soundLoadingProgress(float f)
+{
+	++(game().currentLoadingProgress);
+}
+
 void progress(float f)
 {
 
@@ -54,6 +63,150 @@ void RedneckRacerGame::setSettingsFilePath(const char* filePath)
 {
 	applicationDataFilesDir = String(filePath);
 	m_bestTimes.reset(new BestTimes(applicationDataFilesDir + '/' + BEST_TIMES_FILE_NAME));
+#ifdef ENGINE_PROFILE
+	journalRaces(std::string(applicationDataFilesDir) + "/race.journal");
+#endif
+}
+
+void RedneckRacerGame::journalRaces(const std::string& path)
+{
+	m_journalPath = path;
+}
+
+void RedneckRacerGame::startJournal()
+{
+	m_journal.reset();
+	m_journalFile.close();
+	if (m_journalPath.empty())
+		return;
+
+	// Seeded from the clock as always, but with a seed the replay can have too.
+	UInt32 seed = static_cast<UInt32>(::time(NULL));
+	seedRandomGenerators(seed);
+	if (!m_journalFile.open(m_journalPath.c_str(), std::ios::out | std::ios::binary | std::ios::trunc))
+	{
+		LOGE("Couldn't write the input journal %s", m_journalPath.c_str());
+		return;
+	}
+	Array<Int32> parameters(JP_COUNT);
+	parameters[JP_TRACK] = m_raceTrack;
+	parameters[JP_CONTROL_TYPE] = controlType;
+	parameters[JP_LEFT_KEY] = left;
+	parameters[JP_RIGHT_KEY] = right;
+	m_journal.reset(new InputJournalWriter(m_journalFile, seed, parameters));
+}
+
+RaceTracks::Races RedneckRacerGame::setUpReplay(const Array<Int32>& parameters)
+{
+	LOGASSERT(parameters.size() >= JP_COUNT, "The input journal has %u parameters, not %u", (unsigned)parameters.size(), (unsigned)JP_COUNT);
+	controlType = static_cast<Control_Types>(parameters[JP_CONTROL_TYPE]);
+	left = parameters[JP_LEFT_KEY];
+	right = parameters[JP_RIGHT_KEY];
+	activeScene = prevScene = _RaceScene;
+	return static_cast<RaceTracks::Races>(parameters[JP_TRACK]);
+}
+
+void RedneckRacerGame::replayInput(const InputRecord& record)
+{
+	applyInput(record);
+}
+
+void RedneckRacerGame::queueInput(const InputRecord& record)
+{
+	if (!m_input.push(record))
+	{
+		LOGE("The input queue is full, dropped input event %u", m_input.dropped());
+	}
+}
+
+void RedneckRacerGame::handleQueuedInput()
+{
+	PROFILE_ZONE("handleQueuedInput");
+	// Only what is queued now, anything arriving meanwhile is the next frame's.
+	InputRecord record;
+	InputRecord orientation;
+	bool orientationChanged = false;
+	for (unsigned pending = m_input.size(); pending > 0 && m_input.pop(record); --pending)
+	{
+		switch (record.type)
+		{
+			case InputRecord::E_ORIENTATION:
+				// The sensor outpaces the frames, only its latest sample counts.
+				orientation = record;
+				orientationChanged = true;
+				break;
+			case InputRecord::E_TOUCH:
+				// Translate android coordinates ( x = 0, y = 0 - top left corner) to
+				// director screen coordinates(x=0, y=0 - screen center).
+				record.touch.x = (record.touch.x - deviceScreenWidth / 2) * widthScaleFactor;
+				record.touch.y = ((deviceScreenHeight / 2) - record.touch.y) * heightScaleFactor;
+				applyInput(record);
+				break;
+			default:
+				applyInput(record);
+				break;
+		}
+	}
+	if (orientationChanged)
+		applyInput(orientation);
+}
+
+void RedneckRacerGame::applyInput(const InputRecord& record)
+{
+	// A race started from the input has the simulation building its first frame already.
+	m_director.waitForSimulation();
+	if (m_journal.get() && activeScene == _RaceScene)
+	{
+		switch (record.type)
+		{
+			case InputRecord::E_TOUCH:
+				m_journal->touch(record.touch);
+				break;
+			case InputRecord::E_TRACKBALL:
+				m_journal->trackball(record.values[0]);
+				break;
+			case InputRecord::E_ORIENTATION:
+				m_journal->orientation(record.values[0], record.values[1], record.values[2]);
+				break;
+			case InputRecord::E_KEY_DOWN:
+				m_journal->keyDown(record.key, record.metaState);
+				break;
+			case InputRecord::E_KEY_UP:
+				m_journal->keyUp(record.key, record.metaState);
+				break;
+			case InputRecord::E_FRAME:
+				break;
+		}
+	}
+
+	switch (record.type)
+	{
+		case InputRecord::E_TOUCH:
+			m_director.handleTouchEvent(record.touch);
+			break;
+		case InputRecord::E_TRACKBALL:
+			if ((activeScene == _RaceScene) && (controlType == TRACKBALL))
+			{
+				rollAngle_ = record.values[0] * 8;//Conversion to have numbers similar to the keypad.
+			}
+			break;
+		case InputRecord::E_ORIENTATION:
+			if (controlType == TILT)
+			{
+				rollAngle_ = orientationRollAngle_ = record.values[0];
+				pitchAngle_ = record.values[1];
+				headingAngle_ = record.values[2];
+			}
+			break;
+		case InputRecord::E_KEY_DOWN:
+			keyDown(record.key, record.metaState);
+			break;
+		case InputRecord::E_KEY_UP:
+			keyUp(record.key, record.metaState);
+			break;
+		case InputRecord::E_FRAME:
+			break;
+	}
 }
 
 
@@ -63,8 +216,9 @@ RedneckRacerGame::RedneckRacerGame()
 	, selectLeftKey(false)
 	, selectRightKey(false)
 	, currentLoadingProgress(0)
+	, m_jobs(JobSystem::defaultWorkerCount())
 	, textureLibrary_(new TextureLibrary)
-	, _gameLibrary(textureLibrary_)
+	, _gameLibrary(textureLibrary_, soundDevice.voices())
 	, rollAngle_(0)
 	, pitchAngle_(0)
 	, headingAngle_(0)
@@ -72,8 +226,14 @@ RedneckRacerGame::RedneckRacerGame()
 	, keyRollAngle_(0)
 	, orientationRollAngle_(0)
 	, settingsFile(APP_SETTINGS_FILE_NAME)
+	, m_raceTrack(RaceTracks::YANKEESHOT)
 {
 	_gameLibrary.setProgressFunction(progress);
+	_gameLibrary.setSoundProgressFunction(soundLoadingProgress);
+	// The smaller screens prepare_graphics.sh makes atlases for.
+	textureLibrary_->addAtlasSet("ldpi", Size(240, 400));
+	textureLibrary_->addAtlasSet("mdpi", Size(320, 533));
+	m_director.OnFrameUpdated().connect(boost::bind(&RedneckRacerGame::frameUpdated, this, _1));
 }
 
 RedneckRacerGame::~RedneckRacerGame() {}
@@ -104,6 +264,8 @@ void RedneckRacerGame::resize(int width, int height)
 	widthScaleFactor = (float)DefaultScaleWidth/deviceScreenWidth;
 
 	m_director.setSize(width, height, DefaultScaleWidth, DefaultScaleHeight);
+	textureLibrary_->selectAtlasSet(Size(width, height), Size(DefaultScaleWidth, DefaultScaleHeight));
+	m_director.startSimulation();
 
 	showLoadingScreen();
 }
@@ -114,7 +276,7 @@ void RedneckRacerGame::showLoadingScreen()
 	textureLibrary_->loadAtlasData("fonts/TheMilkmanConspiracy.atlas");
 	textureLibrary_->loadAtlasTexture("fonts/TheMilkmanConspiracy.atlas");
 
-	loadingScreen = new LoadingScreenScene(resourcesForLoadingCount, new TexturedFont(textureLibrary_, "TheMilkmanConspiracy"),
+	loadingScreen = new LoadingScreenScene(resourcesForLoadingCount + GameLibrary::soundCount(), new TexturedFont(textureLibrary_, "TheMilkmanConspiracy"),
 						     	      Point(0,300),
 						     	      "LOADING");
 
@@ -132,7 +294,11 @@ void RedneckRacerGame::setCameraPosition(Point pos)
 
 void RedneckRacerGame::pause()
 {
-
+	if (m_journal.get())
+		m_journal->flush();
+#ifdef ENGINE_PROFILE
+	profiler::dumpChromeTrace(std::string(applicationDataFilesDir) + "/profile.json");
+#endif
 }
 	
 void RedneckRacerGame::resume()
@@ -143,7 +309,10 @@ bool loadingIsOver = false;
 
 void* loadRaceResources(void*)
 {
+	PROFILE_THREAD("Loading");
+	PROFILE_ZONE("loadRaceResources");
 	loadingIsOver = false;
+	game().library().startLoadingSounds();
 	game().textureLibrary()->loadAllAtlases(imageLoadingProgress);
 	game().textureLibrary()->preloadTexImages(imageLoadingProgress);
 	game().library().load();
@@ -155,34 +324,48 @@ void* loadRaceResources(void*)
 void RedneckRacerGame::handleTouchEvent(long downTime, long eventTime, int action, float x, float y, float pressure,
 		float size, int metaState, float xPrecision, float yPrecision, int deviceId, int edgeFlags)
 {
-	// Translate android coordinates ( x = 0, y = 0 - top left corner) to
-	// director screen coordinates(x=0, y=0 - screen center).
-	x -= deviceScreenWidth / 2;
-	y = (deviceScreenHeight / 2) - y;
-	x *= widthScaleFactor;
-	y *= heightScaleFactor;
-
-	m_director.handleTouchEvent(TouchEvent(downTime, eventTime, action, x, y, pressure, size, metaState, xPrecision,
-			yPrecision, deviceId, edgeFlags));
+	InputRecord record;
+	record.type = InputRecord::E_TOUCH;
+	record.touch = TouchEvent(downTime, eventTime, action, x, y, pressure, size, metaState, xPrecision,
+			yPrecision, deviceId, edgeFlags);
+	queueInput(record);
 }
 
 void RedneckRacerGame::handleTrackballEvent(float deltaX)
 {
-        if((activeScene == _RaceScene) && (controlType == TRACKBALL))
-        {
-                rollAngle_ = deltaX * 8;//Conversion to have numbers similar to the keypad.
-        }
+	InputRecord record;
+	record.type = InputRecord::E_TRACKBALL;
+	record.values[0] = deltaX;
+	queueInput(record);
 }
 
 void RedneckRacerGame::handleOrientationChanged(float rollAngle, float pitchAngle, float headingAngle)
 {
 	//LOGD("handleOrientationChanged(rollAngle: %f, pitchAngle: %f, headingAngle: %f", rollAngle, pitchAngle, headingAngle);
-	if(controlType == TILT)
-	{
-		rollAngle_ = orientationRollAngle_ = rollAngle;
-		pitchAngle_ = pitchAngle;
-		headingAngle_ = headingAngle;
-	}
+	InputRecord record;
+	record.type = InputRecord::E_ORIENTATION;
+	record.values[0] = rollAngle;
+	record.values[1] = pitchAngle;
+	record.values[2] = headingAngle;
+	queueInput(record);
+}
+
+void RedneckRacerGame::handleKeyDown(int keyCode, int metaState)
+{
+	InputRecord record;
+	record.type = InputRecord::E_KEY_DOWN;
+	record.key = keyCode;
+	record.metaState = metaState;
+	queueInput(record);
+}
+
+void RedneckRacerGame::handleKeyUp(int keyCode, int metaState)
+{
+	InputRecord record;
+	record.type = InputRecord::E_KEY_UP;
+	record.key = keyCode;
+	record.metaState = metaState;
+	queueInput(record);
 }
 
 void RedneckRacerGame::renderNextFrameWithLoading()
@@ -266,6 +449,7 @@ void RedneckRacerGame::renderNextFrameWithLoading()
 						boost::intrusive_ptr<RaceScene> race = dynamic_pointer_cast<RaceScene>(raceScene);
 						if (race)
 						{
+							startJournal();
 							race->restartRace();
 						}
 					}
@@ -284,9 +468,23 @@ void RedneckRacerGame::renderNextFrameWithLoading()
 }
 void RedneckRacerGame::renderNextFrame()
 {
+	// While the simulation is still on the next frame, the last one is shown again, and the
+	// input waits for it.
+	if (!m_director.simulationIdle())
+	{
+		m_director.displayFrame();
+		return;
+	}
+	handleQueuedInput();
 	renderNextFrameWithLoading();
 }
 
+void RedneckRacerGame::frameUpdated(const TimeDuration& deltaTime)
+{
+	if (m_journal.get() && activeScene == _RaceScene)
+		m_journal->frame(deltaTime);
+}
+
 void RedneckRacerGame::activateLoadingScreenScene()
 {
 	m_director.runScene(loadingScreen);
@@ -295,11 +493,12 @@ void RedneckRacerGame::activateLoadingScreenScene()
 void RedneckRacerGame::startRace(RaceTracks::Races selectedTrack)
 {
 	dynamic_pointer_cast<RaceScene>(raceScene)->setRaceTrack(selectedTrack);
+	m_raceTrack = selectedTrack;
 	activeScene = _RaceScene;
 	_gameLibrary.setSoundGain(game().sfx);
 	loadingSceneCounter = 1;
-	renderNextFrameWithLoading();
 	setCameraPosition(Point(0,0));
+	renderNextFrameWithLoading();
 }
 
 void RedneckRacerGame::activateRaceScene()
@@ -11,6 +11,11 @@
 #include "boost/noncopyable.hpp"
 #include "engine/Resources.hpp"
 #include "engine/SoundDevice.hpp"
+#include "engine/JobSystem.hpp"
+#include "engine/InputJournal.hpp"
+#include "engine/InputQueue.hpp"
+#include "miniblocxx/AutoPtr.hpp"
+#include <fstream>
 
 #include "RaceTracks.hpp"
 
@@ -29,10 +34,14 @@ public:
 	void resize(int width, int height);
 	void pause();
 	void resume();
+	// StartActivity hands input to the GL thread with queueEvent(), between frames. These
+	// only queue it for the next frame to apply at its start.
 	void handleTouchEvent(long downTime, long eventTime, int action, float x, float y, float pressure, float size,
 		int metaState, float xPrecision, float yPrecision, int deviceId, int edgeFlags);
 	void handleTrackballEvent(float deltaX);
 	void handleOrientationChanged(float rollAngle, float pitchAngle, float headingAngle);
+	void handleKeyDown(int keyCode, int metaState);
+	void handleKeyUp(int keyCode, int metaState);
 	void renderNextFrame();
 	void renderNextFrameWithLoading();
 
@@ -52,9 +61,29 @@ public:
 	const TextureLibraryPtr& textureLibrary() { return textureLibrary_; }
 	GameLibrary& library() { return _gameLibrary; }
 	Director& director() { return m_director; }
+	JobSystem& jobs() { return m_jobs; }
 
 	bool runningOnEmulator() const;
 
+	// Journals the input of every race from its start to path, each race replacing the
+	// one before. Profiling builds journal to the data directory.
+	void journalRaces(const std::string& path);
+	// What the journal header's parameters hold.
+	enum JournalParameter
+	{
+		JP_TRACK = 0,
+		JP_CONTROL_TYPE,
+		JP_LEFT_KEY,
+		JP_RIGHT_KEY,
+		JP_COUNT
+	};
+	// Sets the controls up as they were for the journaled race, and returns its track.
+	RaceTracks::Races setUpReplay(const Array<Int32>& parameters);
+	// Hands a journaled event to the game the way it first arrived.
+	void replayInput(const InputRecord& record);
+	// What a replayed race has to steer by.
+	float& rollAngle() { return rollAngle_; }
+
 	std::string getSettingsFile() const;
 	std::string getControlsFile() const;
 	void setSettingsFilePath(const char* filePath);
@@ -112,6 +141,7 @@ private:
 	bool onKeyUpCallback(unsigned key, unsigned modifiersAtPress, unsigned modifiersAtRelease);
 
 	Director m_director;
+	JobSystem m_jobs;
 	TextureLibraryPtr textureLibrary_;
 	GameLibrary _gameLibrary;
 
@@ -136,9 +166,25 @@ private:
 	// Stuff for feedback (redirecting to android market):
 	std::tr1::function<void ()> m_marketFeedbackFunc;
 
-	SoundPtr backgroundMusic;
+	StreamingSoundPtr backgroundMusic;
 	
 	BestTimesPtr m_bestTimes;
+
+	void queueInput(const InputRecord& record);
+	// The render thread's side: what was queued before the frame, every orientation
+	// sample but the latest one dropped.
+	void handleQueuedInput();
+	// Journals record and acts on it. Touches are in Director coordinates by now.
+	void applyInput(const InputRecord& record);
+	void startJournal();
+	// Marks the end of every journaled frame, on whichever thread simulated it.
+	void frameUpdated(const TimeDuration& deltaTime);
+
+	RaceTracks::Races m_raceTrack;
+	std::string m_journalPath;
+	std::filebuf m_journalFile;
+	AutoPtr<InputJournalWriter> m_journal;
+	InputQueue m_input;
 };
 }
 
@@ -5,7 +5,9 @@
 #include "engine/Resource.hpp"
 #include "boost/algorithm/string/predicate.hpp"
 #include "engine/GL.hpp"
+#include "engine/VertexBuffer.hpp"
 #include <algorithm>
+#include <cmath>
 #include "boost/random.hpp"
 
 namespace rr
@@ -13,8 +15,15 @@ namespace rr
 
 	boost::rand48 randEng(::time(NULL));
 
+	void RoadBound::seedRandom(unsigned seed)
+	{
+		randEng.seed(seed);
+	}
+
 	RoadBound::RoadBound(float xCenter, float yCenter):
-		  lastSectionsHeight(-yCenter)
+		  borderTableStartY(0)
+		, borderTableEndY(0)
+		, lastSectionsHeight(-yCenter)
 		, scaleX(1.0f)
 		, scaleY(1.0f)
 		, centerX(xCenter)
@@ -26,8 +35,11 @@ namespace rr
 	{
 		String roadBoundFileName = name;
 		ResourcePtr roadBoundResource = Resources::loadResourceFromAssets(roadBoundFileName.c_str());
-		String boundStr = String(reinterpret_cast<const char*>(&*roadBoundResource->begin()), distance(roadBoundResource->begin(), roadBoundResource->end()));
+		addRoadSectionBorder(String(reinterpret_cast<const char*>(&*roadBoundResource->begin()), distance(roadBoundResource->begin(), roadBoundResource->end())));
+	}
 
+	void RoadBound::addRoadSectionBorder(const String& boundStr)
+	{
 		Coord left, right;
 		StringArray lines = boundStr.tokenize("\r\n");
 		float sectionHeight = 0;
@@ -49,22 +61,75 @@ namespace rr
 		}
 		lastSectionsHeight += sectionHeight;
 		LOGI("Road border size: %zu", roadBorder.size());
-		updateBoundingRect();
+		LOGASSERT(roadBorder.size() > 0, "Road border size is 0!");
+		buildBorderTable();
 	}
 
-	Coord RoadBound::getBoundCoordinates(float yCoord) const
+	void RoadBound::buildBorderTable()
 	{
-		// ? need to optimize ?
-		Coord coord(0, yCoord);
-		vector<DoubleCoord>::const_iterator borderLine = upper_bound(roadBorder.begin(), roadBorder.end(), DoubleCoord(coord, coord)); // Complexity: At most, logarithmic number of comparisons and linear number of steps in the length of [first,last).
-		if (borderLine != roadBorder.end())
+		leftBorderTable.clear();
+		rightBorderTable.clear();
+		if (roadBorder.empty())
+			return;
+
+		borderTableStartY = roadBorder.front().left.y();
+		borderTableEndY = roadBorder.back().left.y();
+		size_t tableSize = size_t(ceil((borderTableEndY - borderTableStartY) / borderTableStep)) + 1;
+		leftBorderTable.reserve(tableSize);
+		rightBorderTable.reserve(tableSize);
+
+		// Walk the rows once, interpolating between the pair of rows that bracket each table y.
+		// The last entry may lie past the end of the road, it is extrapolated from the last pair of rows
+		// so that lookups up to borderTableEndY stay exact.
+		size_t row = 0;
+		for (size_t i = 0; i < tableSize; ++i)
 		{
-			return Coord(borderLine->left.x(), borderLine->right.x());
+			float y = borderTableStartY + i * borderTableStep;
+			while (row + 1 < roadBorder.size() - 1 && roadBorder[row + 1].left.y() <= y)
+				++row;
+
+			const DoubleCoord& lower(roadBorder[row]);
+			const DoubleCoord& upper(roadBorder[std::min(row + 1, roadBorder.size() - 1)]);
+			float rowHeight = upper.left.y() - lower.left.y();
+			float t = rowHeight > 0 ? (y - lower.left.y()) / rowHeight : 1.0f;
+			leftBorderTable.push_back(lower.left.x() + (upper.left.x() - lower.left.x()) * t);
+			rightBorderTable.push_back(lower.right.x() + (upper.right.x() - lower.right.x()) * t);
 		}
-		else
+	}
+
+	Coord RoadBound::getBoundCoordinates(float yCoord) const
+	{
+		float left, right;
+		getBoundCoordinates(&yCoord, 1, &left, &right);
+		return Coord(left, right);
+	}
+
+	void RoadBound::getBoundCoordinates(const float* yCoords, size_t count, float* lefts, float* rights) const
+	{
+		const size_t last = leftBorderTable.size() - 1;
+		const float invStep = 1.0f / borderTableStep;
+		for (size_t i = 0; i < count; ++i)
 		{
-			//LOGI("Invalid truck position!");
-			return Coord(0, 0);
+			float y = yCoords[i];
+			if (leftBorderTable.empty() || y > borderTableEndY)
+			{
+				//LOGI("Invalid truck position!");
+				lefts[i] = 0;
+				rights[i] = 0;
+				continue;
+			}
+
+			float f = std::max(0.0f, (y - borderTableStartY) * invStep);
+			size_t index = size_t(f);
+			if (index >= last)
+			{
+				lefts[i] = leftBorderTable[last];
+				rights[i] = rightBorderTable[last];
+				continue;
+			}
+			float t = f - index;
+			lefts[i] = leftBorderTable[index] + (leftBorderTable[index + 1] - leftBorderTable[index]) * t;
+			rights[i] = rightBorderTable[index] + (rightBorderTable[index + 1] - rightBorderTable[index]) * t;
 		}
 	}
 
@@ -134,8 +199,11 @@ namespace rr
 		{
 			MatrixScope ms;
 			disableTexture2D();
-			gl::color(4, GL_FLOAT, 0, col);
-			vertex(2, GL_FLOAT, 0, vert);
+			const GLvoid* pointer;
+			GLuint buffer = StreamingVertexBuffer::shared().upload(col, colors.size(), pointer);
+			gl::color(4, GL_FLOAT, 0, pointer, buffer);
+			buffer = StreamingVertexBuffer::shared().upload(vert, vertexes.size(), pointer);
+			vertex(2, GL_FLOAT, 0, pointer, buffer);
 			drawArrays(GL_TRIANGLE_STRIP, 0, vertexes.size()/2);
 		}
 
@@ -144,14 +212,6 @@ namespace rr
 	}
 #endif
 
-	void RoadBound::updateBoundingRect()
-	{
-		LOGASSERT(roadBorder.size() > 0, "Road border size is 0!");
-		Rectangle r( -centerX, centerX, roadBorder[roadBorder.size()-1].left.y(), 0);
-		LOGD("RoadBound::updateBoundingRect() left: %f, top: %f, right: %f, bottom: %f", r.left, r.top, r.right, r.bottom);
-		setBoundingRect(r);
-	}
-
 	Coord RoadBound::getLeftBoundByIndex(unsigned int index)
 	{
 		if (roadBorder.size() > index)
@@ -6,27 +6,27 @@
 #include "RRFwd.hpp"
 #include "RRConfig.hpp"
 #include <vector>
-#include "engine/Collidable.hpp"
+#include "miniblocxx/IntrusiveCountableBase.hpp"
 #include "engine/Point.hpp"
 
 //#define TEST_DRAWING_ROAD_BOUND
 
 #ifdef TEST_DRAWING_ROAD_BOUND
 	#include "engine/Drawable.hpp"
-	#include "engine/Collider.hpp"
 #endif
 namespace rr
 {
 
+	// The road is not part of the collision broadphase. RaceScene queries it directly
+	// once per frame to find out which trucks are on the road.
 	class RoadBound:
 #ifdef TEST_DRAWING_ROAD_BOUND
 
-	  public Drawable
-	, public Collider
+	public Drawable
 
 #else
 
-	public Collidable
+	public virtual IntrusiveCountableBase
 
 #endif
 	{
@@ -35,19 +35,24 @@ namespace rr
 		 // xCenter - screen center relatively OpenGl screen coords(0, 0 - top left corner).
 		RoadBound(float xCenter, float yCenter);
 
+		// See seedRandomGenerators().
+		static void seedRandom(unsigned seed);
+
 #ifdef TEST_DRAWING_ROAD_BOUND
 
 		virtual void draw(const Rectangle& screen);
-		virtual bool shouldCheckForCollision() const { return false; }
-		virtual bool doesCollideWith(const Collidable& other) const { return false; }
-		virtual void handleCollision(Collidable& other, const DateTime& thisFrameStartTime, const TimeDuration& deltaTime){};
 
 #endif
 
 		void loadRoadSectionBorder(const String& name);
+		// contents is the text of a .road file: a "scaleX scaleY" line followed by "y left right" lines.
+		void addRoadSectionBorder(const String& contents);
 
-		// Return left and right x coordinates
+		// Return left and right x coordinates, linearly interpolated between the border rows.
+		// Returns (0, 0) past the end of the road.
 		Coord getBoundCoordinates(float yCoord) const;
+		// Batch version of getBoundCoordinates().
+		void getBoundCoordinates(const float* yCoords, size_t count, float* lefts, float* rights) const;
 		bool isPointOnRoad(float x, float y) const;
 		Point getPointOnRoad(float y) const;
 
@@ -55,37 +60,34 @@ namespace rr
 		{
 			lastSectionsHeight = -yCenter;
 			centerX = xCenter;
-			updateBoundingRect();
 		}
 
 		Coord getLeftBoundByIndex(unsigned int index);
 		Coord getRightBoundByIndex(unsigned int index);
 		unsigned int getBoundIndexSize() const { return roadBorder.size(); }
 
-		void updateBoundingRect();
-
 	private:
 
 		struct DoubleCoord
 		{
 			DoubleCoord(Coord l, Coord r): left(l), right(r){}
+			// For use in road border: left.y == right.y.
 			Coord left;
 			Coord right;
-			bool operator<(DoubleCoord dp) const
-			{
-				// For use in road border: left.y == right.y.
-				if (left.y() < dp.left.y()) return true;
-				else return false;
-			}
-
-			bool operator<(float yCoord) const
-			{
-				if (left.y() < yCoord) return true;
-				else return false;
-			}
 		};
 
+		void buildBorderTable();
+
+		// Distance in world units between the rows of the resampled border table.
+		static const float borderTableStep = 4.0f;
+
 		vector<DoubleCoord> roadBorder;
+		// roadBorder resampled at a uniform y step so lookups are a multiply instead of a search.
+		vector<float> leftBorderTable;
+		vector<float> rightBorderTable;
+		float borderTableStartY;
+		float borderTableEndY;
+
 		float lastSectionsHeight;
 		float scaleX;
 		float scaleY;
@@ -45,10 +45,9 @@ namespace rr
 	{
 		Point playerCenter = Point((plRect.left + plRect.right) / 2, (plRect.top + plRect.bottom) / 2);
 		Point opponentCenter = Point((objRect.left + objRect.right) / 2, (objRect.top + objRect.bottom) / 2);
-		graphlib::GenericVector2<float> v1(playerCenter.x(),playerCenter.y());
-		graphlib::GenericVector2<float> v2(opponentCenter.x(),opponentCenter.y());
-		float dist = (v1-v2).length();
-		return (dist <= shotRange);
+		float dx = playerCenter.x() - opponentCenter.x();
+		float dy = playerCenter.y() - opponentCenter.y();
+		return (dx * dx + dy * dy <= shotRange * shotRange);
 	}
 	
 	int ShotGun::calculateDamage(const Point& p1, const Point& p2) const
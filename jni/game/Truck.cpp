@@ -4,15 +4,11 @@
 #include "Truck.hpp"
 #include "TrackBorder.hpp"
 #include "engine/MoveAction.hpp"
-#include "engine/FollowAction.hpp"
 #include "engine/AccelerateAction.hpp"
 #include "engine/Log.hpp"
 #include "RaceScene.hpp"
 #include "Obstacle.hpp"
-#include "RoadBound.hpp"
 #include "CivilCar.hpp"
-#include "boost/signals2.hpp"
-#include "boost/bind.hpp"
 
 
 namespace rr
@@ -45,13 +41,6 @@ namespace rr
 			MoveActionForAngle(turnAngle, truckParams.truckSpeed)->apply(this, thisFrameStartTime, deltaTime);
 		}
 
-		for (vector<AttachedAnimationSprite>::iterator sprite = attachedAnimations.begin(); sprite != attachedAnimations.end(); ++sprite)
-		{
-			if(sprite->animationSprite != NULL)
-			{
-				(sprite->animationSprite)->update(thisFrameStartTime, deltaTime);
-			}
-		}
 		elapsedTime = thisFrameStartTime;
 	}
 
@@ -249,25 +238,22 @@ namespace rr
 						// while turning, exhaust animation does not play.  If it is playing, it is removed here.
 						if(exhaustFlamesSprite != NULL)
 						{
-							game().raceScene->removeChild(exhaustFlamesSprite);
+							detachChild(exhaustFlamesSprite);
 							exhaustFlamesSprite = NULL;
 						}
 					break;
 				}
 				if(exhaustFlamesSprite != NULL)
 				{
-					followingTruck = boost::shared_ptr<FollowAction>(new FollowAction(exhaustFlamesSprite, exhaustFlamesSprite->position()));
-					exhaustFlamesSprite->setPosition(Point(0.0, 0.0));		
-					flamesFollowTruckConnection = OnPositionChanged().connect(Drawable::positionChangedSignalT::slot_type(&FollowAction::OnPositionChanged, 
-																				followingTruck.get(), _2).track(followingTruck));
-					game().raceScene->addChild(exhaustFlamesSprite, RaceScene::sparksZOrder);
+					// the library positions the flames relative to the truck, so they can be attached as is.
+					attachChild(exhaustFlamesSprite);
 				}
 			}
 		} 
 		else if(exhaustFlamesSprite != NULL)
 		{
-			//Exhaust flames Sprite is active, but no longer in rage mode - removing exhaust Flames from scene
-			game().raceScene->removeChild(exhaustFlamesSprite);
+			//Exhaust flames Sprite is active, but no longer in rage mode - removing exhaust Flames from the truck
+			detachChild(exhaustFlamesSprite);
 			exhaustFlamesSprite = NULL;
 		}
 		//LOGD("finished Truck::handleExhaustAnimation()");
@@ -374,23 +360,7 @@ namespace rr
 		}
 
 		float damMult(1.0); // Damage multiplier.
-		if (RoadBound* road = dynamic_cast<RoadBound*>(&other))
-		{
-			Coord border = road->getBoundCoordinates(this->getBoundingRect().top);
-			float mid = (this->getBoundingRect().left +  this->getBoundingRect().right) / 2.0;
-			if ((mid < border.x()) || (mid > border.y()))
-			{
-				// Offroad driving.
-				// Damage and rage from offroad driving are processed in class TruckController.
-				onRoad = false;
-			}
-			else
-			{
-				// On road driving.
-				onRoad = true;
-			}
-		}
-		else if (TrackBorder* border = dynamic_cast<TrackBorder*>(&other))
+		if (TrackBorder* border = dynamic_cast<TrackBorder*>(&other))
 		{
 			//LOGD("Truck %s collided with edge. Position: %f, %f", name().c_str(), position().x(), position().y());
 			Rectangle borderRect(border->getBoundingRect());
@@ -414,7 +384,7 @@ namespace rr
 			// start sparks animation
 			//attachedAnimations[(size_t)Sparks].animationSprite->animation(game().library().effect(GameLibrary::Sparks));
 			Point mid = midpoint(newColliderPosition, newCollideePosition);
-			attachedAnimations[(size_t)Sparks].position = Point(mid.x() - newColliderPosition.x() , mid.y() - newColliderPosition.y() );
+			setAttachedAnimationPosition(Sparks, Point(mid.x() - newColliderPosition.x() , mid.y() - newColliderPosition.y() ));
 			activateAttachedAnimation(Truck::Sparks);
             if(this->isPlayer())
                 truck->playHitSound();
@@ -512,13 +482,14 @@ namespace rr
 		if (attachedAnimations[(size_t)type].animationSprite == NULL)
 		{
 			attachedAnimations[(size_t)type].animationSprite = new Sprite(attachedAnimations[(size_t)type].animation, "Attached");
+			attachChild(attachedAnimations[(size_t)type].animationSprite);
 		}
 		else
 		{
 			attachedAnimations[(size_t)type].animationSprite->animation(attachedAnimations[(size_t)type].animation);
 		}
 
-		attachedAnimations[(size_t)type].position = position;
+		attachedAnimations[(size_t)type].animationSprite->setPosition(position);
 	}
 
 	// Return NULL if animation was not attached by calling attachAnimation.
@@ -528,19 +499,6 @@ namespace rr
 		return attachedAnimations[(size_t)type].animationSprite;
 	}
 
-	void Truck::draw(const Rectangle& screen)
-	{
-		Sprite::draw(screen);
-		for (vector<AttachedAnimationSprite>::iterator sprite = attachedAnimations.begin(); sprite != attachedAnimations.end(); ++sprite)
-		{
-			if(sprite->animationSprite != NULL)
-			{
-				sprite->animationSprite->setPosition(Point(position().x() + sprite->position.x(), position().y() + sprite->position.y()));
-				sprite->animationSprite->draw(screen);
-			}
-		}
-	}
-
 	void Truck::activateAttachedAnimation(AttachedAnimationType type, bool loop)
 	{
 		LOGASSERT((size_t)type <= attachedAnimations.size(), "Invalid attached animation type: %zu", (size_t)type);
@@ -555,7 +513,7 @@ namespace rr
 		LOGASSERT((size_t)type <= attachedAnimations.size(), "Invalid attached animation type: %zu", (size_t)type);
 		if (attachedAnimations[(size_t)type].animationSprite != NULL)
 		{
-			attachedAnimations[(size_t)type].position  = pos;
+			attachedAnimations[(size_t)type].animationSprite->setPosition(pos);
 		}
 	}
 	
@@ -585,7 +543,7 @@ namespace rr
     void Truck::playHitSound() const
     {
         if (_hitSound)
-            _hitSound->play();
+            _hitSound->playAt(position());
     }
 	
 	void Truck::stopSounds() const
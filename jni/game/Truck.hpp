@@ -7,7 +7,6 @@
 #include "Globals.hpp"
 #include "engine/Sprite.hpp"
 #include "Destroyer.hpp"
-#include "engine/FollowAction.hpp"
 
 namespace rr
 {
@@ -113,10 +112,10 @@ namespace rr
 		virtual void setNitroActive( bool isNitroActivated );
 		
 		virtual void replaceAttachedAnimation( AttachedAnimationType type, AnimationPtr& newAnimation, bool horizFlip, Point pos );
-		
-		virtual void draw(const Rectangle& screen);
 
 		virtual bool isOnRoad() const { return onRoad; }
+		// Set once per frame by RaceScene from the road bound.
+		void setOnRoad(bool isOnRoad) { onRoad = isOnRoad; }
 
 		TexturedQuadPtr stopped;
 		AnimationPtr accelerating;
@@ -132,6 +131,7 @@ namespace rr
         
         virtual bool isRacer() const { return false; }
         virtual bool isPlayer() const { return false; }
+        virtual bool isCivilCar() const { return false; }
         
         void playHitSound() const;
 		void stopSounds() const;
@@ -202,22 +202,19 @@ namespace rr
 		bool isInputRight;
 		
 		SpritePtr exhaustFlamesSprite;
-		boost::shared_ptr<FollowAction> followingTruck;
 		bool rageModeActivated;
 		bool nitroActivated;
 		
-		boost::signals2::connection flamesFollowTruckConnection;
-		
 		static const bool FLIP_HORIZ = true;
 		
 		void setDirection(float angleInDegrees);
 
+		// animationSprite is attached as a child of the truck, so its position is relative to the truck.
 		struct AttachedAnimationSprite
 		{
-			AttachedAnimationSprite(): animation(), animationSprite(), position(0,0){}
+			AttachedAnimationSprite(): animation(), animationSprite(){}
 			AnimationPtr animation;
 			SpritePtr animationSprite;
-			Point position;
 		};
 		vector<AttachedAnimationSprite> attachedAnimations;
 		
@@ -0,0 +1,288 @@
+// Copyright 2011 Nuffer Brothers Software LLC. All Rights Reserved.
+
+// Plays a scripted race's worth of sound effects through engine::Sound on an OpenAL
+// loopback device and reports what mixing them cost. Everything is mixed as fast as
+// the CPU allows, so the numbers only depend on the machine and the mixer, not on
+// an audio device.
+//
+// usage: audio_bench [-v voices] [-s seconds] [-p periodFrames] [-l load] [-w out.wav] [assets.zip]
+
+#include "engine/Resources.hpp"
+#include "engine/Sound.hpp"
+#include "engine/VoicePool.hpp"
+#include "miniblocxx/String.hpp"
+#include "openal/include/AL/al.h"
+#include "openal/include/AL/alc.h"
+#include "openal/include/AL/alext.h"
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <time.h>
+#include <vector>
+
+namespace
+{
+	using namespace engine;
+
+	const ALCint frequency = 22050; // what SoundDevice asks for
+	const size_t channels = 2; // the default AL_FORMAT_STEREO16 output
+	const size_t bytesPerSample = 2;
+
+	// How the game plays each of its sounds. perSecond is how often a race triggers one on
+	// average; sounds missing from here are played as normal priority effects once a second.
+	struct Cue
+	{
+		const char* name;
+		Sound::ELoopingOption loopingOption;
+		int priority;
+		float perSecond;
+	};
+
+	const Cue cues[] = {
+		{ "sounds/Edits_Intro4.wav", Sound::E_LOOP, Sound::E_PRIORITY_MUSIC, 0.0f },
+		{ "sounds/truck_startup.wav", Sound::E_PLAY_ONCE, Sound::E_PRIORITY_NORMAL, 0.0f },
+		{ "sounds/truck_rev_fade.wav", Sound::E_PLAY_ONCE, Sound::E_PRIORITY_NORMAL, 0.7f },
+		{ "sounds/Shotgun.wav", Sound::E_PLAY_ONCE, Sound::E_PRIORITY_NORMAL, 0.5f },
+		{ "sounds/GunPing.wav", Sound::E_PLAY_ONCE, Sound::E_PRIORITY_NORMAL, 0.5f },
+		{ "sounds/cops_coming.wav", Sound::E_PLAY_ONCE, Sound::E_PRIORITY_NORMAL, 0.05f },
+		{ "sounds/racers_crash.wav", Sound::E_PLAY_ONCE, Sound::E_PRIORITY_LOW, 0.6f },
+		{ "sounds/roadkill_hit.wav", Sound::E_PLAY_ONCE, Sound::E_PRIORITY_LOW, 0.8f },
+		{ "sounds/fat_guy_splash.wav", Sound::E_PLAY_ONCE, Sound::E_PRIORITY_LOW, 0.3f },
+		{ "sounds/puddle_splash.wav", Sound::E_PLAY_ONCE, Sound::E_PRIORITY_LOW, 0.8f },
+		{ "sounds/outhouse_smash.wav", Sound::E_PLAY_ONCE, Sound::E_PRIORITY_LOW, 0.3f },
+		{ "sounds/hit_bush.wav", Sound::E_PLAY_ONCE, Sound::E_PRIORITY_LOW, 1.2f },
+		{ "sounds/hit_tree.wav", Sound::E_PLAY_ONCE, Sound::E_PRIORITY_LOW, 0.8f },
+		{ "sounds/tractor_crash.wav", Sound::E_PLAY_ONCE, Sound::E_PRIORITY_LOW, 0.2f },
+	};
+	const Cue defaultCue = { "", Sound::E_PLAY_ONCE, Sound::E_PRIORITY_NORMAL, 1.0f };
+	const Cue rageCue = { "", Sound::E_PLAY_ONCE, Sound::E_PRIORITY_HIGH, 0.1f };
+
+	const Cue& cueFor(const String& name)
+	{
+		for (size_t i = 0; i < sizeof(cues) / sizeof(cues[0]); ++i)
+		{
+			if (name == cues[i].name)
+				return cues[i];
+		}
+		if (name.startsWith("sounds/rage"))
+			return rageCue;
+		return defaultCue;
+	}
+
+	struct LoadedSound
+	{
+		SoundPtr sound;
+		float perSecond;
+	};
+
+	// The same numbers on every run, unlike rand().
+	class Random
+	{
+	public:
+		Random() : state(12345) {}
+		float next()
+		{
+			state = state * 1103515245u + 12345u;
+			return (state >> 8) / 16777216.0f;
+		}
+	private:
+		unsigned state;
+	};
+
+	long peakResidentKiB()
+	{
+		rusage usage;
+		getrusage(RUSAGE_SELF, &usage);
+		return usage.ru_maxrss;
+	}
+
+	unsigned long long nowNs()
+	{
+		timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return ts.tv_sec * 1000000000ull + ts.tv_nsec;
+	}
+
+	// Little endian, as RIFF wants it.
+	void put(FILE* f, unsigned value, size_t bytes)
+	{
+		for (size_t i = 0; i < bytes; ++i)
+		{
+			fputc((value >> (i * 8)) & 0xff, f);
+		}
+	}
+
+	void writeWaveHeader(FILE* f, size_t frames)
+	{
+		unsigned dataSize = frames * channels * bytesPerSample;
+		fwrite("RIFF", 1, 4, f);
+		put(f, 36 + dataSize, 4);
+		fwrite("WAVEfmt ", 1, 8, f);
+		put(f, 16, 4);
+		put(f, 1, 2); // PCM
+		put(f, channels, 2);
+		put(f, frequency, 4);
+		put(f, frequency * channels * bytesPerSample, 4);
+		put(f, channels * bytesPerSample, 2);
+		put(f, bytesPerSample * 8, 2);
+		fwrite("data", 1, 4, f);
+		put(f, dataSize, 4);
+	}
+
+	double percentile(const std::vector<unsigned long long>& sorted, double fraction)
+	{
+		size_t i = std::min(sorted.size() - 1, static_cast<size_t>(fraction * sorted.size()));
+		return sorted[i] / 1000.0;
+	}
+
+	int usage()
+	{
+		fprintf(stderr, "usage: audio_bench [-v voices] [-s seconds] [-p periodFrames] [-l load] [-w out.wav] [assets.zip]\n");
+		return 2;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	size_t voiceCount = VoicePool::defaultVoiceCount;
+	float seconds = 60.0f;
+	size_t periodFrames = 1024;
+	float load = 1.0f;
+	const char* wavePath = NULL;
+	const char* assetsPath = "redneckracer-assets.zip";
+
+	for (int i = 1; i < argc; ++i)
+	{
+		bool hasValue = i + 1 < argc;
+		if (!strcmp(argv[i], "-v") && hasValue)
+			voiceCount = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-s") && hasValue)
+			seconds = atof(argv[++i]);
+		else if (!strcmp(argv[i], "-p") && hasValue)
+			periodFrames = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-l") && hasValue)
+			load = atof(argv[++i]);
+		else if (!strcmp(argv[i], "-w") && hasValue)
+			wavePath = argv[++i];
+		else if (argv[i][0] != '-')
+			assetsPath = argv[i];
+		else
+			return usage();
+	}
+	if (voiceCount == 0 || periodFrames == 0 || seconds <= 0)
+		return usage();
+
+	ALCdevice* device = alcLoopbackOpenDeviceSOFT(NULL);
+	if (!device)
+	{
+		fprintf(stderr, "audio_bench: couldn't open a loopback device\n");
+		return 1;
+	}
+	const ALCint attributes[] = { ALC_FREQUENCY, frequency, 0 };
+	ALCcontext* context = alcCreateContext(device, attributes);
+	alcMakeContextCurrent(context);
+
+	{
+		VoicePool voices(voiceCount);
+		std::vector<LoadedSound> sounds;
+		std::vector<SoundPtr> startSounds;
+
+		long residentBeforeLoading = peakResidentKiB();
+		Resources::init(assetsPath);
+		StringArray names = Resources::listResources();
+		for (size_t i = 0; i < names.size(); ++i)
+		{
+			if (!names[i].startsWith("sounds/") || !names[i].endsWith(".wav"))
+				continue;
+			const Cue& cue = cueFor(names[i]);
+			LoadedSound loaded;
+			loaded.sound = new Sound(voices, Resources::loadResourceFromAssets(names[i].c_str()), cue.loopingOption, 1.0, cue.priority);
+			loaded.perSecond = cue.perSecond * load;
+			sounds.push_back(loaded);
+			if (cue.perSecond == 0.0f)
+				startSounds.push_back(loaded.sound);
+		}
+		// Includes the zip's directory, but the sample data is most of it.
+		long loadedKiB = peakResidentKiB() - residentBeforeLoading;
+
+		size_t totalFrames = static_cast<size_t>(seconds * frequency);
+		size_t periods = (totalFrames + periodFrames - 1) / periodFrames;
+		float periodSeconds = periodFrames / static_cast<float>(frequency);
+		// Room for any output format the config may pick, only stereo16 goes to the wave file
+		std::vector<char> mix(periodFrames * 8 * sizeof(float));
+		std::vector<unsigned long long> mixNs;
+		mixNs.reserve(periods);
+
+		FILE* wave = NULL;
+		if (wavePath)
+		{
+			wave = fopen(wavePath, "wb");
+			if (!wave)
+			{
+				fprintf(stderr, "audio_bench: couldn't write %s\n", wavePath);
+				return 1;
+			}
+			writeWaveHeader(wave, periods * periodFrames);
+		}
+
+		for (size_t i = 0; i < startSounds.size(); ++i)
+		{
+			startSounds[i]->play();
+		}
+
+		Random random;
+		size_t plays = 0;
+		size_t busyVoices = 0;
+		size_t peakBusyVoices = 0;
+		for (size_t period = 0; period < periods; ++period)
+		{
+			for (size_t i = 0; i < sounds.size(); ++i)
+			{
+				if (random.next() < sounds[i].perSecond * periodSeconds)
+				{
+					sounds[i].sound->play();
+					++plays;
+				}
+			}
+
+			unsigned long long start = nowNs();
+			alcRenderSamplesSOFT(device, &mix[0], periodFrames);
+			mixNs.push_back(nowNs() - start);
+
+			size_t busy = voices.playingVoiceCount();
+			busyVoices += busy;
+			peakBusyVoices = std::max(peakBusyVoices, busy);
+			if (wave)
+				fwrite(&mix[0], channels * bytesPerSample, periodFrames, wave);
+		}
+		if (wave)
+			fclose(wave);
+
+		unsigned long long totalNs = 0;
+		for (size_t i = 0; i < mixNs.size(); ++i)
+		{
+			totalNs += mixNs[i];
+		}
+		std::vector<unsigned long long> sorted(mixNs);
+		std::sort(sorted.begin(), sorted.end());
+		double mixedSeconds = periods * periodSeconds;
+
+		printf("sounds:        %u loaded, %ld KiB resident once loaded\n", (unsigned)sounds.size(), loadedKiB);
+		printf("script:        %.1f s at %d Hz, %u plays on %u voices (%.1f busy on average, %u at most)\n",
+			mixedSeconds, frequency, (unsigned)plays, (unsigned)voices.voiceCount(),
+			busyVoices / static_cast<double>(periods), (unsigned)peakBusyVoices);
+		printf("mixer:         %.1f ns/sample, %.1fx faster than real time\n",
+			totalNs / static_cast<double>(periods * periodFrames), mixedSeconds / (totalNs / 1e9));
+		printf("aluMixData:    %u calls of %u frames, us min %.1f p50 %.1f p90 %.1f p99 %.1f max %.1f\n",
+			(unsigned)periods, (unsigned)periodFrames, percentile(sorted, 0.0), percentile(sorted, 0.5),
+			percentile(sorted, 0.9), percentile(sorted, 0.99), percentile(sorted, 1.0));
+		printf("peak memory:   %ld KiB resident\n", peakResidentKiB());
+	}
+
+	alcMakeContextCurrent(NULL);
+	alcDestroyContext(context);
+	alcCloseDevice(device);
+	return 0;
+}
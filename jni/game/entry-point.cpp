@@ -224,7 +224,7 @@ Java_com_nufferbrotherssoftware_RedneckRacerLite_StartRenderer_nativeOnKeyDown(
 {
 	try
 	{
-		game().keyDown(keyCode, metastate);
+		game().handleKeyDown(keyCode, metastate);
 	}
 	catch (const blocxx::Exception& e)
 	{
@@ -249,7 +249,7 @@ Java_com_nufferbrotherssoftware_RedneckRacerLite_StartRenderer_nativeOnKeyUp(
 {
 	try
 	{
-		game().keyUp(keyCode, metastate);
+		game().handleKeyUp(keyCode, metastate);
 	}
 	catch (const blocxx::Exception& e)
 	{
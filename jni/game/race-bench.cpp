@@ -0,0 +1,491 @@
+// Copyright 2011 Nuffer Brothers Software LLC. All Rights Reserved.
+
+// Drives whole races headless and reports what a frame costs. The game's random number
+// generators are seeded and the input is scripted, and the races are stepped at a fixed
+// timestep with every GL call going to a counting null mock, so two runs with the same
+// arguments simulate exactly the same frames. Only the timings differ between runs and
+// machines; compare the trace line to check that a change didn't alter the simulation.
+//
+// usage: race_bench [-r races] [-s seconds] [-t track] [-f fps] [-S seed] [-d dataDir] [-j journal] [-c capture] [-D screen] [assets.zip]
+//
+// -j replays a race journaled by RedneckRacerGame::journalRaces() instead of the script:
+// its seed, controls and input, frame by frame with the frame times it had.
+//
+// -c writes the quads every frame draws to capture, see DrawCapture.hpp, for mkatl to
+// regroup the atlases by.
+//
+// -D loads the atlases the game would on a screen of that many pixels, like 320x480.
+//
+// The game opens the default OpenAL device when it starts, run with ALSOFT_DRIVERS=null
+// on a machine without one.
+
+#include "Globals.hpp"
+#include "RaceScene.hpp"
+#include "BestTimes.hpp"
+#include "engine/DrawCapture.hpp"
+#include "engine/GLMock.hpp"
+#include "engine/InputJournal.hpp"
+#include "engine/Profiler.hpp"
+#include "engine/TextureLibrary.hpp"
+#include "engine/TouchEvent.hpp"
+#include "miniblocxx/DateTime.hpp"
+#include "miniblocxx/IOException.hpp"
+#include <algorithm>
+#include <fstream>
+#include <math.h>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+
+namespace
+{
+	// Every operator new of the process, workers included.
+	volatile unsigned long allocations = 0;
+}
+
+void* operator new(size_t size) throw(std::bad_alloc)
+{
+	__sync_fetch_and_add(&allocations, 1);
+	void* p = malloc(size ? size : 1);
+	if (!p)
+		throw std::bad_alloc();
+	return p;
+}
+
+void* operator new[](size_t size) throw(std::bad_alloc)
+{
+	return operator new(size);
+}
+
+// Kept out of line so callers pair operator new with operator delete, not with the free()
+// inside it.
+__attribute__((noinline)) void operator delete(void* p) throw()
+{
+	free(p);
+}
+
+__attribute__((noinline)) void operator delete[](void* p) throw()
+{
+	free(p);
+}
+
+namespace
+{
+	using namespace rr;
+
+	// Does nothing but count, so drawing costs only what the engine spends getting to GL.
+	class CountingGL : public gl::GLMock
+	{
+	public:
+		CountingGL() : calls(0), drawCalls(0), vertices(0), lastTexture(0), lastBuffer(0) {}
+
+		virtual const char* glStrError(GLint) { ++calls; return ""; }
+		virtual void checkGLError(const char*) { ++calls; }
+		virtual void setGLLineWidth(GLfloat) { ++calls; }
+		virtual void clearColorBuffer() { ++calls; }
+		virtual void clearDepthBuffer() { ++calls; }
+		virtual void clearColorAndDepthBuffer() { ++calls; }
+		virtual void loadIdentity() { ++calls; }
+		virtual void translate(GLfloat, GLfloat, GLfloat) { ++calls; }
+		virtual void rotate(GLfloat, GLfloat, GLfloat, GLfloat) { ++calls; }
+		virtual void scale(GLfloat, GLfloat, GLfloat) { ++calls; }
+		virtual void vertex(GLint, GLenum, GLsizei, const GLvoid*) { ++calls; }
+		virtual void color(GLint, GLenum, GLsizei, const GLvoid*) { ++calls; }
+		virtual void enableTexture2D() { ++calls; }
+		virtual void disableTexture2D() { ++calls; }
+		virtual void texCoord(GLint, GLenum, GLsizei, const GLvoid*) { ++calls; }
+		virtual void drawArrays(GLenum, GLint, GLsizei count) { ++calls; ++drawCalls; vertices += count; }
+		virtual GLuint genTexture() { ++calls; return ++lastTexture; }
+		virtual std::string getString(GLenum) { ++calls; return ""; }
+		virtual std::string getVendor() { ++calls; return "race_bench"; }
+		virtual std::string getRenderer() { ++calls; return "CountingGL"; }
+		// What the devices have, so the buffer objects get used.
+		virtual std::string getVersion() { ++calls; return "OpenGL ES-CM 1.1"; }
+		virtual std::string getExtensions() { ++calls; return ""; }
+		virtual void bindTexture2D(GLuint) { ++calls; }
+		virtual void bindAlphaTexture2D(GLuint) { ++calls; }
+		virtual void deleteTextures(GLsizei, const GLuint*) { ++calls; }
+		virtual void texImage2D(GLsizei, GLsizei, GLvoid*) { ++calls; }
+		virtual void texImage2D(GLenum, GLenum, GLsizei, GLsizei, const GLvoid*) { ++calls; }
+		virtual void texParameter(GLenum, GLint) { ++calls; }
+		virtual void compressedTexImage2D(GLenum, GLsizei, GLsizei, GLsizei, const GLvoid*) { ++calls; }
+		virtual void matrixMode(GLenum) { ++calls; }
+		virtual void ortho(GLfloat, GLfloat, GLfloat, GLfloat, GLfloat, GLfloat) { ++calls; }
+		virtual void multMatrix(const GLfloat*) { ++calls; }
+		virtual void enableBlend() { ++calls; }
+		virtual void disableBlend() { ++calls; }
+		virtual void blendFunc(GLenum, GLenum) { ++calls; }
+		virtual GLuint genBuffer() { ++calls; return ++lastBuffer; }
+		virtual void deleteBuffers(GLsizei, const GLuint*) { ++calls; }
+		virtual void bindArrayBuffer(GLuint) { ++calls; }
+		virtual void bufferData(GLsizeiptr, const GLvoid*, GLenum) { ++calls; }
+		virtual void bufferSubData(GLintptr, GLsizeiptr, const GLvoid*) { ++calls; }
+		virtual void MatrixScope() { ++calls; }
+		virtual void DestMatrixScope() { ++calls; }
+		virtual void PushMatrixScope() { ++calls; }
+		virtual void DestPushMatrixScope() { ++calls; }
+		virtual void ColorArrayScope() { ++calls; }
+		virtual void DestColorArrayScope() { ++calls; }
+		virtual void CullFaceScope(GLenum) { ++calls; }
+		virtual void DestCullFaceScope() { ++calls; }
+		virtual void VertexArrayScope() { ++calls; }
+		virtual void DestVertexArrayScope() { ++calls; }
+		virtual void TextureCoordArrayScope() { ++calls; }
+		virtual void DestTextureCoordArrayScope() { ++calls; }
+		virtual void Texture2DScope() { ++calls; }
+		virtual void DestTexture2DScope() { ++calls; }
+
+		unsigned long long calls;
+		unsigned long long drawCalls;
+		unsigned long long vertices;
+
+	private:
+		GLuint lastTexture;
+		GLuint lastBuffer;
+	};
+
+	// The scripted drive: the tilt in degrees from this second of the race on. It repeats
+	// every driveSeconds, weaving across the road so the trucks go off it now and then.
+	struct TiltSample
+	{
+		float second;
+		float rollAngle;
+	};
+
+	const TiltSample drive[] = {
+		{ 0.0f, 0.0f },
+		{ 4.0f, -12.0f },
+		{ 5.5f, 10.0f },
+		{ 7.0f, 0.0f },
+		{ 9.0f, 18.0f },
+		{ 10.0f, -9.0f },
+		{ 12.0f, 0.0f },
+		{ 14.0f, -20.0f },
+		{ 15.0f, 14.0f },
+		{ 16.5f, 0.0f },
+	};
+	const float driveSeconds = 18.0f;
+
+	// Taps ahead of the player, where the opponents usually are, one every tapSeconds in
+	// turn. Screen coordinates, the player's truck is at (40, -133).
+	const float taps[][2] = {
+		{ -80.0f, 120.0f },
+		{ 0.0f, 220.0f },
+		{ 80.0f, 120.0f },
+		{ -40.0f, 40.0f },
+		{ 40.0f, 300.0f },
+	};
+	const float tapSeconds = 0.8f;
+
+	float tiltAt(float second)
+	{
+		second = fmodf(second, driveSeconds);
+		float rollAngle = drive[0].rollAngle;
+		for (size_t i = 0; i < sizeof(drive) / sizeof(drive[0]) && drive[i].second <= second; ++i)
+		{
+			rollAngle = drive[i].rollAngle;
+		}
+		return rollAngle;
+	}
+
+	void touch(Scene& scene, int action, size_t tap, long eventTime)
+	{
+		const float* at = taps[tap % (sizeof(taps) / sizeof(taps[0]))];
+		scene.handleTouchEvent(TouchEvent(eventTime, eventTime, action, at[0], at[1], 1.0f, 1.0f, 0, 1.0f, 1.0f, 0, 0));
+	}
+
+	unsigned long long nowNs()
+	{
+		timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return ts.tv_sec * 1000000000ull + ts.tv_nsec;
+	}
+
+	// FNV-1a over the camera's path, which follows the player's truck.
+	unsigned hashFloat(unsigned hash, float value)
+	{
+		unsigned char bytes[sizeof(value)];
+		memcpy(bytes, &value, sizeof(value));
+		for (size_t i = 0; i < sizeof(value); ++i)
+		{
+			hash = (hash ^ bytes[i]) * 16777619u;
+		}
+		return hash;
+	}
+
+	struct Timings
+	{
+		std::vector<unsigned long long> ns;
+
+		void print(const char* name) const
+		{
+			std::vector<unsigned long long> sorted(ns);
+			std::sort(sorted.begin(), sorted.end());
+			unsigned long long total = 0;
+			for (size_t i = 0; i < sorted.size(); ++i)
+			{
+				total += sorted[i];
+			}
+			printf("%-14s us/frame mean %.1f p50 %.1f p90 %.1f p99 %.1f max %.1f\n", name,
+				total / 1000.0 / sorted.size(), percentile(sorted, 0.5), percentile(sorted, 0.9),
+				percentile(sorted, 0.99), percentile(sorted, 1.0));
+		}
+
+		static double percentile(const std::vector<unsigned long long>& sorted, double fraction)
+		{
+			size_t i = std::min(sorted.size() - 1, static_cast<size_t>(fraction * sorted.size()));
+			return sorted[i] / 1000.0;
+		}
+	};
+
+	// Steps the race a frame the way Director::renderNextFrame() does, measuring each part.
+	class FrameStepper
+	{
+	public:
+		FrameStepper(RaceScene& race, Director& director, const CountingGL& counter)
+			: race(race)
+			, director(director)
+			, counter(counter)
+			, frames(0)
+			, drawCalls(0)
+			, glCalls(0)
+			, vertices(0)
+			, frameAllocations(0)
+			, trace(2166136261u)
+		{
+		}
+
+		void step(const DateTime& frameStart, const TimeDuration& deltaTime)
+		{
+			unsigned long allocationsBefore = allocations;
+			unsigned long long glCallsBefore = counter.calls;
+			unsigned long long drawCallsBefore = counter.drawCalls;
+			unsigned long long verticesBefore = counter.vertices;
+
+			unsigned long long start = nowNs();
+			race.update(frameStart, deltaTime);
+			unsigned long long updated = nowNs();
+			race.handleCollisions(frameStart, deltaTime);
+			unsigned long long collided = nowNs();
+			director.displayFrame();
+			unsigned long long drawn = nowNs();
+			PROFILE_FRAME();
+
+			++frames;
+			update.ns.push_back(updated - start);
+			collide.ns.push_back(collided - updated);
+			draw.ns.push_back(drawn - collided);
+			frameAllocations += allocations - allocationsBefore;
+			glCalls += counter.calls - glCallsBefore;
+			drawCalls += counter.drawCalls - drawCallsBefore;
+			vertices += counter.vertices - verticesBefore;
+
+			const Point& camera = director.cameraPosition();
+			trace = hashFloat(hashFloat(trace, camera.x()), camera.y());
+		}
+
+		void print() const
+		{
+			if (frames == 0)
+				return;
+			update.print("update:");
+			collide.print("collisions:");
+			draw.print("draw:");
+			printf("gl:            %.1f draw calls/frame, %.0f vertices/frame, %.1f calls/frame\n",
+				drawCalls / (double)frames, vertices / (double)frames, glCalls / (double)frames);
+			printf("allocations:   %.1f operator new calls/frame\n", frameAllocations / (double)frames);
+			printf("trace:         %08x\n", trace);
+		}
+
+	private:
+		RaceScene& race;
+		Director& director;
+		const CountingGL& counter;
+		size_t frames;
+		Timings update, collide, draw;
+		unsigned long long drawCalls;
+		unsigned long long glCalls;
+		unsigned long long vertices;
+		unsigned long frameAllocations;
+		unsigned trace;
+	};
+
+	int usage()
+	{
+		fprintf(stderr, "usage: race_bench [-r races] [-s seconds] [-t track] [-f fps] [-S seed] [-d dataDir] [-j journal] [-c capture] [-D screen] [assets.zip]\n");
+		return 2;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	size_t races = 3;
+	float seconds = 90.0f;
+	int track = RaceTracks::YANKEESHOT;
+	int fps = 60;
+	unsigned seed = 1;
+	const char* dataDir = "/tmp";
+	const char* journalPath = NULL;
+	const char* capturePath = NULL;
+	int screenWidth = DefaultScaleWidth;
+	int screenHeight = DefaultScaleHeight;
+	const char* assetsPath = "redneckracer-assets.zip";
+
+	for (int i = 1; i < argc; ++i)
+	{
+		bool hasValue = i + 1 < argc;
+		if (!strcmp(argv[i], "-r") && hasValue)
+			races = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-s") && hasValue)
+			seconds = atof(argv[++i]);
+		else if (!strcmp(argv[i], "-t") && hasValue)
+			track = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-f") && hasValue)
+			fps = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-S") && hasValue)
+			seed = strtoul(argv[++i], NULL, 0);
+		else if (!strcmp(argv[i], "-d") && hasValue)
+			dataDir = argv[++i];
+		else if (!strcmp(argv[i], "-j") && hasValue)
+			journalPath = argv[++i];
+		else if (!strcmp(argv[i], "-c") && hasValue)
+			capturePath = argv[++i];
+		else if (!strcmp(argv[i], "-D") && hasValue)
+		{
+			if (sscanf(argv[++i], "%dx%d", &screenWidth, &screenHeight) != 2)
+				return usage();
+		}
+		else if (argv[i][0] != '-')
+			assetsPath = argv[i];
+		else
+			return usage();
+	}
+	if (races == 0 || seconds <= 0 || fps <= 0 || track < RaceTracks::YANKEESHOT || track > RaceTracks::WIJADIDJA
+		|| screenWidth <= 0 || screenHeight <= 0)
+		return usage();
+
+	std::filebuf journalFile;
+	AutoPtr<InputJournalReader> journal;
+	if (journalPath)
+	{
+		try
+		{
+			if (!journalFile.open(journalPath, std::ios::in | std::ios::binary))
+				BLOCXX_THROW(IOException, "can't be opened");
+			journal.reset(new InputJournalReader(journalFile));
+			if (journal->parameters().size() < RedneckRacerGame::JP_COUNT)
+				BLOCXX_THROW(IOException, "has too few parameters");
+		}
+		catch (const IOException& e)
+		{
+			fprintf(stderr, "race_bench: %s: %s\n", journalPath, e.getMessage());
+			return 1;
+		}
+	}
+
+	CountingGL* counter = new CountingGL;
+	gl::GLMockPtr mock(counter);
+	gl::glMock = counter;
+
+	RedneckRacerGame& racer = game();
+	racer.setSettingsFilePath(dataDir);
+	racer.director().init(assetsPath);
+	racer.director().setSize(DefaultScaleWidth, DefaultScaleHeight, DefaultScaleWidth, DefaultScaleHeight);
+
+	// What loadRaceResources() does on the loading thread.
+	unsigned long long loadStart = nowNs();
+	racer.textureLibrary()->selectAtlasSet(Size(screenWidth, screenHeight), Size(DefaultScaleWidth, DefaultScaleHeight));
+	racer.library().startLoadingSounds();
+	racer.textureLibrary()->loadAllAtlases();
+	racer.textureLibrary()->preloadTexImages(NULL);
+	racer.library().load();
+	double loadMs = (nowNs() - loadStart) / 1e6;
+
+	float scriptedRollAngle = 0;
+	float& rollAngle = journal.get() ? racer.rollAngle() : scriptedRollAngle;
+	if (journal.get())
+	{
+		races = 1;
+		seed = journal->seed();
+		track = racer.setUpReplay(journal->parameters());
+	}
+	seedRandomGenerators(seed);
+	boost::intrusive_ptr<RaceScene> race(new RaceScene(racer.library(), rollAngle,
+		new BestTimes(std::string(dataDir) + "/race_bench.BestTimes")));
+	FrameStepper stepper(*race, racer.director(), *counter);
+	printf("assets:        %s loaded in %.0f ms\n", assetsPath, loadMs);
+	if (capturePath && !drawcapture::start(capturePath))
+	{
+		fprintf(stderr, "race_bench: %s can't be written\n", capturePath);
+		return 1;
+	}
+
+	if (journal.get())
+	{
+		race->setRaceTrack(static_cast<RaceTracks::Races>(track));
+		race->restartRace();
+		racer.director().runScene(race);
+
+		DateTime frameStart(static_cast<time_t>(1000000));
+		size_t frames = 0;
+		TimeDuration raceTime;
+		InputRecord record;
+		try
+		{
+			while (journal->read(record))
+			{
+				if (record.type != InputRecord::E_FRAME)
+				{
+					racer.replayInput(record);
+					continue;
+				}
+				frameStart += record.frameTime;
+				raceTime += record.frameTime;
+				stepper.step(frameStart, record.frameTime);
+				++frames;
+			}
+		}
+		catch (const IOException& e)
+		{
+			fprintf(stderr, "race_bench: %s is corrupt after %u frames: %s\n", journalPath, (unsigned)frames, e.getMessage());
+		}
+		printf("journal:       %s, %u frames in %.1f s of track %d, seed %u\n", journalPath, (unsigned)frames,
+			raceTime.realSeconds(), track, seed);
+	}
+	else
+	{
+		const Int64 stepUs = 1000000 / fps;
+		const TimeDuration step(stepUs);
+		const size_t framesPerRace = static_cast<size_t>(seconds * fps);
+		const size_t framesPerTap = std::max<size_t>(1, static_cast<size_t>(tapSeconds * fps));
+		for (size_t r = 0; r < races; ++r)
+		{
+			// Each race stands alone, whatever the races before it did.
+			seedRandomGenerators(seed + r);
+			rollAngle = 0;
+			race->setRaceTrack(static_cast<RaceTracks::Races>(track));
+			race->restartRace();
+			racer.director().runScene(race);
+
+			const DateTime raceStart(static_cast<time_t>(1000000 + r * 100000));
+			for (size_t frame = 0; frame < framesPerRace; ++frame)
+			{
+				Int64 elapsedUs = frame * stepUs;
+				long eventMs = static_cast<long>(elapsedUs / 1000);
+				rollAngle = tiltAt(elapsedUs / 1e6f);
+				if (frame % framesPerTap == 0)
+					touch(*race, TouchDown, frame / framesPerTap, eventMs);
+				else if (frame % framesPerTap == 1)
+					touch(*race, TouchUp, frame / framesPerTap, eventMs);
+				stepper.step(raceStart + TimeDuration(elapsedUs), step);
+			}
+		}
+		printf("races:         %u x %.1f s of track %d at %d fps, seed %u\n", (unsigned)races, seconds, track, fps, seed);
+	}
+	drawcapture::stop();
+	stepper.print();
+	return 0;
+}
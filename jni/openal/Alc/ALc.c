@@ -37,6 +37,7 @@
 #include "alDatabuffer.h"
 #include "bs2b.h"
 #include "alu.h"
+#include "mixer.h"
 
 
 
@@ -81,6 +82,8 @@ static BackendInfo BackendList[] = {
 
     { NULL, NULL, NULL, NULL, EmptyFuncs }
 };
+static BackendInfo LoopbackBackend =
+    { "loopback", alc_loopback_init, NULL, NULL, EmptyFuncs };
 #undef EmptyFuncs
 
 ///////////////////////////////////////////////////////
@@ -128,6 +131,9 @@ static const ALCfunction alcFunctions[] = {
     { "alcSetThreadContext",        (ALCvoid *) alcSetThreadContext      },
     { "alcGetThreadContext",        (ALCvoid *) alcGetThreadContext      },
 
+    { "alcLoopbackOpenDeviceSOFT",  (ALCvoid *) alcLoopbackOpenDeviceSOFT},
+    { "alcRenderSamplesSOFT",       (ALCvoid *) alcRenderSamplesSOFT     },
+
     { "alEnable",                   (ALCvoid *) alEnable                 },
     { "alDisable",                  (ALCvoid *) alDisable                },
     { "alIsEnabled",                (ALCvoid *) alIsEnabled              },
@@ -436,6 +442,8 @@ static void alc_init(void)
     if(DefaultResampler >= RESAMPLER_MAX || DefaultResampler <= RESAMPLER_MIN)
         DefaultResampler = RESAMPLER_DEFAULT;
 
+    FillCPUCaps(GetConfigValueBool(NULL, "disable-cpu-exts", AL_FALSE));
+
     devs = GetConfigValue(NULL, "drivers", "");
     if(devs[0])
     {
@@ -500,6 +508,7 @@ static void alc_init(void)
 
     for(i = 0;BackendList[i].Init;i++)
         BackendList[i].Init(&BackendList[i].Funcs);
+    LoopbackBackend.Init(&LoopbackBackend.Funcs);
 
     str = GetConfigValue(NULL, "excludefx", "");
     if(str[0])
@@ -1957,20 +1966,18 @@ static ALenum GetFormatFromString(const char *str)
 }
 
 /*
-    alcOpenDevice
+    OpenPlaybackDevice
 
-    Open the Device specified.
+    Creates a playback device with the configured output format and opens it
+    on the first backend that accepts deviceName, or on backend if given.
 */
-ALC_API ALCdevice* ALC_APIENTRY alcOpenDevice(const ALCchar *deviceName)
+static ALCdevice *OpenPlaybackDevice(const ALCchar *deviceName, BackendInfo *backend)
 {
     ALboolean bDeviceFound = AL_FALSE;
     const ALCchar *fmt;
     ALCdevice *device;
     ALint i;
 
-    if(deviceName && !deviceName[0])
-        deviceName = NULL;
-
     device = calloc(1, sizeof(ALCdevice));
     if(!device)
     {
@@ -2033,7 +2040,7 @@ ALC_API ALCdevice* ALC_APIENTRY alcOpenDevice(const ALCchar *deviceName)
     SuspendContext(NULL);
     for(i = 0;BackendList[i].Init;i++)
     {
-        device->Funcs = &BackendList[i].Funcs;
+        device->Funcs = (backend ? &backend->Funcs : &BackendList[i].Funcs);
 #ifdef HAVE_ANDROID
 #endif
         if(ALCdevice_OpenPlayback(device, deviceName))
@@ -2045,6 +2052,8 @@ ALC_API ALCdevice* ALC_APIENTRY alcOpenDevice(const ALCchar *deviceName)
             bDeviceFound = AL_TRUE;
             break;
         }
+        if(backend)
+            break;
     }
     ProcessContext(NULL);
 
@@ -2059,6 +2068,53 @@ ALC_API ALCdevice* ALC_APIENTRY alcOpenDevice(const ALCchar *deviceName)
     return device;
 }
 
+/*
+    alcOpenDevice
+
+    Open the Device specified.
+*/
+ALC_API ALCdevice* ALC_APIENTRY alcOpenDevice(const ALCchar *deviceName)
+{
+    if(deviceName && !deviceName[0])
+        deviceName = NULL;
+
+    return OpenPlaybackDevice(deviceName, NULL);
+}
+
+
+/*
+    alcLoopbackOpenDeviceSOFT
+
+    Open a device that only mixes when alcRenderSamplesSOFT asks it to, in
+    the format the config gives any other device.
+*/
+ALC_API ALCdevice* ALC_APIENTRY alcLoopbackOpenDeviceSOFT(const ALCchar *deviceName)
+{
+    if(deviceName && deviceName[0])
+    {
+        alcSetError(NULL, ALC_INVALID_VALUE);
+        return NULL;
+    }
+
+    return OpenPlaybackDevice(NULL, &LoopbackBackend);
+}
+
+
+/*
+    alcRenderSamplesSOFT
+
+    Mixes samples frames of a loopback device's contexts into buffer
+*/
+ALC_API void ALC_APIENTRY alcRenderSamplesSOFT(ALCdevice *device, ALCvoid *buffer, ALCsizei samples)
+{
+    if(!IsDevice(device) || device->Funcs != &LoopbackBackend.Funcs)
+        alcSetError(device, ALC_INVALID_DEVICE);
+    else if(samples < 0 || (samples > 0 && buffer == NULL))
+        alcSetError(device, ALC_INVALID_VALUE);
+    else
+        aluMixData(device, buffer, samples);
+}
+
 
 /*
     alcCloseDevice
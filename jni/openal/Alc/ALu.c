@@ -35,10 +35,9 @@
 #include "alListener.h"
 #include "alAuxEffectSlot.h"
 #include "alu.h"
+#include "mixer.h"
 #include "bs2b.h"
 
-#define FRACTIONBITS 14
-#define FRACTIONMASK ((1L<<FRACTIONBITS)-1)
 #define MAX_PITCH 65536
 
 /* Minimum ramp length in milliseconds. The value below was chosen to
@@ -895,20 +894,87 @@ static ALvoid CalcSourceParams(const ALCcontext *ALContext, ALsource *ALSource)
     }
 }
 
-static __inline ALfloat point(ALfloat val1, ALfloat val2, ALint frac)
+/* Samples are resampled and mixed this many at a time */
+#define MIX_CHUNK 256
+
+/* Output channels of each source channel, by source channel count */
+static const int ChannelOutputs[9][8] = {
+    { 0 },
+    { 0 },
+    { FRONT_LEFT, FRONT_RIGHT },
+    { 0 },
+    { FRONT_LEFT, FRONT_RIGHT, BACK_LEFT, BACK_RIGHT },
+    { 0 },
+    { FRONT_LEFT, FRONT_RIGHT, FRONT_CENTER, LFE, BACK_LEFT, BACK_RIGHT },
+    { FRONT_LEFT, FRONT_RIGHT, FRONT_CENTER, LFE, BACK_CENTER, SIDE_LEFT, SIDE_RIGHT },
+    { FRONT_LEFT, FRONT_RIGHT, FRONT_CENTER, LFE, BACK_LEFT, BACK_RIGHT, SIDE_LEFT, SIDE_RIGHT }
+};
+
+/* Leaves a filter as if it had passed its input straight through, which is
+ * what one with a zero coefficient does */
+static __inline void PassFilter(FILTER *iir, ALuint offset, ALuint poles, ALfloat last)
 {
-    return val1;
-    (void)val2;
-    (void)frac;
+    ALuint i;
+
+    for(i = 0;i < poles;i++)
+        iir->history[offset+i] = last;
 }
-static __inline ALfloat lerp(ALfloat val1, ALfloat val2, ALint frac)
+
+/* Fills the BUFFER_PADDING frames the resamplers read past the end of a
+ * buffer from the buffer played after it, or with silence. */
+static void FillPadding(ALfloat *dst, ALuint Channels, const ALbuffer *NextBuf, ALuint NextPos)
 {
-    return val1 + ((val2-val1)*(frac * (1.0f/(1<<FRACTIONBITS))));
+    memset(dst, 0, BUFFER_PADDING*Channels*sizeof(ALfloat));
+    if(NextBuf && NextBuf->size && aluChannelsFromFormat(NextBuf->format) == Channels)
+        ReadBufferFrames(NextBuf, NextPos, BUFFER_PADDING, dst);
 }
-static __inline ALfloat cos_lerp(ALfloat val1, ALfloat val2, ALint frac)
+
+/* Compressed buffers are decoded into a per-source window of two blocks, so a
+ * resampler reading one frame past the end of a block still finds it decoded.
+ * Moving on by a block only decodes the new one. */
+#define DECODE_WINDOW_BLOCKS 2
+
+static ALfloat *DecodeWindow(ALsource *Source, const ALbuffer *Buffer, ALuint Channels, ALuint DataSize, ALuint Block, ALuint *WindowFrames)
 {
-    ALfloat mult = (1.0f-cos(frac * (1.0f/(1<<FRACTIONBITS)) * M_PI)) * 0.5f;
-    return val1 + ((val2-val1)*mult);
+    ALuint BlockSamples = IMA4_BLOCK_FRAMES*Channels;
+    ALuint Frames, Blocks, b = 0;
+    ALfloat *Scratch;
+
+    if(!Source->DecodeScratch)
+    {
+        /* IMA4 data is at most stereo */
+        Source->DecodeScratch = malloc((DECODE_WINDOW_BLOCKS*IMA4_BLOCK_FRAMES + BUFFER_PADDING) *
+                                       2 * sizeof(ALfloat));
+        if(!Source->DecodeScratch)
+            return NULL;
+        Source->DecodedId = 0;
+    }
+    Scratch = Source->DecodeScratch;
+
+    Frames = min(DataSize - Block*IMA4_BLOCK_FRAMES, DECODE_WINDOW_BLOCKS*IMA4_BLOCK_FRAMES);
+    Blocks = (Frames+IMA4_BLOCK_FRAMES-1) / IMA4_BLOCK_FRAMES;
+    *WindowFrames = Frames;
+
+    if(Source->DecodedId == Buffer->compressedId)
+    {
+        if(Source->DecodedBlock == Block && Source->DecodedBlocks == Blocks)
+            return Scratch;
+        if(Source->DecodedBlock+1 == Block && Source->DecodedBlocks == DECODE_WINDOW_BLOCKS)
+        {
+            memmove(Scratch, &Scratch[BlockSamples], BlockSamples*sizeof(ALfloat));
+            b = 1;
+        }
+    }
+
+    for(;b < Blocks;b++)
+        DecodeIMA4Block(&Scratch[b*BlockSamples],
+                        &Buffer->compressed[(Block+b)*Buffer->OriginalAlign],
+                        Channels, 0, IMA4_BLOCK_FRAMES);
+
+    Source->DecodedId = Buffer->compressedId;
+    Source->DecodedBlock = Block;
+    Source->DecodedBlocks = Blocks;
+    return Scratch;
 }
 
 static void MixSomeSources(ALCcontext *ALContext, float (*DryBuffer)[OUTPUTCHANNELS], ALuint SamplesToDo)
@@ -918,11 +984,17 @@ static void MixSomeSources(ALCcontext *ALContext, float (*DryBuffer)[OUTPUTCHANN
     ALfloat DrySend[OUTPUTCHANNELS];
     ALfloat dryGainStep[OUTPUTCHANNELS];
     ALfloat wetGainStep[MAX_SENDS];
-    ALuint i, j, k, out;
+    ALfloat Resampled[8][MIX_CHUNK];
+    ALuint i, j, k, n, out;
     ALsource *ALSource;
-    ALfloat value, outsamp;
+    ALfloat outsamp;
+    ResamplerFunc Resample;
+    MonoMixerFunc MixMono;
+    ALuint Sends[MAX_SENDS], SendCount;
+    ALboolean FilterDry;
     ALbufferlistitem *BufferListItem;
     ALint64 DataSize64,DataPos64;
+    ALuint64 Advance;
     FILTER *DryFilter, *WetFilter[MAX_SENDS];
     ALfloat WetSend[MAX_SENDS];
     ALuint rampLength;
@@ -941,6 +1013,7 @@ static void MixSomeSources(ALCcontext *ALContext, float (*DryBuffer)[OUTPUTCHANN
 
     DuplicateStereo = ALContext->Device->DuplicateStereo;
     DeviceFreq = ALContext->Device->Frequency;
+    MixMono = SelectMonoMixer();
 
     rampLength = DeviceFreq * MIN_RAMP_LENGTH / 1000;
     rampLength = max(rampLength, SamplesToDo);
@@ -991,6 +1064,7 @@ next_source:
 
     /* Get source info */
     Resampler     = ALSource->Resampler;
+    Resample      = SelectResampler(Resampler);
     State         = ALSource->state;
     BuffersPlayed = ALSource->BuffersPlayed;
     DataPosInt    = ALSource->position;
@@ -1019,13 +1093,19 @@ next_source:
     }
 
     DryFilter = &ALSource->Params.iirFilter;
+    SendCount = 0;
     for(i = 0;i < MAX_SENDS;i++)
     {
         WetFilter[i] = &ALSource->Params.Send[i].iirFilter;
         WetBuffer[i] = (ALSource->Send[i].Slot ?
                         ALSource->Send[i].Slot->WetBuffer :
                         DummyBuffer);
+        /* Without a slot the send would only feed DummyBuffer */
+        if(ALSource->Send[i].Slot)
+            Sends[SendCount++] = i;
     }
+    /* A zero coefficient filter passes its input through unchanged */
+    FilterDry = (DryFilter->coeff != 0.0f);
 
     /* Get current buffer queue item */
     BufferListItem = ALSource->queue;
@@ -1038,7 +1118,9 @@ next_source:
         ALuint LoopStart = 0;
         ALuint LoopEnd = 0;
         ALuint DataSize = 0;
-        ALbuffer *ALBuffer;
+        ALuint DataStart = 0, DataEnd;
+        ALbuffer *ALBuffer, *PadBuf;
+        ALuint PadPos;
         ALuint BufferSize;
 
         /* Get buffer info */
@@ -1066,29 +1148,36 @@ next_source:
 
         if(DataPosInt >= DataSize)
             goto skipmix;
+        DataEnd = DataSize;
 
+        /* The padding comes from the next buffer, or the loop start when
+         * looping back to the beginning of the queue */
+        PadBuf = NULL;
+        PadPos = 0;
         if(BufferListItem->next)
+            PadBuf = BufferListItem->next->buffer;
+        else if(Looping)
         {
-            ALbuffer *NextBuf = BufferListItem->next->buffer;
-            if(NextBuf && NextBuf->size)
-            {
-                ALint ulExtraSamples = BUFFER_PADDING*Channels*Bytes;
-                ulExtraSamples = min(NextBuf->size, ulExtraSamples);
-                memcpy(&Data[DataSize*Channels], NextBuf->data, ulExtraSamples);
-            }
+            PadBuf = ALSource->queue->buffer;
+            PadPos = LoopStart;
         }
-        else if(Looping)
+
+        if(ALBuffer->compressed)
         {
-            ALbuffer *NextBuf = ALSource->queue->buffer;
-            if(NextBuf && NextBuf->size)
+            DataStart = DataPosInt - (DataPosInt%IMA4_BLOCK_FRAMES);
+            Data = DecodeWindow(ALSource, ALBuffer, Channels, DataSize,
+                                DataPosInt/IMA4_BLOCK_FRAMES, &DataEnd);
+            if(!Data)
             {
-                ALint ulExtraSamples = BUFFER_PADDING*Channels*Bytes;
-                ulExtraSamples = min(NextBuf->size, ulExtraSamples);
-                memcpy(&Data[DataSize*Channels], &NextBuf->data[LoopStart*Channels], ulExtraSamples);
+                State = AL_STOPPED;
+                break;
             }
+            DataEnd += DataStart;
+            if(DataEnd == DataSize)
+                FillPadding(&Data[(DataSize-DataStart)*Channels], Channels, PadBuf, PadPos);
         }
         else
-            memset(&Data[DataSize*Channels], 0, (BUFFER_PADDING*Channels*Bytes));
+            FillPadding(&Data[DataSize*Channels], Channels, PadBuf, PadPos);
 
         /* Compute the gain steps for each output channel */
         for(i = 0;i < OUTPUTCHANNELS;i++)
@@ -1106,256 +1195,166 @@ next_source:
         DataPos64 += DataPosFrac;
         BufferSize = (ALuint)((DataSize64-DataPos64+(increment-1)) / increment);
 
+        if(DataEnd < DataSize)
+        {
+            /* Stop before the resampler reads past the decoded window */
+            ALint64 WindowEnd64 = (ALint64)(DataEnd-1) << FRACTIONBITS;
+            ALuint WindowSize = (ALuint)((WindowEnd64-DataPos64-1) / increment) + 1;
+            BufferSize = min(BufferSize, WindowSize);
+        }
+
         BufferSize = min(BufferSize, (SamplesToDo-j));
 
-        /* Actual sample mixing loop */
+        /* Actual sample mixing loop. Each chunk is resampled a channel at a
+         * time, then filtered and mixed in the order the samples always were,
+         * so the kernels picked above don't change the result. */
         k = 0;
-        Data += DataPosInt*Channels;
+        Data += (DataPosInt-DataStart)*Channels;
 
-        if(Channels == 1) /* Mono */
+        if(Resample && Channels == 1) /* Mono */
         {
-#define DO_MIX(resampler) do { \
-    while(BufferSize--) \
-    { \
-        for(i = 0;i < OUTPUTCHANNELS;i++) \
-            DrySend[i] += dryGainStep[i]; \
-        for(i = 0;i < MAX_SENDS;i++) \
-            WetSend[i] += wetGainStep[i]; \
- \
-        /* First order interpolator */ \
-        value = (resampler)(Data[k], Data[k+1], DataPosFrac); \
- \
-        /* Direct path final mix buffer and panning */ \
-        outsamp = lpFilter4P(DryFilter, 0, value); \
-        DryBuffer[j][FRONT_LEFT]   += outsamp*DrySend[FRONT_LEFT]; \
-        DryBuffer[j][FRONT_RIGHT]  += outsamp*DrySend[FRONT_RIGHT]; \
-        DryBuffer[j][SIDE_LEFT]    += outsamp*DrySend[SIDE_LEFT]; \
-        DryBuffer[j][SIDE_RIGHT]   += outsamp*DrySend[SIDE_RIGHT]; \
-        DryBuffer[j][BACK_LEFT]    += outsamp*DrySend[BACK_LEFT]; \
-        DryBuffer[j][BACK_RIGHT]   += outsamp*DrySend[BACK_RIGHT]; \
-        DryBuffer[j][FRONT_CENTER] += outsamp*DrySend[FRONT_CENTER]; \
-        DryBuffer[j][BACK_CENTER]  += outsamp*DrySend[BACK_CENTER]; \
- \
-        /* Room path final mix buffer and panning */ \
-        for(i = 0;i < MAX_SENDS;i++) \
-        { \
-            outsamp = lpFilter2P(WetFilter[i], 0, value); \
-            WetBuffer[i][j] += outsamp*WetSend[i]; \
-        } \
- \
-        DataPosFrac += increment; \
-        k += DataPosFrac>>FRACTIONBITS; \
-        DataPosFrac &= FRACTIONMASK; \
-        j++; \
-    } \
-} while(0)
-
-            switch(Resampler)
+            while(BufferSize > 0)
             {
-                case POINT_RESAMPLER:
-                DO_MIX(point); break;
-                case LINEAR_RESAMPLER:
-                DO_MIX(lerp); break;
-                case COSINE_RESAMPLER:
-                DO_MIX(cos_lerp); break;
-                case RESAMPLER_MIN:
-                case RESAMPLER_MAX:
-                break;
+                ALuint todo = min(BufferSize, MIX_CHUNK);
+
+                Resample(&Data[k], 1, DataPosFrac, increment, Resampled[0], todo);
+
+                if(FilterDry)
+                {
+                    /* The filters are bound by their latency, so mix the
+                     * direct path alongside them rather than in a pass of
+                     * its own */
+                    for(n = 0;n < todo;n++)
+                    {
+                        const ALfloat value = Resampled[0][n];
+
+                        for(i = 0;i < OUTPUTCHANNELS;i++)
+                            DrySend[i] += dryGainStep[i];
+
+                        /* Direct path final mix buffer and panning */
+                        outsamp = lpFilter4P(DryFilter, 0, value);
+                        DryBuffer[j+n][FRONT_LEFT]   += outsamp*DrySend[FRONT_LEFT];
+                        DryBuffer[j+n][FRONT_RIGHT]  += outsamp*DrySend[FRONT_RIGHT];
+                        DryBuffer[j+n][SIDE_LEFT]    += outsamp*DrySend[SIDE_LEFT];
+                        DryBuffer[j+n][SIDE_RIGHT]   += outsamp*DrySend[SIDE_RIGHT];
+                        DryBuffer[j+n][BACK_LEFT]    += outsamp*DrySend[BACK_LEFT];
+                        DryBuffer[j+n][BACK_RIGHT]   += outsamp*DrySend[BACK_RIGHT];
+                        DryBuffer[j+n][FRONT_CENTER] += outsamp*DrySend[FRONT_CENTER];
+                        DryBuffer[j+n][BACK_CENTER]  += outsamp*DrySend[BACK_CENTER];
+
+                        /* Room path final mix buffer and panning */
+                        for(i = 0;i < SendCount;i++)
+                        {
+                            out = Sends[i];
+                            WetSend[out] += wetGainStep[out];
+                            outsamp = lpFilter2P(WetFilter[out], 0, value);
+                            WetBuffer[out][j+n] += outsamp*WetSend[out];
+                        }
+                    }
+                }
+                else
+                {
+                    PassFilter(DryFilter, 0, 4, Resampled[0][todo-1]);
+
+                    /* Direct path final mix buffer and panning */
+                    MixMono(Resampled[0], &DryBuffer[j], DrySend, dryGainStep, todo);
+
+                    /* Room path final mix buffer and panning */
+                    for(i = 0;i < SendCount;i++)
+                    {
+                        out = Sends[i];
+                        for(n = 0;n < todo;n++)
+                        {
+                            WetSend[out] += wetGainStep[out];
+                            outsamp = lpFilter2P(WetFilter[out], 0, Resampled[0][n]);
+                            WetBuffer[out][j+n] += outsamp*WetSend[out];
+                        }
+                    }
+                }
+                for(i = 0;i < MAX_SENDS;i++)
+                {
+                    if(!ALSource->Send[i].Slot)
+                    {
+                        PassFilter(WetFilter[i], 0, 2, Resampled[0][todo-1]);
+                        WetSend[i] += wetGainStep[i]*todo;
+                    }
+                }
+
+                Advance = (ALuint64)DataPosFrac + (ALuint64)increment*todo;
+                k += (ALuint)(Advance>>FRACTIONBITS);
+                DataPosFrac = (ALuint)(Advance&FRACTIONMASK);
+                j += todo;
+                BufferSize -= todo;
             }
-#undef DO_MIX
         }
-        else if(Channels == 2 && DuplicateStereo) /* Stereo */
+        else if(Resample && Channels >= 2 && Channels <= 8 && ChannelOutputs[Channels][1] != 0)
         {
-            const int chans[] = {
-                FRONT_LEFT, FRONT_RIGHT
-            };
+            const int *chans = ChannelOutputs[Channels];
             const int chans2[] = {
                 BACK_LEFT, SIDE_LEFT, BACK_RIGHT, SIDE_RIGHT
             };
+            const ALboolean dup = (Channels == 2 && DuplicateStereo);
             const ALfloat scaler = 1.0f/Channels;
             const ALfloat dupscaler = aluSqrt(1.0f/3.0f);
 
-#define DO_MIX(resampler) do {                                                \
-    while(BufferSize--)                                                       \
-    {                                                                         \
-        for(i = 0;i < OUTPUTCHANNELS;i++)                                     \
-            DrySend[i] += dryGainStep[i];                                     \
-        for(i = 0;i < MAX_SENDS;i++)                                          \
-            WetSend[i] += wetGainStep[i];                                     \
-                                                                              \
-        for(i = 0;i < Channels;i++)                                           \
-        {                                                                     \
-            value = (resampler)(Data[k*Channels + i],Data[(k+1)*Channels + i],\
-                                DataPosFrac);                                 \
-            outsamp = lpFilter2P(DryFilter, chans[i]*2, value) * dupscaler;   \
-            DryBuffer[j][chans[i]] += outsamp*DrySend[chans[i]];              \
-            DryBuffer[j][chans2[i*2+0]] += outsamp*DrySend[chans2[i*2+0]];    \
-            DryBuffer[j][chans2[i*2+1]] += outsamp*DrySend[chans2[i*2+1]];    \
-            for(out = 0;out < MAX_SENDS;out++)                                \
-            {                                                                 \
-                outsamp = lpFilter1P(WetFilter[out], chans[i], value);        \
-                WetBuffer[out][j] += outsamp*WetSend[out]*scaler;             \
-            }                                                                 \
-        }                                                                     \
-                                                                              \
-        DataPosFrac += increment;                                             \
-        k += DataPosFrac>>FRACTIONBITS;                                       \
-        DataPosFrac &= FRACTIONMASK;                                          \
-        j++;                                                                  \
-    }                                                                         \
-} while(0)
-
-            switch(Resampler)
+            while(BufferSize > 0)
             {
-                case POINT_RESAMPLER:
-                DO_MIX(point); break;
-                case LINEAR_RESAMPLER:
-                DO_MIX(lerp); break;
-                case COSINE_RESAMPLER:
-                DO_MIX(cos_lerp); break;
-                case RESAMPLER_MIN:
-                case RESAMPLER_MAX:
-                break;
-            }
-#undef DO_MIX
-        }
-        else if(Channels == 2) /* Stereo */
-        {
-            const int chans[] = {
-                FRONT_LEFT, FRONT_RIGHT
-            };
-            const ALfloat scaler = 1.0f/Channels;
-
-#define DO_MIX(resampler) do {                                                \
-    while(BufferSize--)                                                       \
-    {                                                                         \
-        for(i = 0;i < OUTPUTCHANNELS;i++)                                     \
-            DrySend[i] += dryGainStep[i];                                     \
-        for(i = 0;i < MAX_SENDS;i++)                                          \
-            WetSend[i] += wetGainStep[i];                                     \
-                                                                              \
-        for(i = 0;i < Channels;i++)                                           \
-        {                                                                     \
-            value = (resampler)(Data[k*Channels + i],Data[(k+1)*Channels + i],\
-                                DataPosFrac);                                 \
-            outsamp = lpFilter2P(DryFilter, chans[i]*2, value);               \
-            DryBuffer[j][chans[i]] += outsamp*DrySend[chans[i]];              \
-            for(out = 0;out < MAX_SENDS;out++)                                \
-            {                                                                 \
-                outsamp = lpFilter1P(WetFilter[out], chans[i], value);        \
-                WetBuffer[out][j] += outsamp*WetSend[out]*scaler;             \
-            }                                                                 \
-        }                                                                     \
-                                                                              \
-        DataPosFrac += increment;                                             \
-        k += DataPosFrac>>FRACTIONBITS;                                       \
-        DataPosFrac &= FRACTIONMASK;                                          \
-        j++;                                                                  \
-    }                                                                         \
-} while(0)
-
-            switch(Resampler)
-            {
-                case POINT_RESAMPLER:
-                DO_MIX(point); break;
-                case LINEAR_RESAMPLER:
-                DO_MIX(lerp); break;
-                case COSINE_RESAMPLER:
-                DO_MIX(cos_lerp); break;
-                case RESAMPLER_MIN:
-                case RESAMPLER_MAX:
-                break;
-            }
-        }
-        else if(Channels == 4) /* Quad */
-        {
-            const int chans[] = {
-                FRONT_LEFT, FRONT_RIGHT,
-                BACK_LEFT,  BACK_RIGHT
-            };
-            const ALfloat scaler = 1.0f/Channels;
+                ALuint todo = min(BufferSize, MIX_CHUNK);
 
-            switch(Resampler)
-            {
-                case POINT_RESAMPLER:
-                DO_MIX(point); break;
-                case LINEAR_RESAMPLER:
-                DO_MIX(lerp); break;
-                case COSINE_RESAMPLER:
-                DO_MIX(cos_lerp); break;
-                case RESAMPLER_MIN:
-                case RESAMPLER_MAX:
-                break;
-            }
-        }
-        else if(Channels == 6) /* 5.1 */
-        {
-            const int chans[] = {
-                FRONT_LEFT,   FRONT_RIGHT,
-                FRONT_CENTER, LFE,
-                BACK_LEFT,    BACK_RIGHT
-            };
-            const ALfloat scaler = 1.0f/Channels;
+                for(i = 0;i < Channels;i++)
+                    Resample(&Data[k*Channels + i], Channels, DataPosFrac, increment,
+                             Resampled[i], todo);
 
-            switch(Resampler)
-            {
-                case POINT_RESAMPLER:
-                DO_MIX(point); break;
-                case LINEAR_RESAMPLER:
-                DO_MIX(lerp); break;
-                case COSINE_RESAMPLER:
-                DO_MIX(cos_lerp); break;
-                case RESAMPLER_MIN:
-                case RESAMPLER_MAX:
-                break;
-            }
-        }
-        else if(Channels == 7) /* 6.1 */
-        {
-            const int chans[] = {
-                FRONT_LEFT,   FRONT_RIGHT,
-                FRONT_CENTER, LFE,
-                BACK_CENTER,
-                SIDE_LEFT,    SIDE_RIGHT
-            };
-            const ALfloat scaler = 1.0f/Channels;
-
-            switch(Resampler)
-            {
-                case POINT_RESAMPLER:
-                DO_MIX(point); break;
-                case LINEAR_RESAMPLER:
-                DO_MIX(lerp); break;
-                case COSINE_RESAMPLER:
-                DO_MIX(cos_lerp); break;
-                case RESAMPLER_MIN:
-                case RESAMPLER_MAX:
-                break;
-            }
-        }
-        else if(Channels == 8) /* 7.1 */
-        {
-            const int chans[] = {
-                FRONT_LEFT,   FRONT_RIGHT,
-                FRONT_CENTER, LFE,
-                BACK_LEFT,    BACK_RIGHT,
-                SIDE_LEFT,    SIDE_RIGHT
-            };
-            const ALfloat scaler = 1.0f/Channels;
+                for(n = 0;n < todo;n++)
+                {
+                    for(i = 0;i < OUTPUTCHANNELS;i++)
+                        DrySend[i] += dryGainStep[i];
+                    for(i = 0;i < SendCount;i++)
+                        WetSend[Sends[i]] += wetGainStep[Sends[i]];
+
+                    for(i = 0;i < Channels;i++)
+                    {
+                        const ALfloat value = Resampled[i][n];
+
+                        outsamp = value;
+                        if(FilterDry)
+                            outsamp = lpFilter2P(DryFilter, chans[i]*2, value);
+                        if(dup)
+                        {
+                            outsamp *= dupscaler;
+                            DryBuffer[j+n][chans2[i*2+0]] += outsamp*DrySend[chans2[i*2+0]];
+                            DryBuffer[j+n][chans2[i*2+1]] += outsamp*DrySend[chans2[i*2+1]];
+                        }
+                        DryBuffer[j+n][chans[i]] += outsamp*DrySend[chans[i]];
+                        for(out = 0;out < SendCount;out++)
+                        {
+                            outsamp = lpFilter1P(WetFilter[Sends[out]], chans[i], value);
+                            WetBuffer[Sends[out]][j+n] += outsamp*WetSend[Sends[out]]*scaler;
+                        }
+                    }
+                }
+                for(i = 0;i < Channels;i++)
+                {
+                    if(!FilterDry)
+                        PassFilter(DryFilter, chans[i]*2, 2, Resampled[i][todo-1]);
+                    for(out = 0;out < MAX_SENDS;out++)
+                    {
+                        if(!ALSource->Send[out].Slot)
+                            PassFilter(WetFilter[out], chans[i], 1, Resampled[i][todo-1]);
+                    }
+                }
+                for(out = 0;out < MAX_SENDS;out++)
+                {
+                    if(!ALSource->Send[out].Slot)
+                        WetSend[out] += wetGainStep[out]*todo;
+                }
 
-            switch(Resampler)
-            {
-                case POINT_RESAMPLER:
-                DO_MIX(point); break;
-                case LINEAR_RESAMPLER:
-                DO_MIX(lerp); break;
-                case COSINE_RESAMPLER:
-                DO_MIX(cos_lerp); break;
-                case RESAMPLER_MIN:
-                case RESAMPLER_MAX:
-                break;
+                Advance = (ALuint64)DataPosFrac + (ALuint64)increment*todo;
+                k += (ALuint)(Advance>>FRACTIONBITS);
+                DataPosFrac = (ALuint)(Advance&FRACTIONMASK);
+                j += todo;
+                BufferSize -= todo;
             }
-#undef DO_MIX
         }
         else /* Unknown? */
         {
@@ -0,0 +1,159 @@
+/**
+ * OpenAL cross platform audio library
+ * Copyright (C) 1999-2007 by authors.
+ * This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ *  License along with this library; if not, write to the
+ *  Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ *  Boston, MA  02111-1307, USA.
+ * Or go to http://www.gnu.org/copyleft/lgpl.html
+ */
+
+#include "config.h"
+
+#include <math.h>
+
+#include "mixer.h"
+
+#if defined(ANDROID) && defined(HAVE_NEON) && !defined(__ARM_NEON__)
+#include <cpu-features.h>
+#endif
+
+ALuint CPUCapFlags = 0;
+
+void FillCPUCaps(ALboolean disable)
+{
+    CPUCapFlags = 0;
+    if(disable)
+        return;
+
+#ifdef HAVE_SSE2
+    /* Only built where the compiler may assume SSE2 anyway */
+    CPUCapFlags |= CPU_CAP_SSE2;
+#endif
+#ifdef HAVE_NEON
+#if defined(ANDROID) && !defined(__ARM_NEON__)
+    /* armeabi-v7a doesn't promise NEON (eg. Tegra 2), so ask */
+    if(android_getCpuFamily() == ANDROID_CPU_FAMILY_ARM &&
+       (android_getCpuFeatures()&ANDROID_CPU_ARM_FEATURE_NEON))
+        CPUCapFlags |= CPU_CAP_NEON;
+#else
+    CPUCapFlags |= CPU_CAP_NEON;
+#endif
+#endif
+}
+
+ResamplerFunc SelectResampler(resampler_t resampler)
+{
+    switch(resampler)
+    {
+        case POINT_RESAMPLER:
+#ifdef HAVE_NEON
+            if((CPUCapFlags&CPU_CAP_NEON))
+                return Resample_point_NEON;
+#endif
+#ifdef HAVE_SSE2
+            if((CPUCapFlags&CPU_CAP_SSE2))
+                return Resample_point_SSE2;
+#endif
+            return Resample_point_C;
+        case LINEAR_RESAMPLER:
+#ifdef HAVE_NEON
+            if((CPUCapFlags&CPU_CAP_NEON))
+                return Resample_lerp_NEON;
+#endif
+#ifdef HAVE_SSE2
+            if((CPUCapFlags&CPU_CAP_SSE2))
+                return Resample_lerp_SSE2;
+#endif
+            return Resample_lerp_C;
+        case COSINE_RESAMPLER:
+            return Resample_cos_lerp_C;
+        case RESAMPLER_MIN:
+        case RESAMPLER_MAX:
+            break;
+    }
+    return NULL;
+}
+
+MonoMixerFunc SelectMonoMixer(void)
+{
+#ifdef HAVE_NEON
+    if((CPUCapFlags&CPU_CAP_NEON))
+        return MixMono_NEON;
+#endif
+#ifdef HAVE_SSE2
+    if((CPUCapFlags&CPU_CAP_SSE2))
+        return MixMono_SSE2;
+#endif
+    return MixMono_C;
+}
+
+
+static __inline ALfloat point(ALfloat val1, ALfloat val2, ALint frac)
+{
+    return val1;
+    (void)val2;
+    (void)frac;
+}
+static __inline ALfloat lerp(ALfloat val1, ALfloat val2, ALint frac)
+{
+    return val1 + ((val2-val1)*(frac * (1.0f/(1<<FRACTIONBITS))));
+}
+static __inline ALfloat cos_lerp(ALfloat val1, ALfloat val2, ALint frac)
+{
+    ALfloat mult = (1.0f-cos(frac * (1.0f/(1<<FRACTIONBITS)) * M_PI)) * 0.5f;
+    return val1 + ((val2-val1)*mult);
+}
+
+#define DECL_TEMPLATE(sampler)                                                \
+void Resample_##sampler##_C(const ALfloat *data, ALuint chans, ALuint frac,   \
+                            ALuint increment, ALfloat *dst, ALuint count)     \
+{                                                                             \
+    ALuint k = 0;                                                             \
+    ALuint i;                                                                 \
+                                                                              \
+    for(i = 0;i < count;i++)                                                  \
+    {                                                                         \
+        dst[i] = sampler(data[k*chans], data[(k+1)*chans], frac);             \
+                                                                              \
+        frac += increment;                                                    \
+        k += frac>>FRACTIONBITS;                                              \
+        frac &= FRACTIONMASK;                                                 \
+    }                                                                         \
+}
+
+DECL_TEMPLATE(point)
+DECL_TEMPLATE(lerp)
+DECL_TEMPLATE(cos_lerp)
+
+#undef DECL_TEMPLATE
+
+void MixMono_C(const ALfloat *src, ALfloat (*dst)[OUTPUTCHANNELS], ALfloat *gains, const ALfloat *steps, ALuint count)
+{
+    ALuint i, c;
+
+    for(i = 0;i < count;i++)
+    {
+        for(c = 0;c < OUTPUTCHANNELS;c++)
+            gains[c] += steps[c];
+
+        dst[i][FRONT_LEFT]   += src[i]*gains[FRONT_LEFT];
+        dst[i][FRONT_RIGHT]  += src[i]*gains[FRONT_RIGHT];
+        dst[i][SIDE_LEFT]    += src[i]*gains[SIDE_LEFT];
+        dst[i][SIDE_RIGHT]   += src[i]*gains[SIDE_RIGHT];
+        dst[i][BACK_LEFT]    += src[i]*gains[BACK_LEFT];
+        dst[i][BACK_RIGHT]   += src[i]*gains[BACK_RIGHT];
+        dst[i][FRONT_CENTER] += src[i]*gains[FRONT_CENTER];
+        dst[i][BACK_CENTER]  += src[i]*gains[BACK_CENTER];
+    }
+}
@@ -0,0 +1,130 @@
+/**
+ * OpenAL cross platform audio library
+ * Copyright (C) 1999-2007 by authors.
+ * This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ *  License along with this library; if not, write to the
+ *  Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ *  Boston, MA  02111-1307, USA.
+ * Or go to http://www.gnu.org/copyleft/lgpl.html
+ */
+
+#include "config.h"
+
+#include "mixer.h"
+
+#if defined(HAVE_NEON) && defined(__ARM_NEON__)
+
+#include <arm_neon.h>
+
+/* Frame positions are still stepped one at a time, exactly as the C
+ * resamplers do, so only the sample math is done four at a time. Returns the
+ * fraction of the frame at k before stepping. */
+static __inline ALuint StepPosition(ALuint *k, ALuint *frac, ALuint increment)
+{
+    ALuint ret = *frac;
+
+    *frac += increment;
+    *k += *frac>>FRACTIONBITS;
+    *frac &= FRACTIONMASK;
+    return ret;
+}
+
+static __inline float32x4_t Gather(const ALfloat *data, ALuint chans, const ALuint *pos, ALuint offset)
+{
+    float32x4_t ret = vdupq_n_f32(data[(pos[0]+offset)*chans]);
+    ret = vsetq_lane_f32(data[(pos[1]+offset)*chans], ret, 1);
+    ret = vsetq_lane_f32(data[(pos[2]+offset)*chans], ret, 2);
+    ret = vsetq_lane_f32(data[(pos[3]+offset)*chans], ret, 3);
+    return ret;
+}
+
+void Resample_point_NEON(const ALfloat *data, ALuint chans, ALuint frac,
+                         ALuint increment, ALfloat *dst, ALuint count)
+{
+    ALuint pos[4];
+    ALuint k = 0;
+    ALuint i = 0, p;
+
+    for(;count-i >= 4;i += 4)
+    {
+        for(p = 0;p < 4;p++)
+        {
+            pos[p] = k;
+            StepPosition(&k, &frac, increment);
+        }
+        vst1q_f32(&dst[i], Gather(data, chans, pos, 0));
+    }
+    Resample_point_C(&data[k*chans], chans, frac, increment, &dst[i], count-i);
+}
+
+void Resample_lerp_NEON(const ALfloat *data, ALuint chans, ALuint frac,
+                        ALuint increment, ALfloat *dst, ALuint count)
+{
+    const float32x4_t fracScale = vdupq_n_f32(1.0f/(1<<FRACTIONBITS));
+    ALuint pos[4], fracs[4];
+    ALuint k = 0;
+    ALuint i = 0, p;
+
+    for(;count-i >= 4;i += 4)
+    {
+        float32x4_t val1, val2, mu;
+
+        for(p = 0;p < 4;p++)
+        {
+            pos[p] = k;
+            fracs[p] = StepPosition(&k, &frac, increment);
+        }
+        val1 = Gather(data, chans, pos, 0);
+        val2 = Gather(data, chans, pos, 1);
+        mu = vmulq_f32(vcvtq_f32_u32(vld1q_u32(fracs)), fracScale);
+        vst1q_f32(&dst[i], vaddq_f32(val1, vmulq_f32(vsubq_f32(val2, val1), mu)));
+    }
+    Resample_lerp_C(&data[k*chans], chans, frac, increment, &dst[i], count-i);
+}
+
+void MixMono_NEON(const ALfloat *src, ALfloat (*dst)[OUTPUTCHANNELS], ALfloat *gains, const ALfloat *steps, ALuint count)
+{
+    /* FRONT_LEFT..LFE and BACK_LEFT..SIDE_LEFT go four at a time, with the
+     * LFE masked out, and SIDE_RIGHT on its own */
+    static const ALuint noLFEBits[4] = { 0xffffffff, 0xffffffff, 0xffffffff, 0 };
+    const uint32x4_t noLFE = vld1q_u32(noLFEBits);
+    float32x4_t gain0 = vld1q_f32(&gains[FRONT_LEFT]);
+    float32x4_t gain1 = vld1q_f32(&gains[BACK_LEFT]);
+    const float32x4_t step0 = vld1q_f32(&steps[FRONT_LEFT]);
+    const float32x4_t step1 = vld1q_f32(&steps[BACK_LEFT]);
+    ALfloat gain8 = gains[SIDE_RIGHT];
+    const ALfloat step8 = steps[SIDE_RIGHT];
+    ALuint i;
+
+    for(i = 0;i < count;i++)
+    {
+        float32x4_t mix0, mix1;
+
+        gain0 = vaddq_f32(gain0, step0);
+        gain1 = vaddq_f32(gain1, step1);
+        gain8 += step8;
+
+        mix0 = vmulq_n_f32(gain0, src[i]);
+        mix0 = vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(mix0), noLFE));
+        mix1 = vmulq_n_f32(gain1, src[i]);
+        vst1q_f32(&dst[i][FRONT_LEFT], vaddq_f32(vld1q_f32(&dst[i][FRONT_LEFT]), mix0));
+        vst1q_f32(&dst[i][BACK_LEFT], vaddq_f32(vld1q_f32(&dst[i][BACK_LEFT]), mix1));
+        dst[i][SIDE_RIGHT] += src[i]*gain8;
+    }
+
+    vst1q_f32(&gains[FRONT_LEFT], gain0);
+    vst1q_f32(&gains[BACK_LEFT], gain1);
+    gains[SIDE_RIGHT] = gain8;
+}
+
+#endif
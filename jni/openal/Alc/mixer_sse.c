@@ -0,0 +1,124 @@
+/**
+ * OpenAL cross platform audio library
+ * Copyright (C) 1999-2007 by authors.
+ * This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ *  License along with this library; if not, write to the
+ *  Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ *  Boston, MA  02111-1307, USA.
+ * Or go to http://www.gnu.org/copyleft/lgpl.html
+ */
+
+#include "config.h"
+
+#include "mixer.h"
+
+#ifdef HAVE_SSE2
+
+#include <emmintrin.h>
+
+/* Frame positions are still stepped one at a time, exactly as the C
+ * resamplers do, so only the sample math is done four at a time. Returns the
+ * fraction of the frame at k before stepping. */
+static __inline ALuint StepPosition(ALuint *k, ALuint *frac, ALuint increment)
+{
+    ALuint ret = *frac;
+
+    *frac += increment;
+    *k += *frac>>FRACTIONBITS;
+    *frac &= FRACTIONMASK;
+    return ret;
+}
+
+void Resample_point_SSE2(const ALfloat *data, ALuint chans, ALuint frac,
+                         ALuint increment, ALfloat *dst, ALuint count)
+{
+    ALuint pos[4];
+    ALuint k = 0;
+    ALuint i = 0, p;
+
+    for(;count-i >= 4;i += 4)
+    {
+        for(p = 0;p < 4;p++)
+        {
+            pos[p] = k;
+            StepPosition(&k, &frac, increment);
+        }
+        _mm_storeu_ps(&dst[i], _mm_setr_ps(data[pos[0]*chans], data[pos[1]*chans],
+                                           data[pos[2]*chans], data[pos[3]*chans]));
+    }
+    Resample_point_C(&data[k*chans], chans, frac, increment, &dst[i], count-i);
+}
+
+void Resample_lerp_SSE2(const ALfloat *data, ALuint chans, ALuint frac,
+                        ALuint increment, ALfloat *dst, ALuint count)
+{
+    const __m128 fracScale = _mm_set1_ps(1.0f/(1<<FRACTIONBITS));
+    ALuint pos[4], fracs[4];
+    ALuint k = 0;
+    ALuint i = 0, p;
+
+    for(;count-i >= 4;i += 4)
+    {
+        __m128 val1, val2, mu;
+
+        for(p = 0;p < 4;p++)
+        {
+            pos[p] = k;
+            fracs[p] = StepPosition(&k, &frac, increment);
+        }
+        val1 = _mm_setr_ps(data[pos[0]*chans], data[pos[1]*chans],
+                           data[pos[2]*chans], data[pos[3]*chans]);
+        val2 = _mm_setr_ps(data[(pos[0]+1)*chans], data[(pos[1]+1)*chans],
+                           data[(pos[2]+1)*chans], data[(pos[3]+1)*chans]);
+        mu = _mm_mul_ps(_mm_cvtepi32_ps(_mm_setr_epi32(fracs[0], fracs[1], fracs[2], fracs[3])),
+                        fracScale);
+        _mm_storeu_ps(&dst[i], _mm_add_ps(val1, _mm_mul_ps(_mm_sub_ps(val2, val1), mu)));
+    }
+    Resample_lerp_C(&data[k*chans], chans, frac, increment, &dst[i], count-i);
+}
+
+void MixMono_SSE2(const ALfloat *src, ALfloat (*dst)[OUTPUTCHANNELS], ALfloat *gains, const ALfloat *steps, ALuint count)
+{
+    /* FRONT_LEFT..LFE and BACK_LEFT..SIDE_LEFT go four at a time, with the
+     * LFE masked out, and SIDE_RIGHT on its own */
+    const __m128 noLFE = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+    __m128 gain0 = _mm_loadu_ps(&gains[FRONT_LEFT]);
+    __m128 gain1 = _mm_loadu_ps(&gains[BACK_LEFT]);
+    const __m128 step0 = _mm_loadu_ps(&steps[FRONT_LEFT]);
+    const __m128 step1 = _mm_loadu_ps(&steps[BACK_LEFT]);
+    ALfloat gain8 = gains[SIDE_RIGHT];
+    const ALfloat step8 = steps[SIDE_RIGHT];
+    ALuint i;
+
+    for(i = 0;i < count;i++)
+    {
+        const __m128 smp = _mm_set1_ps(src[i]);
+
+        gain0 = _mm_add_ps(gain0, step0);
+        gain1 = _mm_add_ps(gain1, step1);
+        gain8 += step8;
+
+        _mm_storeu_ps(&dst[i][FRONT_LEFT],
+                      _mm_add_ps(_mm_loadu_ps(&dst[i][FRONT_LEFT]),
+                                 _mm_and_ps(_mm_mul_ps(smp, gain0), noLFE)));
+        _mm_storeu_ps(&dst[i][BACK_LEFT],
+                      _mm_add_ps(_mm_loadu_ps(&dst[i][BACK_LEFT]), _mm_mul_ps(smp, gain1)));
+        dst[i][SIDE_RIGHT] += src[i]*gain8;
+    }
+
+    _mm_storeu_ps(&gains[FRONT_LEFT], gain0);
+    _mm_storeu_ps(&gains[BACK_LEFT], gain1);
+    gains[SIDE_RIGHT] = gain8;
+}
+
+#endif
@@ -9,10 +9,18 @@ extern "C" {
 
 #define BUFFER_PADDING 2
 
+// Sample frames in one IMA4 ADPCM block (512 bytes per channel)
+#define IMA4_BLOCK_FRAMES 1017
+
 typedef struct ALbuffer
 {
-    ALfloat *data;
-    ALsizei  size;
+    ALfloat *data;   // NULL while the samples are kept compressed
+    ALsizei  size;   // size of the decoded samples, even when they aren't stored
+
+    // IMA4 ADPCM blocks as uploaded, decoded by the mixer while playing. NULL for
+    // other formats or when the ima4-decompress option is set.
+    ALubyte *compressed;
+    ALuint   compressedId; // changes whenever the compressed data does
 
     ALenum   format;
     ALenum   eOriginalFormat;
@@ -32,6 +40,9 @@ typedef struct ALbuffer
 
 ALvoid ReleaseALBuffers(ALCdevice *device);
 
+ALvoid DecodeIMA4Block(ALfloat *dst, const ALubyte *src, ALint chans, ALuint first, ALuint count);
+ALvoid ReadBufferFrames(const ALbuffer *buf, ALuint frame, ALuint count, ALfloat *dst);
+
 #ifdef __cplusplus
 }
 #endif
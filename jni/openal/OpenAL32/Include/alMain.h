@@ -305,6 +305,7 @@ void alc_android_probe(int type);
 void alc_null_init(BackendFuncs *func_list);
 void alc_null_deinit(void);
 void alc_null_probe(int type);
+void alc_loopback_init(BackendFuncs *func_list);
 
 
 typedef struct UIntMap {
@@ -86,6 +86,12 @@ typedef struct ALsource
     ALfloat WetGains[MAX_SENDS];
     ALboolean FirstStart;
 
+    // Decoded frames of the compressed buffer being played, see DecodeWindow()
+    ALfloat *DecodeScratch;
+    ALuint   DecodedId;     // compressedId of the buffer they came from
+    ALuint   DecodedBlock;  // first block in the scratch
+    ALuint   DecodedBlocks;
+
     // Current target parameters used for mixing
     ALboolean NeedsUpdate;
     struct {
@@ -0,0 +1,68 @@
+#ifndef _MIXER_H_
+#define _MIXER_H_
+
+#include "alMain.h"
+#include "AL/al.h"
+#include "alu.h"
+#include "alSource.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(__SSE2__) && !defined(HAVE_SSE2)
+#define HAVE_SSE2
+#endif
+#if defined(__ARM_NEON__) && !defined(HAVE_NEON)
+#define HAVE_NEON
+#endif
+
+#define FRACTIONBITS 14
+#define FRACTIONMASK ((1L<<FRACTIONBITS)-1)
+
+enum {
+    CPU_CAP_SSE2 = 1<<0,
+    CPU_CAP_NEON = 1<<1
+};
+extern ALuint CPUCapFlags;
+
+/* Detects the vector units the kernels below can use, unless the
+ * disable-cpu-exts option is set */
+void FillCPUCaps(ALboolean disable);
+
+/* Resamples count samples of one channel of interleaved data, whose first
+ * frame is read at frac (in 1<<FRACTIONBITS units), into dst. */
+typedef void (*ResamplerFunc)(const ALfloat *data, ALuint chans, ALuint frac,
+                              ALuint increment, ALfloat *dst, ALuint count);
+
+/* Mixes count mono samples into every output channel but the LFE, stepping
+ * each channel's gain by its step before every sample, as the mixer always
+ * has. */
+typedef void (*MonoMixerFunc)(const ALfloat *src, ALfloat (*dst)[OUTPUTCHANNELS],
+                              ALfloat *gains, const ALfloat *steps, ALuint count);
+
+ResamplerFunc SelectResampler(resampler_t resampler);
+MonoMixerFunc SelectMonoMixer(void);
+
+void Resample_point_C(const ALfloat *data, ALuint chans, ALuint frac, ALuint increment, ALfloat *dst, ALuint count);
+void Resample_lerp_C(const ALfloat *data, ALuint chans, ALuint frac, ALuint increment, ALfloat *dst, ALuint count);
+void Resample_cos_lerp_C(const ALfloat *data, ALuint chans, ALuint frac, ALuint increment, ALfloat *dst, ALuint count);
+void MixMono_C(const ALfloat *src, ALfloat (*dst)[OUTPUTCHANNELS], ALfloat *gains, const ALfloat *steps, ALuint count);
+
+#ifdef HAVE_SSE2
+void Resample_point_SSE2(const ALfloat *data, ALuint chans, ALuint frac, ALuint increment, ALfloat *dst, ALuint count);
+void Resample_lerp_SSE2(const ALfloat *data, ALuint chans, ALuint frac, ALuint increment, ALfloat *dst, ALuint count);
+void MixMono_SSE2(const ALfloat *src, ALfloat (*dst)[OUTPUTCHANNELS], ALfloat *gains, const ALfloat *steps, ALuint count);
+#endif
+
+#ifdef HAVE_NEON
+void Resample_point_NEON(const ALfloat *data, ALuint chans, ALuint frac, ALuint increment, ALfloat *dst, ALuint count);
+void Resample_lerp_NEON(const ALfloat *data, ALuint chans, ALuint frac, ALuint increment, ALfloat *dst, ALuint count);
+void MixMono_NEON(const ALfloat *src, ALfloat (*dst)[OUTPUTCHANNELS], ALfloat *gains, const ALfloat *steps, ALuint count);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
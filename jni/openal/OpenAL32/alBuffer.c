@@ -39,6 +39,10 @@ static void ConvertDataRear(ALfloat *dst, const ALvoid *src, ALint origBytes, AL
 static void ConvertDataIMA4(ALfloat *dst, const ALvoid *src, ALint origChans, ALsizei len);
 static void ConvertDataMULaw(ALfloat *dst, const ALvoid *src, ALsizei len);
 static void ConvertDataMULawRear(ALfloat *dst, const ALvoid *src, ALsizei len);
+static void DropCompressed(ALbuffer *ALBuf);
+
+/* Source of compressedId values, so the mixer can tell when compressed data changed */
+static ALuint NextCompressedId = 1;
 
 #define LookupBuffer(m, k) ((ALbuffer*)LookupUIntMapKey(&(m), (k)))
 
@@ -213,6 +217,7 @@ AL_API ALvoid AL_APIENTRY alDeleteBuffers(ALsizei n, const ALuint *puiBuffers)
                 {
                     // Release the memory used to store audio data
                     free(ALBuf->data);
+                    free(ALBuf->compressed);
 
                     // Release buffer structure
                     RemoveUIntMapKey(&device->BufferMap, ALBuf->buffer);
@@ -341,6 +346,7 @@ AL_API ALvoid AL_APIENTRY alBufferData(ALuint buffer,ALenum format,const ALvoid
                     if(temp)
                     {
                         ALBuf->data = temp;
+                        DropCompressed(ALBuf);
                         ConvertDataRear(ALBuf->data, data, OrigBytes, newsize);
 
                         ALBuf->format = NewFormat;
@@ -413,6 +419,43 @@ AL_API ALvoid AL_APIENTRY alBufferData(ALuint buffer,ALenum format,const ALvoid
                     newsize = size / 512;
                     newsize *= 1017;
 
+                    if(!GetConfigValueBool(NULL, "ima4-decompress", AL_FALSE))
+                    {
+                        // Keep the blocks as they are (an eighth of the size of the
+                        // decoded samples) and let the mixer decode them as it plays.
+                        ALuint BlockBytes = 512 * Channels;
+                        ALuint64 compressedsize = (newsize/(1017*Channels)) * BlockBytes;
+
+                        if(compressedsize > INT_MAX)
+                        {
+                            alSetError(Context, AL_OUT_OF_MEMORY);
+                            break;
+                        }
+                        temp = realloc(ALBuf->compressed, compressedsize ? compressedsize : 1);
+                        if(temp)
+                        {
+                            ALBuf->compressed = temp;
+                            memcpy(ALBuf->compressed, data, compressedsize);
+                            ALBuf->compressedId = NextCompressedId++;
+                            free(ALBuf->data);
+                            ALBuf->data = NULL;
+
+                            ALBuf->format = NewFormat;
+                            ALBuf->eOriginalFormat = format;
+                            ALBuf->size = newsize*NewBytes;
+                            ALBuf->frequency = freq;
+
+                            ALBuf->LoopStart = 0;
+                            ALBuf->LoopEnd = newsize / Channels;
+
+                            ALBuf->OriginalSize = size;
+                            ALBuf->OriginalAlign = BlockBytes;
+                        }
+                        else
+                            alSetError(Context, AL_OUT_OF_MEMORY);
+                        break;
+                    }
+
                     allocsize = (BUFFER_PADDING*Channels + newsize)*NewBytes;
                     if(allocsize > INT_MAX)
                     {
@@ -423,6 +466,7 @@ AL_API ALvoid AL_APIENTRY alBufferData(ALuint buffer,ALenum format,const ALvoid
                     if(temp)
                     {
                         ALBuf->data = temp;
+                        DropCompressed(ALBuf);
                         ConvertDataIMA4(ALBuf->data, data, Channels, newsize/(1017*Channels));
 
                         ALBuf->format = NewFormat;
@@ -476,6 +520,7 @@ AL_API ALvoid AL_APIENTRY alBufferData(ALuint buffer,ALenum format,const ALvoid
                     if(temp)
                     {
                         ALBuf->data = temp;
+                        DropCompressed(ALBuf);
                         ConvertDataMULaw(ALBuf->data, data, size);
 
                         ALBuf->format = NewFormat;
@@ -517,6 +562,7 @@ AL_API ALvoid AL_APIENTRY alBufferData(ALuint buffer,ALenum format,const ALvoid
                     if(temp)
                     {
                         ALBuf->data = temp;
+                        DropCompressed(ALBuf);
                         ConvertDataMULawRear(ALBuf->data, data, newsize);
 
                         ALBuf->format = NewFormat;
@@ -640,6 +686,14 @@ AL_API ALvoid AL_APIENTRY alBufferSubDataEXT(ALuint buffer,ALenum format,const A
                 case AL_FORMAT_STEREO_IMA4: {
                     int Channels = aluChannelsFromFormat(ALBuf->format);
 
+                    if(ALBuf->compressed)
+                    {
+                        // offset and length are whole blocks, see OriginalAlign
+                        memcpy(&ALBuf->compressed[offset], data, length);
+                        ALBuf->compressedId = NextCompressedId++;
+                        break;
+                    }
+
                     // offset -> sample*channel offset, length -> block count
                     offset /= 36;
                     offset *= 65;
@@ -1082,6 +1136,7 @@ static ALenum LoadData(ALbuffer *ALBuf, const ALvoid *data, ALsizei size, ALuint
     temp = realloc(ALBuf->data, allocsize);
     if(!temp) return AL_OUT_OF_MEMORY;
     ALBuf->data = temp;
+    DropCompressed(ALBuf);
 
     // Samples are converted here
     ConvertData(ALBuf->data, data, OrigBytes, newsize);
@@ -1189,61 +1244,119 @@ static void ConvertDataRear(ALfloat *dst, const ALvoid *src, ALint origBytes, AL
 static void ConvertDataIMA4(ALfloat *dst, const ALvoid *src, ALint chans, ALsizei len)
 {
     const ALubyte *IMAData;
-    ALint Sample[2],Index[2];
-    ALuint IMACode[2];
-    ALsizei i,j,k,c;
+    ALsizei i;
 
     if(src == NULL)
         return;
     IMAData = src;
     for(i = 0;i < len;i++)
     {
-        for(c = 0;c < chans;c++)
-        {
-            Sample[c]  = *(IMAData++);
-            Sample[c] |= *(IMAData++) << 8;
-            Sample[c]  = (Sample[c]^0x8000) - 32768;
-            Index[c]  = *(IMAData++);
-            Index[c] |= *(IMAData++) << 8;
-            Index[c]  = (Index[c]^0x8000) - 32768;
+        DecodeIMA4Block(&dst[i*IMA4_BLOCK_FRAMES*chans], IMAData, chans, 0, IMA4_BLOCK_FRAMES);
+        IMAData += 512*chans;
+    }
+}
 
-            Index[c] = ((Index[c]<0) ? 0 : Index[c]);
-            Index[c] = ((Index[c]>88) ? 88 : Index[c]);
+/*
+ * DecodeIMA4Block
+ *
+ * Decodes the frames [first, first+count) of one IMA4 block (512*chans bytes)
+ * into dst. The block still has to be decoded from its start, but only the
+ * requested frames are written.
+ */
+ALvoid DecodeIMA4Block(ALfloat *dst, const ALubyte *src, ALint chans, ALuint first, ALuint count)
+{
+    const ALubyte *IMAData = src;
+    ALint Sample[2],Index[2];
+    ALuint IMACode[2];
+    ALuint end = first+count;
+    ALuint j,k;
+    ALint c;
+
+    for(c = 0;c < chans;c++)
+    {
+        Sample[c]  = *(IMAData++);
+        Sample[c] |= *(IMAData++) << 8;
+        Sample[c]  = (Sample[c]^0x8000) - 32768;
+        Index[c]  = *(IMAData++);
+        Index[c] |= *(IMAData++) << 8;
+        Index[c]  = (Index[c]^0x8000) - 32768;
+
+        Index[c] = ((Index[c]<0) ? 0 : Index[c]);
+        Index[c] = ((Index[c]>88) ? 88 : Index[c]);
+
+        if(first == 0 && end > 0)
+            dst[c] = ((Sample[c] < 0) ? (Sample[c]/32768.0f) : (Sample[c]/32767.0f));
+    }
 
-            dst[i*1017*chans + c] = ((Sample[c] < 0) ? (Sample[c]/32768.0f) : (Sample[c]/32767.0f));
+    for(j = 1;j < IMA4_BLOCK_FRAMES && j < end;j += 8)
+    {
+        for(c = 0;c < chans;c++)
+        {
+            IMACode[c]  = *(IMAData++);
+            IMACode[c] |= *(IMAData++) << 8;
+            IMACode[c] |= *(IMAData++) << 16;
+            IMACode[c] |= *(IMAData++) << 24;
         }
 
-        for(j = 1;j < 1017;j += 8)
+        for(k = 0;k < 8;k++)
         {
             for(c = 0;c < chans;c++)
             {
-                IMACode[c]  = *(IMAData++);
-                IMACode[c] |= *(IMAData++) << 8;
-                IMACode[c] |= *(IMAData++) << 16;
-                IMACode[c] |= *(IMAData++) << 24;
-            }
+                Sample[c] += ((g_IMAStep_size[Index[c]]*g_IMACodeword_4[IMACode[c]&15])/8);
+                Index[c] += g_IMAIndex_adjust_4[IMACode[c]&15];
 
-            for(k = 0;k < 8;k++)
-            {
-                for(c = 0;c < chans;c++)
-                {
-                    Sample[c] += ((g_IMAStep_size[Index[c]]*g_IMACodeword_4[IMACode[c]&15])/8);
-                    Index[c] += g_IMAIndex_adjust_4[IMACode[c]&15];
-
-                    if(Sample[c] < -32768) Sample[c] = -32768;
-                    else if(Sample[c] > 32767) Sample[c] = 32767;
+                if(Sample[c] < -32768) Sample[c] = -32768;
+                else if(Sample[c] > 32767) Sample[c] = 32767;
 
-                    if(Index[c]<0) Index[c] = 0;
-                    else if(Index[c]>88) Index[c] = 88;
+                if(Index[c]<0) Index[c] = 0;
+                else if(Index[c]>88) Index[c] = 88;
 
-                    dst[(i*1017+j+k)*chans + c] = ((Sample[c] < 0) ? (Sample[c]/32768.0f) : (Sample[c]/32767.0f));
-                    IMACode[c] >>= 4;
-                }
+                if(j+k >= first && j+k < end)
+                    dst[(j+k-first)*chans + c] = ((Sample[c] < 0) ? (Sample[c]/32768.0f) : (Sample[c]/32767.0f));
+                IMACode[c] >>= 4;
             }
         }
     }
 }
 
+/*
+ * ReadBufferFrames
+ *
+ * Copies count sample frames starting at frame from buf into dst, decoding
+ * them if the buffer is kept compressed. Frames past the end of the buffer
+ * are left untouched in dst.
+ */
+ALvoid ReadBufferFrames(const ALbuffer *buf, ALuint frame, ALuint count, ALfloat *dst)
+{
+    ALuint chans = aluChannelsFromFormat(buf->format);
+    ALuint frames;
+
+    if(chans == 0)
+        return;
+    frames = buf->size / (chans*aluBytesFromFormat(buf->format));
+    if(frame >= frames)
+        return;
+    count = min(count, frames-frame);
+
+    if(!buf->compressed)
+    {
+        memcpy(dst, &buf->data[frame*chans], count*chans*sizeof(ALfloat));
+        return;
+    }
+
+    while(count > 0)
+    {
+        ALuint block = frame / IMA4_BLOCK_FRAMES;
+        ALuint first = frame % IMA4_BLOCK_FRAMES;
+        ALuint todo = min(count, IMA4_BLOCK_FRAMES-first);
+
+        DecodeIMA4Block(dst, &buf->compressed[block*buf->OriginalAlign], chans, first, todo);
+        dst += todo*chans;
+        frame += todo;
+        count -= todo;
+    }
+}
+
 static void ConvertDataMULaw(ALfloat *dst, const ALvoid *src, ALsizei len)
 {
     ALsizei i;
@@ -1274,6 +1387,12 @@ static void ConvertDataMULawRear(ALfloat *dst, const ALvoid *src, ALsizei len)
     }
 }
 
+static void DropCompressed(ALbuffer *ALBuf)
+{
+    free(ALBuf->compressed);
+    ALBuf->compressed = NULL;
+}
+
 /*
 *    ReleaseALBuffers()
 *
@@ -1289,6 +1408,7 @@ ALvoid ReleaseALBuffers(ALCdevice *device)
 
         // Release sample data
         free(temp->data);
+        free(temp->compressed);
 
         // Release Buffer structure
         ALTHUNK_REMOVEENTRY(temp->buffer);
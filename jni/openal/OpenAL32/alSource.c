@@ -179,6 +179,7 @@ AL_API ALvoid AL_APIENTRY alDeleteSources(ALsizei n, const ALuint *sources)
                     RemoveUIntMapKey(&Context->SourceMap, Source->source);
                     ALTHUNK_REMOVEENTRY(Source->source);
 
+                    free(Source->DecodeScratch);
                     memset(Source,0,sizeof(ALsource));
                     free(Source);
                 }
@@ -2126,6 +2127,7 @@ ALvoid ReleaseALSources(ALCcontext *Context)
 
         // Release source structure
         ALTHUNK_REMOVEENTRY(temp->source);
+        free(temp->DecodeScratch);
         memset(temp, 0, sizeof(ALsource));
         free(temp);
     }
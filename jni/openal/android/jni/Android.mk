@@ -31,9 +31,21 @@ LOCAL_SRC_FILES  := ../../OpenAL32/alAuxEffectSlot.c \
                     ../../Alc/ALu.c                  \
                     ../../Alc/android.c              \
                     ../../Alc/bs2b.c                 \
+                    ../../Alc/loopback.c             \
+                    ../../Alc/mixer.c                \
+                    ../../Alc/mixer_sse.c            \
                     ../../Alc/null.c                 \
 
 LOCAL_CFLAGS     := -DAL_BUILD_LIBRARY -DAL_ALEXT_PROTOTYPES
+
+# NEON isn't guaranteed on armeabi-v7a, so its kernels get built with NEON
+# enabled and are only picked after checking the CPU at run time
+ifeq ($(TARGET_ARCH_ABI),armeabi-v7a)
+LOCAL_SRC_FILES  += ../../Alc/mixer_neon.c.neon
+LOCAL_CFLAGS     += -DHAVE_NEON
+LOCAL_STATIC_LIBRARIES := cpufeatures
+endif
+
 LOCAL_LDLIBS     := -llog -Wl,-s
 
 include $(BUILD_SHARED_LIBRARY)
@@ -89,3 +101,4 @@ include $(BUILD_SHARED_LIBRARY)
 
 ########################################################################################################
 
+$(call import-module,android/cpufeatures)
@@ -138,6 +138,18 @@ ALC_API ALCcontext* ALC_APIENTRY alcGetThreadContext(void);
 #endif
 #endif
 
+#ifndef ALC_SOFT_loopback
+#define ALC_SOFT_loopback 1
+/* Only the device functions. The render format is the one the config gives
+ * any other device, ALC_FORMAT_CHANNELS_SOFT and friends aren't supported. */
+typedef ALCdevice* (ALC_APIENTRY*LPALCLOOPBACKOPENDEVICESOFT)(const ALCchar *deviceName);
+typedef void (ALC_APIENTRY*LPALCRENDERSAMPLESSOFT)(ALCdevice *device, ALCvoid *buffer, ALCsizei samples);
+#ifdef AL_ALEXT_PROTOTYPES
+ALC_API ALCdevice* ALC_APIENTRY alcLoopbackOpenDeviceSOFT(const ALCchar *deviceName);
+ALC_API void ALC_APIENTRY alcRenderSamplesSOFT(ALCdevice *device, ALCvoid *buffer, ALCsizei samples);
+#endif
+#endif
+
 #ifndef AL_EXT_source_distance_model
 #define AL_EXT_source_distance_model 1
 #define AL_SOURCE_DISTANCE_MODEL                 0x200
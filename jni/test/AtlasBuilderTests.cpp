@@ -0,0 +1,152 @@
+/*
+ * AtlasBuilderTests.cpp
+ */
+
+#define PROVIDE_AUTO_TEST_MAIN
+#include "AutoTest.hpp"
+
+#include "atlas/AtlasBuilder.hpp"
+#include "atlas/AtlasImage.hpp"
+#include "atlas/AtlasPlanner.hpp"
+#include "atlas/MaxRects.hpp"
+#include "engine/JobSystem.hpp"
+#include <sstream>
+#include <vector>
+
+using namespace atlas;
+using blocxx::String;
+
+namespace
+{
+	bool overlap(const Rect& a, const Rect& b)
+	{
+		return a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height && b.y < a.y + a.height;
+	}
+}
+
+AUTO_UNIT_TEST(MaxRectsFillsTheAtlas)
+{
+	MaxRects rects(128, 128, false);
+	Rect placed;
+	bool rotated;
+	std::vector<Rect> all;
+	for (int i = 0; i < 4; ++i)
+	{
+		unitAssert(rects.insert(64, 64, MaxRects::BestShortSideFit, placed, rotated));
+		unitAssert(!rotated);
+		for (size_t j = 0; j < all.size(); ++j)
+		{
+			unitAssert(!overlap(placed, all[j]));
+		}
+		all.push_back(placed);
+	}
+	unitAssert(rects.occupancy() == 1.0);
+	unitAssert(rects.freeRects().empty());
+	unitAssert(!rects.insert(1, 1, MaxRects::BestShortSideFit, placed, rotated));
+}
+
+AUTO_UNIT_TEST(MaxRectsTurnsWhatOnlyFitsTurned)
+{
+	Rect placed;
+	bool rotated;
+	MaxRects fixed(100, 50, false);
+	unitAssert(!fixed.insert(50, 100, MaxRects::BestAreaFit, placed, rotated));
+
+	MaxRects turning(100, 50, true);
+	unitAssert(turning.insert(50, 100, MaxRects::BestAreaFit, placed, rotated));
+	unitAssert(rotated);
+	unitAssert(placed.width == 100 && placed.height == 50);
+}
+
+AUTO_UNIT_TEST(PackStartsAnotherAtlasWhenFull)
+{
+	// Five quarters of an atlas is two atlases, the second a quarter full.
+	std::vector<Rect> sizes(5, Rect(0, 0, 64, 64));
+	Packing packing = pack(sizes, 128, false, MaxRects::BestShortSideFit, LargestAreaFirst);
+	unitAssert(packing.atlasCount == 2);
+	unitAssert(packing.lastOccupancy == 0.25);
+	for (size_t i = 0; i < sizes.size(); ++i)
+	{
+		for (size_t j = i + 1; j < sizes.size(); ++j)
+		{
+			unitAssert(packing.atlas[i] != packing.atlas[j] || !overlap(packing.placed[i], packing.placed[j]));
+		}
+	}
+
+	engine::JobSystem jobs(2);
+	Packing best = packBest(sizes, 128, false, jobs);
+	unitAssert(best.atlasCount == 2);
+}
+
+AUTO_UNIT_TEST(ParseListLineScalesAndNames)
+{
+	ListEntry entry;
+	unitAssert(!parseListLine("// a comment", entry));
+	unitAssert(!parseListLine("  ", entry));
+
+	unitAssert(parseListLine("interface/Housebar.png,+2,+1.5,-0.5,*housebar", entry));
+	unitAssert(entry.filename == "interface/Housebar.png");
+	unitAssert(entry.name() == "Housebar");
+	unitAssert(entry.scaleWidthUp == 2 && entry.scaleHeightUp == 1.5);
+	unitAssert(entry.scaleWidthDown == 0.5f && entry.scaleHeightDown == 1);
+
+	unitAssert(parseListLine("Truck.png", entry));
+	unitAssert(entry.scaleWidthUp == 1 && entry.scaleWidthDown == 1);
+}
+
+AUTO_UNIT_TEST(AtlasImageTrimsAndTurns)
+{
+	AtlasImage image(4, 3);
+	image.pixel(2, 1)[3] = 0xFF;
+	Rect bounds = image.opaqueBounds();
+	unitAssert(bounds.x == 2 && bounds.y == 1 && bounds.width == 1 && bounds.height == 1);
+	unitAssert(!image.opaque());
+
+	// Clockwise, the left column becomes the top row.
+	AtlasImage turned = image.rotated();
+	unitAssert(turned.width() == 3 && turned.height() == 4);
+	unitAssert(turned.pixel(1, 2)[3] == 0xFF);
+
+	// The edges repeat into the margin.
+	AtlasImage atlas(8, 8);
+	atlas.blit(image.cropped(bounds), 3, 3, 2);
+	unitAssert(atlas.pixel(1, 1)[3] == 0xFF && atlas.pixel(5, 5)[3] == 0xFF);
+	unitAssert(atlas.pixel(0, 0)[3] == 0 && atlas.pixel(6, 6)[3] == 0);
+}
+
+AUTO_UNIT_TEST(PlanSectionsKeepsWhatIsDrawnTogether)
+{
+	// a and c are always drawn together, and b and d, but the four don't fit in one atlas.
+	CoUsage usage;
+	std::istringstream capture("a c b d\na c\n\nb d a\n");
+	usage.read(capture);
+	unitAssert(usage.frames() == 4);
+	unitAssert(usage.pairs().find(std::make_pair(String("a"), String("c")))->second == 2);
+
+	std::vector<String> names;
+	names.push_back("a");
+	names.push_back("b");
+	names.push_back("c");
+	names.push_back("d");
+	std::vector<Rect> sizes(4, Rect(0, 0, 64, 64));
+	std::vector<size_t> sections = planSections(names, sizes, usage, 128 * 128 / 2);
+	unitAssert(sections[0] == sections[2] && sections[1] == sections[3] && sections[0] != sections[1]);
+	// Only c b and d a switch between them.
+	unitAssert(switchesPerFrame(names, sections, usage) == 0.5);
+
+	// Never drawn together, they still share as few atlases as fit them.
+	sections = planSections(names, sizes, CoUsage(), 128 * 128);
+	for (size_t i = 0; i < sections.size(); ++i)
+	{
+		unitAssert(sections[i] == 0);
+	}
+}
+
+AUTO_UNIT_TEST(SectionLinesAreNotImages)
+{
+	ListEntry entry;
+	unitAssert(isSectionLine(SECTION_LINE));
+	unitAssert(isSectionLine(String(" ") + SECTION_LINE + "\r"));
+	unitAssert(!parseListLine(SECTION_LINE, entry));
+	unitAssert(!isSectionLine("// atlases of the trees"));
+}
@@ -110,3 +110,80 @@ AUTO_UNIT_TEST(DrawableClearActions)
 	drawn->update(DateTime(), delta);
 	unitAssert(drawn->getPositionRelativeToOrigin(screen) == Point(0,0));
 }
+
+AUTO_UNIT_TEST(DrawableAttachChildFollowsParent)
+{
+	// Arrange
+	DrawablePtr parent = new DrawableRectangle(positive, positive);
+	DrawablePtr child = new DrawableRectangle(positive, positive);
+	parent->setPosition(Point(10,10));
+	child->setPosition(Point(1,2));
+	
+	// Act
+	parent->attachChild(child);
+	
+	// Assert
+	unitAssert(child->parent() == parent.get());
+	unitAssert(child->position() == Point(1,2));
+	unitAssert(child->worldPosition() == Point(11,12));
+	unitAssert(child->getPositionRelativeToOrigin(screen) == Point(11,12));
+	
+	// Act
+	parent->setPosition(Point(20,20));
+	
+	// Assert
+	unitAssert(child->worldPosition() == Point(21,22));
+}
+
+AUTO_UNIT_TEST(DrawableAttachGrandchild)
+{
+	// Arrange
+	DrawablePtr parent = new DrawableRectangle(positive, positive);
+	DrawablePtr child = new DrawableRectangle(positive, positive);
+	DrawablePtr grandchild = new DrawableRectangle(positive, positive);
+	child->setPosition(Point(1,1));
+	grandchild->setPosition(Point(1,1));
+	parent->attachChild(child);
+	child->attachChild(grandchild);
+	unitAssert(grandchild->worldPosition() == Point(2,2));
+	
+	// Act
+	parent->setPosition(Point(5,5));
+	
+	// Assert
+	unitAssert(grandchild->worldPosition() == Point(7,7));
+}
+
+AUTO_UNIT_TEST(DrawableDetachChild)
+{
+	// Arrange
+	DrawablePtr parent = new DrawableRectangle(positive, positive);
+	DrawablePtr child = new DrawableRectangle(positive, positive);
+	parent->setPosition(Point(10,10));
+	child->setPosition(Point(1,2));
+	parent->attachChild(child);
+	
+	// Act
+	parent->detachChild(child);
+	
+	// Assert
+	unitAssert(child->parent() == 0);
+	unitAssert(parent->attachedChildren().size() == 0);
+	unitAssert(child->worldPosition() == Point(1,2));
+}
+
+AUTO_UNIT_TEST(DrawableUpdateUpdatesAttachedChildren)
+{
+	// Arrange
+	DrawablePtr parent = new DrawableRectangle(positive, positive);
+	DrawablePtr child = new DrawableRectangle(positive, positive);
+	parent->attachChild(child);
+	child->addAction(new MoveAction(0, positive));
+	
+	// Act
+	parent->update(DateTime(), delta);
+	
+	// Assert
+	unitAssert(child->position() == Point(0,25));
+	unitAssert(child->worldPosition() == Point(0,25));
+}
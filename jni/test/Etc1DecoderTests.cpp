@@ -0,0 +1,169 @@
+/*
+ * Etc1DecoderTests.cpp
+ */
+
+#define PROVIDE_AUTO_TEST_MAIN
+#include "AutoTest.hpp"
+
+#include "engine/Etc1Decoder.hpp"
+#include "engine/Resource.hpp"
+#include "engine/TextureLoader.hpp"
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "MockGLMock.h"
+#include <vector>
+
+using namespace engine;
+using ::testing::_;
+using ::testing::Mock;
+
+namespace
+{
+	GLushort rgb565(int r, int g, int b)
+	{
+		return GLushort(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+	}
+
+	// Individual colors, red 136 green 68 blue 34 on the left and 255 0 17 on the right,
+	// tables 0 and 7. Every pixel adds the small modifier, except the lower right one
+	// which subtracts the large one.
+	const unsigned char individual[8] = { 0x8F, 0x40, 0x21, 0x1C, 0x80, 0x00, 0x80, 0x00 };
+
+	// Differential colors 10 20 0 (5 bit) on top, +1 -1 +3 below, tables 1 and 2, flipped.
+	const unsigned char differential[8] = { 0x51, 0xA7, 0x03, 0x2B, 0x00, 0x00, 0x00, 0x00 };
+
+	// A 2 x 2 image is one block.
+	ResourcePtr pkm(const unsigned char* block)
+	{
+		const unsigned char header[16] = { 'P', 'K', 'M', ' ', '1', '0', 0, 0, 0, 4, 0, 4, 0, 2, 0, 2 };
+		Array<UInt8> data(header, header + 16);
+		data.insert(data.end(), block, block + 8);
+		return new Resource(data, "test.pkm");
+	}
+
+	// Gray 0x88 everywhere.
+	const unsigned char gray[8] = { 0x88, 0x88, 0x88, 0x00, 0x00, 0x00, 0x00, 0x00 };
+
+	GLushort mergedPixel;
+	void saveFirstPixel(GLenum format, GLenum type, GLsizei width, GLsizei height, const GLvoid* imageData)
+	{
+		mergedPixel = *static_cast<const GLushort*>(imageData);
+	}
+
+	std::vector<GLushort> decodeBlock(const unsigned char* block)
+	{
+		std::vector<GLushort> pixels(16);
+		Etc1Decoder::decodeImage(block, 4, 4, &pixels[0], 4);
+		return pixels;
+	}
+}
+
+AUTO_UNIT_TEST(Etc1DecoderIndividualMode)
+{
+	std::vector<GLushort> pixels = decodeBlock(individual);
+	unitAssert(pixels[0] == rgb565(138, 70, 36));
+	unitAssert(pixels[1 * 4 + 1] == rgb565(138, 70, 36));
+	// Clamped to 255 on the right.
+	unitAssert(pixels[3] == rgb565(255, 47, 64));
+	// And to 0 where the large modifier comes off.
+	unitAssert(pixels[3 * 4 + 3] == rgb565(72, 0, 0));
+}
+
+AUTO_UNIT_TEST(Etc1DecoderDifferentialFlippedMode)
+{
+	std::vector<GLushort> pixels = decodeBlock(differential);
+	unitAssert(pixels[0] == rgb565(87, 170, 5));
+	unitAssert(pixels[1 * 4 + 3] == rgb565(87, 170, 5));
+	unitAssert(pixels[2 * 4 + 0] == rgb565(99, 165, 33));
+	unitAssert(pixels[3 * 4 + 3] == rgb565(99, 165, 33));
+}
+
+AUTO_UNIT_TEST(Etc1DecoderImageEdges)
+{
+	// 10 x 6 is 3 x 2 blocks, each a flat red of its own. More blocks than lanes
+	// leaves some unused in the last pass, when there are lanes.
+	std::vector<unsigned char> blocks(6 * 8, 0);
+	for (int i = 0; i < 6; ++i)
+		blocks[i * 8] = (i << 4) | i;
+	const unsigned stride = 12;
+	const GLushort untouched = 0xBEEF;
+	std::vector<GLushort> pixels(stride * 6, untouched);
+	Etc1Decoder::decodeImage(&blocks[0], 10, 6, &pixels[0], stride);
+
+	for (int i = 0; i < 6; ++i)
+	{
+		int x = (i % 3) * 4;
+		int y = (i / 3) * 4;
+		unitAssert(pixels[y * stride + x] == rgb565(i * 17 + 2, 2, 2));
+	}
+	unitAssert(pixels[5 * stride + 9] == rgb565(5 * 17 + 2, 2, 2));
+	// The block's columns past the width, and what is past the width in each row, are left.
+	unitAssert(pixels[5 * stride + 10] == untouched);
+	unitAssert(pixels[0 * stride + 11] == untouched);
+	unitAssert(Etc1Decoder::lanes() >= 1);
+}
+
+AUTO_UNIT_TEST(TextureLoaderDecodesPKMWithoutETC1)
+{
+	ResourcePtr image = pkm(individual);
+
+	gl::MockGLMock mock;
+	gl::glMock = &mock;
+	gl::state.etc1 = false;
+	EXPECT_CALL(mock, compressedTexImage2D(_, _, _, _, _)).Times(0);
+	EXPECT_CALL(mock, texImage2D(GL_RGB, GL_UNSIGNED_SHORT_5_6_5, 2, 2, _));
+	int width = 0;
+	int height = 0;
+	TextureLoader::loadTextureFromPKM(image, width, height);
+	unitAssert(width == 2 && height == 2);
+	unitAssert(Mock::VerifyAndClearExpectations(&mock));
+	gl::glMock = NULL;
+}
+
+AUTO_UNIT_TEST(Etc1DecoderGreen)
+{
+	std::vector<GLubyte> pixels(16);
+	Etc1Decoder::decodeGreen(individual, 4, 4, &pixels[0], 4);
+	unitAssert(pixels[0] == 70);
+	unitAssert(pixels[3] == 47);
+	unitAssert(pixels[3 * 4 + 3] == 0);
+}
+
+AUTO_UNIT_TEST(TextureLoaderAlphaPlaneWithCombiners)
+{
+	gl::MockGLMock mock;
+	gl::glMock = &mock;
+	gl::state.etc1 = false;
+	gl::state.combiners = true;
+	EXPECT_CALL(mock, genTexture()).WillOnce(::testing::Return(1)).WillOnce(::testing::Return(2));
+	EXPECT_CALL(mock, texImage2D(GL_RGB, GL_UNSIGNED_SHORT_5_6_5, 2, 2, _));
+	EXPECT_CALL(mock, texImage2D(GL_ALPHA, GL_UNSIGNED_BYTE, 2, 2, _));
+	int width = 0;
+	int height = 0;
+	GLuint alphaTexture = gl::INVALID_TEXTURE;
+	GLuint texture = TextureLoader::loadTextureFromPKM(pkm(individual), pkm(gray), width, height, alphaTexture);
+	unitAssert(texture == 1);
+	unitAssert(alphaTexture == 2);
+	unitAssert(Mock::VerifyAndClearExpectations(&mock));
+	gl::state.combiners = false;
+	gl::glMock = NULL;
+}
+
+AUTO_UNIT_TEST(TextureLoaderAlphaPlaneMergedWithoutCombiners)
+{
+	gl::MockGLMock mock;
+	gl::glMock = &mock;
+	gl::state.etc1 = false;
+	gl::state.combiners = false;
+	EXPECT_CALL(mock, genTexture()).WillOnce(::testing::Return(1));
+	EXPECT_CALL(mock, texImage2D(GL_RGBA, GL_UNSIGNED_SHORT_4_4_4_4, 2, 2, _)).WillOnce(::testing::Invoke(saveFirstPixel));
+	int width = 0;
+	int height = 0;
+	GLuint alphaTexture = gl::INVALID_TEXTURE;
+	TextureLoader::loadTextureFromPKM(pkm(individual), pkm(gray), width, height, alphaTexture);
+	unitAssert(alphaTexture == gl::INVALID_TEXTURE);
+	// 138 70 36 with 0x88 + 2 alpha, 4 bits each.
+	unitAssert(mergedPixel == ((138 >> 4) << 12 | (70 >> 4) << 8 | (36 >> 4) << 4 | (0x8A >> 4)));
+	unitAssert(Mock::VerifyAndClearExpectations(&mock));
+	gl::glMock = NULL;
+}
@@ -0,0 +1,81 @@
+/*
+ * GLStateTests.cpp
+ */
+
+#define PROVIDE_AUTO_TEST_MAIN
+#include "AutoTest.hpp"
+
+#include "engine/GL.hpp"
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "MockGLMock.h"
+
+using namespace engine;
+
+AUTO_UNIT_TEST(GLCachedOnlyReportsChanges)
+{
+	gl::Cached<GLuint> texture;
+	unitAssert(texture.change(0));
+	unitAssert(!texture.change(0));
+	unitAssert(texture.change(7));
+	unitAssert(!texture.change(7));
+	texture.forget();
+	unitAssert(texture.change(7));
+}
+
+AUTO_UNIT_TEST(GLArrayPointersCompareEveryArgument)
+{
+	GLfloat vertexes[4];
+	gl::ArrayPointer pointer(2, GL_FLOAT, 0, vertexes);
+	unitAssert(pointer == gl::ArrayPointer(2, GL_FLOAT, 0, vertexes));
+	unitAssert(!(pointer == gl::ArrayPointer(2, GL_FLOAT, 0, vertexes + 2)));
+	unitAssert(!(pointer == gl::ArrayPointer(3, GL_FLOAT, 0, vertexes)));
+	unitAssert(!(pointer == gl::ArrayPointer(2, GL_SHORT, 0, vertexes)));
+	unitAssert(!(pointer == gl::ArrayPointer(2, GL_FLOAT, 8, vertexes)));
+	unitAssert(!(pointer == gl::ArrayPointer(2, GL_FLOAT, 0, vertexes, 1)));
+}
+
+AUTO_UNIT_TEST(GLInvalidateStateForgetsEverything)
+{
+	gl::invalidateState();
+	unitAssert(gl::state.texture.change(3));
+	unitAssert(gl::state.blendFunc.change(std::make_pair(GLenum(GL_SRC_ALPHA), GLenum(GL_ONE_MINUS_SRC_ALPHA))));
+	unitAssert(gl::state.lineWidth.change(2.0f));
+	unitAssert(!gl::state.texture.change(3));
+
+	gl::invalidateState();
+	unitAssert(gl::state.texture.change(3));
+	unitAssert(gl::state.blendFunc.change(std::make_pair(GLenum(GL_SRC_ALPHA), GLenum(GL_ONE_MINUS_SRC_ALPHA))));
+	unitAssert(gl::state.lineWidth.change(2.0f));
+	gl::invalidateState();
+}
+
+AUTO_UNIT_TEST(GLMockSeesRepeatedCalls)
+{
+	using namespace gl;
+	MockGLMock mock;
+	glMock = &mock;
+	using ::testing::Mock;
+
+	EXPECT_CALL(mock, enableTexture2D()).Times(2);
+	EXPECT_CALL(mock, bindTexture2D(4)).Times(2);
+
+	enableTexture2D();
+	bindTexture2D(4);
+	enableTexture2D();
+	bindTexture2D(4);
+
+	unitAssert(Mock::VerifyAndClearExpectations(&mock));
+	glMock = NULL;
+}
+
+AUTO_UNIT_TEST(GLAlphaTextureNeedsCombiners)
+{
+	// With one texture unit binding an alpha plane leaves GL, and what it caches, alone.
+	gl::invalidateState();
+	gl::state.combiners = false;
+	gl::bindAlphaTexture2D(5);
+	unitAssert(!gl::state.alphaTexture.is(5));
+	unitAssert(gl::state.alphaTexture.change(5));
+	gl::invalidateState();
+}
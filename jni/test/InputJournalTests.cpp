@@ -0,0 +1,155 @@
+/*
+ * InputJournalTests.cpp
+ */
+
+#define PROVIDE_AUTO_TEST_MAIN
+#include "AutoTest.hpp"
+
+#include "engine/InputJournal.hpp"
+#include "miniblocxx/IOException.hpp"
+#include <sstream>
+#include <string>
+
+using namespace engine;
+
+namespace
+{
+	Array<Int32> parameters()
+	{
+		Array<Int32> result;
+		result.push_back(2);
+		result.push_back(-1);
+		result.push_back(82);
+		return result;
+	}
+
+	std::string journalOf(void (*write)(InputJournalWriter&))
+	{
+		std::stringbuf out;
+		{
+			InputJournalWriter writer(out, 1234, parameters());
+			write(writer);
+		}
+		return out.str();
+	}
+
+	void writeEverything(InputJournalWriter& writer)
+	{
+		writer.frame(TimeDuration(Int64(16667)));
+		writer.touch(TouchEvent(100, 125, 1, 10.5f, -20.25f, 0.75f, 0.5f, 3, 1.0f, 2.0f, 4, 5));
+		writer.trackball(-0.125f);
+		writer.orientation(12.5f, -3.0f, 270.0f);
+		writer.keyDown(21, 1);
+		writer.keyUp(22, 0);
+		writer.frame(TimeDuration(Int64(0)));
+	}
+
+	void writeNothing(InputJournalWriter&)
+	{
+	}
+
+	void writeFrame(InputJournalWriter& writer)
+	{
+		writer.frame(TimeDuration(Int64(16667)));
+	}
+}
+
+AUTO_UNIT_TEST(InputJournalHeaderRoundTrips)
+{
+	std::stringbuf in(journalOf(writeNothing));
+	InputJournalReader reader(in);
+	unitAssert(reader.seed() == 1234);
+	unitAssert(reader.parameters().size() == 3);
+	unitAssert(reader.parameters()[0] == 2);
+	unitAssert(reader.parameters()[1] == -1);
+	unitAssert(reader.parameters()[2] == 82);
+	InputRecord record;
+	unitAssert(!reader.read(record));
+}
+
+AUTO_UNIT_TEST(InputJournalRecordsRoundTrip)
+{
+	std::stringbuf in(journalOf(writeEverything));
+	InputJournalReader reader(in);
+	InputRecord record;
+
+	unitAssert(reader.read(record));
+	unitAssert(record.type == InputRecord::E_FRAME);
+	unitAssert(record.frameTime.microseconds() == 16667);
+
+	unitAssert(reader.read(record));
+	unitAssert(record.type == InputRecord::E_TOUCH);
+	unitAssert(record.touch.downTime == 100);
+	unitAssert(record.touch.eventTime == 125);
+	unitAssert(record.touch.action == 1);
+	unitAssert(record.touch.x == 10.5f);
+	unitAssert(record.touch.y == -20.25f);
+	unitAssert(record.touch.pressure == 0.75f);
+	unitAssert(record.touch.size == 0.5f);
+	unitAssert(record.touch.metaState == 3);
+	unitAssert(record.touch.xPrecision == 1.0f);
+	unitAssert(record.touch.yPrecision == 2.0f);
+	unitAssert(record.touch.deviceId == 4);
+	unitAssert(record.touch.edgeFlags == 5);
+
+	unitAssert(reader.read(record));
+	unitAssert(record.type == InputRecord::E_TRACKBALL);
+	unitAssert(record.values[0] == -0.125f);
+
+	unitAssert(reader.read(record));
+	unitAssert(record.type == InputRecord::E_ORIENTATION);
+	unitAssert(record.values[0] == 12.5f);
+	unitAssert(record.values[1] == -3.0f);
+	unitAssert(record.values[2] == 270.0f);
+
+	unitAssert(reader.read(record));
+	unitAssert(record.type == InputRecord::E_KEY_DOWN);
+	unitAssert(record.key == 21);
+	unitAssert(record.metaState == 1);
+
+	unitAssert(reader.read(record));
+	unitAssert(record.type == InputRecord::E_KEY_UP);
+	unitAssert(record.key == 22);
+	unitAssert(record.metaState == 0);
+
+	unitAssert(reader.read(record));
+	unitAssert(record.type == InputRecord::E_FRAME);
+	unitAssert(record.frameTime.microseconds() == 0);
+
+	unitAssert(!reader.read(record));
+}
+
+AUTO_UNIT_TEST(InputJournalFramesAreSmall)
+{
+	unitAssert(journalOf(writeFrame).size() - journalOf(writeNothing).size() <= 4);
+}
+
+AUTO_UNIT_TEST(InputJournalEndsAtACutOffRecord)
+{
+	std::string journal = journalOf(writeEverything);
+	// Cut the last frame record in half.
+	std::stringbuf in(journal.substr(0, journal.size() - 1));
+	InputJournalReader reader(in);
+	InputRecord record;
+	size_t records = 0;
+	while (reader.read(record))
+	{
+		++records;
+	}
+	unitAssert(records == 6);
+}
+
+AUTO_UNIT_TEST(InputJournalRejectsOtherFiles)
+{
+	std::stringbuf in("Not a journal at all");
+	bool threw = false;
+	try
+	{
+		InputJournalReader reader(in);
+	}
+	catch (const IOException&)
+	{
+		threw = true;
+	}
+	unitAssert(threw);
+}
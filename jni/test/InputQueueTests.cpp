@@ -0,0 +1,109 @@
+/*
+ * InputQueueTests.cpp
+ */
+
+#define PROVIDE_AUTO_TEST_MAIN
+#include "AutoTest.hpp"
+
+#include "engine/InputQueue.hpp"
+#include <pthread.h>
+
+using namespace engine;
+
+namespace
+{
+	InputRecord keyDown(int key)
+	{
+		InputRecord record;
+		record.type = InputRecord::E_KEY_DOWN;
+		record.key = key;
+		return record;
+	}
+
+	const int streamed = 200000;
+
+	void* produce(void* queue)
+	{
+		for (int key = 0; key < streamed; )
+		{
+			if (static_cast<InputQueue*>(queue)->push(keyDown(key)))
+				++key;
+		}
+		return NULL;
+	}
+}
+
+AUTO_UNIT_TEST(InputQueuePopsInOrder)
+{
+	InputQueue queue;
+	InputRecord record;
+	unitAssert(queue.size() == 0);
+	unitAssert(!queue.pop(record));
+
+	unitAssert(queue.push(keyDown(1)));
+	unitAssert(queue.push(keyDown(2)));
+	unitAssert(queue.size() == 2);
+	unitAssert(queue.pop(record));
+	unitAssert(record.type == InputRecord::E_KEY_DOWN);
+	unitAssert(record.key == 1);
+	unitAssert(queue.pop(record));
+	unitAssert(record.key == 2);
+	unitAssert(!queue.pop(record));
+}
+
+AUTO_UNIT_TEST(InputQueueDropsWhenFull)
+{
+	InputQueue queue;
+	for (int i = 0; i < InputQueue::capacity; ++i)
+	{
+		unitAssert(queue.push(keyDown(i)));
+	}
+	unitAssert(!queue.push(keyDown(-1)));
+	unitAssert(queue.dropped() == 1);
+	unitAssert(queue.size() == InputQueue::capacity);
+
+	InputRecord record;
+	unitAssert(queue.pop(record));
+	unitAssert(record.key == 0);
+	unitAssert(queue.push(keyDown(InputQueue::capacity)));
+	for (int i = 1; i <= InputQueue::capacity; ++i)
+	{
+		unitAssert(queue.pop(record));
+		unitAssert(record.key == i);
+	}
+	unitAssert(!queue.pop(record));
+}
+
+AUTO_UNIT_TEST(InputQueueWrapsAround)
+{
+	InputQueue queue;
+	InputRecord record;
+	for (int i = 0; i < 3 * InputQueue::capacity + 1; ++i)
+	{
+		unitAssert(queue.push(keyDown(i)));
+		unitAssert(queue.pop(record));
+		unitAssert(record.key == i);
+	}
+	unitAssert(queue.size() == 0);
+}
+
+AUTO_UNIT_TEST(InputQueueHandsOverBetweenThreads)
+{
+	InputQueue queue;
+	pthread_t producer;
+	unitAssert(pthread_create(&producer, NULL, produce, &queue) == 0);
+	InputRecord record;
+	int expected = 0;
+	bool inOrder = true;
+	while (expected < streamed)
+	{
+		if (queue.pop(record))
+		{
+			inOrder = inOrder && record.type == InputRecord::E_KEY_DOWN && record.key == expected;
+			++expected;
+		}
+	}
+	pthread_join(producer, NULL);
+	unitAssert(inOrder);
+	unitAssert(!queue.pop(record));
+}
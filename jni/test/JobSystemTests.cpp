@@ -0,0 +1,87 @@
+/*
+ * JobSystemTests.cpp
+ */
+
+#define PROVIDE_AUTO_TEST_MAIN
+#include "AutoTest.hpp"
+
+#include "engine/JobSystem.hpp"
+#include <vector>
+
+using namespace engine;
+
+namespace
+{
+	// Counts how often every index was visited.
+	class CountVisits : public JobSystem::RangeBody
+	{
+	public:
+		CountVisits(size_t count)
+			: visits(count, 0)
+		{
+		}
+
+		virtual void run(size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; ++i)
+			{
+				++visits[i];
+			}
+		}
+
+		bool eachVisitedOnce() const
+		{
+			for (size_t i = 0; i < visits.size(); ++i)
+			{
+				if (visits[i] != 1)
+					return false;
+			}
+			return true;
+		}
+
+		std::vector<int> visits;
+	};
+}
+
+AUTO_UNIT_TEST(JobSystemWithoutWorkersRunsInline)
+{
+	JobSystem jobs(0);
+	unitAssert(jobs.workerCount() == 0);
+	CountVisits body(10);
+	jobs.parallelFor(10, 3, body);
+	unitAssert(body.eachVisitedOnce());
+}
+
+AUTO_UNIT_TEST(JobSystemParallelForVisitsEveryIndexOnce)
+{
+	JobSystem jobs(3);
+	unitAssert(jobs.workerCount() == 3);
+	for (size_t count = 0; count < 50; ++count)
+	{
+		CountVisits body(count);
+		jobs.parallelFor(count, 4, body);
+		unitAssert(body.eachVisitedOnce());
+	}
+}
+
+AUTO_UNIT_TEST(JobSystemIsReusable)
+{
+	JobSystem jobs(2);
+	CountVisits body(1000);
+	for (int i = 0; i < 100; ++i)
+	{
+		jobs.parallelFor(1000, 1, body);
+	}
+	for (size_t i = 0; i < body.visits.size(); ++i)
+	{
+		unitAssert(body.visits[i] == 100);
+	}
+}
+
+AUTO_UNIT_TEST(JobSystemZeroGrainMeansOne)
+{
+	JobSystem jobs(2);
+	CountVisits body(7);
+	jobs.parallelFor(7, 0, body);
+	unitAssert(body.eachVisitedOnce());
+}
@@ -0,0 +1,297 @@
+/*
+ * MixerTests.cpp
+ */
+
+#define PROVIDE_AUTO_TEST_MAIN
+#include "AutoTest.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// OpenAL's internal headers define min and max macros, so they go last.
+#include "config.h"
+#include "alMain.h"
+#include "AL/al.h"
+#include "AL/alc.h"
+#include "AL/alext.h"
+#include "mixer.h"
+
+#ifdef HAVE_ALSA
+// The ALSA backend is left out. It never opens, so the game's SoundDevice gets the null
+// one, and the tests mix through a loopback device.
+namespace
+{
+	ALCboolean noDevice(ALCdevice*, const ALCchar*)
+	{
+		return ALC_FALSE;
+	}
+}
+
+extern "C"
+{
+	void alc_alsa_init(BackendFuncs* funcs)
+	{
+		funcs->OpenPlayback = noDevice;
+		funcs->OpenCapture = noDevice;
+	}
+	void alc_alsa_deinit(void) {}
+	void alc_alsa_probe(int) {}
+}
+#endif
+
+namespace
+{
+	const ALuint fracOne = 1 << FRACTIONBITS;
+	const ALuint maxUlps = 2;
+
+	// The vector kernels may flush denormals or round a step differently, so
+	// allow a couple of units in the last place.
+	bool closeEnough(ALfloat a, ALfloat b)
+	{
+		if (std::fabs(a - b) < 1e-30f)
+			return true;
+		if ((a < 0) != (b < 0))
+			return false;
+		ALint ia, ib;
+		std::memcpy(&ia, &a, sizeof(ia));
+		std::memcpy(&ib, &b, sizeof(ib));
+		return static_cast<ALuint>(std::abs(ia - ib)) <= maxUlps;
+	}
+
+	bool allClose(const std::vector<ALfloat>& a, const std::vector<ALfloat>& b)
+	{
+		if (a.size() != b.size())
+			return false;
+		for (size_t i = 0; i < a.size(); ++i)
+		{
+			if (!closeEnough(a[i], b[i]))
+				return false;
+		}
+		return true;
+	}
+
+	ALfloat randomSample()
+	{
+		return std::rand() / (RAND_MAX / 2.0f) - 1.0f;
+	}
+
+	std::vector<ALfloat> randomSamples(size_t count)
+	{
+		std::vector<ALfloat> samples(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			samples[i] = randomSample();
+		}
+		return samples;
+	}
+
+	// Runs resampler over every channel of data and returns the output of them all.
+	std::vector<ALfloat> resample(ResamplerFunc resampler, const std::vector<ALfloat>& data,
+		ALuint chans, ALuint frac, ALuint increment, ALuint count)
+	{
+		std::vector<ALfloat> out(count * chans + 1, 0.0f);
+		for (ALuint c = 0; c < chans; ++c)
+		{
+			resampler(&data[c], chans, frac, increment, &out[c * count], count);
+		}
+		return out;
+	}
+
+	bool resamplerMatchesC(resampler_t type, ResamplerFunc reference)
+	{
+		const ALfloat pitches[] = { 1.0f, 0.5f, 0.73f, 1.9f, 3.7f };
+		const ALuint chanCounts[] = { 1, 2, 6 };
+		const ALuint counts[] = { 0, 1, 3, 4, 5, 255, 256 };
+
+		ResamplerFunc resampler = SelectResampler(type);
+		if (resampler == NULL)
+			return false;
+		for (size_t p = 0; p < sizeof(pitches) / sizeof(pitches[0]); ++p)
+		{
+			ALuint increment = static_cast<ALuint>(pitches[p] * fracOne);
+			for (size_t c = 0; c < sizeof(chanCounts) / sizeof(chanCounts[0]); ++c)
+			{
+				ALuint chans = chanCounts[c];
+				for (size_t n = 0; n < sizeof(counts) / sizeof(counts[0]); ++n)
+				{
+					ALuint count = counts[n];
+					ALuint frames = static_cast<ALuint>(count * pitches[p]) + 3;
+					std::vector<ALfloat> data = randomSamples(frames * chans);
+					ALuint frac = std::rand() % fracOne;
+
+					if (!allClose(resample(resampler, data, chans, frac, increment, count),
+						resample(reference, data, chans, frac, increment, count)))
+						return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	struct MonoMix
+	{
+		MonoMix(ALuint count)
+			: src(randomSamples(count))
+			, dst(randomSamples(count * OUTPUTCHANNELS))
+			, gains(randomSamples(OUTPUTCHANNELS))
+			, steps(OUTPUTCHANNELS)
+		{
+			for (size_t c = 0; c < steps.size(); ++c)
+			{
+				steps[c] = randomSample() / 1024;
+			}
+		}
+
+		void run(MonoMixerFunc mixer)
+		{
+			if (!src.empty())
+			{
+				mixer(&src[0], reinterpret_cast<ALfloat (*)[OUTPUTCHANNELS]>(&dst[0]),
+					&gains[0], &steps[0], src.size());
+			}
+		}
+
+		std::vector<ALfloat> src;
+		std::vector<ALfloat> dst;
+		std::vector<ALfloat> gains;
+		std::vector<ALfloat> steps;
+	};
+
+	const ALsizei ima4Blocks = 7;
+
+	// Mixes mono and stereo IMA4 sources at several pitches, some looping, to float
+	// stereo, with the buffers kept compressed or decoded when they are loaded.
+	std::vector<ALfloat> mixIma4(bool decompress)
+	{
+		const char* configPath = "MixerTests.conf";
+		FILE* config = std::fopen(configPath, "w");
+		std::fprintf(config, "format = AL_FORMAT_STEREO32\nfrequency = 44100\nima4-decompress = %s\n",
+			decompress ? "true" : "false");
+		std::fclose(config);
+		setenv("ALSOFT_CONF", configPath, 1);
+		FreeALConfig();
+		ReadALConfig();
+
+		ALCdevice* device = alcLoopbackOpenDeviceSOFT(NULL);
+		ALCcontext* context = alcCreateContext(device, NULL);
+		alcMakeContextCurrent(context);
+
+		std::srand(42);
+		std::vector<ALubyte> mono(ima4Blocks * 512);
+		std::vector<ALubyte> stereo(ima4Blocks * 1024);
+		for (size_t i = 0; i < mono.size(); ++i)
+		{
+			mono[i] = std::rand();
+		}
+		for (size_t i = 0; i < stereo.size(); ++i)
+		{
+			stereo[i] = std::rand();
+		}
+		ALuint buffers[2];
+		alGenBuffers(2, buffers);
+		alBufferData(buffers[0], AL_FORMAT_MONO_IMA4, &mono[0], mono.size(), 22050);
+		alBufferData(buffers[1], AL_FORMAT_STEREO_IMA4, &stereo[0], stereo.size(), 32000);
+
+		const ALfloat pitches[] = { 1.0f, 0.73f, 1.9f, 3.7f, 1.0f, 0.5f };
+		const ALsizei sourceCount = sizeof(pitches) / sizeof(pitches[0]);
+		ALuint sources[sourceCount];
+		alGenSources(sourceCount, sources);
+		for (ALsizei i = 0; i < sourceCount; ++i)
+		{
+			alSourcei(sources[i], AL_BUFFER, buffers[i & 1]);
+			alSourcef(sources[i], AL_PITCH, pitches[i]);
+			alSourcei(sources[i], AL_LOOPING, i >= 4);
+			alSourcei(sources[i], AL_SOURCE_RELATIVE, AL_TRUE);
+			alSource3f(sources[i], AL_POSITION, i * 0.3f - 1.0f, 0, 0);
+		}
+		alSourcePlayv(sourceCount, sources);
+
+		// Uneven updates, so the block windows are entered and left at every point.
+		std::vector<ALfloat> out;
+		std::vector<ALfloat> update(2 * 4096);
+		for (ALsizei n = 0; n < 40; ++n)
+		{
+			ALsizei frames = 1000 + n * 37 % 3000;
+			alcRenderSamplesSOFT(device, &update[0], frames);
+			out.insert(out.end(), update.begin(), update.begin() + 2 * frames);
+		}
+
+		alDeleteSources(sourceCount, sources);
+		alDeleteBuffers(2, buffers);
+		alcMakeContextCurrent(NULL);
+		alcDestroyContext(context);
+		alcCloseDevice(device);
+		unsetenv("ALSOFT_CONF");
+		std::remove(configPath);
+		return out;
+	}
+}
+
+AUTO_UNIT_TEST(MixerDisabledCPUExtensionsSelectCKernels)
+{
+	FillCPUCaps(AL_TRUE);
+	unitAssert(CPUCapFlags == 0);
+	unitAssert(SelectResampler(POINT_RESAMPLER) == Resample_point_C);
+	unitAssert(SelectResampler(LINEAR_RESAMPLER) == Resample_lerp_C);
+	unitAssert(SelectResampler(COSINE_RESAMPLER) == Resample_cos_lerp_C);
+	unitAssert(SelectMonoMixer() == MixMono_C);
+	FillCPUCaps(AL_FALSE);
+}
+
+AUTO_UNIT_TEST(MixerPointResamplerMatchesC)
+{
+	FillCPUCaps(AL_FALSE);
+	unitAssert(resamplerMatchesC(POINT_RESAMPLER, Resample_point_C));
+}
+
+AUTO_UNIT_TEST(MixerLinearResamplerMatchesC)
+{
+	FillCPUCaps(AL_FALSE);
+	unitAssert(resamplerMatchesC(LINEAR_RESAMPLER, Resample_lerp_C));
+}
+
+AUTO_UNIT_TEST(MixerMonoMixerMatchesC)
+{
+	FillCPUCaps(AL_FALSE);
+	const ALuint counts[] = { 0, 1, 7, 256 };
+	for (size_t n = 0; n < sizeof(counts) / sizeof(counts[0]); ++n)
+	{
+		MonoMix vector(counts[n]);
+		MonoMix scalar(vector);
+		vector.run(SelectMonoMixer());
+		scalar.run(MixMono_C);
+		unitAssert(allClose(vector.dst, scalar.dst));
+		unitAssert(allClose(vector.gains, scalar.gains));
+	}
+}
+
+AUTO_UNIT_TEST(MixerMonoMixerSkipsLFE)
+{
+	FillCPUCaps(AL_FALSE);
+	MonoMix mix(16);
+	std::vector<ALfloat> before(mix.dst);
+	mix.run(SelectMonoMixer());
+	for (size_t i = 0; i < 16; ++i)
+	{
+		unitAssert(mix.dst[i * OUTPUTCHANNELS + LFE] == before[i * OUTPUTCHANNELS + LFE]);
+		unitAssert(mix.dst[i * OUTPUTCHANNELS + FRONT_LEFT] != before[i * OUTPUTCHANNELS + FRONT_LEFT]);
+	}
+}
+
+AUTO_UNIT_TEST(MixerIma4BlocksMixLikeTheDecompressedBuffer)
+{
+	FillCPUCaps(AL_FALSE);
+	std::vector<ALfloat> decompressed = mixIma4(true);
+	std::vector<ALfloat> compressed = mixIma4(false);
+	unitAssert(compressed.size() == decompressed.size());
+	bool audible = false;
+	for (size_t i = 0; i < compressed.size(); ++i)
+	{
+		unitAssert(compressed[i] == decompressed[i]);
+		audible = audible || compressed[i] != 0;
+	}
+	unitAssert(audible);
+}
@@ -51,10 +51,14 @@ namespace engine {
 						 std::string());
 			MOCK_METHOD1(bindTexture2D,
 						 void(GLuint texture));
+			MOCK_METHOD1(bindAlphaTexture2D,
+						 void(GLuint texture));
 			MOCK_METHOD2(deleteTextures,
 						 void(GLsizei n, const GLuint *textures));
 			MOCK_METHOD3(texImage2D,
 						 void(GLsizei width, GLsizei height, GLvoid* imageData));
+			MOCK_METHOD5(texImage2D,
+						 void(GLenum format, GLenum type, GLsizei width, GLsizei height, const GLvoid* imageData));
 			MOCK_METHOD2(texParameter,
 						 void(GLenum pname, GLint param));
 			MOCK_METHOD5(compressedTexImage2D,
@@ -65,10 +69,30 @@ namespace engine {
 						 void(GLfloat left, GLfloat right, GLfloat bottom, GLfloat top, GLfloat zNear, GLfloat zFar));
 			MOCK_METHOD1(multMatrix,
 						 void(const GLfloat* m));
+			MOCK_METHOD0(enableBlend,
+						 void());
+			MOCK_METHOD0(disableBlend,
+						 void());
+			MOCK_METHOD2(blendFunc,
+						 void(GLenum sfactor, GLenum dfactor));
+			MOCK_METHOD0(genBuffer,
+						 GLuint());
+			MOCK_METHOD2(deleteBuffers,
+						 void(GLsizei n, const GLuint* buffers));
+			MOCK_METHOD1(bindArrayBuffer,
+						 void(GLuint buffer));
+			MOCK_METHOD3(bufferData,
+						 void(GLsizeiptr size, const GLvoid* data, GLenum usage));
+			MOCK_METHOD3(bufferSubData,
+						 void(GLintptr offset, GLsizeiptr size, const GLvoid* data));
 			MOCK_METHOD0(MatrixScope,
 						 void());
 			MOCK_METHOD0(DestMatrixScope,
 						 void());
+			MOCK_METHOD0(PushMatrixScope,
+						 void());
+			MOCK_METHOD0(DestPushMatrixScope,
+						 void());
 			MOCK_METHOD0(ColorArrayScope,
 						 void());
 			MOCK_METHOD0(DestColorArrayScope,
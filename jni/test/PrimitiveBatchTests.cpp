@@ -0,0 +1,113 @@
+/*
+ * PrimitiveBatchTests.cpp
+ */
+
+#define PROVIDE_AUTO_TEST_MAIN
+#include "AutoTest.hpp"
+
+#include "engine/DrawableRectangle.hpp"
+#include "engine/PrimitiveBatch.hpp"
+#include "engine/Rectangle.hpp"
+#include "engine/RenderList.hpp"
+#include "engine/Scene.hpp"
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "MockGLMock.h"
+
+using namespace engine;
+using ::testing::_;
+using ::testing::InSequence;
+using ::testing::Mock;
+
+namespace
+{
+	const GLfloat red[4] = { 1, 0, 0, 1 };
+
+	// Draws a strip of its own, so it isn't batched.
+	class Strip : public Drawable
+	{
+	public:
+		virtual void draw(const Rectangle& screen) { gl::drawArrays(GL_TRIANGLE_STRIP, 0, 4); }
+	};
+}
+
+AUTO_UNIT_TEST(PrimitiveBatchRectangleIsTwoTriangles)
+{
+	PrimitiveBatch batch;
+	batch.rectangle(Point(1, 2), 3, 4, red);
+	unitAssert(batch.vertexCount() == 6);
+	// Zero sized shapes add nothing.
+	batch.rectangle(Point(1, 2), 0, 4, red);
+	batch.line(Point(1, 2), Point(1, 2), 1, red);
+	unitAssert(batch.vertexCount() == 6);
+}
+
+AUTO_UNIT_TEST(PrimitiveBatchLineIsAsWideAsAsked)
+{
+	// A flat line from (0, 0) to (10, 0), 2 wide, goes from y -1 to 1.
+	PrimitiveBatch batch;
+	batch.line(Point(0, 0), Point(10, 0), 2, red);
+	unitAssert(batch.vertexCount() == 6);
+	batch.outline(Point(0, 0), 10, 10, 2, red);
+	unitAssert(batch.vertexCount() == 30);
+
+	// Recorded, to see what flush() drew.
+	RenderList list;
+	RenderRecorder recorder;
+	gl::setThreadRecorder(&recorder);
+	recorder.begin(list);
+	batch.flush();
+	recorder.end();
+	gl::setThreadRecorder(NULL);
+
+	unitAssert(list.drawCount() == 1);
+	const RenderList::Draw& draw = list.draw(0);
+	unitAssert(draw.mode == GL_TRIANGLES);
+	unitAssert(draw.count == 30);
+	const GLfloat* vertexes = &list.data()[draw.vertexes];
+	unitAssert(vertexes[0] == 0 && vertexes[1] == 1);
+	unitAssert(vertexes[4] == 10 && vertexes[5] == -1);
+	const GLfloat* colors = &list.data()[draw.colors];
+	unitAssert(colors[0] == 1 && colors[1] == 0 && colors[119] == 1);
+}
+
+AUTO_UNIT_TEST(PrimitiveBatchDrawsOncePerFlush)
+{
+	PrimitiveBatch batch;
+	batch.rectangle(Point(0, 0), 1, 1, red);
+	batch.rectangle(Point(5, 5), 1, 1, red);
+
+	gl::MockGLMock mock;
+	gl::glMock = &mock;
+	EXPECT_CALL(mock, drawArrays(GL_TRIANGLES, 0, 12));
+	batch.flush();
+	unitAssert(batch.empty());
+	// Nothing left to draw.
+	batch.flush();
+	unitAssert(Mock::VerifyAndClearExpectations(&mock));
+	gl::glMock = NULL;
+}
+
+AUTO_UNIT_TEST(SceneDrawsTheBatchBeforeWhatComesAfterIt)
+{
+	boost::intrusive_ptr<Scene> scene(new Scene);
+	boost::intrusive_ptr<DrawableRectangle> first(new DrawableRectangle(1, 1));
+	boost::intrusive_ptr<DrawableRectangle> second(new DrawableRectangle(1, 1));
+	boost::intrusive_ptr<DrawableRectangle> last(new DrawableRectangle(1, 1));
+	scene->addChild(first, 0).addChild(second, 1).addChild(new Strip, 2).addChild(last, 3);
+	Rectangle screen(0, 10, 10, 0);
+
+	gl::MockGLMock mock;
+	gl::glMock = &mock;
+	{
+		InSequence dummy;
+		// The two rectangles, borders and all, then the strip over them, then the last.
+		EXPECT_CALL(mock, drawArrays(GL_TRIANGLES, 0, 60));
+		EXPECT_CALL(mock, drawArrays(GL_TRIANGLE_STRIP, 0, 4));
+		EXPECT_CALL(mock, drawArrays(GL_TRIANGLES, 0, 30));
+	}
+	scene->draw(screen);
+	unitAssert(PrimitiveBatch::shared().empty());
+	unitAssert(Mock::VerifyAndClearExpectations(&mock));
+	gl::glMock = NULL;
+}
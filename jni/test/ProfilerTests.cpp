@@ -0,0 +1,183 @@
+/*
+ * ProfilerTests.cpp
+ */
+
+#define PROVIDE_AUTO_TEST_MAIN
+#include "AutoTest.hpp"
+
+#include "engine/Profiler.hpp"
+#include <pthread.h>
+#include <stdio.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+using namespace engine;
+
+namespace
+{
+	void spin(unsigned long long ns)
+	{
+		unsigned long long end = profiler::now() + ns;
+		while (profiler::now() < end)
+		{
+		}
+	}
+
+	void runFrames(size_t frames)
+	{
+		for (size_t i = 0; i < frames; ++i)
+		{
+			profiler::endFrame();
+		}
+	}
+
+	const profiler::ZoneStats* findZone(const std::vector<profiler::ZoneStats>& zones, const std::string& name)
+	{
+		for (size_t i = 0; i < zones.size(); ++i)
+		{
+			if (zones[i].name == name)
+				return &zones[i];
+		}
+		return NULL;
+	}
+
+	std::string readFile(const char* path)
+	{
+		std::ifstream in(path);
+		std::stringstream contents;
+		contents << in.rdbuf();
+		return contents.str();
+	}
+
+	size_t countOf(const std::string& text, const std::string& what)
+	{
+		size_t count = 0;
+		for (size_t at = text.find(what); at != std::string::npos; at = text.find(what, at + 1))
+		{
+			++count;
+		}
+		return count;
+	}
+
+	void* zoneOnOtherThread(void*)
+	{
+		profiler::setThreadName("Worker");
+		profiler::Zone zone("OtherThreadZone");
+		return NULL;
+	}
+
+	const char* tracePath = "ProfilerTests.json";
+}
+
+AUTO_UNIT_TEST(ProfilerStatsOnlyAfterAFullWindow)
+{
+	profiler::reset();
+	{
+		profiler::Zone zone("Windowed");
+	}
+	runFrames(profiler::statsWindowFrames - 1);
+	unitAssert(profiler::worstZones(10).empty());
+	runFrames(1);
+	unitAssert(findZone(profiler::worstZones(10), "Windowed") != NULL);
+}
+
+AUTO_UNIT_TEST(ProfilerWorstZonesComeFirst)
+{
+	profiler::reset();
+	{
+		profiler::Zone zone("Slow");
+		spin(2000000);
+	}
+	{
+		profiler::Zone zone("Fast");
+	}
+	runFrames(profiler::statsWindowFrames);
+
+	std::vector<profiler::ZoneStats> zones = profiler::worstZones(10);
+	unitAssert(zones.size() == 2);
+	unitAssert(zones[0].name == "Slow");
+	unitAssert(zones[0].worstMs >= 2.0);
+	unitAssert(zones[1].name == "Fast");
+	unitAssert(profiler::worstZones(1).size() == 1);
+}
+
+AUTO_UNIT_TEST(ProfilerZoneTotalsAddUpPerFrame)
+{
+	profiler::reset();
+	for (size_t i = 0; i < 3; ++i)
+	{
+		profiler::Zone zone("Repeated");
+		spin(1000000);
+	}
+	runFrames(profiler::statsWindowFrames);
+
+	const profiler::ZoneStats* zone = findZone(profiler::worstZones(10), "Repeated");
+	unitAssert(zone != NULL);
+	unitAssert(zone->worstMs >= 3.0);
+	// All three were in the first of the window's frames.
+	unitAssert(zone->averageMs < zone->worstMs);
+	unitAssert(zone->calls * profiler::statsWindowFrames > 2.9 && zone->calls * profiler::statsWindowFrames < 3.1);
+}
+
+AUTO_UNIT_TEST(ProfilerCountsZonesOfOtherThreads)
+{
+	profiler::reset();
+	pthread_t thread;
+	unitAssert(pthread_create(&thread, NULL, zoneOnOtherThread, NULL) == 0);
+	pthread_join(thread, NULL);
+	runFrames(profiler::statsWindowFrames);
+	unitAssert(findZone(profiler::worstZones(10), "OtherThreadZone") != NULL);
+}
+
+AUTO_UNIT_TEST(ProfilerDumpsChromeTrace)
+{
+	profiler::reset();
+	profiler::setThreadName("Main");
+	{
+		profiler::Zone outer("Outer");
+		profiler::Zone inner("Inner \"quoted\"");
+	}
+	unitAssert(profiler::dumpChromeTrace(tracePath));
+	std::string trace = readFile(tracePath);
+	remove(tracePath);
+
+	unitAssert(trace.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[") == 0);
+	unitAssert(trace.find("\"args\":{\"name\":\"Main\"}") != std::string::npos);
+	unitAssert(trace.find("\"name\":\"Outer\",\"ph\":\"X\"") != std::string::npos);
+	unitAssert(trace.find("\"name\":\"Inner \\\"quoted\\\"\"") != std::string::npos);
+	unitAssert(countOf(trace, "\"ph\":\"X\"") == 2);
+}
+
+AUTO_UNIT_TEST(ProfilerKeepsOnlyTheNewestZones)
+{
+	profiler::reset();
+	{
+		profiler::Zone zone("Oldest");
+	}
+	for (size_t i = 0; i < profiler::eventsPerThread; ++i)
+	{
+		profiler::Zone zone("Newer");
+	}
+	unitAssert(profiler::dumpChromeTrace(tracePath));
+	std::string trace = readFile(tracePath);
+	remove(tracePath);
+
+	unitAssert(trace.find("\"Oldest\"") == std::string::npos);
+	// The slot the thread writes next is never read, it may be half written.
+	unitAssert(countOf(trace, "\"name\":\"Newer\"") == profiler::eventsPerThread - 1);
+}
+
+AUTO_UNIT_TEST(ProfilerResetForgetsZones)
+{
+	{
+		profiler::Zone zone("Forgotten");
+	}
+	profiler::reset();
+	unitAssert(profiler::dumpChromeTrace(tracePath));
+	std::string trace = readFile(tracePath);
+	remove(tracePath);
+	unitAssert(trace.find("Forgotten") == std::string::npos);
+	unitAssert(profiler::worstZones(10).empty());
+	unitAssert(profiler::worstFrameMs() == 0);
+}
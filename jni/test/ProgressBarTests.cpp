@@ -8,6 +8,7 @@
 #define PROVIDE_AUTO_TEST_MAIN
 #include "AutoTest.hpp"
 
+#include "engine/PrimitiveBatch.hpp"
 #include "engine/ProgressBar.hpp"
 #include "engine/Rectangle.hpp"
 #include "gtest/gtest.h"
@@ -163,25 +164,18 @@ AUTO_UNIT_TEST(ProgressBarDraw)
 	{
 		InSequence dummy;
 	
+		// The border goes into the batch, and is drawn with it. The bar is empty.
 		EXPECT_CALL(mock, MatrixScope());
 		EXPECT_CALL(mock, disableTexture2D());
-		EXPECT_CALL(mock, color(4,GL_FLOAT,0,_));
-		EXPECT_CALL(mock, vertex(2,GL_FLOAT,0,_));
-		EXPECT_CALL(mock, translate(_,_,0));
-		EXPECT_CALL(mock, setGLLineWidth(_));
-		EXPECT_CALL(mock, drawArrays(GL_LINE_LOOP,0,4));
-		EXPECT_CALL(mock, DestMatrixScope());
-		EXPECT_CALL(mock, MatrixScope());
-		EXPECT_CALL(mock, disableTexture2D());
-		EXPECT_CALL(mock, color(4,GL_FLOAT,0,_));
-		EXPECT_CALL(mock, vertex(2,GL_FLOAT,0,_));
-		EXPECT_CALL(mock, translate(_,_,0));
-		EXPECT_CALL(mock, drawArrays(GL_TRIANGLE_STRIP,0,4));
+		EXPECT_CALL(mock, vertex(2,GL_FLOAT,6 * sizeof(GLfloat),_));
+		EXPECT_CALL(mock, color(4,GL_FLOAT,6 * sizeof(GLfloat),_));
+		EXPECT_CALL(mock, drawArrays(GL_TRIANGLES,0,24));
 		EXPECT_CALL(mock, DestMatrixScope());
 	}
 	
 	// Act
 	bar.draw(screen);
+	PrimitiveBatch::shared().flush();
 	
 	// Assert
 	unitAssert(Mock::VerifyAndClearExpectations(&mock));
@@ -0,0 +1,257 @@
+/*
+ * RenderListTests.cpp
+ */
+
+#define PROVIDE_AUTO_TEST_MAIN
+#include "AutoTest.hpp"
+
+#include "engine/Director.hpp"
+#include "engine/RenderList.hpp"
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "MockGLMock.h"
+#include <math.h>
+#include <pthread.h>
+
+using namespace engine;
+using ::testing::_;
+using ::testing::InSequence;
+using ::testing::Mock;
+using ::testing::Pointee;
+
+namespace
+{
+	const GLfloat square[8] = { -0.5,-0.5, 0.5,-0.5, -0.5,0.5, 0.5,0.5 };
+	const GLfloat red[16] = { 1,0,0,1, 1,0,0,1, 1,0,0,1, 1,0,0,1 };
+	const GLfloat uvs[8] = { 0,0, 1,0, 0,1, 1,1 };
+
+	bool near(GLfloat a, GLfloat b)
+	{
+		return fabsf(a - b) < 0.0001f;
+	}
+
+	// Records on the calling thread for as long as it lasts.
+	struct Recording
+	{
+		Recording(RenderList& list)
+		{
+			gl::setThreadRecorder(&recorder);
+			recorder.begin(list);
+		}
+		~Recording()
+		{
+			recorder.end();
+			gl::setThreadRecorder(NULL);
+		}
+		RenderRecorder recorder;
+	};
+
+	void drawSquare(GLfloat x, GLfloat y, GLfloat size, GLfloat angle = 0)
+	{
+		using namespace gl;
+		MatrixScope ms;
+		translate(x, y, 0);
+		rotate(angle, 0, 0, 1);
+		scale(size, size, 1);
+		vertex(2, GL_FLOAT, 0, square);
+		color(4, GL_FLOAT, 0, red);
+		drawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	}
+
+	// Counts its updates, and draws a square on the thread that updates it.
+	class SquareScene : public Scene
+	{
+	public:
+		SquareScene() : updates(0) {}
+		virtual void update(const DateTime& thisFrameStartTime, const TimeDuration& deltaTime)
+		{
+			++updates;
+			thread = pthread_self();
+		}
+		virtual void draw(const Rectangle& screen) { drawSquare(0, 0, 1); }
+		int updates;
+		pthread_t thread;
+	};
+}
+
+AUTO_UNIT_TEST(RenderRecorderOnlyRecordsItsOwnThread)
+{
+	unitAssert(!gl::recording());
+	{
+		RenderList list;
+		Recording recording(list);
+		unitAssert(gl::recording());
+		unitAssert(gl::currentMock() == &recording.recorder);
+	}
+	unitAssert(!gl::recording());
+	unitAssert(gl::threadRecorders == 0);
+}
+
+AUTO_UNIT_TEST(RenderRecorderMovesVertexesByTheModelview)
+{
+	RenderList list;
+	{
+		Recording recording(list);
+		// Dropped, a MatrixScope starts from the identity.
+		gl::translate(100, 0, 0);
+		drawSquare(10, 20, 4);
+	}
+	unitAssert(list.drawCount() == 1);
+	const RenderList::Draw& draw = list.draw(0);
+	unitAssert(draw.mode == GL_TRIANGLE_STRIP);
+	unitAssert(draw.count == 4);
+	unitAssert(draw.texture == gl::INVALID_TEXTURE);
+	const GLfloat* vertexes = &list.data()[draw.vertexes];
+	unitAssert(near(vertexes[0], 8) && near(vertexes[1], 18));
+	unitAssert(near(vertexes[6], 12) && near(vertexes[7], 22));
+	const GLfloat* colors = &list.data()[draw.colors];
+	unitAssert(colors[0] == 1 && colors[1] == 0 && colors[15] == 1);
+}
+
+AUTO_UNIT_TEST(RenderRecorderRotatesLikeGL)
+{
+	RenderList list;
+	{
+		Recording recording(list);
+		drawSquare(0, 0, 2, 90);
+	}
+	// (1, -1) turned a quarter counterclockwise.
+	const GLfloat* vertexes = &list.data()[list.draw(0).vertexes];
+	unitAssert(near(vertexes[2], 1) && near(vertexes[3], 1));
+}
+
+AUTO_UNIT_TEST(RenderRecorderKeepsTheTextureAndBlending)
+{
+	RenderList list;
+	{
+		Recording recording(list);
+		gl::enableTexture2D();
+		gl::bindTexture2D(7);
+		gl::texCoord(2, GL_FLOAT, 0, uvs);
+		gl::disableBlend();
+		drawSquare(0, 0, 1);
+		gl::enableBlend();
+		gl::disableTexture2D();
+		gl::setGLLineWidth(3);
+		drawSquare(0, 0, 1);
+	}
+	unitAssert(list.drawCount() == 2);
+	unitAssert(list.draw(0).texture == 7);
+	unitAssert(!list.draw(0).blend);
+	unitAssert(list.data()[list.draw(0).texCoords + 7] == 1);
+	unitAssert(list.draw(1).texture == gl::INVALID_TEXTURE);
+	unitAssert(list.draw(1).blend);
+	unitAssert(list.draw(1).lineWidth == 3);
+}
+
+AUTO_UNIT_TEST(RenderRecorderKeepsTheAlphaTexture)
+{
+	RenderList list;
+	{
+		Recording recording(list);
+		gl::enableTexture2D();
+		gl::bindTexture2D(7);
+		gl::bindAlphaTexture2D(8);
+		gl::texCoord(2, GL_FLOAT, 0, uvs);
+		drawSquare(0, 0, 1);
+		// Untextured drawing turns it off.
+		gl::disableTexture2D();
+		gl::enableTexture2D();
+		drawSquare(0, 0, 1);
+	}
+	unitAssert(list.draw(0).alphaTexture == 8);
+	unitAssert(list.draw(1).alphaTexture == gl::INVALID_TEXTURE);
+}
+
+AUTO_UNIT_TEST(RenderListSubmitsWhatWasRecorded)
+{
+	RenderList list;
+	{
+		Recording recording(list);
+		gl::clearColorBuffer();
+		gl::enableTexture2D();
+		gl::bindTexture2D(7);
+		gl::texCoord(2, GL_FLOAT, 0, uvs);
+		drawSquare(0, 0, 1);
+		GLuint unused = 9;
+		gl::deleteTextures(1, &unused);
+	}
+	unitAssert(list.clearsColor());
+
+	gl::MockGLMock mock;
+	gl::glMock = &mock;
+	{
+		InSequence dummy;
+		EXPECT_CALL(mock, deleteTextures(1, _));
+		EXPECT_CALL(mock, multMatrix(_));
+		EXPECT_CALL(mock, clearColorBuffer());
+		EXPECT_CALL(mock, bindTexture2D(7));
+		EXPECT_CALL(mock, drawArrays(GL_TRIANGLE_STRIP, 0, 4));
+		EXPECT_CALL(mock, multMatrix(_));
+		EXPECT_CALL(mock, clearColorBuffer());
+		EXPECT_CALL(mock, bindTexture2D(7));
+		EXPECT_CALL(mock, drawArrays(GL_TRIANGLE_STRIP, 0, 4));
+	}
+	list.submit();
+	// Shown again, the texture is only deleted once.
+	list.submit();
+	unitAssert(Mock::VerifyAndClearExpectations(&mock));
+	gl::glMock = NULL;
+}
+
+AUTO_UNIT_TEST(RenderListDeletesWhatWasLetGoOfBetweenFrames)
+{
+	RenderList first;
+	RenderList second;
+	RenderRecorder recorder;
+	gl::setThreadRecorder(&recorder);
+	recorder.begin(first);
+	recorder.end();
+	GLuint texture = 9;
+	gl::deleteTextures(1, &texture);
+	GLuint buffer = 4;
+	gl::deleteBuffers(1, &buffer);
+	recorder.begin(second);
+	recorder.end();
+	gl::setThreadRecorder(NULL);
+
+	gl::MockGLMock mock;
+	gl::glMock = &mock;
+	EXPECT_CALL(mock, multMatrix(_)).Times(2);
+	// The list already recorded may still be shown, only the next one deletes them.
+	EXPECT_CALL(mock, deleteTextures(_, _)).Times(0);
+	EXPECT_CALL(mock, deleteBuffers(_, _)).Times(0);
+	first.submit();
+	{
+		InSequence dummy;
+		EXPECT_CALL(mock, deleteTextures(1, Pointee(9u)));
+		EXPECT_CALL(mock, deleteBuffers(1, Pointee(4u)));
+	}
+	second.submit();
+	unitAssert(Mock::VerifyAndClearExpectations(&mock));
+	gl::glMock = NULL;
+}
+
+AUTO_UNIT_TEST(DirectorSubmitsWhatItsSimulationRecorded)
+{
+	gl::MockGLMock mock;
+	gl::glMock = &mock;
+	// The first frame is waited for, the second shows it again while the simulation
+	// builds the next, and the third shows that.
+	EXPECT_CALL(mock, drawArrays(GL_TRIANGLE_STRIP, 0, 4)).Times(3);
+	boost::intrusive_ptr<SquareScene> scene = new SquareScene;
+	{
+		Director director;
+		director.runScene(scene);
+		director.startSimulation();
+		director.renderNextFrame();
+		unitAssert(director.simulationIdle());
+		director.renderNextFrame();
+		director.renderNextFrame();
+		director.stopSimulation();
+	}
+	unitAssert(scene->updates == 3);
+	unitAssert(!pthread_equal(scene->thread, pthread_self()));
+	unitAssert(Mock::VerifyAndClearExpectations(&mock));
+	gl::glMock = NULL;
+}
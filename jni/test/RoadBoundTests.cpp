@@ -0,0 +1,73 @@
+/*
+ * RoadBoundTests.cpp
+ */
+
+#define PROVIDE_AUTO_TEST_MAIN
+#include "AutoTest.hpp"
+
+#include "game/RoadBound.hpp"
+#include "engine/Point.hpp"
+
+using namespace rr;
+
+namespace
+{
+	// Road centered at x = 100 with the first row at y = 0. Rows are every 10 units
+	// and the road narrows from 100 to 60 units wide over the first 20 units.
+	RoadBoundPtr createRoad()
+	{
+		RoadBoundPtr road = new RoadBound(0, 0);
+		road->addRoadSectionBorder("1 1\n0 50 150\n10 60 140\n20 70 130\n30 70 130\n");
+		return road;
+	}
+}
+
+AUTO_UNIT_TEST(RoadBoundRowCoordinates)
+{
+	RoadBoundPtr road = createRoad();
+	unitAssert(road->getBoundCoordinates(0) == Coord(50, 150));
+	unitAssert(road->getBoundCoordinates(10) == Coord(60, 140));
+	unitAssert(road->getBoundCoordinates(20) == Coord(70, 130));
+	unitAssert(road->getBoundCoordinates(30) == Coord(70, 130));
+}
+
+AUTO_UNIT_TEST(RoadBoundInterpolatesBetweenRows)
+{
+	RoadBoundPtr road = createRoad();
+	unitAssert(road->getBoundCoordinates(5) == Coord(55, 145));
+	unitAssert(road->getBoundCoordinates(16) == Coord(66, 134));
+}
+
+AUTO_UNIT_TEST(RoadBoundOutOfRange)
+{
+	RoadBoundPtr road = createRoad();
+	// before the first row the first row is used
+	unitAssert(road->getBoundCoordinates(-10) == Coord(50, 150));
+	// past the end of the road there is no road
+	unitAssert(road->getBoundCoordinates(31) == Coord(0, 0));
+	unitAssert(!road->isPointOnRoad(100, 31));
+	unitAssert(road->isPointOnRoad(100, 30));
+}
+
+AUTO_UNIT_TEST(RoadBoundSectionsAreStacked)
+{
+	RoadBoundPtr road = createRoad();
+	road->addRoadSectionBorder("1 1\n10 80 120\n20 90 110\n");
+	unitAssert(road->getBoundCoordinates(40) == Coord(80, 120));
+	unitAssert(road->getBoundCoordinates(45) == Coord(85, 115));
+	unitAssert(road->getBoundCoordinates(50) == Coord(90, 110));
+}
+
+AUTO_UNIT_TEST(RoadBoundBatchLookup)
+{
+	RoadBoundPtr road = createRoad();
+	float ys[] = { 0, 5, 16, 31 };
+	float lefts[4], rights[4];
+	road->getBoundCoordinates(ys, 4, lefts, rights);
+	for (int i = 0; i < 4; ++i)
+	{
+		Coord single = road->getBoundCoordinates(ys[i]);
+		unitAssert(lefts[i] == single.x());
+		unitAssert(rights[i] == single.y());
+	}
+}
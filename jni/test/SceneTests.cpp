@@ -34,6 +34,18 @@ vector<TexturedQuadPtr> createFrames()
 const SpritePtr first = new Sprite(new Animation(createFrames()));
 const SpritePtr second = new Sprite(new Animation(createFrames()));
 
+// Covers area without transparency, as an opaque background sprite would.
+class OpaqueRectangle : public Drawable
+{
+public:
+	OpaqueRectangle(const Rectangle& area) : area(area), draws(0) {}
+	virtual void draw(const Rectangle& screen) { ++draws; }
+	virtual bool opaqueArea(const Rectangle& screen, Rectangle& area) { area = this->area; return true; }
+	Rectangle area;
+	int draws;
+};
+typedef boost::intrusive_ptr<OpaqueRectangle> OpaqueRectanglePtr;
+
 AUTO_UNIT_TEST(SceneAddChildren)
 {
 	// Arrange
@@ -192,6 +204,64 @@ AUTO_UNIT_TEST(SceneDrawOne)
 	unitAssert(Mock::VerifyAndClearExpectations(&mock));
 }
 
+AUTO_UNIT_TEST(SceneIsOpaqueWhereStackedOpaqueChildrenCoverTheScreen)
+{
+	Scene scene;
+	Rectangle screen(0,5,5,0);
+	Rectangle area(0,0,0,0);
+	unitAssert(!scene.opaqueArea(screen, area));
+
+	scene.addChild(new OpaqueRectangle(Rectangle(-1,6,3,-1)));
+	unitAssert(!scene.opaqueArea(screen, area));
+
+	scene.addChild(new OpaqueRectangle(Rectangle(-1,6,8,4)));
+	unitAssert(!scene.opaqueArea(screen, area));
+
+	scene.addChild(new OpaqueRectangle(Rectangle(-1,6,4,2)));
+	unitAssert(scene.opaqueArea(screen, area));
+	unitAssert(area == screen);
+}
+
+AUTO_UNIT_TEST(SceneOnlyCountsOpaqueChildrenDrawnFirst)
+{
+	Scene scene;
+	Rectangle screen(0,5,5,0);
+	Rectangle area(0,0,0,0);
+	scene.addChild(new OpaqueRectangle(screen), 1);
+	scene.addChild(new DrawableRectangle(1,1), 0);
+	unitAssert(!scene.opaqueArea(screen, area));
+}
+
+AUTO_UNIT_TEST(SceneDrawsOpaqueChildrenFirstWithoutBlending)
+{
+	using namespace gl;
+	using ::testing::InSequence;
+	using ::testing::Mock;
+
+	Scene scene;
+	Rectangle screen(0,5,5,0);
+	OpaqueRectanglePtr background = new OpaqueRectangle(screen);
+	OpaqueRectanglePtr foreground = new OpaqueRectangle(screen);
+	scene.addChild(background, -1);
+	scene.addChild(first);
+	scene.addChild(foreground, 1);
+
+	MockGLMock mock;
+	glMock = &mock;
+	{
+		InSequence dummy;
+		EXPECT_CALL(mock, disableBlend());
+		EXPECT_CALL(mock, enableBlend()).Times(3);
+	}
+
+	scene.draw(screen);
+
+	unitAssert(Mock::VerifyAndClearExpectations(&mock));
+	glMock = NULL;
+	unitAssert(background->draws == 1);
+	unitAssert(foreground->draws == 1);
+}
+
 // TODO: Write a DrawTwo test.
 // Warning: GoogleMock wasn't easy to write this for
 //  (and thus the TODO) because it hasn't readily
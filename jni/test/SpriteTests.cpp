@@ -9,13 +9,19 @@
 #include "AutoTest.hpp"
 
 #include "engine/Animation.hpp"
+#include "engine/DrawCapture.hpp"
 #include "engine/EngineFwd.hpp"
 #include "engine/Rectangle.hpp"
+#include "engine/RenderList.hpp"
 #include "engine/Sprite.hpp"
 #include "engine/TexturedQuad.hpp"
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 #include "MockGLMock.h"
+#include <fstream>
+#include <math.h>
+#include <stdio.h>
+#include <string>
 
 using namespace engine;
 using namespace blocxx;
@@ -100,3 +106,106 @@ AUTO_UNIT_TEST(SpriteDrawAnimation)
 	// Assert
 	unitAssert(Mock::VerifyAndClearExpectations(&mock));
 }
+
+AUTO_UNIT_TEST(TexturedQuadRotatedAndTrimmedInAtlas)
+{
+	// The left half of the top half is what wasn't transparent, turned in the atlas.
+	TexturedQuadPtr quad = new TexturedQuad(0, 0, 0.5, 0.25, new Texture(1), 10, 20);
+	quad->setRotatedInAtlas();
+	quad->setTrimmedArea(Rectangle(-0.5, 0, 0.5, 0));
+	Rectangle screen(0, 10, 10, 0);
+
+	RenderList list;
+	RenderRecorder recorder;
+	gl::setThreadRecorder(&recorder);
+	recorder.begin(list);
+	quad->draw(screen);
+	quad->setFlippedHorizontal(true);
+	quad->draw(screen);
+	quad = NULL;
+	recorder.end();
+	gl::setThreadRecorder(NULL);
+
+	unitAssert(list.drawCount() == 2);
+	// The bottom left and top right vertexes, and their uvs: the image's bottom left is the
+	// rectangle's top left.
+	const GLfloat* vertexes = &list.data()[list.draw(0).vertexes];
+	const GLfloat* uvs = &list.data()[list.draw(0).texCoords];
+	unitAssert(vertexes[0] == -0.5 && vertexes[1] == 0);
+	unitAssert(vertexes[6] == 0 && vertexes[7] == 0.5);
+	unitAssert(uvs[0] == 0 && uvs[1] == 0);
+	unitAssert(uvs[6] == 0.5 && uvs[7] == 0.25);
+
+	// Flipped, the trimmed part moves to the right half, and the image's bottom right is there.
+	vertexes = &list.data()[list.draw(1).vertexes];
+	uvs = &list.data()[list.draw(1).texCoords];
+	unitAssert(vertexes[0] == 0 && vertexes[1] == 0);
+	unitAssert(vertexes[6] == 0.5 && vertexes[7] == 0.5);
+	unitAssert(uvs[0] == 0 && uvs[1] == 0.25);
+}
+
+AUTO_UNIT_TEST(TrimmedQuadKeepsTheSpritesTransform)
+{
+	// Only the left half wasn't transparent, drawn through a sprite that is moved and turned.
+	Rectangle screen(0, 100, 100, 0);
+	Point position;
+
+	RenderList list;
+	RenderRecorder recorder;
+	gl::setThreadRecorder(&recorder);
+	recorder.begin(list);
+	{
+		TexturedQuadPtr quad = new TexturedQuad(0, 0, 0.5, 1, new Texture(1), 10, 10);
+		quad->setTrimmedArea(Rectangle(-0.5, 0, 0.5, -0.5));
+		Sprite sprite(quad);
+		sprite.setPosition(Point(20, 30));
+		sprite.setRotation(90);
+		position = sprite.getPositionRelativeToOrigin(screen);
+		sprite.draw(screen);
+	}
+	recorder.end();
+	gl::setThreadRecorder(NULL);
+
+	unitAssert(list.drawCount() == 1);
+	// The trimmed bottom left at (-5, -5) and top right at (0, 5) of the sprite, turned a
+	// quarter clockwise around its position.
+	const GLfloat* vertexes = &list.data()[list.draw(0).vertexes];
+	unitAssert(fabs(vertexes[0] - (position.x() - 5)) < 0.001 && fabs(vertexes[1] - (position.y() + 5)) < 0.001);
+	unitAssert(fabs(vertexes[6] - (position.x() + 5)) < 0.001 && fabs(vertexes[7] - position.y()) < 0.001);
+}
+
+AUTO_UNIT_TEST(TexturedQuadDrawsAreCaptured)
+{
+	TexturedQuadPtr truck = new TexturedQuad(0, 0, 1, 1, new Texture(1), 10, 10);
+	truck->setName("Truck");
+	TexturedQuadPtr tree = new TexturedQuad(0, 0, 1, 1, new Texture(1), 10, 10);
+	tree->setName("tree01");
+	TexturedQuadPtr unnamed = new TexturedQuad(0, 0, 1, 1, new Texture(1), 10, 10);
+	Rectangle screen(0, 10, 10, 0);
+
+	RenderList list;
+	RenderRecorder recorder;
+	gl::setThreadRecorder(&recorder);
+	recorder.begin(list);
+	unitAssert(drawcapture::start("SpriteTests.capture"));
+	truck->draw(screen);
+	truck->draw(screen);
+	unnamed->draw(screen);
+	tree->draw(screen);
+	drawcapture::endFrame();
+	drawcapture::endFrame();
+	tree->draw(screen);
+	drawcapture::stop();
+	truck = tree = unnamed = NULL;
+	recorder.end();
+	gl::setThreadRecorder(NULL);
+
+	// Drawn again right after itself a quad is written once, and a frame without any is a line still.
+	std::ifstream in("SpriteTests.capture");
+	std::string line;
+	unitAssert(std::getline(in, line) && line == "Truck tree01");
+	unitAssert(std::getline(in, line) && line.empty());
+	unitAssert(std::getline(in, line) && line == "tree01");
+	unitAssert(!std::getline(in, line));
+	remove("SpriteTests.capture");
+}
@@ -0,0 +1,128 @@
+/*
+ * VertexBufferTests.cpp
+ */
+
+#define PROVIDE_AUTO_TEST_MAIN
+#include "AutoTest.hpp"
+
+#include "engine/VertexBuffer.hpp"
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "MockGLMock.h"
+
+using namespace engine;
+using ::testing::_;
+using ::testing::Mock;
+using ::testing::Return;
+
+namespace
+{
+	const GLfloat first[4] = { 1, 2, 3, 4 };
+	const GLfloat second[4] = { 5, 6, 7, 8 };
+
+	// A context with buffer objects, as Director::init() would find it.
+	struct BufferContext
+	{
+		BufferContext()
+		{
+			gl::glMock = &mock;
+			gl::invalidateState();
+			gl::state.buffers = true;
+			++gl::state.context;
+		}
+		~BufferContext()
+		{
+			gl::glMock = NULL;
+			gl::state.buffers = false;
+		}
+		gl::MockGLMock mock;
+	};
+}
+
+AUTO_UNIT_TEST(StaticVertexBufferWithoutBufferObjectsDrawsFromClientMemory)
+{
+	gl::state.buffers = false;
+	StaticVertexBuffer buffer(4);
+	UInt32 a = buffer.allocate(first);
+	UInt32 b = buffer.allocate(second);
+	unitAssert(buffer.prepare() == 0);
+	const GLfloat* pointer = static_cast<const GLfloat*>(buffer.pointer(b, 1));
+	unitAssert(pointer[0] == 6 && pointer[2] == 8);
+	pointer = static_cast<const GLfloat*>(buffer.pointer(a));
+	unitAssert(pointer[0] == 1);
+}
+
+AUTO_UNIT_TEST(StaticVertexBufferReusesReleasedSlots)
+{
+	StaticVertexBuffer buffer(4);
+	UInt32 a = buffer.allocate(first);
+	UInt32 b = buffer.allocate(second);
+	unitAssert(a != b);
+	buffer.release(a);
+	unitAssert(buffer.allocate(second) == a);
+	unitAssert(buffer.allocate(first) != a);
+}
+
+AUTO_UNIT_TEST(StaticVertexBufferUploadsOnlyWhatChanged)
+{
+	BufferContext context;
+	StaticVertexBuffer buffer(4);
+	buffer.allocate(first);
+	UInt32 slot = buffer.allocate(second);
+
+	EXPECT_CALL(context.mock, genBuffer()).WillOnce(Return(5));
+	EXPECT_CALL(context.mock, bindArrayBuffer(5)).Times(3);
+	EXPECT_CALL(context.mock, bufferData(_, NULL, GL_STATIC_DRAW));
+	EXPECT_CALL(context.mock, bufferSubData(0, 8 * sizeof(GLfloat), _));
+	EXPECT_CALL(context.mock, bufferSubData(4 * sizeof(GLfloat), 4 * sizeof(GLfloat), _));
+
+	unitAssert(buffer.prepare() == 5);
+	unitAssert(buffer.prepare() == 5);
+	buffer.set(slot, first);
+	unitAssert(buffer.prepare() == 5);
+	unitAssert(buffer.pointer(slot, 1) == reinterpret_cast<const GLvoid*>(5 * sizeof(GLfloat)));
+	unitAssert(Mock::VerifyAndClearExpectations(&context.mock));
+}
+
+AUTO_UNIT_TEST(StaticVertexBufferStartsOverInANewContext)
+{
+	BufferContext context;
+	StaticVertexBuffer buffer(4);
+	buffer.allocate(first);
+
+	EXPECT_CALL(context.mock, genBuffer()).WillOnce(Return(5)).WillOnce(Return(9));
+	EXPECT_CALL(context.mock, bindArrayBuffer(_)).Times(2);
+	EXPECT_CALL(context.mock, bufferData(_, NULL, GL_STATIC_DRAW)).Times(2);
+	EXPECT_CALL(context.mock, bufferSubData(0, 4 * sizeof(GLfloat), _)).Times(2);
+
+	unitAssert(buffer.prepare() == 5);
+	++gl::state.context;
+	unitAssert(buffer.prepare() == 9);
+	unitAssert(Mock::VerifyAndClearExpectations(&context.mock));
+}
+
+AUTO_UNIT_TEST(StreamingVertexBufferTakesTurns)
+{
+	BufferContext context;
+	StreamingVertexBuffer buffer;
+
+	EXPECT_CALL(context.mock, genBuffer()).WillOnce(Return(5)).WillOnce(Return(6));
+	EXPECT_CALL(context.mock, bindArrayBuffer(_)).Times(3);
+	EXPECT_CALL(context.mock, bufferData(4 * sizeof(GLfloat), first, GL_DYNAMIC_DRAW)).Times(3);
+
+	const GLvoid* pointer = first;
+	unitAssert(buffer.upload(first, 4, pointer) == 5);
+	unitAssert(pointer == NULL);
+	unitAssert(buffer.upload(first, 4, pointer) == 6);
+	unitAssert(buffer.upload(first, 4, pointer) == 5);
+	unitAssert(Mock::VerifyAndClearExpectations(&context.mock));
+}
+
+AUTO_UNIT_TEST(StreamingVertexBufferWithoutBufferObjectsDrawsFromTheData)
+{
+	gl::state.buffers = false;
+	StreamingVertexBuffer buffer;
+	const GLvoid* pointer = NULL;
+	unitAssert(buffer.upload(second, 4, pointer) == 0);
+	unitAssert(pointer == second);
+}
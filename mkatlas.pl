@@ -38,6 +38,8 @@
 # -s 512 sets the atlas image size to 512 pixels. The number must be a power of 2.
 # -f sets the atl file with lines as described above
 # -r sets the root directory for images. All paths from the atl file are relative to this directory
+# -a with -e .pkm: ETC1 has no alpha, so an atlas with any translucent image also gets its alpha as a gray
+#    fooAtlas_alpha.pkm, named on an "alpha:" line of the .atlas file. The game draws the two together.
 #
 # Happy coding! - Matthias
 
@@ -135,14 +137,14 @@ sub insertImg()
 
 sub usage()
 {
-    print "mkatlas -f configfile [-s size (128)] [-r imgrootdir (.)] [-p pvrspacing (0)] [-e output extension (.png)] [-g group name (1)]\n";
+    print "mkatlas -f configfile [-s size (128)] [-r imgrootdir (.)] [-p pvrspacing (0)] [-e output extension (.png)] [-g group name (1)] [-a (alpha plane for .pkm)]\n";
     exit;
 }
 
 sub init()
 {
     use Getopt::Std;
-    my $opt_string = 'hf:s:r:p:e:g:';
+    my $opt_string = 'hf:s:r:p:e:g:a';
     getopts( "$opt_string", \%opt ) or usage();
     usage() if $opt{h} || !$opt{f};
     $opt{s} = 128 if(!defined($opt{s}));
@@ -229,7 +231,7 @@ sub main
 	while ($images_left > 0)
 	{
 		# build coordinate tree
-		my %atlasParam = (W => $opt{s}, H => $opt{s});
+		my %atlasParam = (W => $opt{s}, H => $opt{s}, TRANSLUCENT => 0);
 		my %node = (LEFT => 0, BOTTOM => 0, W => $atlasParam{W}, H => $atlasParam{H}, IMG_REF => 0, CHILDA => 0, CHILDB => 0);
 		
 		# process the images from largest to smallest
@@ -304,6 +306,17 @@ sub main
 			my $etc1callp = "$etc1tool ${file_prefix}Atlas.pkm --decode -o ${file_prefix}Atlas_etc1prev.png";
 			print "Calling $etc1callp\n";
 			system($etc1callp);
+
+			if ($opt{a} && $atlasParam{TRANSLUCENT})
+			{
+				&writeAlphaPlane($gd_atlas, "${file_prefix}Atlas_alpha.png");
+				my $alphacall = "$etc1tool ${file_prefix}Atlas_alpha.png --encode -o ${file_prefix}Atlas_alpha.pkm";
+				print "Calling $alphacall\n";
+				system($alphacall);
+				open (ATLASFILE, '>>', "${file_prefix}.atlas");
+				print ATLASFILE "alpha: ${image_filename}Atlas_alpha.pkm\n";
+				close(ATLASFILE);
+			}
 		}
 		
 		@images = @images_overflow;
@@ -440,9 +453,47 @@ sub generateAtlas
 		
 		$qname = $1 if ($node->{IMG_REF}->{FILENAME} =~ /^(.*)\..*$/);
 		$qname = $1 if($qname =~ /^.*\/(.*)$/);
-		print {$atlasParam->{ATLAS_FH}} "quad: $qname $x_coord $y_coord $w_dst $h_dst $scaleWidthDown $scaleHeightDown\n";
+		my $opaque = &isOpaque($gd_image_src) ? " opaque" : "";
+		$atlasParam->{TRANSLUCENT} = 1 if ($opaque eq "");
+		print {$atlasParam->{ATLAS_FH}} "quad: $qname $x_coord $y_coord $w_dst $h_dst $scaleWidthDown $scaleHeightDown$opaque\n";
     }
 	
     &generateAtlas($node->{CHILDA}, $atlasParam) if($node->{CHILDA});
     &generateAtlas($node->{CHILDB}, $atlasParam) if($node->{CHILDB});
 }
+
+# true if no pixel of the image has any transparency (GD alpha 0), the game draws those quads without blending
+sub isOpaque
+{
+	my ($gd_image) = @_;
+	my ($w, $h) = $gd_image->getBounds();
+	for (my $y = 0; $y < $h; $y++)
+	{
+		for (my $x = 0; $x < $w; $x++)
+		{
+			return 0 if ($gd_image->alpha($gd_image->getPixel($x, $y)) != 0);
+		}
+	}
+	return 1;
+}
+
+# writes the alpha of the atlas as a gray png, white where it's opaque (GD alpha 0) and black where it's clear (127)
+sub writeAlphaPlane
+{
+	my ($gd_atlas, $filename) = @_;
+	my ($w, $h) = $gd_atlas->getBounds();
+	my $gd_alpha = GD::Image->newTrueColor($w, $h);
+	my @grays = map { $gd_alpha->colorAllocate($_, $_, $_) } (0..255);
+	for (my $y = 0; $y < $h; $y++)
+	{
+		for (my $x = 0; $x < $w; $x++)
+		{
+			my $alpha = $gd_atlas->alpha($gd_atlas->getPixel($x, $y));
+			$gd_alpha->setPixel($x, $y, $grays[int((127 - $alpha) * 255 / 127 + 0.5)]);
+		}
+	}
+	open (ALPHA, '>', $filename) || die("Cannot open $filename");
+	binmode ALPHA;
+	print ALPHA $gd_alpha->png(9);
+	close ALPHA;
+}
@@ -2,11 +2,14 @@
 
 # this script depends on resize_fonts.sh, resize_assets.sh and generate_atlases.sh
 
-# (NOTE: generate_atlases.sh depends on mkatlas.pl which depends on compression tools: etc1tool and texturetool)
+# (NOTE: generate_atlases.sh depends on jni/atlas/mkatlas or mkatlas.pl which depend on compression tools: etc1tool and texturetool)
 
 # for simplicity, this script can be run with a single parameter for a target device (android or iphone).
 # Or it can be run with custom size, compression and directory options. See usage for details.
 
+# for android it also makes the atlases of the smaller screens in atlasSets, each in a directory of the atlas dir.
+# The game picks the set for the screen it has, see TextureLibrary::selectAtlasSet() and RedneckRacerGame.
+
 set -u #referencing undefined variable causes error
 set -x #print out everything it does
 set -e #anything with non-zero exit status aborts script
@@ -34,6 +37,25 @@ checkSrcDirectory()
 	fi
 }
 
+#<directory>:<screen width>x<screen height>, as RedneckRacerGame adds them
+atlasSets='ldpi:240x400 mdpi:320x533'
+
+#makes each set of atlasSets from the full-size graphics, as the atlases are made below
+makeAtlasSets()
+{
+	for atlasSet in ${atlasSets}; do
+		setDir=$(echo ${atlasSet} | cut -d: -f1)
+		setW=$(echo ${atlasSet} | cut -d: -f2 | cut -dx -f1)
+		setH=$(echo ${atlasSet} | cut -d: -f2 | cut -dx -f2)
+		rm -rf "${atlasesDir}/${setDir}"
+		mkdir -p "${atlasesDir}/${setDir}"
+		# the .road and realrect.bound files stay the full size set's, the game's world doesn't shrink
+		./resize_assets.sh ${setW} ${setH} "${graphicsSrcDir}" "./graphics/${setDir}" || { echo "FAILED!"; exit 1; }
+		./generate_atlases.sh ${compression} "./graphics/${setDir}" "${atlasesDir}/${setDir}" || { echo "FAILED!"; exit 1; }
+		./resize_fonts.sh ${setH} "${graphicsSrcDir}" "${atlasesDir}/${setDir}/fonts" || { echo "FAILED!"; exit 1; }
+	done
+}
+
 #defaults
 compression='none'
 graphicsSrcDir='./graphics/ginormous'
@@ -111,4 +133,8 @@ mv "${resizedGraphicsDir}/"*".road" "${resizedGraphicsDir}/realrect.bound" "${at
 ./generate_atlases.sh ${compression} "${resizedGraphicsDir}" "${atlasesDir}" || { echo "FAILED!"; exit 1; }
 ./resize_fonts.sh ${targetH} "${graphicsSrcDir}" "${atlasesDir}/fonts" || { echo "FAILED!"; exit 1; }
 
+if [ $# == 1 ] && [ "${targetDevice}" == 'android' ]; then
+	makeAtlasSets
+fi
+
 echo "Finished!"